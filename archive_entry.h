@@ -0,0 +1,44 @@
+#ifndef _ARCHIVE_ENTRY_H_
+#define _ARCHIVE_ENTRY_H_
+
+#include <string>
+
+#include <glib.h>
+
+/**
+ * \brief One member of an archive written by ArchiveWriteRequest
+ *
+ * Either a byte range of a file on disk or a small in-memory blob (e.g. a
+ * manifest). A length of -1 means "up to the file size at packing time".
+ */
+class ArchiveEntry
+{
+public:
+    ArchiveEntry() :
+        offset{0}, length{-1}, in_memory{false}
+    {}
+
+    ArchiveEntry(const std::string& p) :
+        path{p}, offset{0}, length{-1}, in_memory{false}
+    {}
+
+    ArchiveEntry(const std::string& p, goffset o, goffset l) :
+        path{p}, offset{o}, length{l}, in_memory{false}
+    {}
+
+    static ArchiveEntry from_memory(const std::string& name, const std::string& content)
+    {
+        ArchiveEntry entry(name);
+        entry.content = content;
+        entry.in_memory = true;
+        return entry;
+    }
+
+    std::string path;
+    std::string content;
+    goffset offset;
+    goffset length;
+    bool in_memory;
+};
+
+#endif /* _ARCHIVE_ENTRY_H_ */
@@ -0,0 +1,306 @@
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <giomm/fileinputstream.h>
+#include <giomm/fileoutputstream.h>
+#include <giomm/zlibcompressor.h>
+#include <giomm/converteroutputstream.h>
+
+#include "archive_write_request.h"
+#include "utils.h"
+
+namespace {
+
+const std::size_t TAR_BLOCK_SIZE = 512;
+const std::size_t COPY_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * ustar header, see POSIX.1-1988 / pax(1).
+ */
+struct TarHeader
+{
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char chksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char pad[12];
+};
+
+static_assert(sizeof(TarHeader) == TAR_BLOCK_SIZE, "tar header must be one block");
+
+void put_octal(char *field, std::size_t len, unsigned long long value)
+{
+    // len - 1 digits plus terminating NUL
+    snprintf(field, len, "%0*llo", static_cast<int>(len - 1), value);
+}
+
+/**
+ * Splits the member name into ustar prefix and name. Leading slashes are
+ * stripped like tar does.
+ */
+void put_name(TarHeader& header, const std::string& file)
+{
+    auto pos = file.find_first_not_of('/');
+    std::string member = pos == std::string::npos ? "" : file.substr(pos);
+
+    if (member.size() <= sizeof(header.name)) {
+        memcpy(header.name, member.data(), member.size());
+        return;
+    }
+
+    // split at a slash, so that both parts fit
+    auto slash = member.rfind('/', sizeof(header.prefix));
+    while (slash != std::string::npos && slash > 0) {
+        if (member.size() - slash - 1 <= sizeof(header.name)) {
+            memcpy(header.prefix, member.data(), slash);
+            memcpy(header.name, member.data() + slash + 1, member.size() - slash - 1);
+            return;
+        }
+        slash = member.rfind('/', slash - 1);
+    }
+
+    throw std::runtime_error("File name too long for archive: " + file);
+}
+
+void write_block(const Glib::RefPtr<Gio::OutputStream>& out, const void *data,
+                 std::size_t len)
+{
+    gsize written;
+    out->write_all(data, len, written);
+}
+
+void write_padding(const Glib::RefPtr<Gio::OutputStream>& out, goffset size)
+{
+    static const char zeros[TAR_BLOCK_SIZE] = { 0 };
+    auto rest = size % TAR_BLOCK_SIZE;
+
+    if (rest)
+        write_block(out, zeros, TAR_BLOCK_SIZE - rest);
+}
+
+} // namespace
+
+ArchiveWriteRequest::ArchiveWriteRequest(
+    const std::vector<std::string>& files, const std::string& path,
+    int compression_level)
+    : _files(files)
+    , _path(path)
+    , _compression_level(compression_level)
+    , _bytes_in(0)
+    , _files_written(0)
+    , _error(false)
+{
+    _done.connect(sigc::mem_fun(*this, &ArchiveWriteRequest::on_done));
+}
+
+ArchiveWriteRequest::ArchiveWriteRequest(
+    const std::vector<std::string>& files,
+    const Glib::RefPtr<Gio::OutputStream>& stream, int compression_level)
+    : _files(files)
+    , _stream(stream)
+    , _compression_level(compression_level)
+    , _bytes_in(0)
+    , _files_written(0)
+    , _error(false)
+{
+    _done.connect(sigc::mem_fun(*this, &ArchiveWriteRequest::on_done));
+}
+
+ArchiveWriteRequest::~ArchiveWriteRequest()
+{
+    if (_worker.joinable())
+        _worker.join();
+}
+
+Glib::RefPtr<ArchiveWriteRequest>
+ArchiveWriteRequest::create(const std::vector<std::string>& files,
+                            const std::string& path, int compression_level)
+{
+    return Glib::RefPtr<ArchiveWriteRequest>(
+        new ArchiveWriteRequest(files, path, compression_level));
+}
+
+Glib::RefPtr<ArchiveWriteRequest>
+ArchiveWriteRequest::create(const std::vector<std::string>& files,
+                            const Glib::RefPtr<Gio::OutputStream>& stream,
+                            int compression_level)
+{
+    return Glib::RefPtr<ArchiveWriteRequest>(
+        new ArchiveWriteRequest(files, stream, compression_level));
+}
+
+void ArchiveWriteRequest::start_write()
+{
+    if (_compression_level < 0 || _compression_level > 9) {
+        PRINT_WARNING("Invalid archive compression level " << _compression_level
+                      << ", using " << DEFAULT_COMPRESSION_LEVEL);
+        _compression_level = DEFAULT_COMPRESSION_LEVEL;
+    }
+
+    PRINT_DEBUG("ArchiveWriteRequest::start_write(): " << _files.size()
+                << " files, level " << _compression_level);
+    _worker = std::thread(&ArchiveWriteRequest::run, this);
+}
+
+void ArchiveWriteRequest::run()
+{
+    // NOTE: runs in worker thread, no logging or signals in here
+    try {
+        if (_stream) {
+            write_archive(_stream);
+        } else {
+            auto file = Gio::File::create_for_path(_path);
+            auto out = file->replace("", false, Gio::FILE_CREATE_NONE);
+            try {
+                write_archive(out);
+                out->close();
+            } catch (...) {
+                out->close();
+                file->remove();
+                throw;
+            }
+        }
+    } catch (const Glib::Error& ex) {
+        _error = true;
+        _error_msg = ex.what();
+    } catch (const std::exception& ex) {
+        _error = true;
+        _error_msg = ex.what();
+    }
+
+    _done.emit();
+}
+
+void ArchiveWriteRequest::write_archive(const Glib::RefPtr<Gio::OutputStream>& out)
+{
+    auto compressor = Gio::ZlibCompressor::create(
+        Gio::ZLIB_COMPRESSOR_FORMAT_GZIP, _compression_level);
+    auto gz = Gio::ConverterOutputStream::create(out, compressor);
+
+    // the caller owns the stream, only finish the gzip trailer
+    gz->set_close_base_stream(false);
+
+    for (auto&& entry : _files)
+        write_entry(gz, entry);
+
+    // end of archive: two zero blocks
+    static const char zeros[2 * TAR_BLOCK_SIZE] = { 0 };
+    write_block(gz, zeros, sizeof(zeros));
+
+    gz->close();
+}
+
+void ArchiveWriteRequest::write_entry(const Glib::RefPtr<Gio::OutputStream>& out,
+                                      const ArchiveEntry& entry)
+{
+    struct stat sb;
+    goffset size;
+
+    if (entry.in_memory) {
+        memset(&sb, 0, sizeof(sb));
+        sb.st_mode  = 0644;
+        sb.st_uid   = getuid();
+        sb.st_gid   = getgid();
+        sb.st_mtime = time(nullptr);
+        size = entry.content.size();
+    } else {
+        // configured log files might not exist (yet), skip them
+        if (stat(entry.path.c_str(), &sb) || !S_ISREG(sb.st_mode)) {
+            _skipped.push_back(entry.path);
+            return;
+        }
+        size = entry.length >= 0 ?
+            entry.length : std::max<goffset>(sb.st_size - entry.offset, 0);
+    }
+
+    TarHeader header;
+    memset(&header, 0, sizeof(header));
+
+    put_name(header, entry.path);
+    put_octal(header.mode, sizeof(header.mode), sb.st_mode & 07777);
+    put_octal(header.uid, sizeof(header.uid), sb.st_uid);
+    put_octal(header.gid, sizeof(header.gid), sb.st_gid);
+    put_octal(header.size, sizeof(header.size), size);
+    put_octal(header.mtime, sizeof(header.mtime), sb.st_mtime);
+    header.typeflag = '0';
+    memcpy(header.magic, "ustar", 6);
+    memcpy(header.version, "00", 2);
+
+    // checksum is computed with the checksum field set to blanks
+    unsigned long chksum = 0;
+    memset(header.chksum, ' ', sizeof(header.chksum));
+    for (std::size_t i = 0; i < sizeof(header); ++i)
+        chksum += reinterpret_cast<const unsigned char *>(&header)[i];
+    snprintf(header.chksum, sizeof(header.chksum), "%06lo", chksum);
+    header.chksum[7] = ' ';
+
+    write_block(out, &header, sizeof(header));
+
+    if (entry.in_memory) {
+        write_block(out, entry.content.data(), entry.content.size());
+    } else {
+        // copy exactly the size announced in the header; log files may grow
+        // while we read them, truncated ones get zero-filled
+        std::vector<char> buffer(COPY_BUFFER_SIZE);
+        goffset remaining = size;
+        auto in = Gio::File::create_for_path(entry.path)->read();
+
+        if (entry.offset > 0)
+            in->seek(entry.offset, Glib::SEEK_TYPE_SET);
+
+        while (remaining > 0) {
+            gsize chunk = std::min<goffset>(remaining, buffer.size());
+            gssize bytes_read = in->read(buffer.data(), chunk);
+
+            if (bytes_read <= 0) {
+                std::fill(buffer.begin(), buffer.begin() + chunk, 0);
+                bytes_read = chunk;
+            }
+
+            write_block(out, buffer.data(), bytes_read);
+            remaining -= bytes_read;
+        }
+        in->close();
+    }
+
+    write_padding(out, size);
+
+    _bytes_in += size;
+    ++_files_written;
+}
+
+void ArchiveWriteRequest::on_done()
+{
+    if (_worker.joinable())
+        _worker.join();
+
+    for (auto&& file : _skipped)
+        PRINT_WARNING("Archive: skipping missing file " << file);
+
+    PRINT_DEBUG("ArchiveWriteRequest::on_done(): " << _files_written
+                << " files, " << _bytes_in << " bytes");
+
+    auto signal = ArchiveWriteResult::create(_bytes_in, _files_written,
+                                             _error, _error_msg);
+    finished.emit(signal);
+}
@@ -0,0 +1,106 @@
+#ifndef _ARCHIVE_WRITE_REQUEST_H_
+#define _ARCHIVE_WRITE_REQUEST_H_
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+#include <glibmm/dispatcher.h>
+#include <giomm/file.h>
+#include <giomm/outputstream.h>
+
+#include <sigc++/signal.h>
+
+#include "archive_write_result.h"
+#include "archive_entry.h"
+
+/**
+ * This class packs a list of files into a gzip compressed tar archive
+ * (ustar format) without forking tar. The archive is streamed through a
+ * Gio::ZlibCompressor either into a file or into any given output stream.
+ *
+ * The packing runs on a worker thread, the end of the operation will be
+ * channeled by the `finished` signal in the main loop.
+ *
+ * Example of usage:
+ *   auto req = ArchiveWriteRequest::create(files, "/mnt/share/log.tar.gz");
+ *   req->finished.connect(sigc::ptr_fun(&foobar));
+ *   req->start_write();
+ */
+class ArchiveWriteRequest : public Glib::Object
+{
+public:
+    static const int DEFAULT_COMPRESSION_LEVEL = 6;
+
+    ArchiveWriteRequest(const std::vector<ArchiveEntry>& files,
+                        const std::string& path,
+                        int compression_level = DEFAULT_COMPRESSION_LEVEL);
+
+    ArchiveWriteRequest(const std::vector<ArchiveEntry>& files,
+                        const Glib::RefPtr<Gio::OutputStream>& stream,
+                        int compression_level = DEFAULT_COMPRESSION_LEVEL);
+
+    ~ArchiveWriteRequest();
+
+    /**
+     * Creates an archive request writing to a file. An existing file will
+     * be replaced, a partially written file is removed on error.
+     *
+     * @param files             files (or file ranges) to pack
+     * @param path              archive file to create
+     * @param compression_level zlib level 0..9
+     *
+     * @return archive request instance
+     */
+    static Glib::RefPtr<ArchiveWriteRequest>
+    create(const std::vector<ArchiveEntry>& files, const std::string& path,
+           int compression_level = DEFAULT_COMPRESSION_LEVEL);
+
+    /**
+     * Creates an archive request writing to an already opened stream. The
+     * stream is not closed, only the compressor on top of it.
+     *
+     * @param files             files (or file ranges) to pack
+     * @param stream            target stream, must not be used by the main
+     *                          loop until `finished` was emitted
+     * @param compression_level zlib level 0..9
+     *
+     * @return archive request instance
+     */
+    static Glib::RefPtr<ArchiveWriteRequest>
+    create(const std::vector<ArchiveEntry>& files,
+           const Glib::RefPtr<Gio::OutputStream>& stream,
+           int compression_level = DEFAULT_COMPRESSION_LEVEL);
+
+    /**
+     * Starts the worker thread.
+     */
+    void start_write();
+
+    sigc::signal<void, const Glib::RefPtr<ArchiveWriteResult>& > finished;
+
+private:
+    std::vector<ArchiveEntry> _files;
+    std::vector<std::string> _skipped;
+    std::string _path;
+    Glib::RefPtr<Gio::OutputStream> _stream;
+    int _compression_level;
+    std::thread _worker;
+    Glib::Dispatcher _done;
+
+    // written by the worker, read after `_done` fired
+    goffset _bytes_in;
+    std::size_t _files_written;
+    bool _error;
+    std::string _error_msg;
+
+    void run();
+    void write_archive(const Glib::RefPtr<Gio::OutputStream>& out);
+    void write_entry(const Glib::RefPtr<Gio::OutputStream>& out,
+                     const ArchiveEntry& entry);
+    void on_done();
+};
+
+#endif /* _ARCHIVE_WRITE_REQUEST_H_ */
@@ -0,0 +1,62 @@
+#ifndef _ARCHIVE_WRITE_RESULT_H_
+#define _ARCHIVE_WRITE_RESULT_H_
+
+#include <string>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+
+class ArchiveWriteResult : public Glib::Object
+{
+public:
+    ArchiveWriteResult() :
+        _bytes_in{0}, _files{0}, _error{false}
+    {}
+
+    ArchiveWriteResult(goffset bytes_in, std::size_t files, bool error = false,
+                       const std::string& error_msg = "") :
+        _error_msg(error_msg), _bytes_in{bytes_in}, _files{files}, _error{error}
+    {}
+
+    inline static Glib::RefPtr<ArchiveWriteResult>
+    create(goffset bytes_in, std::size_t files, bool error = false,
+           const std::string& error_msg = "")
+    {
+        return Glib::RefPtr<ArchiveWriteResult>(
+            new ArchiveWriteResult(bytes_in, files, error, error_msg));
+    }
+
+    inline const std::string& error_msg() const
+    {
+        return _error_msg;
+    }
+
+    /**
+     * Number of uncompressed payload bytes put into the archive.
+     */
+    inline goffset bytes_in() const
+    {
+        return _bytes_in;
+    }
+
+    /**
+     * Number of files put into the archive.
+     */
+    inline std::size_t files() const
+    {
+        return _files;
+    }
+
+    inline bool error() const
+    {
+        return _error;
+    }
+
+private:
+    std::string _error_msg;
+    goffset _bytes_in;
+    std::size_t _files;
+    bool _error;
+};
+
+#endif /* _ARCHIVE_WRITE_RESULT_H_ */
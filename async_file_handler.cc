@@ -0,0 +1,166 @@
+#include <stdexcept>
+#include <chrono>
+
+#include "async_file_handler.h"
+#include "file_handler.h"
+#include "utils.h"
+
+AsyncFileHandler::RefPtr AsyncFileHandler::instance(nullptr);
+
+AsyncFileHandler::AsyncFileHandler() :
+    Glib::Object(),
+    _stop{false},
+    _next_id{0},
+    _running{0}
+{
+    _done.connect(sigc::mem_fun(*this, &AsyncFileHandler::on_done));
+
+    for (unsigned i = 0; i < DEFAULT_WORKERS; ++i)
+        _workers.emplace_back(&AsyncFileHandler::worker, this);
+}
+
+AsyncFileHandler::~AsyncFileHandler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cond.notify_all();
+
+    for (auto&& worker : _workers)
+        worker.join();
+}
+
+void AsyncFileHandler::get_file(const std::string& path, const Slot& slot)
+{
+    run("get_file " + path, [path] (FileOperationResult& result) {
+            result.content() = FileHandler::get_file(path);
+        }, slot);
+}
+
+void AsyncFileHandler::set_file(const std::string& path, const std::string& content,
+                                const Slot& slot)
+{
+    run("set_file " + path, [path, content] (FileOperationResult&) {
+            FileHandler::set_file(path, content);
+        }, slot);
+}
+
+void AsyncFileHandler::copy_file(const std::string& path1, const std::string& path2,
+                                 const Slot& slot)
+{
+    run("copy_file " + path1, [path1, path2] (FileOperationResult&) {
+            FileHandler::copy_file(path1, path2);
+        }, slot);
+}
+
+void AsyncFileHandler::move_file(const std::string& path1, const std::string& path2,
+                                 const Slot& slot)
+{
+    run("move_file " + path1, [path1, path2] (FileOperationResult&) {
+            FileHandler::move_file(path1, path2);
+        }, slot);
+}
+
+void AsyncFileHandler::remove_directory(const std::string& path, const Slot& slot)
+{
+    run("remove_directory " + path, [path] (FileOperationResult&) {
+            FileHandler::remove_directory(path);
+        }, slot);
+}
+
+void AsyncFileHandler::list_directory(const std::string& path, const Slot& slot)
+{
+    run("list_directory " + path, [path] (FileOperationResult& result) {
+            result.listing() = FileHandler::list_directory(path);
+        }, slot);
+}
+
+void AsyncFileHandler::run(const std::string& name, const Operation& operation,
+                           const Slot& slot)
+{
+    Job job;
+
+    job.id        = _next_id++;
+    job.name      = name;
+    job.operation = operation;
+    job.result    = FileOperationResult::create();
+
+    if (!slot.empty())
+        _slots[job.id] = slot;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(job));
+    }
+    _cond.notify_one();
+}
+
+std::size_t AsyncFileHandler::pending() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queue.size() + _running + _done_queue.size();
+}
+
+void AsyncFileHandler::worker()
+{
+    for (;;) {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, [this] { return _stop || !_queue.empty(); });
+            if (_stop)
+                return;
+
+            job = std::move(_queue.front());
+            _queue.pop_front();
+            ++_running;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        try {
+            job.operation(*job.result.operator->());
+        } catch (const std::exception& ex) {
+            job.result->set_error(ex.what());
+        }
+        auto duration = std::chrono::steady_clock::now() - start;
+        job.result->set_duration_ms(
+            std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_running;
+            _done_queue.push_back(std::move(job));
+        }
+        _done.emit();
+    }
+}
+
+void AsyncFileHandler::on_done()
+{
+    std::deque<Job> done;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        done.swap(_done_queue);
+    }
+
+    for (auto&& job : done) {
+        if (job.result->duration_ms() >= SLOW_OPERATION_MS)
+            PRINT_WARNING("Slow file operation: " << job.name << " took "
+                          << job.result->duration_ms() << " ms");
+
+        auto it = _slots.find(job.id);
+        if (it == _slots.end()) {
+            if (job.result->error())
+                PRINT_ERROR("File operation " << job.name << " failed: "
+                            << job.result->error_msg());
+            continue;
+        }
+
+        auto slot = it->second;
+        _slots.erase(it);
+        slot(job.result);
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef _ASYNC_FILE_HANDLER_H_
+#define _ASYNC_FILE_HANDLER_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+#include <glibmm/dispatcher.h>
+
+#include <sigc++/slot.h>
+
+#include "file_operation_result.h"
+
+/**
+ * This class provides asynchronous counterparts of the FileHandler methods.
+ * The operations run on a small, fixed number of worker threads, so a slow
+ * CIFS mount or USB stick does not block the main loop. Completion is
+ * reported in the main loop by calling the given slot. Operations are
+ * started in the order they were requested; with more than one worker they
+ * may finish in a different order.
+ *
+ * Example of usage:
+ *   AsyncFileHandler::get_instance()->set_file(path, content,
+ *       sigc::mem_fun(*this, &Foo::on_written));
+ */
+class AsyncFileHandler : public Glib::Object
+{
+public:
+    using RefPtr = Glib::RefPtr<AsyncFileHandler>;
+    using Slot = sigc::slot<void, const Glib::RefPtr<FileOperationResult>&>;
+    using Operation = std::function<void (FileOperationResult&)>;
+
+    static const unsigned DEFAULT_WORKERS = 4;
+    static const gint64 SLOW_OPERATION_MS = 1000;
+
+    static inline RefPtr& get_instance()
+    {
+        if (!instance)
+            instance = create();
+        return instance;
+    }
+
+    ~AsyncFileHandler();
+
+    void get_file(const std::string& path, const Slot& slot);
+    void set_file(const std::string& path, const std::string& content, const Slot& slot = Slot());
+    void copy_file(const std::string& path1, const std::string& path2, const Slot& slot = Slot());
+    void move_file(const std::string& path1, const std::string& path2, const Slot& slot = Slot());
+    void remove_directory(const std::string& path, const Slot& slot = Slot());
+    void list_directory(const std::string& path, const Slot& slot);
+
+    /**
+     * Run an arbitrary filesystem operation on the workers. The operation
+     * must not touch main loop objects.
+     *
+     * @param name      operation name for slow operation logging
+     * @param operation executed in a worker thread, exceptions are stored
+     *                  in the result
+     * @param slot      called in the main loop when done
+     */
+    void run(const std::string& name, const Operation& operation, const Slot& slot = Slot());
+
+    /**
+     * Number of operations queued or running.
+     */
+    std::size_t pending() const;
+
+private:
+    struct Job
+    {
+        unsigned id;
+        std::string name;
+        Operation operation;
+        Glib::RefPtr<FileOperationResult> result;
+    };
+
+    static RefPtr instance;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cond;
+    std::deque<Job> _queue;
+    std::deque<Job> _done_queue;
+    std::vector<std::thread> _workers;
+    bool _stop;
+    unsigned _next_id;
+    std::size_t _running;
+    Glib::Dispatcher _done;
+
+    // slots are only touched in the main loop
+    std::map<unsigned, Slot> _slots;
+
+    AsyncFileHandler();
+
+    static inline RefPtr create()
+    {
+        return RefPtr(new AsyncFileHandler());
+    }
+
+    void worker();
+    void on_done();
+};
+
+#endif /* _ASYNC_FILE_HANDLER_H_ */
@@ -0,0 +1,622 @@
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BASE64_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+#include "base64_codec.h"
+
+namespace {
+
+const char alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// groups of 3 input bytes per line, g_base64_encode_step() breaks after 76 chars
+const int LINE_GROUPS = 19;
+
+/* rank of each character, 0xff for characters outside the alphabet.
+ * Like in glib, '=' has rank 0.
+ */
+struct RankTable
+{
+    uint8_t rank[256];
+
+    RankTable()
+    {
+        std::memset(rank, 0xff, sizeof(rank));
+        for (int i = 0; i < 64; ++i)
+            rank[static_cast<uint8_t>(alphabet[i])] = i;
+        rank['='] = 0;
+    }
+};
+
+const RankTable rank_table;
+
+/* Kernels encode whole groups of 3 bytes, resp. decode blocks of clean
+ * characters (no padding, whitespace, ...). The decode kernels return the
+ * number of characters consumed, they stop before the first block which
+ * contains anything else.
+ */
+typedef void (*EncodeKernel)(const uint8_t *in, std::size_t groups, char *out);
+typedef std::size_t (*DecodeKernel)(const uint8_t *in, std::size_t len, uint8_t *out);
+
+void encode_scalar(const uint8_t *in, std::size_t groups, char *out)
+{
+    for (std::size_t i = 0; i < groups; ++i, in += 3, out += 4) {
+        uint32_t v = (in[0] << 16) | (in[1] << 8) | in[2];
+
+        out[0] = alphabet[(v >> 18) & 0x3f];
+        out[1] = alphabet[(v >> 12) & 0x3f];
+        out[2] = alphabet[(v >> 6) & 0x3f];
+        out[3] = alphabet[v & 0x3f];
+    }
+}
+
+std::size_t decode_scalar(const uint8_t *in, std::size_t len, uint8_t *out)
+{
+    std::size_t pos = 0;
+
+    for (; pos + 4 <= len; pos += 4, out += 3) {
+        uint8_t a = rank_table.rank[in[pos]];
+        uint8_t b = rank_table.rank[in[pos + 1]];
+        uint8_t c = rank_table.rank[in[pos + 2]];
+        uint8_t d = rank_table.rank[in[pos + 3]];
+
+        if ((a | b | c | d) & 0xc0 || in[pos + 2] == '=' || in[pos + 3] == '=')
+            break;
+
+        uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = v >> 16;
+        out[1] = v >> 8;
+        out[2] = v;
+    }
+
+    return pos;
+}
+
+#ifdef BASE64_X86
+
+__attribute__((target("ssse3")))
+inline __m128i enc_reshuffle_ssse3(__m128i in)
+{
+    // per 32 bit word: b1 b0 b2 b1, then move the 6 bit fields into bytes
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+    return _mm_or_si128(t1, t3);
+}
+
+__attribute__((target("ssse3")))
+inline __m128i enc_translate_ssse3(__m128i in)
+{
+    // offsets for 0..25, 26..51, 52..61 (10x), 62, 63
+    const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+    __m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+    __m128i mask = _mm_cmpgt_epi8(in, _mm_set1_epi8(25));
+    indices = _mm_sub_epi8(indices, mask);
+
+    return _mm_add_epi8(in, _mm_shuffle_epi8(lut, indices));
+}
+
+__attribute__((target("ssse3")))
+void encode_ssse3(const uint8_t *in, std::size_t groups, char *out)
+{
+    std::size_t len = groups * 3;
+    std::size_t pos = 0;
+
+    // 12 bytes are used, but 16 are loaded
+    for (; pos + 16 <= len; pos += 12, out += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos));
+        v = enc_translate_ssse3(enc_reshuffle_ssse3(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), v);
+    }
+
+    encode_scalar(in + pos, (len - pos) / 3, out);
+}
+
+__attribute__((target("ssse3")))
+inline bool dec_translate_ssse3(__m128i in, __m128i& values)
+{
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_0f = _mm_set1_epi8(0x0f);
+
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_0f);
+    const __m128i lo_nibbles = _mm_and_si128(in, mask_0f);
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xffff)
+        return false;
+
+    const __m128i eq_2f = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f));
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    values = _mm_add_epi8(in, roll);
+
+    return true;
+}
+
+__attribute__((target("ssse3")))
+inline __m128i dec_reshuffle_ssse3(__m128i values)
+{
+    const __m128i ab_bc = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i abc = _mm_madd_epi16(ab_bc, _mm_set1_epi32(0x00011000));
+
+    return _mm_shuffle_epi8(abc, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("ssse3")))
+std::size_t decode_ssse3(const uint8_t *in, std::size_t len, uint8_t *out)
+{
+    std::size_t pos = 0;
+    alignas(16) uint8_t tmp[16];
+
+    for (; pos + 16 <= len; pos += 16, out += 12) {
+        __m128i values;
+
+        if (!dec_translate_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos)), values))
+            break;
+
+        // only 12 bytes are valid, the output buffer may be exhausted
+        _mm_store_si128(reinterpret_cast<__m128i *>(tmp), dec_reshuffle_ssse3(values));
+        std::memcpy(out, tmp, 12);
+    }
+
+    return pos;
+}
+
+__attribute__((target("avx2")))
+inline __m256i enc_reshuffle_avx2(__m256i in)
+{
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+
+    return _mm256_or_si256(t1, t3);
+}
+
+__attribute__((target("avx2")))
+inline __m256i enc_translate_avx2(__m256i in)
+{
+    const __m256i lut = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+                                         65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+    __m256i indices = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+    __m256i mask = _mm256_cmpgt_epi8(in, _mm256_set1_epi8(25));
+    indices = _mm256_sub_epi8(indices, mask);
+
+    return _mm256_add_epi8(in, _mm256_shuffle_epi8(lut, indices));
+}
+
+__attribute__((target("avx2")))
+void encode_avx2(const uint8_t *in, std::size_t groups, char *out)
+{
+    std::size_t len = groups * 3;
+    std::size_t pos = 0;
+
+    // 2 x 12 bytes are used, the upper load reads 16
+    for (; pos + 28 <= len; pos += 24, out += 32) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        v = enc_translate_avx2(enc_reshuffle_avx2(v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), v);
+    }
+
+    encode_ssse3(in + pos, (len - pos) / 3, out);
+}
+
+__attribute__((target("avx2")))
+std::size_t decode_avx2(const uint8_t *in, std::size_t len, uint8_t *out)
+{
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_0f = _mm256_set1_epi8(0x0f);
+    alignas(32) uint8_t tmp[32];
+    std::size_t pos = 0;
+
+    for (; pos + 32 <= len; pos += 32, out += 24) {
+        const __m256i in_v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + pos));
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in_v, 4), mask_0f);
+        const __m256i lo_nibbles = _mm256_and_si256(in_v, mask_0f);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+
+        if (!_mm256_testz_si256(lo, hi))
+            break;
+
+        const __m256i eq_2f = _mm256_cmpeq_epi8(in_v, _mm256_set1_epi8(0x2f));
+        const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        const __m256i values = _mm256_add_epi8(in_v, roll);
+
+        const __m256i ab_bc = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i abc = _mm256_madd_epi16(ab_bc, _mm256_set1_epi32(0x00011000));
+        abc = _mm256_shuffle_epi8(abc, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        abc = _mm256_permutevar8x32_epi32(abc, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+
+        _mm256_store_si256(reinterpret_cast<__m256i *>(tmp), abc);
+        std::memcpy(out, tmp, 24);
+    }
+
+    return pos + decode_ssse3(in + pos, len - pos, out);
+}
+
+#endif /* BASE64_X86 */
+
+#ifdef BASE64_NEON
+
+/* decode tables for characters 0..63 and 64..127, rank + 1 or 0 for
+ * characters which are not handled by the kernel
+ */
+struct NeonTables
+{
+    uint8x16x4_t enc;
+    uint8x16x4_t dec_lo;
+    uint8x16x4_t dec_hi;
+
+    NeonTables()
+    {
+        uint8_t dec[128];
+
+        for (int i = 0; i < 128; ++i)
+            dec[i] = rank_table.rank[i] == 0xff ? 0 : rank_table.rank[i] + 1;
+        dec['='] = 0;
+
+        for (int i = 0; i < 4; ++i) {
+            enc.val[i] = vld1q_u8(reinterpret_cast<const uint8_t *>(alphabet) + 16 * i);
+            dec_lo.val[i] = vld1q_u8(dec + 16 * i);
+            dec_hi.val[i] = vld1q_u8(dec + 64 + 16 * i);
+        }
+    }
+};
+
+const NeonTables& neon_tables()
+{
+    static const NeonTables tables;
+    return tables;
+}
+
+void encode_neon(const uint8_t *in, std::size_t groups, char *out)
+{
+    const auto& tables = neon_tables();
+    const uint8x16_t mask_3f = vdupq_n_u8(0x3f);
+    std::size_t len = groups * 3;
+    std::size_t pos = 0;
+
+    for (; pos + 48 <= len; pos += 48, out += 64) {
+        uint8x16x3_t src = vld3q_u8(in + pos);
+        uint8x16x4_t res;
+
+        res.val[0] = vshrq_n_u8(src.val[0], 2);
+        res.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(src.val[1], 4), vshlq_n_u8(src.val[0], 4)), mask_3f);
+        res.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(src.val[2], 6), vshlq_n_u8(src.val[1], 2)), mask_3f);
+        res.val[3] = vandq_u8(src.val[2], mask_3f);
+
+        for (int i = 0; i < 4; ++i)
+            res.val[i] = vqtbl4q_u8(tables.enc, res.val[i]);
+
+        vst4q_u8(reinterpret_cast<uint8_t *>(out), res);
+    }
+
+    encode_scalar(in + pos, (len - pos) / 3, out);
+}
+
+std::size_t decode_neon(const uint8_t *in, std::size_t len, uint8_t *out)
+{
+    const auto& tables = neon_tables();
+    const uint8x16_t one = vdupq_n_u8(1);
+    const uint8x16_t bit_40 = vdupq_n_u8(0x40);
+    std::size_t pos = 0;
+
+    for (; pos + 64 <= len; pos += 64, out += 48) {
+        uint8x16x4_t src = vld4q_u8(in + pos);
+        uint8x16_t valid = vdupq_n_u8(0xff);
+
+        for (int i = 0; i < 4; ++i) {
+            uint8x16_t lo = vqtbl4q_u8(tables.dec_lo, src.val[i]);
+            uint8x16_t hi = vqtbl4q_u8(tables.dec_hi, veorq_u8(src.val[i], bit_40));
+            uint8x16_t v = vorrq_u8(lo, hi);
+
+            valid = vminq_u8(valid, v);
+            src.val[i] = vsubq_u8(v, one);
+        }
+
+        if (vminvq_u8(valid) == 0)
+            break;
+
+        uint8x16x3_t res;
+        res.val[0] = vorrq_u8(vshlq_n_u8(src.val[0], 2), vshrq_n_u8(src.val[1], 4));
+        res.val[1] = vorrq_u8(vshlq_n_u8(src.val[1], 4), vshrq_n_u8(src.val[2], 2));
+        res.val[2] = vorrq_u8(vshlq_n_u8(src.val[2], 6), src.val[3]);
+
+        vst3q_u8(out, res);
+    }
+
+    return pos;
+}
+
+#endif /* BASE64_NEON */
+
+struct Kernels
+{
+    const char *name;
+    EncodeKernel encode;
+    DecodeKernel decode;
+};
+
+const Kernels scalar_kernels = { "scalar", encode_scalar, decode_scalar };
+#ifdef BASE64_X86
+const Kernels ssse3_kernels = { "ssse3", encode_ssse3, decode_ssse3 };
+const Kernels avx2_kernels = { "avx2", encode_avx2, decode_avx2 };
+#endif
+#ifdef BASE64_NEON
+const Kernels neon_kernels = { "neon", encode_neon, decode_neon };
+#endif
+
+const Kernels *find_kernels(const std::string& name)
+{
+#ifdef BASE64_X86
+    __builtin_cpu_init();
+
+    if ((name.empty() || name == "avx2") && __builtin_cpu_supports("avx2"))
+        return &avx2_kernels;
+    if ((name.empty() || name == "ssse3") && __builtin_cpu_supports("ssse3"))
+        return &ssse3_kernels;
+#endif
+#ifdef BASE64_NEON
+    if (name.empty() || name == "neon")
+        return &neon_kernels;
+#endif
+    if (name.empty() || name == "scalar")
+        return &scalar_kernels;
+
+    return nullptr;
+}
+
+const Kernels *& kernels()
+{
+    static const Kernels *selected = find_kernels("");
+    return selected;
+}
+
+} // namespace
+
+Base64Codec::Encoder::Encoder(bool break_lines) :
+    _break_lines{break_lines}, _buffered{0}, _groups{0}
+{}
+
+std::size_t Base64Codec::Encoder::max_step_size(std::size_t len, bool break_lines)
+{
+    std::size_t size = (len / 3 + 1) * 4 + 4;
+
+    if (break_lines)
+        size += size / 76 + 1;
+
+    return size;
+}
+
+char *Base64Codec::Encoder::encode_groups(const unsigned char *in, std::size_t groups, char *out)
+{
+    auto encode = kernels()->encode;
+
+    if (!_break_lines) {
+        encode(in, groups, out);
+        return out + groups * 4;
+    }
+
+    while (groups) {
+        std::size_t n = std::min<std::size_t>(groups, LINE_GROUPS - _groups);
+
+        encode(in, n, out);
+        in += n * 3;
+        out += n * 4;
+        groups -= n;
+
+        _groups += n;
+        if (_groups == LINE_GROUPS) {
+            *out++ = '\n';
+            _groups = 0;
+        }
+    }
+
+    return out;
+}
+
+std::size_t Base64Codec::Encoder::step(const void *data, std::size_t len, char *out)
+{
+    auto in = static_cast<const unsigned char *>(data);
+    char *outptr = out;
+
+    if (_buffered + len > 2) {
+        // complete the group left over from the last call
+        if (_buffered) {
+            unsigned char group[3];
+            std::size_t missing = 3 - _buffered;
+
+            std::memcpy(group, _buf, _buffered);
+            std::memcpy(group + _buffered, in, missing);
+            in += missing;
+            len -= missing;
+            _buffered = 0;
+
+            outptr = encode_groups(group, 1, outptr);
+        }
+
+        std::size_t groups = len / 3;
+        outptr = encode_groups(in, groups, outptr);
+        in += groups * 3;
+        len -= groups * 3;
+    }
+
+    std::memcpy(_buf + _buffered, in, len);
+    _buffered += len;
+
+    return outptr - out;
+}
+
+std::size_t Base64Codec::Encoder::close(char *out)
+{
+    char *outptr = out;
+
+    if (_buffered) {
+        unsigned c1 = _buf[0];
+        unsigned c2 = _buffered == 2 ? _buf[1] : 0;
+
+        outptr[0] = alphabet[c1 >> 2];
+        outptr[1] = alphabet[(c2 >> 4) | ((c1 & 0x3) << 4)];
+        outptr[2] = _buffered == 2 ? alphabet[(c2 & 0x0f) << 2] : '=';
+        outptr[3] = '=';
+        outptr += 4;
+        ++_groups;
+    }
+
+    // like g_base64_encode_close(), also for empty input or a full line
+    if (_break_lines)
+        *outptr++ = '\n';
+
+    _buffered = 0;
+    _groups = 0;
+
+    return outptr - out;
+}
+
+Base64Codec::Decoder::Decoder() :
+    _save{0}, _state{0}
+{}
+
+std::size_t Base64Codec::Decoder::max_step_size(std::size_t len)
+{
+    return (len / 4) * 3 + 3;
+}
+
+std::size_t Base64Codec::Decoder::step(const char *data, std::size_t len, unsigned char *out)
+{
+    auto inptr = reinterpret_cast<const uint8_t *>(data);
+    auto inend = inptr + len;
+    auto decode = kernels()->decode;
+    unsigned char *outptr = out;
+    unsigned int v = _save;
+    int i = _state;
+    uint8_t last[2] = { 0, 0 };
+
+    /* same semantics as g_base64_decode_step(): a negative state means the
+     * last character of the previous call was a padding character
+     */
+    if (i < 0) {
+        i = -i;
+        last[0] = '=';
+    }
+
+    while (inptr < inend) {
+        // at a group boundary, decode as much as possible in one go
+        if (i == 0 && last[0] != '=') {
+            std::size_t n = decode(inptr, inend - inptr, outptr);
+
+            if (n) {
+                inptr += n;
+                outptr += n / 4 * 3;
+                last[0] = last[1] = 'A';
+                continue;
+            }
+        }
+
+        uint8_t c = *inptr++;
+        uint8_t rank = rank_table.rank[c];
+
+        if (rank == 0xff)
+            continue;
+
+        last[1] = last[0];
+        last[0] = c;
+        v = (v << 6) | rank;
+        if (++i == 4) {
+            *outptr++ = v >> 16;
+            if (last[1] != '=')
+                *outptr++ = v >> 8;
+            if (last[0] != '=')
+                *outptr++ = v;
+            i = 0;
+        }
+    }
+
+    _save = v;
+    _state = last[0] == '=' ? -i : i;
+
+    return outptr - out;
+}
+
+std::string Base64Codec::encode(const std::string& input, bool break_lines)
+{
+    Encoder encoder(break_lines);
+    std::string out;
+
+    out.resize(Encoder::max_step_size(input.size(), break_lines) + Encoder::MAX_CLOSE_SIZE);
+
+    std::size_t n = encoder.step(input.data(), input.size(), &out[0]);
+    n += encoder.close(&out[n]);
+    out.resize(n);
+
+    return out;
+}
+
+std::string Base64Codec::decode(const std::string& input)
+{
+    Decoder decoder;
+    std::string out;
+    std::size_t len = std::strlen(input.c_str());
+
+    out.resize(Decoder::max_step_size(len));
+
+    std::size_t n = decoder.step(input.data(), len,
+                                 reinterpret_cast<unsigned char *>(&out[0]));
+    out.resize(n);
+
+    return out;
+}
+
+const char *Base64Codec::implementation()
+{
+    return kernels()->name;
+}
+
+bool Base64Codec::use_implementation(const std::string& name)
+{
+    auto selected = find_kernels(name);
+
+    if (!selected)
+        return false;
+
+    kernels() = selected;
+    return true;
+}
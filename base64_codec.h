@@ -0,0 +1,108 @@
+#ifndef _BASE64_CODEC_H_
+#define _BASE64_CODEC_H_
+
+#include <string>
+#include <cstddef>
+
+/**
+ * \brief Vectorized Base64 encoder/decoder
+ *
+ * Produces the same output as Glib::Base64 / g_base64_encode_step() and
+ * g_base64_decode_step(), including line breaks after 76 characters and
+ * the lenient decoding of invalid characters. The inner loops use AVX2 or
+ * SSSE3 (selected at runtime) on x86 and NEON on aarch64, with a scalar
+ * fallback.
+ *
+ * Encoder and Decoder keep state between calls, so data can be processed
+ * in chunks.
+ */
+class Base64Codec
+{
+public:
+    class Encoder
+    {
+    public:
+        explicit Encoder(bool break_lines = false);
+
+        /**
+         * Size of the output buffer needed by step() for len input bytes.
+         */
+        static std::size_t max_step_size(std::size_t len, bool break_lines = false);
+
+        /**
+         * Size of the output buffer needed by close().
+         */
+        static const std::size_t MAX_CLOSE_SIZE = 5;
+
+        /**
+         * Encode len bytes, up to two bytes are kept for the next call.
+         *
+         * @return number of characters written to out
+         */
+        std::size_t step(const void *in, std::size_t len, char *out);
+
+        /**
+         * Flush the remaining bytes with padding and reset the state.
+         *
+         * @return number of characters written to out
+         */
+        std::size_t close(char *out);
+
+    private:
+        bool _break_lines;
+        unsigned char _buf[2];
+        int _buffered;
+        int _groups;
+
+        char *encode_groups(const unsigned char *in, std::size_t groups, char *out);
+    };
+
+    class Decoder
+    {
+    public:
+        Decoder();
+
+        /**
+         * Size of the output buffer needed by step() for len characters.
+         */
+        static std::size_t max_step_size(std::size_t len);
+
+        /**
+         * Decode len characters, characters outside the alphabet are
+         * skipped.
+         *
+         * @return number of bytes written to out
+         */
+        std::size_t step(const char *in, std::size_t len, unsigned char *out);
+
+    private:
+        unsigned int _save;
+        int _state;
+    };
+
+    /**
+     * Encode a whole buffer.
+     */
+    static std::string encode(const std::string& input, bool break_lines = false);
+
+    /**
+     * Decode a whole buffer. Like g_base64_decode() the input ends at the
+     * first NUL character.
+     */
+    static std::string decode(const std::string& input);
+
+    /**
+     * Name of the implementation in use: "avx2", "ssse3", "neon" or "scalar".
+     */
+    static const char *implementation();
+
+    /**
+     * Select an implementation by name, e.g. for benchmarks. Must not be
+     * called while other threads encode or decode.
+     *
+     * @return false if not supported by this CPU
+     */
+    static bool use_implementation(const std::string& name);
+};
+
+#endif /* _BASE64_CODEC_H_ */
@@ -0,0 +1,112 @@
+//
+// Compares the in-process ArchiveWriteRequest with the formerly used forked
+// `tar zcvf`. Wall clock and CPU time (user + sys, including children) are
+// printed for both.
+//
+// usage: bench_archive <level> <out_dir> <file> [<file> ...]
+//
+
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <giomm/init.h>
+
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+#include "archive_write_request.h"
+#include "utils.h"
+
+static double cpu_seconds(int who)
+{
+    struct rusage ru;
+
+    getrusage(who, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+        ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+static void report(const std::string& name, double wall, double cpu,
+                   const std::string& archive)
+{
+    struct stat sb;
+    long long size = stat(archive.c_str(), &sb) ? -1 : sb.st_size;
+
+    std::cout << name << ": wall " << wall << " s, cpu " << cpu
+              << " s, archive " << size << " bytes" << std::endl;
+}
+
+static void bench_in_process(const std::vector<std::string>& files,
+                             const std::string& archive, int level)
+{
+    auto loop = Glib::MainLoop::create();
+    std::vector<ArchiveEntry> entries(files.begin(), files.end());
+    auto req = ArchiveWriteRequest::create(entries, archive, level);
+    bool ok = false;
+
+    req->finished.connect([&](const Glib::RefPtr<ArchiveWriteResult>& result) {
+            ok = !result->error();
+            if (!ok)
+                std::cerr << "in-process: " << result->error_msg() << std::endl;
+            loop->quit();
+        });
+
+    auto cpu_start = cpu_seconds(RUSAGE_SELF);
+    auto start = std::chrono::steady_clock::now();
+    req->start_write();
+    loop->run();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    if (ok)
+        report("in-process", wall.count(), cpu_seconds(RUSAGE_SELF) - cpu_start,
+               archive);
+}
+
+static void bench_tar(const std::vector<std::string>& files,
+                      const std::string& archive)
+{
+    std::string cmd = "tar zcvf " + archive;
+    for (auto&& file : files)
+        cmd += " " + file;
+    cmd += " > /dev/null 2>&1";
+
+    auto cpu_start = cpu_seconds(RUSAGE_CHILDREN);
+    auto start = std::chrono::steady_clock::now();
+    auto status = system(cmd.c_str());
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) > 1) {
+        std::cerr << "tar failed" << std::endl;
+        return;
+    }
+
+    report("tar", wall.count(), cpu_seconds(RUSAGE_CHILDREN) - cpu_start, archive);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4) {
+        std::cerr << "usage: " << argv[0]
+                  << " <level> <out_dir> <file> [<file> ...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Glib::init();
+    Gio::init();
+
+    int level = atoi(argv[1]);
+    std::string out_dir = argv[2];
+    std::vector<std::string> files(argv + 3, argv + argc);
+
+    bench_tar(files, out_dir + "/bench_tar.tar.gz");
+    bench_in_process(files, out_dir + "/bench_in_process.tar.gz", level);
+
+    return EXIT_SUCCESS;
+}
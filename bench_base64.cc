@@ -0,0 +1,149 @@
+//
+// Compares Base64Codec with Glib::Base64 for inputs from 1 KB to 64 MB.
+// Prints the encode and decode throughput in MB/s (of unencoded data) for
+// glib and every implementation supported by this CPU, and checks that the
+// output is identical to glib. Before, the output is compared for small
+// sizes around the line length of 57 input bytes, with and without line
+// breaks.
+//
+// usage: bench_base64 [--break-lines]
+//
+
+#include <glibmm/init.h>
+#include <glibmm/base64.h>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "base64_codec.h"
+
+static const std::size_t MIN_SIZE = 1024;
+static const std::size_t MAX_SIZE = 64 * 1024 * 1024;
+
+// process at least this many bytes per measurement
+static const std::size_t MIN_TOTAL = 256 * 1024 * 1024;
+
+static double measure(std::size_t size, const std::function<void ()>& fn)
+{
+    std::size_t rounds = std::max<std::size_t>(1, MIN_TOTAL / size);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < rounds; ++i)
+        fn();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    return size * rounds / wall.count() / (1024 * 1024);
+}
+
+// sizes at the edges of a line: empty, full lines and one byte more or less
+static std::vector<std::size_t> edge_sizes()
+{
+    std::vector<std::size_t> sizes = { 0, 1, 2, 3 };
+
+    for (std::size_t k = 1; k <= 4; ++k) {
+        sizes.push_back(57 * k - 1);
+        sizes.push_back(57 * k);
+        sizes.push_back(57 * k + 1);
+    }
+
+    return sizes;
+}
+
+static bool check_edges(const std::vector<std::string>& impls, const std::string& data)
+{
+    bool ok = true;
+
+    for (auto size : edge_sizes()) {
+        const std::string input = data.substr(0, size);
+
+        for (bool break_lines : { false, true }) {
+            const std::string encoded = Glib::Base64::encode(input, break_lines);
+
+            for (auto&& name : impls) {
+                Base64Codec::use_implementation(name);
+                if (Base64Codec::encode(input, break_lines) != encoded) {
+                    std::cerr << name << ": encoded output of " << size << " bytes"
+                              << (break_lines ? " with line breaks" : "")
+                              << " differs from glib" << std::endl;
+                    ok = false;
+                }
+                if (Base64Codec::decode(encoded) != input) {
+                    std::cerr << name << ": decoded output of " << size << " bytes"
+                              << (break_lines ? " with line breaks" : "")
+                              << " differs from input" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    bool break_lines = argc > 1 && !strcmp(argv[1], "--break-lines");
+    std::vector<std::string> impls;
+
+    Glib::init();
+
+    for (auto&& name : { "scalar", "ssse3", "avx2", "neon" })
+        if (Base64Codec::use_implementation(name))
+            impls.push_back(name);
+
+    std::cout << std::setw(10) << "size" << std::setw(8) << "op"
+              << std::setw(10) << "glib";
+    for (auto&& name : impls)
+        std::cout << std::setw(10) << name;
+    std::cout << "  (MB/s)" << std::endl;
+
+    std::mt19937 rng(42);
+    std::string data(MAX_SIZE, '\0');
+    for (auto&& c : data)
+        c = rng();
+
+    bool ok = check_edges(impls, data);
+
+    for (std::size_t size = MIN_SIZE; size <= MAX_SIZE; size *= 4) {
+        const std::string input = data.substr(0, size);
+        const std::string encoded = Glib::Base64::encode(input, break_lines);
+        std::string result;
+
+        std::cout << std::setw(10) << size << std::setw(8) << "encode" << std::fixed
+                  << std::setprecision(0) << std::setw(10)
+                  << measure(size, [&] { result = Glib::Base64::encode(input, break_lines); });
+        for (auto&& name : impls) {
+            Base64Codec::use_implementation(name);
+            std::cout << std::setw(10)
+                      << measure(size, [&] { result = Base64Codec::encode(input, break_lines); });
+            if (result != encoded) {
+                std::cerr << name << ": encoded output differs from glib" << std::endl;
+                ok = false;
+            }
+        }
+        std::cout << std::endl;
+
+        std::cout << std::setw(10) << size << std::setw(8) << "decode"
+                  << std::setw(10)
+                  << measure(size, [&] { result = Glib::Base64::decode(encoded); });
+        for (auto&& name : impls) {
+            Base64Codec::use_implementation(name);
+            std::cout << std::setw(10)
+                      << measure(size, [&] { result = Base64Codec::decode(encoded); });
+            if (result != input) {
+                std::cerr << name << ": decoded output differs from input" << std::endl;
+                ok = false;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+#!/bin/bash
+#------------------------------------------------------------------------------
+#
+# \brief	build a benchmark at two revisions and run it on both
+#
+# usage: bench_compare.sh BEFORE AFTER TARGET [ARGS...]
+#
+# Both revisions are checked out into temporary worktrees, TARGET is built
+# in each and run from its source directory with ARGS. The results go to
+# before.json and after.json in $BENCH_OUTPUT (default ./bench_compare).
+# bench_micro compares the second run with the first (--baseline), for
+# bench_xml_processor the allocations per request of each fid are listed.
+#
+# With BENCH_SOURCE=REV the source of the benchmark (TARGET.cc) is taken
+# from REV for both builds, e.g. to run cases added by AFTER on BEFORE:
+#
+#   BENCH_SOURCE=HEAD ./bench_compare.sh 57a5546^ 57a5546 bench_micro \
+#       --filter dcResponse
+#
+#------------------------------------------------------------------------------
+
+set -e
+
+if [ $# -lt 3 ]; then
+	echo "usage: $0 BEFORE AFTER TARGET [ARGS...]" >&2
+	exit 2
+fi
+
+BEFORE=$1
+AFTER=$2
+TARGET=$3
+shift 3
+
+OUT=$(realpath -m "${BENCH_OUTPUT:-bench_compare}")
+TMP=$(mktemp -d)
+
+cleanup()
+{
+	for name in before after; do
+		[ -d "$TMP/$name" ] && git worktree remove --force "$TMP/$name"
+	done
+	rm -rf "$TMP"
+}
+trap cleanup EXIT
+
+mkdir -p "$OUT"
+
+# fid, allocs and xml_allocs per fid of a bench_xml_processor result
+fid_allocs()
+{
+	sed -n 's/^    "\([^"]*\)": {"requests".*"allocs": \([0-9.]*\), "xml_allocs": \([0-9.]*\).*/\1 \2 \3/p' "$1" | sort
+}
+
+# build NAME REV
+build()
+{
+	local dir="$TMP/$1"
+
+	git worktree add --detach "$dir" "$2" >/dev/null
+	if [ -n "$BENCH_SOURCE" ]; then
+		git show "$BENCH_SOURCE:$TARGET.cc" > "$dir/$TARGET.cc"
+	fi
+	cmake -S "$dir" -B "$dir/_build" >/dev/null
+	cmake --build "$dir/_build" --target "$TARGET" -j"$(nproc)" >/dev/null
+}
+
+build before "$BEFORE"
+build after "$AFTER"
+
+echo "[$0] $TARGET at $BEFORE"
+(cd "$TMP/before" && "./_build/$TARGET" "$@" --output "$OUT/before.json")
+
+extra=()
+if [ "$TARGET" = bench_micro ]; then
+	extra=(--baseline "$OUT/before.json")
+fi
+
+echo "[$0] $TARGET at $AFTER"
+(cd "$TMP/after" && "./_build/$TARGET" "$@" "${extra[@]}" --output "$OUT/after.json")
+
+if [ "$TARGET" = bench_xml_processor ]; then
+	echo
+	join <(fid_allocs "$OUT/before.json") <(fid_allocs "$OUT/after.json") | awk '
+		BEGIN { printf "%-28s %12s %12s %9s %12s %12s\n", "fid", "allocs", "after", "change", "xml_allocs", "after" }
+		{ printf "%-28s %12.1f %12.1f %+8.1f%% %12.1f %12.1f\n", $1, $2, $4, $2 ? ($4 / $2 - 1) * 100 : 0, $3, $5 }'
+	echo
+fi
+
+echo "[$0] fin, results in $OUT."
+
+
+#---fin------------------------------------------------------------------------
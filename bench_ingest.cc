@@ -0,0 +1,135 @@
+//
+// Compares reading and parsing request files the way the watchdog formerly
+// did it (std::getline per line, then parsing one document at a time in the
+// main loop) with the batched IngestBatchRequest. Generates <count> request
+// files in <dir> and prints the ingestion rate in files/s for both.
+//
+// usage: bench_ingest <dir> [<count>]
+//
+
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+
+#include <libxml++/parsers/domparser.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <functional>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "ingest_batch_request.h"
+
+static std::vector<std::string> create_files(const std::string& dir, int count)
+{
+    std::vector<std::string> files;
+
+    for (int i = 0; i < count; ++i) {
+        std::stringstream ss;
+        ss << dir << "/ZIX-" << std::setw(6) << std::setfill('0') << i << "_zix.xml";
+
+        std::ofstream ofs(ss.str());
+        ofs << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<zix tid=\"" << i << "\">\n"
+            << "  <function fid=\"getParameter\">\n"
+            << "    <parameter name=\"parId\" value=\"serialnumber\"/>\n"
+            << "  </function>\n"
+            << "</zix>\n";
+        files.push_back(ss.str());
+    }
+
+    return files;
+}
+
+static void report(const std::string& name, std::size_t files, std::size_t failed,
+                   double wall)
+{
+    std::cout << name << ": " << files << " files (" << failed << " failed) in "
+              << wall << " s, " << files / wall << " files/s" << std::endl;
+}
+
+static void bench_getline(const std::vector<std::string>& files)
+{
+    std::size_t failed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto&& file : files) {
+        std::ifstream ifs(file);
+        std::string content, line;
+
+        while (std::getline(ifs, line)) {
+            content += line;
+            content += "\n";
+        }
+
+        try {
+            xmlpp::DomParser parser;
+            parser.parse_memory(content);
+        } catch (const std::exception&) {
+            ++failed;
+        }
+    }
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    report("getline", files.size(), failed, wall.count());
+}
+
+static void bench_batch(const std::vector<std::string>& files, std::size_t batch_size)
+{
+    auto loop = Glib::MainLoop::create();
+    std::size_t pos = 0, failed = 0;
+    Glib::RefPtr<IngestBatchRequest> req;
+
+    std::function<void ()> start_next = [&]() {
+        if (pos >= files.size()) {
+            loop->quit();
+            return;
+        }
+
+        IngestBatchRequest::EntryList entries;
+        for (; pos < files.size() && entries.size() < batch_size; ++pos)
+            entries.emplace_back(files[pos], "");
+
+        req = IngestBatchRequest::create(entries);
+        req->finished.connect([&](const Glib::RefPtr<IngestBatchResult>& result) {
+                for (auto&& entry : result->entries())
+                    if (!entry.parser)
+                        ++failed;
+                start_next();
+            });
+        req->start_read();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    start_next();
+    loop->run();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    report("batch", files.size(), failed, wall.count());
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <dir> [<count>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Glib::init();
+
+    int count = argc > 2 ? atoi(argv[2]) : 1000;
+    auto files = create_files(argv[1], count);
+
+    bench_getline(files);
+    bench_batch(files, 256);
+
+    for (auto&& file : files)
+        std::remove(file.c_str());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,626 @@
+//
+// Micro benchmarks of the protocol and string hot paths: crc32, frame
+// digestion of SerialInterfaceHandler, DC replies from the frame to the
+// XmlResult, CSerialMessage split/reassembly, xml_escape, UstringUtils,
+// LogFileEntry, TimeUtilities::get_timestamp, FileHandler::base64_* and
+// element_to_string. Each runs with fixed size inputs and, where it makes
+// sense, with the corpus in testxmls/ (run it from the source directory).
+//
+// Like Google Benchmark every case is run until --min-time has passed,
+// repeated --repetitions times and the median is reported. --output writes
+// the results as JSON, one benchmark per line. --baseline compares with such
+// a file and fails if a case got slower by more than --max-regression
+// percent, e.g.
+//
+//   bench_micro --output before.json
+//   ... change something ...
+//   bench_micro --baseline before.json --max-regression 5
+//
+// usage: bench_micro [--filter SUBSTR] [--min-time S] [--repetitions N]
+//                    [--output FILE] [--baseline FILE] [--max-regression PCT]
+//
+
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <glibmm/fileutils.h>
+#include <giomm/init.h>
+
+#include <libxml++/parsers/domparser.h>
+#include <libxml++/document.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <map>
+#include <string>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+
+#include "crc32.h"
+#include "serial_interface_handler.h"
+#include "serial_message.h"
+#include "xml_helpers.h"
+#include "ustring_utils.h"
+#include "log_file_entry.h"
+#include "time_utilities.h"
+#include "file_handler.h"
+#include "xml_processor.h"
+#include "xml_result_parsed.h"
+#include "core_function_call.h"
+#include "xml_parameter.h"
+#include "zix_interface.h"
+#include "log.h"
+
+// keep the compiler from optimizing the benchmarked call away
+template <typename T>
+static inline void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct benchmark {
+    std::string name;
+    std::size_t bytes;      // processed per iteration, 0 if not meaningful
+    std::function<void (std::size_t)> run;
+};
+
+struct result {
+    std::string name;
+    std::size_t iterations;
+    double ns_per_op;
+    double mb_per_s;
+};
+
+static std::vector<benchmark> benchmarks;
+
+static void add(const std::string& name, std::size_t bytes,
+                const std::function<void (std::size_t)>& run)
+{
+    benchmarks.push_back(benchmark{ name, bytes, run });
+}
+
+static double run_once(const benchmark& b, std::size_t iterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    b.run(iterations);
+    std::chrono::duration<double, std::nano> wall = std::chrono::steady_clock::now() - start;
+
+    return wall.count();
+}
+
+static result measure(const benchmark& b, double min_time, int repetitions)
+{
+    std::size_t iterations = 1;
+    double ns;
+
+    // find the iterations which take about min_time
+    while ((ns = run_once(b, iterations)) < min_time * 1e9 / 10 && iterations < 1000000000)
+        iterations *= 10;
+    iterations = std::max<std::size_t>(
+        1, static_cast<std::size_t>(iterations * min_time * 1e9 / std::max(ns, 1.0)));
+
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; ++i)
+        samples.push_back(run_once(b, iterations) / iterations);
+    std::sort(samples.begin(), samples.end());
+
+    result r;
+    r.name = b.name;
+    r.iterations = iterations;
+    r.ns_per_op = samples[samples.size() / 2];
+    r.mb_per_s = b.bytes ? b.bytes / r.ns_per_op * 1e9 / (1024 * 1024) : 0;
+
+    return r;
+}
+
+// ns_per_op by name from a file written with --output
+static std::map<std::string, double> load_baseline(const std::string& path)
+{
+    std::map<std::string, double> baseline;
+    std::ifstream ifs(path);
+    std::string line;
+
+    while (std::getline(ifs, line)) {
+        std::size_t name = line.find("\"name\": \"");
+        std::size_t ns = line.find("\"ns_per_op\": ");
+
+        if (name == std::string::npos || ns == std::string::npos)
+            continue;
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = atof(line.c_str() + ns + 13);
+    }
+
+    return baseline;
+}
+
+static std::string random_text(std::size_t size, const std::string& alphabet, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+    std::string text;
+
+    while (text.size() < size)
+        text += alphabet[pick(rng)];
+
+    return text;
+}
+
+// text like in log messages, with markup and umlauts if utf8
+static Glib::ustring log_text(std::size_t size, bool utf8)
+{
+    static const char *words[] = {
+        "ADC", "value", "swings", "above", "accepted", "limit.", "Device", "may",
+        "output", "readings", "<out>", "of", "tolerance", "&", "calibration", "\"UV\"",
+    };
+    static const char *umlauts[] = { "Übertemperatur", "Prüfung", "größer", "Maß" };
+    std::mt19937 rng(23);
+    std::string text;
+
+    while (text.size() < size) {
+        if (utf8 && rng() % 8 == 0)
+            text += umlauts[rng() % 4];
+        else
+            text += words[rng() % 16];
+        switch (rng() % 10) {
+        case 0: text += "\n\t\t"; break;
+        case 1: text += "   "; break;
+        default: text += " "; break;
+        }
+    }
+
+    return text;
+}
+
+struct corpus_file {
+    std::string name;
+    std::string xml;
+    std::shared_ptr<xmlpp::DomParser> parser;
+};
+
+static std::vector<corpus_file> load_corpus(const std::string& dir)
+{
+    std::vector<corpus_file> corpus;
+    std::vector<std::string> names;
+
+    try {
+        Glib::Dir d(dir);
+        for (auto&& name : d)
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0)
+                names.push_back(name);
+    } catch (const Glib::Error& ex) {
+        std::cerr << ex.what() << ", skipping the corpus benchmarks" << std::endl;
+    }
+    std::sort(names.begin(), names.end());
+
+    for (auto&& name : names) {
+        corpus_file f;
+
+        f.name = name;
+        f.xml = Glib::file_get_contents(dir + "/" + name);
+        try {
+            f.parser = std::make_shared<xmlpp::DomParser>();
+            f.parser->parse_memory(f.xml);
+        } catch (const std::exception&) {
+            // some requests are invalid on purpose
+            f.parser.reset();
+        }
+        corpus.push_back(f);
+    }
+
+    return corpus;
+}
+
+static std::string serial_frame(int mid, int i, int n, const std::string& payload)
+{
+    char header[sizeof(SSerialHeader) + 1];
+    char footer[sizeof(SSerialFooter) + 1];
+    std::string frame;
+
+    snprintf(header, sizeof(header), "%c%c%04d%04d%04d",
+             (char)eSerialCodeStart, (char)eSerialCodePayload, mid, i, n);
+    frame.append(header, sizeof(SSerialHeader));
+    frame += payload;
+    snprintf(footer, sizeof(footer), "%08X%c",
+             crc32(0, frame.data(), frame.size()), (char)eSerialCodeStop);
+    frame.append(footer, sizeof(SSerialFooter));
+
+    return frame;
+}
+
+static void add_crc32(const std::vector<corpus_file>& corpus)
+{
+    for (std::size_t size : { 16, 256, 4096, 65536 }) {
+        auto data = std::make_shared<std::string>(random_text(size, "abcdefgh<>/= \"", 1));
+        add("crc32/" + std::to_string(size), size, [data](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                keep(crc32(0, data->data(), data->size()));
+        });
+    }
+
+    std::size_t bytes = 0;
+    for (auto&& f : corpus)
+        bytes += f.xml.size();
+    add("crc32/corpus", bytes, [&corpus](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i)
+            for (auto&& f : corpus)
+                keep(crc32(0, f.xml.data(), f.xml.size()));
+    });
+}
+
+// A DC reply as QueryClientSerial passes it on to the client. Before the
+// handlers parsed replies themselves, response_ready carried the raw reply
+// and QueryClientSerial parsed it. Both are handled, so the dcResponse cases
+// can be built on such a tree as the baseline, see bench_compare.sh.
+static void forward_response(const Glib::RefPtr<XmlResult>& result)
+{
+    keep(result->to_xml());
+}
+
+static void forward_response(const Glib::ustring& reply)
+{
+    keep(XmlResultParsed::create(reply)->to_xml());
+}
+
+template <typename T>
+static void connect_forward_response(sigc::signal<void, const T&, int>& response_ready)
+{
+    response_ready.connect([](const T& response, int) { forward_response(response); });
+}
+
+// Frames are fed through handleInputData of a handler on a pty, like the
+// serial port delivers them. For digestFrame every frame is frame 1 of 2,
+// the message is never complete and nothing is passed to the XmlProcessor.
+static void add_serial(const Glib::RefPtr<XmlProcessor>& processor)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (master < 0 || grantpt(master) || unlockpt(master)) {
+        std::cerr << "no pty, skipping the serial benchmarks" << std::endl;
+        return;
+    }
+
+    Glib::RefPtr<SerialInterfaceHandler> handler;
+    try {
+        handler = SerialInterfaceHandler::create(STR_ZIXINF_IPC, ptsname(master), 115200,
+                                                 processor, ESerialHandlerModeNormal);
+    } catch (...) {
+        std::cerr << "no serial handler, skipping the serial benchmarks" << std::endl;
+        close(master);
+        return;
+    }
+
+    for (std::size_t size : { 64, SERIAL_MAX_PAYLOAD_SIZE }) {
+        auto frame = std::make_shared<std::string>(serial_frame(1, 1, 2, random_text(size, "<abc d=\"1\"/>", 2)));
+        add("digestFrame/" + std::to_string(size), frame->size(), [handler, frame, master](std::size_t n) {
+            char buf[4096];
+
+            for (std::size_t i = 0; i < n; ++i) {
+                handler->handleInputData(const_cast<gchar *>(frame->data()), frame->size());
+                // the ACKs, before the pty buffer is full
+                if (i % 64 == 0)
+                    while (read(master, buf, sizeof(buf)) > 0)
+                        ;
+            }
+            while (read(master, buf, sizeof(buf)) > 0)
+                ;
+        });
+    }
+
+    // Complete single frame replies of a DC, from the frame to the
+    // XmlResult which is forwarded to the client
+    connect_forward_response(handler->response_ready);
+
+    for (std::size_t size : { 256, SERIAL_MAX_PAYLOAD_SIZE }) {
+        std::string reply = "<task tid=\"1\"><reply status=\"200\"><message>ok</message>\n";
+        const std::string value = "<value name=\"temperature\">23.5</value>\n";
+        const std::string tail = "</reply></task>";
+
+        while (reply.size() + value.size() + tail.size() <= size)
+            reply += value;
+        reply += tail;
+
+        auto frame = std::make_shared<std::string>(serial_frame(1, 1, 1, reply));
+        add("dcResponse/" + std::to_string(size), frame->size(), [handler, frame, master](std::size_t n) {
+            char buf[4096];
+
+            for (std::size_t i = 0; i < n; ++i) {
+                handler->handleInputData(const_cast<gchar *>(frame->data()), frame->size());
+                if (i % 64 == 0)
+                    while (read(master, buf, sizeof(buf)) > 0)
+                        ;
+            }
+            while (read(master, buf, sizeof(buf)) > 0)
+                ;
+        });
+    }
+}
+
+static void add_serial_message()
+{
+    for (std::size_t size : { 1024, 65536 }) {
+        auto payload = std::make_shared<Glib::ustring>(log_text(size, true));
+        auto message = Glib::RefPtr<CSerialMessage>(new CSerialMessage(SERIAL_MAX_PAYLOAD_SIZE));
+        auto frames = std::make_shared<std::vector<std::string> >();
+
+        message->initSenderMessage(*payload, 1);
+        while (message->dataLeft()) {
+            message->popFrame();
+            frames->push_back(message->getFramePayload());
+        }
+
+        add("CSerialMessage/split/" + std::to_string(size), payload->bytes(),
+            [payload, message](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    message->initSenderMessage(*payload, 1);
+                    while (message->dataLeft()) {
+                        message->popFrame();
+                        keep(message->getFramePayload());
+                    }
+                }
+            });
+        add("CSerialMessage/reassemble/" + std::to_string(size), payload->bytes(),
+            [frames, message](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    int count = frames->size();
+                    message->initReceiverMessage(count);
+                    for (int f = 0; f < count; ++f)
+                        message->pushFrame(f + 1, count, (*frames)[f]);
+                    keep(message->getPayload());
+                }
+            });
+    }
+}
+
+static void add_strings(const std::vector<corpus_file>& corpus)
+{
+    struct input { std::string name; Glib::ustring text; };
+    auto inputs = std::make_shared<std::vector<input> >();
+
+    for (std::size_t size : { 64, 4096 }) {
+        inputs->push_back(input{ "ascii/" + std::to_string(size), log_text(size, false) });
+        inputs->push_back(input{ "utf8/" + std::to_string(size), log_text(size, true) });
+    }
+
+    Glib::ustring all;
+    for (auto&& f : corpus)
+        all += f.xml;
+    if (!all.empty())
+        inputs->push_back(input{ "corpus", all });
+
+    for (std::size_t k = 0; k < inputs->size(); ++k) {
+        const input& in = (*inputs)[k];
+
+        add("xml_escape/" + in.name, in.text.bytes(), [inputs, k](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                keep(xml_escape((*inputs)[k].text));
+        });
+        add("strip_newlines_and_tabs/" + in.name, in.text.bytes(), [inputs, k](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                keep(UstringUtils::strip_newlines_and_tabs((*inputs)[k].text));
+        });
+        add("condense_spaces/" + in.name, in.text.bytes(), [inputs, k](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                keep(UstringUtils::condense_spaces((*inputs)[k].text));
+        });
+    }
+}
+
+static void add_log_entry()
+{
+    for (bool utf8 : { false, true }) {
+        auto params = std::make_shared<std::map<std::string, Glib::ustring> >();
+
+        (*params)["source"]    = "DC";
+        (*params)["timestamp"] = "2016-11-19 19:31:02.154";
+        (*params)["category"]  = "Service";
+        (*params)["level"]     = "Warning";
+        (*params)["theme"]     = "Device UV calibration";
+        (*params)["message"]   = log_text(200, utf8);
+
+        add(std::string("LogFileEntry/") + (utf8 ? "utf8" : "ascii"), 0, [params](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                LogFileEntry entry(*params);
+                keep(entry.entry());
+            }
+        });
+    }
+
+    add("get_timestamp", 0, [](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i)
+            keep(TimeUtilities::get_timestamp());
+    });
+}
+
+static void add_base64()
+{
+    for (std::size_t size : { 64, 4096, 1024 * 1024 }) {
+        auto data = std::make_shared<std::string>(random_text(size, std::string("\0\x01\xff\x80xyz", 7), 3));
+        auto encoded = std::make_shared<std::string>(FileHandler::base64_encode(*data));
+
+        add("base64_encode/" + std::to_string(size), size, [data](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                keep(FileHandler::base64_encode(*data));
+        });
+        add("base64_decode/" + std::to_string(size), size, [encoded](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                keep(FileHandler::base64_decode(*encoded));
+        });
+    }
+}
+
+static void add_element_to_string(const std::vector<corpus_file>& corpus)
+{
+    // a getMeasurementsList like reply with many entries
+    std::stringstream ss;
+    ss << "<reply status=\"200\">";
+    for (int i = 0; i < 1000; ++i)
+        ss << "<measurement id=\"" << i << "\" name=\"Messung " << i
+           << "\" date=\"2016-11-19\"><value unit=\"mm\">" << i * 0.5 << "</value></measurement>";
+    ss << "</reply>";
+
+    auto large = std::make_shared<xmlpp::DomParser>();
+    large->parse_memory(ss.str());
+    add("element_to_string/1000_elements", ss.str().size(), [large](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i)
+            keep(element_to_string(large->get_document()->get_root_node(), 0, 0));
+    });
+
+    std::size_t bytes = 0;
+    for (auto&& f : corpus)
+        if (f.parser)
+            bytes += f.xml.size();
+    add("element_to_string/corpus", bytes, [&corpus](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i)
+            for (auto&& f : corpus)
+                if (f.parser)
+                    keep(element_to_string(f.parser->get_document()->get_root_node(), 0, 0));
+    });
+}
+
+static void usage(const char *name)
+{
+    std::cerr
+        << "usage: " << name << " [options]\n"
+        << "  --filter SUBSTR         run only benchmarks containing SUBSTR\n"
+        << "  --min-time S            seconds per measurement (default 0.2)\n"
+        << "  --repetitions N         measurements per benchmark, median is used (default 5)\n"
+        << "  --output FILE           write the results as JSON\n"
+        << "  --baseline FILE         compare with the JSON of an earlier run\n"
+        << "  --max-regression PCT    fail if slower than the baseline by more (default 10)\n"
+        << "  --corpus DIR            realistic inputs (default testxmls)\n";
+}
+
+int main(int argc, char **argv)
+{
+    enum {
+        OPT_FILTER = 1, OPT_MIN_TIME, OPT_REPETITIONS, OPT_OUTPUT, OPT_BASELINE,
+        OPT_MAX_REGRESSION, OPT_CORPUS,
+    };
+    static const struct option options[] = {
+        { "filter",         required_argument, NULL, OPT_FILTER },
+        { "min-time",       required_argument, NULL, OPT_MIN_TIME },
+        { "repetitions",    required_argument, NULL, OPT_REPETITIONS },
+        { "output",         required_argument, NULL, OPT_OUTPUT },
+        { "baseline",       required_argument, NULL, OPT_BASELINE },
+        { "max-regression", required_argument, NULL, OPT_MAX_REGRESSION },
+        { "corpus",         required_argument, NULL, OPT_CORPUS },
+        { NULL, 0, NULL, 0 },
+    };
+
+    std::string filter, output, baseline_file, corpus_dir = "testxmls";
+    double min_time = 0.2, max_regression = 10;
+    int repetitions = 5;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (opt) {
+        case OPT_FILTER:
+            filter = optarg;
+            break;
+        case OPT_MIN_TIME:
+            min_time = atof(optarg);
+            break;
+        case OPT_REPETITIONS:
+            repetitions = std::max(1, atoi(optarg));
+            break;
+        case OPT_OUTPUT:
+            output = optarg;
+            break;
+        case OPT_BASELINE:
+            baseline_file = optarg;
+            break;
+        case OPT_MAX_REGRESSION:
+            max_regression = atof(optarg);
+            break;
+        case OPT_CORPUS:
+            corpus_dir = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the direct logger prints to stdout, keep the results readable
+    FILE *out = fdopen(dup(STDOUT_FILENO), "w");
+    if (!out || !freopen("/dev/null", "w", stdout))
+        return EXIT_FAILURE;
+    setInternLogLevel(ELogLevelFatal);
+
+    Glib::init();
+    Gio::init();
+
+    XmlParameter::init();
+
+    auto processor = XmlProcessor::create();
+    auto corpus = load_corpus(corpus_dir);
+
+    add_crc32(corpus);
+    add_serial(processor);
+    add_serial_message();
+    add_strings(corpus);
+    add_log_entry();
+    add_base64();
+    add_element_to_string(corpus);
+
+    std::map<std::string, double> baseline;
+    if (!baseline_file.empty())
+        baseline = load_baseline(baseline_file);
+
+    std::vector<result> results;
+    bool regression = false;
+
+    fprintf(out, "%-40s %14s %12s %12s%s\n", "benchmark", "ns/op", "MB/s", "iterations",
+            baseline.empty() ? "" : "     change");
+    for (auto&& b : benchmarks) {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos)
+            continue;
+
+        result r = measure(b, min_time, repetitions);
+        results.push_back(r);
+
+        fprintf(out, "%-40s %14.1f %12.1f %12zu", r.name.c_str(), r.ns_per_op, r.mb_per_s,
+                r.iterations);
+        if (baseline.count(r.name)) {
+            double change = (r.ns_per_op / baseline[r.name] - 1) * 100;
+            bool slower = change > max_regression;
+
+            fprintf(out, " %+9.1f%%%s", change, slower ? "  REGRESSION" : "");
+            regression |= slower;
+        } else if (!baseline.empty()) {
+            fprintf(out, "        new");
+        }
+        fprintf(out, "\n");
+        fflush(out);
+    }
+
+    if (!output.empty()) {
+        std::ofstream ofs(output);
+
+        ofs << std::fixed << std::setprecision(1) << "{\"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i)
+            ofs << (i ? ",\n" : "\n") << "  {\"name\": \"" << results[i].name
+                << "\", \"iterations\": " << results[i].iterations
+                << ", \"ns_per_op\": " << results[i].ns_per_op
+                << ", \"mb_per_s\": " << results[i].mb_per_s << "}";
+        ofs << "\n]}\n";
+    }
+
+    if (regression)
+        fprintf(out, "slower than %s by more than %.1f%%\n", baseline_file.c_str(), max_regression);
+    fclose(out);
+
+    return regression ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,280 @@
+//
+// Compares the latency of the HMAC signature of SignatureCreationRequest:
+// the former openssl process (xml written to a temp file, spawn
+// `openssl dgst -sha1 -hmac`, parse its output) against SignatureEngine
+// in-process. Checks that both produce the same signature.
+//
+// Then compares the gpg verification of SignatureCheckRequest: the former
+// ProcessRequest with signature and xml in two temp files against the
+// current one with the xml on stdin. Both run in the main loop like the
+// request does, with a keyring generated in a temp directory. Checks that
+// both accept the signature. Uses a tenth of the rounds.
+//
+// usage: bench_signature [rounds]
+//
+
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <glibmm/spawn.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+#include <giomm/init.h>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <unistd.h>
+
+#include "signature_engine.h"
+#include "process_request.h"
+#include "file_handler.h"
+
+static const char *KEY = "00:11:22:33:44:55";
+
+static Glib::ustring sign_via_openssl(const std::string& xml)
+{
+    std::string path;
+    int fd = Glib::file_open_tmp(path, "bench_signature");
+    std::string out;
+
+    if (write(fd, xml.data(), xml.size()) != static_cast<ssize_t>(xml.size())) {
+        close(fd);
+        throw std::runtime_error("Failed to write " + path);
+    }
+    close(fd);
+
+    std::vector<std::string> argv = { "openssl", "dgst", "-sha1", "-hmac", KEY, path };
+    Glib::spawn_sync("", argv, Glib::SPAWN_SEARCH_PATH, sigc::slot<void>(), &out);
+    unlink(path.c_str());
+
+    return FileHandler::base64_encode(out.substr(out.rfind(' ') + 1));
+}
+
+static std::string write_temp(const std::string& content)
+{
+    std::string path;
+    int fd = Glib::file_open_tmp(path, "bench_signature");
+
+    if (write(fd, content.data(), content.size()) != static_cast<ssize_t>(content.size())) {
+        close(fd);
+        throw std::runtime_error("Failed to write " + path);
+    }
+    close(fd);
+
+    return path;
+}
+
+static void run_gpg(const std::vector<std::string>& argv, std::string *out = nullptr)
+{
+    int status;
+
+    Glib::spawn_sync("", argv, Glib::SPAWN_SEARCH_PATH, sigc::slot<void>(), out, nullptr, &status);
+    if (status)
+        throw std::runtime_error("gpg failed with status " + std::to_string(status));
+}
+
+static std::string make_temp_dir()
+{
+    std::string path = Glib::build_filename(Glib::get_tmp_dir(), "bench_signature_XXXXXX");
+
+    if (!mkdtemp(&path[0]))
+        throw std::runtime_error("Failed to create " + path);
+
+    return path;
+}
+
+/* throwaway key in a temp gpg home, exported to a keyring file
+ */
+class GpgKey
+{
+public:
+    GpgKey() :
+        home(make_temp_dir()),
+        keyring(home + "/keyring.gpg")
+    {
+        std::string exported;
+
+        run_gpg({ "gpg", "--homedir", home, "--batch", "--passphrase", "",
+                  "--quick-gen-key", "bench <bench@zix>", "default", "default", "never" });
+        run_gpg({ "gpg", "--homedir", home, "--batch", "--export" }, &exported);
+        Glib::file_set_contents(keyring, exported);
+    }
+
+    ~GpgKey()
+    {
+        std::vector<std::string> argv = { "rm", "-rf", home };
+        Glib::spawn_sync("", argv, Glib::SPAWN_SEARCH_PATH);
+    }
+
+    // binary detached signature
+    std::string sign(const std::string& xml) const
+    {
+        std::string signature;
+        auto path = write_temp(xml);
+
+        run_gpg({ "gpg", "--homedir", home, "--batch", "--detach-sign", "-o", "-", path },
+                &signature);
+        unlink(path.c_str());
+
+        return signature;
+    }
+
+    std::vector<std::string> verify_args() const
+    {
+        return { "gpg", "--homedir", home, "--batch", "--verify", "--keyring", keyring,
+                 "--ignore-time-conflict", "--no-default-keyring" };
+    }
+
+    std::string home;
+    std::string keyring;
+};
+
+static bool run_process(const Glib::RefPtr<ProcessRequest>& proc)
+{
+    auto loop = Glib::MainLoop::create();
+    bool success = false;
+
+    proc->set_no_log_error();
+    proc->finished.connect([&] (const Glib::RefPtr<ProcessResult>& result) {
+        success = result->success();
+        loop->quit();
+    });
+    proc->start_process();
+    loop->run();
+
+    return success;
+}
+
+// former check: signature and xml in two temp files
+static bool verify_via_files(const GpgKey& key, const std::string& xml, const std::string& signature)
+{
+    auto args = key.verify_args();
+    auto sig_file = write_temp(signature);
+    auto xml_file = write_temp(xml);
+
+    args.push_back(sig_file);
+    args.push_back(xml_file);
+    bool valid = run_process(ProcessRequest::create(args, ProcessRequest::DEFAULT_TIMEOUT));
+
+    unlink(sig_file.c_str());
+    unlink(xml_file.c_str());
+
+    return valid;
+}
+
+// current check: signature in a temp file, xml on stdin
+static bool verify_via_stdin(const GpgKey& key, const std::string& xml, const std::string& signature)
+{
+    auto args = key.verify_args();
+    auto sig_file = write_temp(signature);
+
+    args.push_back(sig_file);
+    args.push_back("-");
+    auto proc = ProcessRequest::create(args, ProcessRequest::DEFAULT_TIMEOUT);
+    proc->set_stdin_data(xml);
+    bool valid = run_process(proc);
+
+    unlink(sig_file.c_str());
+
+    return valid;
+}
+
+// mean latency in microseconds
+static double measure(int rounds, const std::function<void ()>& fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+        fn();
+    std::chrono::duration<double, std::micro> wall = std::chrono::steady_clock::now() - start;
+
+    return wall.count() / rounds;
+}
+
+static std::string make_xml(std::size_t size, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string xml = "<?xml version=\"1.0\"?>\n<function fid=\"dataOut\"><data>";
+
+    while (xml.size() < size)
+        xml.push_back(letter(rng));
+    xml += "</data></function>\n";
+
+    return xml;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : 100;
+    int gpg_rounds = rounds >= 10 ? rounds / 10 : 1;
+    bool ok = true;
+
+    Glib::init();
+    Gio::init();
+
+    std::mt19937 rng(42);
+
+    std::cout << std::setw(10) << "size" << std::setw(12) << "openssl"
+              << std::setw(12) << "glib" << "  (us/signature)" << std::endl;
+
+    for (std::size_t size : { 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024 }) {
+        std::string xml = make_xml(size, rng);
+        Glib::ustring spawned, in_process;
+
+        try {
+            std::cout << std::setw(10) << size << std::fixed << std::setprecision(1)
+                      << std::setw(12) << measure(rounds, [&] { spawned = sign_via_openssl(xml); });
+        } catch (const Glib::Error& ex) {
+            std::cerr << "openssl failed: " << ex.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cout << std::setw(12)
+                  << measure(rounds, [&] { in_process = SignatureEngine::hmac_signature(KEY, xml); })
+                  << std::endl;
+
+        if (spawned != in_process) {
+            std::cerr << "signatures differ: " << spawned << " != " << in_process << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << std::endl << std::setw(10) << "size" << std::setw(12) << "gpg files"
+              << std::setw(12) << "gpg stdin" << "  (us/verification)" << std::endl;
+
+    try {
+        GpgKey key;
+
+        for (std::size_t size : { 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024 }) {
+            std::string xml = make_xml(size, rng);
+            std::string signature = key.sign(xml);
+            bool via_files = false, via_stdin = false;
+
+            std::cout << std::setw(10) << size << std::fixed << std::setprecision(1)
+                      << std::setw(12)
+                      << measure(gpg_rounds, [&] { via_files = verify_via_files(key, xml, signature); })
+                      << std::setw(12)
+                      << measure(gpg_rounds, [&] { via_stdin = verify_via_stdin(key, xml, signature); })
+                      << std::endl;
+
+            if (!via_files || !via_stdin) {
+                std::cerr << "gpg rejected the signature (files: " << via_files
+                          << ", stdin: " << via_stdin << ")" << std::endl;
+                ok = false;
+            }
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "gpg setup failed: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const Glib::Error& ex) {
+        std::cerr << "gpg setup failed: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,618 @@
+//
+// Replays the request corpus in testxmls/ against an in-process XmlProcessor
+// with QueryClientDummy as devicecontroller. Requests are drawn at random
+// from the corpus with a per fid weight and either sent closed loop (keeping
+// --concurrency requests outstanding) or open loop with Poisson arrivals at
+// --rate requests/s. In open loop the latency is measured from the intended
+// arrival, so queueing in the processor is part of it.
+//
+// Every file is first run once on its own to count the allocations per
+// request (operator new and the libxml2 allocator) without interference of
+// concurrent requests. The status of each reply is compared with the one in
+// responsexmls/<file> where that exists.
+//
+// The result is written as JSON to stdout (or --output), one fid per line so
+// runs of different releases can be diffed. The log of the library goes to
+// stderr with --verbose and is discarded otherwise. Run it from the source
+// directory, some requests reference files relative to it.
+//
+// usage: bench_xml_processor [--count N] [--concurrency N] [--rate R]
+//                            [--mix FID=WEIGHT]... [--interface NAME]
+//                            [--requests DIR] [--responses DIR] [--seed N]
+//                            [--timeout S] [--output FILE] [--verbose]
+//
+
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <glibmm/fileutils.h>
+#include <giomm/init.h>
+
+#include <libxml/xmlmemory.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <map>
+#include <string>
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include "xml_processor.h"
+#include "interface_connection.h"
+#include "query_client_dummy.h"
+#include "core_function_call.h"
+#include "xml_parameter.h"
+#include "log.h"
+
+// allocation counters, see operator new and xmlMemSetup below
+static std::atomic<unsigned long> cxx_allocs(0);
+static std::atomic<unsigned long> xml_allocs(0);
+
+void *operator new(std::size_t size)
+{
+    void *p = malloc(size ? size : 1);
+
+    if (!p)
+        throw std::bad_alloc();
+    cxx_allocs.fetch_add(1, std::memory_order_relaxed);
+
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+static void *xml_malloc(size_t size)
+{
+    xml_allocs.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size);
+}
+
+static void *xml_realloc(void *p, size_t size)
+{
+    xml_allocs.fetch_add(1, std::memory_order_relaxed);
+    return realloc(p, size);
+}
+
+static char *xml_strdup(const char *str)
+{
+    xml_allocs.fetch_add(1, std::memory_order_relaxed);
+    return strdup(str);
+}
+
+static void xml_free(void *p)
+{
+    free(p);
+}
+
+typedef std::chrono::steady_clock clock_type;
+
+struct sample {
+    std::string file;
+    std::string fid;
+    std::string xml;
+    std::string expected_status;    // empty if there is no response file
+};
+
+struct fid_stats {
+    fid_stats() : weight(1), requests(0), mismatches(0), calib_requests(0),
+                  calib_cxx_allocs(0), calib_xml_allocs(0) {}
+
+    double weight;
+    unsigned long requests;
+    unsigned long mismatches;
+    std::vector<double> latencies;  // us
+    std::map<std::string, unsigned long> status;
+    unsigned long calib_requests;
+    unsigned long calib_cxx_allocs;
+    unsigned long calib_xml_allocs;
+};
+
+// Receives the replies of the processor
+class BenchConnection : public InterfaceConnection
+{
+public:
+    BenchConnection(const std::function<void (const Glib::ustring&, int)>& on_result)
+        : InterfaceConnection("")
+        , _on_result(on_result)
+    { }
+
+    void emit_result(const Glib::ustring& result, int tid) override
+    {
+        _on_result(result, tid);
+    }
+
+    void cancel() override
+    { }
+
+private:
+    std::function<void (const Glib::ustring&, int)> _on_result;
+};
+
+static std::string read_file(const std::string& path)
+{
+    std::ifstream ifs(path);
+    std::stringstream ss;
+
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+// value of attribute "name" of the first element in xml
+static std::string root_attribute(const std::string& xml, const std::string& name)
+{
+    std::size_t pos = 0;
+
+    // skip <?xml ...?> and comments
+    while ((pos = xml.find('<', pos)) != std::string::npos
+           && pos + 1 < xml.size() && (xml[pos + 1] == '?' || xml[pos + 1] == '!'))
+        ++pos;
+    if (pos == std::string::npos)
+        return "";
+
+    std::size_t end = xml.find('>', pos);
+    std::string tag = xml.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    std::string key = " " + name + "=";
+    std::size_t attr = tag.find(key);
+
+    if (attr == std::string::npos)
+        return "";
+    attr += key.size();
+    if (attr >= tag.size())
+        return "";
+
+    char quote = tag[attr];
+    std::size_t close = tag.find(quote, attr + 1);
+    if (close == std::string::npos)
+        return "";
+
+    return tag.substr(attr + 1, close - attr - 1);
+}
+
+static std::vector<sample> load_corpus(const std::string& req_dir, const std::string& res_dir)
+{
+    std::vector<std::string> names;
+    std::vector<sample> samples;
+
+    Glib::Dir dir(req_dir);
+    for (auto&& name : dir)
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0)
+            names.push_back(name);
+    std::sort(names.begin(), names.end());
+
+    for (auto&& name : names) {
+        sample s;
+
+        s.file = name;
+        s.xml = read_file(req_dir + "/" + name);
+        s.fid = root_attribute(s.xml, "fid");
+        if (s.fid.empty())
+            s.fid = "unknown";
+        if (Glib::file_test(res_dir + "/" + name, Glib::FILE_TEST_EXISTS))
+            s.expected_status = root_attribute(read_file(res_dir + "/" + name), "status");
+
+        samples.push_back(s);
+    }
+
+    return samples;
+}
+
+// nearest rank, values must be sorted
+static double percentile(const std::vector<double>& values, double p)
+{
+    if (values.empty())
+        return 0;
+
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p * values.size()));
+
+    return values[rank ? rank - 1 : 0];
+}
+
+static std::string json_string(const std::string& str)
+{
+    std::string out = "\"";
+
+    for (auto&& c : str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+
+    return out + "\"";
+}
+
+static void usage(const char *name)
+{
+    std::cerr
+        << "usage: " << name << " [options]\n"
+        << "  --count N           requests to send (default 1000)\n"
+        << "  --concurrency N     maximum outstanding requests (default 1)\n"
+        << "  --rate R            Poisson arrivals per second, 0: closed loop (default)\n"
+        << "  --mix FID=WEIGHT    relative weight of FID, 0 excludes it (default 1,\n"
+        << "                      0 for exit, update, procedure, setConf, dataFree, delFile)\n"
+        << "  --interface NAME    interface the requests come from (default Unknown)\n"
+        << "  --requests DIR      request corpus (default testxmls)\n"
+        << "  --responses DIR     expected replies (default responsexmls)\n"
+        << "  --seed N            seed for the mix and the arrivals\n"
+        << "  --timeout S         give up waiting for replies after S seconds (default 60)\n"
+        << "  --output FILE       write the JSON to FILE instead of stdout\n"
+        << "  --verbose           show the log of the library on stderr\n";
+}
+
+int main(int argc, char **argv)
+{
+    enum {
+        OPT_COUNT = 1, OPT_CONCURRENCY, OPT_RATE, OPT_MIX, OPT_INTERFACE, OPT_REQUESTS,
+        OPT_RESPONSES, OPT_SEED, OPT_TIMEOUT, OPT_OUTPUT, OPT_VERBOSE,
+    };
+    static const struct option options[] = {
+        { "count",       required_argument, NULL, OPT_COUNT },
+        { "concurrency", required_argument, NULL, OPT_CONCURRENCY },
+        { "rate",        required_argument, NULL, OPT_RATE },
+        { "mix",         required_argument, NULL, OPT_MIX },
+        { "interface",   required_argument, NULL, OPT_INTERFACE },
+        { "requests",    required_argument, NULL, OPT_REQUESTS },
+        { "responses",   required_argument, NULL, OPT_RESPONSES },
+        { "seed",        required_argument, NULL, OPT_SEED },
+        { "timeout",     required_argument, NULL, OPT_TIMEOUT },
+        { "output",      required_argument, NULL, OPT_OUTPUT },
+        { "verbose",     no_argument,       NULL, OPT_VERBOSE },
+        { NULL, 0, NULL, 0 },
+    };
+
+    unsigned long count = 1000;
+    unsigned long concurrency = 1;
+    double rate = 0;
+    std::map<std::string, double> mix = {
+        { "exit", 0 }, { "update", 0 }, { "procedure", 0 },
+        { "setConf", 0 }, { "dataFree", 0 }, { "delFile", 0 },
+    };
+    std::string interface = "Unknown";
+    std::string req_dir = "testxmls", res_dir = "responsexmls";
+    std::string output;
+    unsigned seed = 42;
+    int timeout = 60;
+    bool verbose = false;
+    int opt;
+
+    // before anything touches libxml2
+    xmlMemSetup(xml_free, xml_malloc, xml_realloc, xml_strdup);
+
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        const char *eq;
+
+        switch (opt) {
+        case OPT_COUNT:
+            count = strtoul(optarg, NULL, 10);
+            break;
+        case OPT_CONCURRENCY:
+            concurrency = std::max(1ul, strtoul(optarg, NULL, 10));
+            break;
+        case OPT_RATE:
+            rate = atof(optarg);
+            break;
+        case OPT_MIX:
+            eq = strchr(optarg, '=');
+            if (!eq || eq == optarg) {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            mix[std::string(optarg, eq - optarg)] = atof(eq + 1);
+            break;
+        case OPT_INTERFACE:
+            interface = optarg;
+            break;
+        case OPT_REQUESTS:
+            req_dir = optarg;
+            break;
+        case OPT_RESPONSES:
+            res_dir = optarg;
+            break;
+        case OPT_SEED:
+            seed = strtoul(optarg, NULL, 10);
+            break;
+        case OPT_TIMEOUT:
+            timeout = atoi(optarg);
+            break;
+        case OPT_OUTPUT:
+            output = optarg;
+            break;
+        case OPT_VERBOSE:
+            verbose = true;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The direct logger prints to stdout, keep it away from the JSON
+    int json_fd = dup(STDOUT_FILENO);
+    if (verbose) {
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    } else {
+        if (!freopen("/dev/null", "w", stdout))
+            return EXIT_FAILURE;
+        setInternLogLevel(ELogLevelError);
+    }
+
+    Glib::init();
+    Gio::init();
+
+    XmlParameter::init();
+    QueryClient::set_instance(QueryClientDummy::create());
+
+    auto processor = XmlProcessor::create();
+
+    std::vector<sample> samples;
+    try {
+        samples = load_corpus(req_dir, res_dir);
+    } catch (const Glib::Error& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::map<std::string, fid_stats> stats;
+    std::vector<double> weights;
+    for (auto&& s : samples) {
+        auto& fs = stats[s.fid];
+        if (mix.count(s.fid))
+            fs.weight = mix[s.fid];
+        weights.push_back(fs.weight);
+    }
+    auto mix_empty = [&]() {
+        if (std::find_if(weights.begin(), weights.end(),
+                         [](double w) { return w > 0; }) != weights.end())
+            return false;
+        std::cerr << "no requests left in the mix" << std::endl;
+        return true;
+    };
+    if (mix_empty())
+        return EXIT_FAILURE;
+
+    auto loop = Glib::MainLoop::create();
+    std::mt19937 rng(seed);
+    std::discrete_distribution<std::size_t> pick(weights.begin(), weights.end());
+    std::exponential_distribution<double> interarrival(rate > 0 ? rate : 1);
+
+    struct pending_request {
+        std::size_t sample;
+        clock_type::time_point start;
+    };
+    std::map<int, pending_request> pending;
+    std::vector<std::pair<std::size_t, clock_type::time_point> > backlog;
+    int next_tid = 1;
+    unsigned long submitted = 0, completed = 0, mismatches = 0;
+    std::vector<double> all_latencies;
+    bool calibrating = true;
+    std::function<void ()> pump;
+    sigc::connection idle_connection, timer_connection;
+
+    // ms = 0: as soon as the main loop is idle, e.g. after a reply
+    auto schedule_pump = [&](unsigned ms) {
+        if (ms) {
+            timer_connection.disconnect();
+            timer_connection = Glib::signal_timeout().connect(
+                [&]() { timer_connection.disconnect(); pump(); return false; }, ms);
+        } else if (!idle_connection.connected()) {
+            idle_connection = Glib::signal_idle().connect(
+                [&]() { idle_connection.disconnect(); pump(); return false; });
+        }
+    };
+
+    std::shared_ptr<InterfaceConnection> connection;
+
+    auto submit = [&](std::size_t index, clock_type::time_point start) {
+        int tid = next_tid++;
+        std::istringstream is(samples[index].xml);
+
+        pending[tid] = pending_request{ index, start };
+        processor->parse_stream(is, tid, 0, connection, interface);
+    };
+
+    connection = std::make_shared<BenchConnection>([&](const Glib::ustring& result, int tid) {
+        auto it = pending.find(tid);
+        if (it == pending.end())
+            return;
+
+        const sample& s = samples[it->second.sample];
+        auto& fs = stats[s.fid];
+        std::chrono::duration<double, std::micro> latency = clock_type::now() - it->second.start;
+        std::string status = root_attribute(result, "status");
+
+        pending.erase(it);
+        if (!s.expected_status.empty() && status != s.expected_status) {
+            if (calibrating || verbose)
+                std::cerr << s.file << ": status " << status << ", expected "
+                          << s.expected_status << std::endl;
+            if (!calibrating) {
+                ++fs.mismatches;
+                ++mismatches;
+            }
+        }
+
+        if (calibrating)
+            return;
+
+        ++completed;
+        ++fs.requests;
+        ++fs.status[status];
+        fs.latencies.push_back(latency.count());
+        all_latencies.push_back(latency.count());
+
+        if (completed == count)
+            loop->quit();
+        else
+            schedule_pump(0);
+    });
+
+    // calibration: every sample of the mix on its own, also warms up
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        if (weights[i] <= 0)
+            continue;
+
+        auto& fs = stats[samples[i].fid];
+        unsigned long cxx = cxx_allocs, xml = xml_allocs;
+        int tid = next_tid;
+        bool expired = false;
+
+        auto timer = Glib::signal_timeout().connect_seconds(
+            [&]() { expired = true; return false; }, timeout);
+        submit(i, clock_type::now());
+        // replies of QueryClientDummy may still be queued in the main loop
+        while (pending.count(tid) && !expired)
+            loop->get_context()->iteration(true);
+        timer.disconnect();
+
+        if (expired) {
+            std::cerr << samples[i].file << ": no reply, excluded" << std::endl;
+            pending.erase(tid);
+            weights[i] = 0;
+            continue;
+        }
+
+        ++fs.calib_requests;
+        fs.calib_cxx_allocs += cxx_allocs - cxx;
+        fs.calib_xml_allocs += xml_allocs - xml;
+    }
+    calibrating = false;
+    if (mix_empty())
+        return EXIT_FAILURE;
+    pick = std::discrete_distribution<std::size_t>(weights.begin(), weights.end());
+
+    // load
+    clock_type::time_point next_arrival = clock_type::now();
+
+    pump = [&]() {
+        auto now = clock_type::now();
+
+        if (rate > 0) {
+            while (submitted < count && next_arrival <= now) {
+                backlog.emplace_back(pick(rng), next_arrival);
+                ++submitted;
+                next_arrival += std::chrono::duration_cast<clock_type::duration>(
+                    std::chrono::duration<double>(interarrival(rng)));
+            }
+            while (!backlog.empty() && pending.size() < concurrency) {
+                submit(backlog.front().first, backlog.front().second);
+                backlog.erase(backlog.begin());
+            }
+            if (submitted < count) {
+                std::chrono::duration<double, std::milli> wait = next_arrival - clock_type::now();
+                schedule_pump(std::max(0, static_cast<int>(wait.count())));
+            }
+        } else {
+            while (submitted < count && pending.size() < concurrency) {
+                ++submitted;
+                submit(pick(rng), clock_type::now());
+            }
+        }
+    };
+
+    unsigned long cxx_start = cxx_allocs, xml_start = xml_allocs;
+    auto start = clock_type::now();
+
+    if (count) {
+        schedule_pump(0);
+        Glib::signal_timeout().connect_seconds([&]() { loop->quit(); return false; }, timeout);
+        loop->run();
+    }
+
+    std::chrono::duration<double> wall = clock_type::now() - start;
+    unsigned long load_cxx = cxx_allocs - cxx_start, load_xml = xml_allocs - xml_start;
+    double seconds = wall.count() > 0 ? wall.count() : 1;
+
+    std::sort(all_latencies.begin(), all_latencies.end());
+
+    std::stringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{\n"
+         << "  \"config\": {\"count\": " << count << ", \"concurrency\": " << concurrency
+         << ", \"rate\": " << rate << ", \"interface\": " << json_string(interface)
+         << ", \"requests\": " << json_string(req_dir) << ", \"seed\": " << seed << "},\n"
+         << "  \"total\": {\"requests\": " << completed
+         << ", \"lost\": " << count - completed
+         << ", \"mismatches\": " << mismatches
+         << ", \"seconds\": " << std::setprecision(3) << wall.count() << std::setprecision(1)
+         << ", \"throughput\": " << completed / seconds
+         << ", \"p50_us\": " << percentile(all_latencies, 0.5)
+         << ", \"p99_us\": " << percentile(all_latencies, 0.99)
+         << ", \"p999_us\": " << percentile(all_latencies, 0.999)
+         << ", \"max_us\": " << (all_latencies.empty() ? 0 : all_latencies.back())
+         << ", \"allocs\": " << (completed ? double(load_cxx) / completed : 0)
+         << ", \"xml_allocs\": " << (completed ? double(load_xml) / completed : 0)
+         << "},\n"
+         << "  \"fids\": {";
+
+    bool first = true;
+    for (auto&& entry : stats) {
+        auto& fs = entry.second;
+        if (fs.weight <= 0)
+            continue;
+
+        std::sort(fs.latencies.begin(), fs.latencies.end());
+
+        json << (first ? "\n" : ",\n") << "    " << json_string(entry.first) << ": {"
+             << "\"requests\": " << fs.requests
+             << ", \"mismatches\": " << fs.mismatches
+             << ", \"throughput\": " << fs.requests / seconds
+             << ", \"p50_us\": " << percentile(fs.latencies, 0.5)
+             << ", \"p99_us\": " << percentile(fs.latencies, 0.99)
+             << ", \"p999_us\": " << percentile(fs.latencies, 0.999)
+             << ", \"max_us\": " << (fs.latencies.empty() ? 0 : fs.latencies.back())
+             << ", \"allocs\": "
+             << (fs.calib_requests ? double(fs.calib_cxx_allocs) / fs.calib_requests : 0)
+             << ", \"xml_allocs\": "
+             << (fs.calib_requests ? double(fs.calib_xml_allocs) / fs.calib_requests : 0)
+             << ", \"status\": {";
+        bool first_status = true;
+        for (auto&& status : fs.status) {
+            json << (first_status ? "" : ", ") << json_string(status.first) << ": "
+                 << status.second;
+            first_status = false;
+        }
+        json << "}}";
+        first = false;
+    }
+    json << "\n  }\n}\n";
+
+    if (output.empty()) {
+        std::string str = json.str();
+        if (write(json_fd, str.data(), str.size()) != static_cast<ssize_t>(str.size()))
+            return EXIT_FAILURE;
+    } else {
+        std::ofstream ofs(output);
+        ofs << json.str();
+    }
+    close(json_fd);
+
+    std::cerr << completed << " requests in " << wall.count() << " s, "
+              << completed / seconds << " requests/s, p99 "
+              << percentile(all_latencies, 0.99) << " us" << std::endl;
+
+    processor.reset();
+
+    return completed == count && mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,82 @@
+#ifndef _BLOCK_POOL_H_
+#define _BLOCK_POOL_H_
+
+#include <cstddef>
+#include <new>
+
+/**
+ * \brief Free list of equally sized memory blocks
+ *
+ * Meant for the class specific operator new/delete of objects which are
+ * created and destroyed by every request, e.g. XmlStringParameter. Released
+ * blocks are kept for the next object of the thread instead of going back
+ * to the heap, so a steady stream of requests does not allocate them. At
+ * most MaxFree blocks are kept per thread.
+ *
+ * Objects of derived classes which do not fit into a block are allocated
+ * on the heap, so the sized operator delete has to be used:
+ *
+ *   static void *operator new(std::size_t size)
+ *   { return BlockPool<sizeof(Param)>::allocate(size); }
+ *   static void operator delete(void *p, std::size_t size)
+ *   { BlockPool<sizeof(Param)>::release(p, size); }
+ */
+template <std::size_t BlockSize, std::size_t MaxFree = 256>
+class BlockPool
+{
+public:
+    static void *allocate(std::size_t size)
+    {
+        FreeList& list = free_list();
+
+        if (size > BlockSize || !list.head)
+            return ::operator new(size > BlockSize ? size : BlockSize);
+
+        Block *block = list.head;
+        list.head = block->next;
+        list.count--;
+
+        return block;
+    }
+
+    static void release(void *p, std::size_t size)
+    {
+        FreeList& list = free_list();
+
+        if (!p)
+            return;
+
+        if (size > BlockSize || list.count >= MaxFree) {
+            ::operator delete(p);
+            return;
+        }
+
+        Block *block = static_cast<Block *>(p);
+        block->next = list.head;
+        list.head = block;
+        list.count++;
+    }
+
+private:
+    struct Block
+    {
+        Block *next;
+    };
+
+    struct FreeList
+    {
+        Block *head;
+        std::size_t count;
+    };
+
+    static_assert(BlockSize >= sizeof(Block), "block too small for the free list");
+
+    static FreeList& free_list()
+    {
+        static thread_local FreeList list = { nullptr, 0 };
+
+        return list;
+    }
+};
+
+#endif /* _BLOCK_POOL_H_ */
@@ -39,6 +39,8 @@
 #include "samba_mounter.h"
 #include "simple_crypt.h"
 #include "network_config.h"
+#include "archive_write_request.h"
+#include "socket_write_queue.h"
 
 
 #include <libxml++/nodes/element.h>
@@ -1174,6 +1176,68 @@ Glib::ustring ConfHandler::getLogLevel()
     return( value );
 }
 
+int ConfHandler::getArchiveCompressionLevel()
+{
+    xmlpp::NodeSet nodeSet;
+    xmlpp::Element* element;
+    xmlpp::Attribute* attribute;
+    Glib::ustring value;
+
+    nodeSet=nodeRoot->find("/sic/log/archiveCompressionLevel");
+    if(nodeSet.size())
+    {
+        element= dynamic_cast<xmlpp::Element *>( nodeSet.front() );
+        if(!element)
+            return ArchiveWriteRequest::DEFAULT_COMPRESSION_LEVEL;
+
+        if( ( attribute=element->get_attribute("value") ) )
+            value = attribute->get_value();
+    }
+
+    if (value.empty())
+        return ArchiveWriteRequest::DEFAULT_COMPRESSION_LEVEL;
+
+    std::stringstream ss{value};
+    int level;
+    ss >> level;
+
+    if (ss.fail() || ss.bad() || level < 0 || level > 9)
+        return ArchiveWriteRequest::DEFAULT_COMPRESSION_LEVEL;
+
+    return level;
+}
+
+std::size_t ConfHandler::getSocketWriteBufferMax()
+{
+    xmlpp::NodeSet nodeSet;
+    xmlpp::Element* element;
+    xmlpp::Attribute* attribute;
+    Glib::ustring value;
+
+    nodeSet=nodeRoot->find("/sic/interfaces/socketWriteBufferMax");
+    if(nodeSet.size())
+    {
+        element= dynamic_cast<xmlpp::Element *>( nodeSet.front() );
+        if(!element)
+            return SocketWriteQueue::DEFAULT_MAX_BUFFERED;
+
+        if( ( attribute=element->get_attribute("value") ) )
+            value = attribute->get_value();
+    }
+
+    if (value.empty())
+        return SocketWriteQueue::DEFAULT_MAX_BUFFERED;
+
+    std::stringstream ss{value};
+    std::size_t size;
+    ss >> size;
+
+    if (ss.fail() || ss.bad() || size == 0)
+        return SocketWriteQueue::DEFAULT_MAX_BUFFERED;
+
+    return size;
+}
+
 Glib::ustring ConfHandler::getAllocationProcessor(const Glib::ustring& id)
 {
     xmlpp::NodeSet nodeSet;
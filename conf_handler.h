@@ -210,6 +210,12 @@ class ConfHandler: public Glib::Object
     // log level
     Glib::ustring getLogLevel();
 
+    // zlib level for log/monitor archives
+    int getArchiveCompressionLevel();
+
+    // bytes queued per socket connection before a client is dropped
+    std::size_t getSocketWriteBufferMax();
+
     // serial protocol handler
     SerialProtocol getSerialProtocolHandler(const Glib::ustring& protocol_id);
 
@@ -3,25 +3,8 @@
 
 #include "xml_exception.h"
 #include "xml_string_parameter.h"
-#include "file_handler.h"
-
-#include "core_function_log.h"
-#include "core_function_get_files_list.h"
-#include "core_function_del_file.h"
-#include "core_function_get_file.h"
-#include "core_function_set_file.h"
-#include "core_function_get_conf.h"
-#include "core_function_set_conf.h"
-#include "core_function_data_sync.h"
-#include "core_function_data_out.h"
-#include "core_function_data_free.h"
-#include "core_function_data_in.h"
-#include "core_function_wrap_dc.h"
-#include "core_function_get_measurement.h"
-#include "core_function_get_measurements_list.h"
-#include "core_function_procedure.h"
-#include "core_function_exit.h"
-#include "core_function_update.h"
+#include "async_file_handler.h"
+#include "utils.h"
 
 CoreFunctionCall::CoreFunctionCall (const Glib::ustring & fid,
 				    XmlParameterList parameters,
@@ -31,6 +14,7 @@ CoreFunctionCall::CoreFunctionCall (const Glib::ustring & fid,
     , _description (description)
     , _textbody (textbody)
     , _fid (fid)
+    , _binary_replies (false)
 { }
 
 CoreFunctionCall::~CoreFunctionCall()
@@ -38,27 +22,31 @@ CoreFunctionCall::~CoreFunctionCall()
 
 Glib::RefPtr<FunctionCall>
 CoreFunctionCall::create (const Glib::ustring & fid,
+			  FunctionRegistry::Id function,
 			  XmlParameterList parameters,
 			  Glib::RefPtr <XmlDescription> description,
 			  const Glib::ustring & textbody,
 			  const xmlpp::Element *en,
 			  const Glib::ustring & interface,
-                          const Glib::ustring & filename)
+                          const Glib::ustring & filename,
+			  const Glib::RefPtr <Glib::Bytes> & attachment,
+			  bool binary_replies)
 {
-    auto f_iter = factory_map.find (fid);
+    const FunctionRegistry::Entry *entry = FunctionRegistry::get (function);
 
     /* check, whether we have an entry here
      */
-    if (f_iter == factory_map.end()) {
+    if (!entry) {
 	throw XmlExceptionUnknownFid (fid);
     }
 
     /* ok... call constructor and return result
      */
-    auto ret = f_iter->second (parameters, description, textbody, en);
+    auto ret = entry->factory (parameters, description, textbody, en);
 
     ret->set_interface(interface);
     ret->set_filename(filename);
+    ret->set_attachment(attachment, binary_replies);
 
     return Glib::RefPtr <FunctionCall>::cast_dynamic (ret);
 }
@@ -73,19 +61,30 @@ CoreFunctionCall::call_finished (Glib::RefPtr <XmlResult> result)
     if (dest_param) {
         PRINT_DEBUG ("dest param is set to " << dest_param->get_str());
         auto dest = dest_param->get_str();
-        FileHandler::set_file (dest, result->to_dest ());
-	result->set_redirected ();
+
+	/* dest might be on a slow share, do not block the main loop
+	 */
+	AsyncFileHandler::get_instance ()->set_file (dest, result->to_dest (),
+	    sigc::bind (sigc::mem_fun (*this, &CoreFunctionCall::dest_written), result));
+	return;
     }
 
     finished.emit (result);
 }
 
-std::map <Glib::ustring, CoreFunctionCall::Factory> CoreFunctionCall::factory_map;
-
 void
-CoreFunctionCall::register_factory (const Glib::ustring & fid, Factory factory)
+CoreFunctionCall::dest_written (const Glib::RefPtr <FileOperationResult> & op_result,
+				Glib::RefPtr <XmlResult> result)
 {
-    factory_map [fid] = factory;
+    if (op_result->error ()) {
+	/* reply directly instead
+	 */
+	PRINT_ERROR ("Failed to write result to dest: " << op_result->error_msg ());
+    } else {
+	result->set_redirected ();
+    }
+
+    finished.emit (result);
 }
 
 void CoreFunctionCall::set_interface(const Glib::ustring & interface)
@@ -98,47 +97,49 @@ void CoreFunctionCall::set_filename(const Glib::ustring & filename)
 	_filename = filename;
 }
 
+void CoreFunctionCall::set_attachment(const Glib::RefPtr <Glib::Bytes> & attachment, bool binary_replies)
+{
+	_attachment = attachment;
+	_binary_replies = binary_replies;
+}
+
 void
-CoreFunctionCall::init ()
+CoreFunctionCall::check_attachment_range (std::size_t offset, std::size_t size) const
+{
+    if (!_attachment)
+	EXCEPTION ("Request has no attachment");
+
+    gsize total = _attachment->get_size ();
+
+    if (offset > total || size > total - offset)
+	EXCEPTION ("Attachment range " << offset << "+" << size << " exceeds attachment size " << total);
+}
+
+std::string
+CoreFunctionCall::attachment_range (std::size_t offset, std::size_t size) const
+{
+    check_attachment_range (offset, size);
+
+    gsize total;
+    auto data = static_cast <const char *> (_attachment->get_data (total));
+
+    return std::string (data + offset, size);
+}
+
+SharedBuffer
+CoreFunctionCall::attachment_buffer (std::size_t offset, std::size_t size) const
+{
+    check_attachment_range (offset, size);
+
+    if (offset == 0 && size == _attachment->get_size ())
+	return SharedBuffer (_attachment);
+
+    return SharedBuffer (Glib::wrap (g_bytes_new_from_bytes (_attachment->gobj (), offset, size)));
+}
+
+bool
+CoreFunctionCall::use_reply_attachments () const
 {
-    register_factory ("log", & CoreFunctionLog::factory);
-    register_factory ("getFilesList", & CoreFunctionGetFilesList::factory);
-    register_factory ("delFile", & CoreFunctionDelFile::factory);
-    register_factory ("getFile", & CoreFunctionGetFile::factory);
-    register_factory ("setFile", & CoreFunctionSetFile::factory);
-    register_factory ("getConf", & CoreFunctionGetConf::factory);
-    register_factory ("setConf", & CoreFunctionSetConf::factory);
-    register_factory ("dataSync", & CoreFunctionDataSync::factory);
-    register_factory ("dataOut", & CoreFunctionDataOut::factory);
-    register_factory ("dataFree", & CoreFunctionDataFree::factory);
-    register_factory ("getMeasurement", & CoreFunctionGetMeasurement::factory);
-    register_factory ("dataIn", & CoreFunctionDataIn::factory);
-    register_factory ("getMeasurementsList", &CoreFunctionGetMeasurementsList::factory);
-    register_factory ("update", &CoreFunctionUpdate::factory);
-
-    register_factory ("setMeasurementsList", CoreFunctionWrapDC::factory_set_measurements_list);
-    register_factory ("getCalibration", CoreFunctionWrapDC::factory_get_calibration);
-    register_factory ("getDefaults", CoreFunctionWrapDC::factory_get_defaults);
-    register_factory ("getProfilesList", CoreFunctionWrapDC::factory_get_profiles_list);
-    register_factory ("getProfile", CoreFunctionWrapDC::factory_get_profile);
-    register_factory ("getParametersList", CoreFunctionWrapDC::factory_get_parameters_list);
-    register_factory ("getParameter", CoreFunctionWrapDC::factory_get_parameter);
-    register_factory ("getTemplatesList", CoreFunctionWrapDC::factory_get_templates_list);
-    register_factory ("getTemplate", CoreFunctionWrapDC::factory_get_template);
-    register_factory ("setMeasurement", CoreFunctionWrapDC::factory_set_measurement);
-    register_factory ("setCalibration", CoreFunctionWrapDC::factory_set_calibration);
-    register_factory ("setDefaults", CoreFunctionWrapDC::factory_set_defaults);
-    register_factory ("setProfilesList", CoreFunctionWrapDC::factory_set_profiles_list);
-    register_factory ("setProfile", CoreFunctionWrapDC::factory_set_profile);
-    register_factory ("setParameter", CoreFunctionWrapDC::factory_set_parameter);
-    register_factory ("setTemplatesList", CoreFunctionWrapDC::factory_set_templates_list);
-    register_factory ("setTemplate", CoreFunctionWrapDC::factory_set_template);
-    register_factory ("delMeasurement", CoreFunctionWrapDC::factory_del_measurement);
-    register_factory ("delProfile", CoreFunctionWrapDC::factory_del_profile);
-    register_factory ("delTemplate", CoreFunctionWrapDC::factory_del_template);
-    register_factory ("guiIO", CoreFunctionWrapDC::factory_gui_io);
-
-    register_factory ("procedure", CoreFunctionProcedure::factory);
-    register_factory ("exit", CoreFunctionExit::factory);
+    return _binary_replies && !_parameters.get<XmlStringParameter>("dest");
 }
 
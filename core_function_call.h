@@ -7,6 +7,7 @@
 
 #include <glibmm/ustring.h>
 #include <glibmm/refptr.h>
+#include <glibmm/bytes.h>
 #include <sigc++/signal.h>
 
 #include "xml_parameter_list.h"
@@ -14,12 +15,15 @@
 #include "xml_result.h"
 
 #include "function_call.h"
+#include "function_registry.h"
+#include "file_operation_result.h"
+#include "shared_buffer.h"
 
 /**
  * \brief Baseclass for Code that can be called via xml Request
  *
- * This Class owns the mapping Table from fid to a Factory,
- * which creates the function Call object.
+ * The function Call object is created by the Factory of
+ * the fid in the FunctionRegistry.
  *
  * Note that a Function Call is asynchronous. Its started,
  * and emits a signal when finished.
@@ -34,25 +38,29 @@ class CoreFunctionCall : public FunctionCall
 
 	virtual ~CoreFunctionCall ();
 
-	typedef Glib::RefPtr <CoreFunctionCall> (*Factory) (XmlParameterList parameters,
-							Glib::RefPtr <XmlDescription> description,
-							const Glib::ustring & textbody,
-							const xmlpp::Element * en);
+	typedef FunctionRegistry::Factory Factory;
 
 
 	static Glib::RefPtr<FunctionCall> create (const Glib::ustring & fid,
+						  FunctionRegistry::Id function,
 						  XmlParameterList parameters,
 						  Glib::RefPtr <XmlDescription> description,
 						  const Glib::ustring & textbody,
 						  const xmlpp::Element * en,
 						  const Glib::ustring & interface,
-                                                  const Glib::ustring & filename = "");
+                                                  const Glib::ustring & filename = "",
+						  const Glib::RefPtr <Glib::Bytes> & attachment = Glib::RefPtr <Glib::Bytes> (),
+						  bool binary_replies = false);
 
-	static void register_factory (const Glib::ustring & fid, Factory factory);
-	static void init ();
 	void set_interface(const Glib::ustring& interface);
         void set_filename(const Glib::ustring& filename);
 
+	/**
+	 * Binary attachment of the request and whether the reply may carry
+	 * one (see InterfaceConnection::supports_attachments).
+	 */
+	void set_attachment(const Glib::RefPtr <Glib::Bytes> & attachment, bool binary_replies);
+
     protected:
 	XmlParameterList _parameters;
 	Glib::RefPtr <XmlDescription> _description;
@@ -60,11 +68,35 @@ class CoreFunctionCall : public FunctionCall
 	Glib::ustring _fid;
 	Glib::ustring _interface;
         Glib::ustring _filename;
+	Glib::RefPtr <Glib::Bytes> _attachment;
+	bool _binary_replies;
 
 	void call_finished (Glib::RefPtr <XmlResult> result);
 
+	/**
+	 * Throws, if the request has no attachment or the range is outside.
+	 */
+	void check_attachment_range (std::size_t offset, std::size_t size) const;
+
+	/**
+	 * Copy of size bytes at offset of the request attachment.
+	 */
+	std::string attachment_range (std::size_t offset, std::size_t size) const;
+
+	/**
+	 * Like attachment_range (), but referencing the request attachment.
+	 */
+	SharedBuffer attachment_buffer (std::size_t offset, std::size_t size) const;
+
+	/**
+	 * Whether files may be sent as reply attachment. Not, if the reply
+	 * is written to a dest file.
+	 */
+	bool use_reply_attachments () const;
+
     private:
-	static std::map <Glib::ustring, Factory> factory_map;
+	void dest_written (const Glib::RefPtr <FileOperationResult> & op_result,
+			   Glib::RefPtr <XmlResult> result);
 };
 
 #endif
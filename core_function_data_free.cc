@@ -11,8 +11,11 @@
 #include "xml_result_forbidden.h"
 #include "xml_result_internal_device_error.h"
 #include "file_handler.h"
+#include "async_file_handler.h"
+#include "deletion_service.h"
 #include "conf_handler.h"
 #include "id_mapper.h"
+#include "measurement_catalog.h"
 #include "utils.h"
 
 #include "core_function_data_free.h"
@@ -39,7 +42,7 @@ CoreFunctionDataFree::factory(XmlParameterList parameters,
         new CoreFunctionDataFree(parameters, description, text));
 }
 
-void CoreFunctionDataFree::set_deletion_flag() const
+void CoreFunctionDataFree::set_deletion_flag()
 {
     std::string path{_measurement_dir};
 
@@ -47,7 +50,8 @@ void CoreFunctionDataFree::set_deletion_flag() const
     path += _iid;
     path += "/.delete";
 
-    FileHandler::set_file(path, "To be deleted");
+    AsyncFileHandler::get_instance()->set_file(path, "To be deleted",
+        sigc::mem_fun(*this, &CoreFunctionDataFree::on_operation_done));
 }
 
 void CoreFunctionDataFree::free_iid_mapping(const std::string& iid) const
@@ -58,26 +62,57 @@ void CoreFunctionDataFree::free_iid_mapping(const std::string& iid) const
     } catch (const std::exception& ex) {
         PRINT_ERROR("Failed to remove mapping: " << ex.what());
     }
+
+    try {
+        MeasurementCatalog::get_instance()->remove(iid);
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Failed to remove catalog entry: " << ex.what());
+    }
 }
 
-void CoreFunctionDataFree::immediate_deletion() const
+void CoreFunctionDataFree::immediate_deletion()
 {
     std::string path{_measurement_dir};
+    auto deletion_service = DeletionService::get_instance();
 
     path += "/";
 
-    // two cases: iid given -> remove that dir, else remove all dirs...
-    if (!_iid.empty()) {
-        path += _iid;
-        FileHandler::remove_directory(path);
-        free_iid_mapping(_iid);
-    } else {
-        auto measurements = FileHandler::list_directory(path);
-        for (auto&& measurement : measurements) {
-            FileHandler::remove_directory(path + measurement);
-            free_iid_mapping(measurement);
+    // directories are moved to the trash at once and deleted in background
+    try {
+        // two cases: iid given -> remove that dir, else remove all dirs...
+        if (!_iid.empty()) {
+            deletion_service->remove(path + _iid);
+            free_iid_mapping(_iid);
+        } else {
+            auto measurements = FileHandler::list_directory(path);
+            for (auto&& measurement : measurements) {
+                deletion_service->remove(path + measurement);
+                free_iid_mapping(measurement);
+            }
         }
+    } catch (const std::exception& ex) {
+        XML_RESULT_NOT_FOUND("Could not flag measurement " << _iid << " for deletion");
+        return;
     }
+
+    XML_RESULT_OK("");
+}
+
+void CoreFunctionDataFree::on_operation_done(const Glib::RefPtr<FileOperationResult>& result)
+{
+    if (result->error()) {
+        PRINT_ERROR(result->error_msg());
+        XML_RESULT_NOT_FOUND("Could not flag measurement " << _iid << " for deletion");
+        return;
+    }
+
+    try {
+        MeasurementCatalog::get_instance()->set_flagged(_iid);
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Failed to flag catalog entry: " << ex.what());
+    }
+
+    XML_RESULT_OK("");
 }
 
 void CoreFunctionDataFree::start_call()
@@ -101,15 +136,8 @@ void CoreFunctionDataFree::start_call()
 
     _iid = iid_param ? iid_param->get_str() : "";
 
-    try {
-        if (enforce_deletion)
-            immediate_deletion();
-        else
-            set_deletion_flag();
-    } catch (const std::exception& ex) {
-        XML_RESULT_NOT_FOUND("Could not flag measurement " << _iid << " for deletion");
-        return;
-    }
-
-    XML_RESULT_OK("");
+    if (enforce_deletion)
+        immediate_deletion();
+    else
+        set_deletion_flag();
 }
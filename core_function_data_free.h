@@ -7,6 +7,7 @@
 #include <glibmm/ustring.h>
 
 #include "core_function_call.h"
+#include "file_operation_result.h"
 #include "xml_parameter_list.h"
 
 /**
@@ -37,9 +38,10 @@ private:
     std::string _measurement_dir;
     Glib::ustring _iid;
 
-    void immediate_deletion() const;
-    void set_deletion_flag() const;
+    void immediate_deletion();
+    void set_deletion_flag();
     void free_iid_mapping(const std::string& iid) const;
+    void on_operation_done(const Glib::RefPtr<FileOperationResult>& result);
 };
 
 #endif /* _CORE_FUNCTION_DATA_FREE_H_ */
@@ -4,6 +4,10 @@
 #include <string>
 #include <regex>
 #include <algorithm>
+#include <sstream>
+
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "xml_string_parameter.h"
 #include "xml_file.h"
@@ -19,6 +23,7 @@
 #include "log_handler.h"
 #include "conf_handler.h"
 #include "id_mapper.h"
+#include "export_checkpoints.h"
 #include "utils.h"
 
 #include "core_function_data_out.h"
@@ -55,6 +60,7 @@ void CoreFunctionDataOut::process_xml_params()
     const auto& output_param   = _parameters.get<XmlStringParameter>("output");
     const auto& protocol_param = _parameters.get<XmlStringParameter>("protocol");
     const auto& scheme_param   = _parameters.get<XmlStringParameter>("scheme");
+    const auto& mode_param     = _parameters.get<XmlStringParameter>("mode");
 
     _type     = type_param     ? type_param->get_str()     : "measurement";
     _id       = id_param       ? id_param->get_str()       : "";
@@ -63,6 +69,7 @@ void CoreFunctionDataOut::process_xml_params()
     _output   = output_param   ? output_param->get_str()   : "";
     _protocol = protocol_param ? protocol_param->get_str() : "";
     _scheme   = scheme_param   ? scheme_param->get_str()   : "";
+    _mode     = mode_param     ? mode_param->get_str()     : "full";
 
     _dest = FileDestination(dest_param ? dest_param->get_str() : "");
 }
@@ -82,6 +89,13 @@ bool CoreFunctionDataOut::check_valid_xml() const
     if (_type == "measurement" && _id.empty() && _iid.empty())
         return false;
 
+    // mode: incremental is only supported for log archives in folders
+    if (_mode != "full" && _mode != "incremental")
+        return false;
+    if (_mode == "incremental" &&
+        ((_type != "log" && _type != "monitor") || !_dest.is_file_based_dest()))
+        return false;
+
     return true;
 }
 
@@ -350,45 +364,114 @@ void CoreFunctionDataOut::start_socket_copying()
     }
 }
 
-void CoreFunctionDataOut::start_tar_process()
+std::vector<ArchiveEntry> CoreFunctionDataOut::create_archive_entries()
 {
-    // start tar process
+    auto conf_handler = ConfHandler::get_instance();
+    bool incremental  = _mode == "incremental";
+    std::vector<ArchiveEntry> entries;
+    std::stringstream manifest;
+
+    auto log_files = _type == "log" ?
+        conf_handler->getAllLogFiles() : conf_handler->getAllMonitorFiles();
+
+    manifest << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+             << "<manifest serial=\"" << xml_escape(get_serial_number())
+             << "\" type=\"" << xml_escape(_type)
+             << "\" dest=\"" << xml_escape(_dest.to_string())
+             << "\" mode=\"" << xml_escape(_mode) << "\" created=\""
+             << TimeUtilities::get_timestamp() << "\">\n";
+
+    _checkpoints.clear();
+    for (auto&& file : log_files) {
+        struct stat sb;
+
+        // missing files are reported by the archive writer
+        if (stat(file.c_str(), &sb) || !S_ISREG(sb.st_mode)) {
+            entries.emplace_back(file);
+            continue;
+        }
+
+        // only the delta since the last export to this destination,
+        // without a usable checkpoint the whole file is a new segment
+        goffset from = 0;
+        if (incremental) {
+            try {
+                from = ExportCheckpoints::get_instance()->get_offset(
+                    _dest.to_string(), _type, file, sb.st_ino, sb.st_size);
+            } catch (const std::exception& ex) {
+                PRINT_WARNING("Failed to read export checkpoint of " << file
+                              << ", exporting it completely: " << ex.what());
+            }
+        }
+        goffset length = sb.st_size - from;
+
+        if (!incremental || length > 0)
+            entries.emplace_back(file, from, length);
+
+        manifest << "  <file path=\"" << xml_escape(file)
+                 << "\" segment=\"" << (from ? "continued" : "new")
+                 << "\" from=\"" << from << "\" to=\"" << sb.st_size << "\"/>\n";
+
+        _checkpoints.push_back({ file, static_cast<guint64>(sb.st_ino), sb.st_size });
+    }
+    manifest << "</manifest>\n";
+
+    if (incremental)
+        entries.push_back(ArchiveEntry::from_memory("manifest.xml", manifest.str()));
+
+    return entries;
+}
+
+void CoreFunctionDataOut::commit_checkpoints()
+{
+    // a full export brings the destination up to date as well
+    try {
+        auto checkpoints = ExportCheckpoints::get_instance();
+
+        for (auto&& cp : _checkpoints)
+            checkpoints->set_offset(_dest.to_string(), _type, cp.file,
+                                    cp.inode, cp.offset);
+        checkpoints->save();
+    } catch (const std::exception& ex) {
+        PRINT_WARNING("Failed to save export checkpoints, next incremental "
+                      "export will repeat data: " << ex.what());
+    }
+}
+
+void CoreFunctionDataOut::start_archive_write()
+{
+    // pack log/monitor files in-process, no tar fork
     try {
         auto conf_handler = ConfHandler::get_instance();
-        std::vector<std::string> tar_args{"tar", "zcvf"};
-        std::vector<Glib::ustring> log_files;
         std::string serial = get_serial_number();
         std::string archive_name =
             serial + "__" + TimeUtilities::get_timestamp_log_format() + "." +
-            _type + ".tar.gz";
+            _type + (_mode == "incremental" ? ".incremental" : "") + ".tar.gz";
 
         auto folder = conf_handler->getFolder(_dest, _type);
         if (folder.size() != 1)
             EXCEPTION("Failed to get conf folder from zixconf.xml");
-	lHighDebug ("DataOut: starting tar process\n");
+	lHighDebug ("DataOut: starting archive writer\n");
         std::string root_folder = conf_handler->getRootFolder(_dest);
         std::string conf_folder = folder[0].path();
-        std::string path = root_folder + "/" + conf_folder + "/" + archive_name;
-
-        tar_args.emplace_back(path);
-
-        // get log files
-        if (_type == "log")
-            log_files = conf_handler->getAllLogFiles();
-        else
-            log_files = conf_handler->getAllMonitorFiles();
-        for (auto&& file : log_files)
-            tar_args.emplace_back(file);
-
-        // start process
-        _tar_proc = ProcessRequest::create(tar_args, ProcessRequest::DEFAULT_TIMEOUT);
-        _tar_proc->finished.connect(
-            sigc::mem_fun(*this, &CoreFunctionDataOut::on_tar_proc_finish));
-        _tar_proc->start_process();
+        std::string dir  = root_folder + "/" + conf_folder;
+        std::string path = dir + "/" + archive_name;
+
+        // make sure target directory exists
+        if (!FileHandler::directory_exists(dir))
+            FileHandler::create_directory(dir);
+
+        // start worker
+        _archive_req = ArchiveWriteRequest::create(
+            create_archive_entries(), path,
+            conf_handler->getArchiveCompressionLevel());
+        _archive_req->finished.connect(
+            sigc::mem_fun(*this, &CoreFunctionDataOut::on_archive_write_finish));
+        _archive_req->start_write();
     } catch (const std::exception& ex) {
         auto xml_res = XmlResultInternalDeviceError::create(
             Glib::ustring::compose(
-                "Starting tar process failed: %1", ex.what()));
+                "Starting archive creation failed: %1", ex.what()));
         finished.emit(xml_res);
     }
 }
@@ -544,20 +627,20 @@ void CoreFunctionDataOut::on_copy_proc_finish(
     finished.emit(xml_res);
 }
 
-void CoreFunctionDataOut::on_tar_proc_finish(
-    const Glib::RefPtr<ProcessResult>& result)
+void CoreFunctionDataOut::on_archive_write_finish(
+    const Glib::RefPtr<ArchiveWriteResult>& result)
 {
     // failure?
-    if (!result->get_exited_normally() ||
-            (result->get_child_status() != 0 &&
-             result->get_child_status() != 1)) {
+    if (result->error()) {
         auto xml_res = XmlResultInternalDeviceError::create(
-            Glib::ustring::compose("Tar process failed: %1",
-                                   result->error_reason()));
+            Glib::ustring::compose("Archive creation failed: %1",
+                                   result->error_msg()));
         finished.emit(xml_res);
         return;
     }
 
+    commit_checkpoints();
+
     // finished!
     auto xml_res = XmlResultOk::create();
     finished.emit(xml_res);
@@ -589,7 +672,7 @@ void CoreFunctionDataOut::type_dispatcher()
     // 3 Cases: log/monitor ; measurement ; conf
     if (_type == "log" || _type == "monitor") {
         if (_dest.is_file_based_dest())
-            start_tar_process();
+            start_archive_write();
         else if (_dest.is_socket_or_com_dest())
             start_socket_copying();
         else
@@ -14,6 +14,8 @@
 #include "process_result.h"
 #include "copy_file_request.h"
 #include "copy_file_result.h"
+#include "archive_write_request.h"
+#include "archive_write_result.h"
 #include "post_processing_builder.h"
 #include "file_destination.h"
 #include "copy_queue_entry.h"
@@ -44,11 +46,22 @@ public:
 						   const xmlpp::Element * en);
 
 private:
+    /**
+     * Export state of one log file, committed to ExportCheckpoints once
+     * the archive has been written.
+     */
+    struct LogCheckpoint
+    {
+        std::string file;
+        guint64 inode;
+        goffset offset;
+    };
+
     Glib::RefPtr<ProcessRequest> _post_proc;
     Glib::RefPtr<ProcessRequest> _lp_proc;
     Glib::RefPtr<ProcessRequest> _copy_proc;
-    Glib::RefPtr<ProcessRequest> _tar_proc;
     Glib::RefPtr<CopyFileRequest> _copy_req;
+    Glib::RefPtr<ArchiveWriteRequest> _archive_req;
     Glib::RefPtr<SignatureCreationRequest> _sig_req;
     Glib::ustring _type;
     Glib::ustring _id;
@@ -57,9 +70,11 @@ private:
     Glib::ustring _output;
     Glib::ustring _protocol;
     Glib::ustring _scheme;
+    Glib::ustring _mode;
     FileDestination _dest;
     PostProcessingBuilder::PostProcessingQueue _pp_queue;
     CopyQueue _copy_queue;
+    std::vector<LogCheckpoint> _checkpoints;
     std::size_t _post_proc_idx;
     std::size_t _copy_req_idx;
     std::string _serial_number;
@@ -75,20 +90,22 @@ private:
     std::string get_serial_number();
     std::string create_config_xml();
     void type_dispatcher();
+    std::vector<ArchiveEntry> create_archive_entries();
+    void commit_checkpoints();
 
     void start_postprocessing();
     void start_copying();
     void start_printer_copying();
     void start_file_copying();
     void start_socket_copying();
-    void start_tar_process();
+    void start_archive_write();
     void return_local_printer_result ();
     void start_signature_creation(const std::string& xml_file);
 
     void on_post_proc_finish(const Glib::RefPtr<ProcessResult>& result);
     void on_lp_proc_finish(const Glib::RefPtr<ProcessResult>& result);
     void on_copy_proc_finish(const Glib::RefPtr<ProcessResult>& result);
-    void on_tar_proc_finish(const Glib::RefPtr<ProcessResult>& result);
+    void on_archive_write_finish(const Glib::RefPtr<ArchiveWriteResult>& result);
     void on_copy_finish(const Glib::RefPtr<CopyFileResult>& result);
     void on_signature_creation_finish(const Glib::RefPtr<SignatureCreationResult>& result);
 };
@@ -16,6 +16,7 @@
 #include "file_handler.h"
 #include "conf_handler.h"
 #include "id_mapper.h"
+#include "measurement_catalog.h"
 #include "utils.h"
 
 #include "core_function_data_sync.h"
@@ -181,6 +182,15 @@ void CoreFunctionDataSync::add_id_mapping(const Glib::ustring& id) const
     }
 }
 
+void CoreFunctionDataSync::update_catalog() const
+{
+    try {
+        MeasurementCatalog::get_instance()->update(_iid);
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Updating measurement catalog failed: " << ex.what());
+    }
+}
+
 void CoreFunctionDataSync::handle_xml(const std::string& file_name)
 {
     auto measurement_param = _parameters.get<XmlMeasurement>("measurement");
@@ -199,8 +209,10 @@ void CoreFunctionDataSync::handle_xml(const std::string& file_name)
 
 void CoreFunctionDataSync::handle_img(const std::string& file_name)
 {
-    // base64 decode
-    std::string decoded = FileHandler::base64_decode(_textbody);
+    // raw image in the request attachment or base64 encoded in the body
+    SharedBuffer decoded = _attachment
+        ? attachment_buffer(0, _attachment->get_size())
+        : SharedBuffer(FileHandler::base64_decode(_textbody));
 
     // write file, but asyncly
     _write_req = WriteFileRequest::create(file_name, decoded);
@@ -255,6 +267,9 @@ void CoreFunctionDataSync::on_write_finish(const Glib::RefPtr<WriteFileResult>&
     // write complete -> add mapping
     add_id_mapping();
 
+    // write complete -> account new size
+    update_catalog();
+
     // file write complete! Done?
     if (_dap.empty() && _car.empty()) {
         XML_RESULT_OK("");
@@ -355,6 +370,9 @@ void CoreFunctionDataSync::on_car_finish(const Glib::RefPtr<ProcessResult>& resu
 
     _ret_value.emplace_back(msg);
 
+    // account created results
+    update_catalog();
+
     // done!
     XML_RESULT_OK_RET("", _ret_value);
 }
@@ -62,6 +62,7 @@ private:
     PostProcessor get_postprocessor(const std::string& format) const;
     StringPair split_car_attribute() const;
     void add_id_mapping(const Glib::ustring& id = "") const;
+    void update_catalog() const;
     StringPair get_and_strip_id(const std::string& stdout) const;
     void delete_post_processing_results() const;
 
@@ -101,63 +101,58 @@ void CoreFunctionGetFile::handle_one_file(const Glib::RefPtr<XmlFile>& file)
             sigc::mem_fun(*this, &CoreFunctionGetFile::on_write_query_finish));
         dc->execute(_write_query);
     } else {
-        _read_proc = ReadFileRequest::create(file->get_id());
-        _read_proc->finished.connect(
-            sigc::mem_fun(*this, &CoreFunctionGetFile::on_read_finish));
-        _read_proc->start_read();
+        try {
+            add_local_file(file);
+        } catch (const std::exception& ex) {
+            XML_RESULT_NOT_FOUND(ex.what());
+            return;
+        }
+
+        next_file();
     }
 }
 
-void CoreFunctionGetFile::on_write_query_finish(
-    const Glib::RefPtr<XmlResult>& result)
+void CoreFunctionGetFile::add_local_file(const Glib::RefPtr<XmlFile>& file)
 {
-    // failure?
-    if (result->get_status() != 200) {
-        PRINT_ERROR("GetFile on DC failed");
-        call_finished(result);
-        return;
-    }
+    Glib::ustring head;
 
-    // save data
-    _return_values.push_back(result->to_body());
+    if (file->get_host().empty())
+        head = Glib::ustring::compose("<file id=\"%1\">", file->get_id());
+    else
+        head = Glib::ustring::compose("<file host=\"%1\" id=\"%2\">",
+                                      file->get_host(), file->get_id());
 
-    // start next read
+    if (use_reply_attachments())
+        _result->add_file_attachment(file->get_id(), head, "</file>");
+    else
+        _result->add_file_base64(file->get_id(), head, "</file>", head + "</file>");
+}
+
+void CoreFunctionGetFile::next_file()
+{
     if (++_proc_read_it != _files.cend()) {
         handle_one_file(*_proc_read_it);
         return;
     }
 
-    XML_RESULT_OK_RET("", _return_values);
+    call_finished(_result);
 }
 
-void CoreFunctionGetFile::on_read_finish(const Glib::RefPtr<ReadFileResult>& result)
+void CoreFunctionGetFile::on_write_query_finish(
+    const Glib::RefPtr<XmlResult>& result)
 {
     // failure?
-    if (result->error()) {
-        XML_RESULT_NOT_FOUND(result->error_msg());
+    if (result->get_status() != 200) {
+        PRINT_ERROR("GetFile on DC failed");
+        call_finished(result);
         return;
     }
 
     // save data
-    auto encoded = FileHandler::base64_encode(result->content());
-    const auto& file = *_proc_read_it;
-
-    if (file->get_host().empty())
-        _return_values.push_back(
-            Glib::ustring::compose("<file id=\"%1\">%2</file>",
-                                   file->get_id(), encoded));
-    else
-        _return_values.push_back(
-            Glib::ustring::compose("<file host=\"%1\" id=\"%2\">%3</file>",
-                                   file->get_host(), file->get_id(), encoded));
-
-    // continue with next file
-    if (++_proc_read_it != _files.cend()) {
-        handle_one_file(*_proc_read_it);
-        return;
-    }
+    _result->add_text(result->to_body());
 
-    XML_RESULT_OK_RET("", _return_values);
+    // start next read
+    next_file();
 }
 
 void CoreFunctionGetFile::start_call()
@@ -176,6 +171,8 @@ void CoreFunctionGetFile::start_call()
 
         check_file_list();
 
+        _result = XmlResultStream::create();
+
         // Exporting roofs for SIC does not make sense, way to big
         if (!_files.size() && ( host_param->get_str() == "SIC" ) )
             EXCEPTION("Cant export whole root file system. Too large.");
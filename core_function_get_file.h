@@ -10,8 +10,7 @@
 
 #include "core_function_call.h"
 #include "xml_parameter_list.h"
-#include "read_file_request.h"
-#include "read_file_result.h"
+#include "xml_result_stream.h"
 #include "query_client.h"
 #include "xml_file.h"
 
@@ -27,6 +26,8 @@
  *
  * Parameters: Host (DC || SIC) ; File(s) ; Id
  *
+ * Local files are not read into memory, they are base64 encoded in
+ * chunks while the reply is written, see XmlResultStream.
  */
 class CoreFunctionGetFile : public CoreFunctionCall
 {
@@ -46,18 +47,18 @@ public:
 						    const xmlpp::Element * en);
 
 private:
-    Glib::RefPtr<ReadFileRequest> _read_proc;
     Glib::RefPtr<Query> _write_query;
+    Glib::RefPtr<XmlResultStream> _result;
     std::list<Glib::RefPtr<XmlFile> > _files;
     std::list<Glib::RefPtr<XmlFile> >::const_iterator _proc_read_it;
-    std::vector<Glib::ustring> _return_values;
 
     void addDirectory( Glib::ustring directoryName);
     void check_file_list() const;
 
-    void on_read_finish(const Glib::RefPtr<ReadFileResult>& result);
     void on_write_query_finish(const Glib::RefPtr<XmlResult>& result);
     void handle_one_file(const Glib::RefPtr<XmlFile>& file);
+    void add_local_file(const Glib::RefPtr<XmlFile>& file);
+    void next_file();
 };
 
 #endif /* _CORE_FUNCTION_GET_FILE_H_ */
@@ -7,6 +7,7 @@
 #include "xml_result_not_found.h"
 #include "file_handler.h"
 #include "id_mapper.h"
+#include "measurement_catalog.h"
 #include "utils.h"
 
 #include "core_function_get_measurement.h"
@@ -138,24 +139,49 @@ void CoreFunctionGetMeasurement::on_post_proc_finished(
         return;
     }
 
-    // done with post processing -> read generated files
+    // done with post processing -> account results, read generated files
+    try {
+        auto catalog = MeasurementCatalog::get_instance();
+        std::string last_iid;
+
+        for (auto&& entry : _pp_queue) {
+            if (entry.iid == last_iid)
+                continue;
+            catalog->update(entry.iid);
+            last_iid = entry.iid;
+        }
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Updating measurement catalog failed: " << ex.what());
+    }
+
     start_reading();
 }
 
 void CoreFunctionGetMeasurement::start_reading()
 {
     PRINT_DEBUG ("CoreFunctionGetMeasurement::start_reading()");
-    _pp_it = _pp_queue.cbegin();
 
-    const auto& entry = *_pp_it;
-    _read_req = ReadFileRequest::create(entry.generated_file);
-    _read_req->finished.connect(
-        sigc::mem_fun(*this, &CoreFunctionGetMeasurement::on_read_finished));
-    _read_req->start_read();
+    /* the generated files are encoded while the reply is written
+     */
+    _result = XmlResultStream::create();
+
+    try {
+        for (auto&& entry : _pp_queue)
+            _result->add_file_base64(entry.generated_file,
+                                     build_result_xml(entry, false),
+                                     "</measurement>\n",
+                                     build_result_xml(entry, true));
+    } catch (const std::exception& ex) {
+        XML_RESULT_NOT_FOUND("Read measurement failed: " << ex.what());
+        return;
+    }
+
+    // done!
+    call_finished(_result);
 }
 
 Glib::ustring CoreFunctionGetMeasurement::build_result_xml(
-    const PostProcessingEntry& entry, const std::string& content) const
+    const PostProcessingEntry& entry, bool empty) const
 {
     Glib::ustring ret;
 
@@ -166,43 +192,14 @@ Glib::ustring CoreFunctionGetMeasurement::build_result_xml(
         ret += Glib::ustring::compose("iid=\"%1\" ", entry.iid);
     if (!entry.format.empty())
         ret += Glib::ustring::compose("format=\"%1\" ", entry.format);
-    if (!content.empty())
-        ret += Glib::ustring::compose(">\n%1</measurement>\n", content);
+    if (!empty)
+        ret += ">\n";
     else
         ret += "/>\n";
 
     return ret;
 }
 
-void CoreFunctionGetMeasurement::on_read_finished(
-    const Glib::RefPtr<ReadFileResult>& result)
-{
-    PRINT_DEBUG ("CoreFunctionGetMeasurement::on_read_finished()");
-    if (result->error()) {
-        XML_RESULT_NOT_FOUND("Read measurement failed: " << result->error_msg());
-        return;
-    }
-
-    // save content
-    const auto& entry       = *_pp_it;
-    auto        encoded     = FileHandler::base64_encode(result->content());
-    _return_values.emplace_back(build_result_xml(entry, encoded));
-
-    // start with next file
-    ++_pp_it;
-    if (_pp_it != _pp_queue.cend()) {
-        _read_req = ReadFileRequest::create(_pp_it->generated_file);
-        _read_req->finished.connect(
-            sigc::mem_fun(*this, &CoreFunctionGetMeasurement::on_read_finished));
-        _read_req->start_read();
-
-        return;
-    }
-
-    // done!
-    XML_RESULT_OK_RET("", _return_values);
-}
-
 void CoreFunctionGetMeasurement::start_call()
 {
     process_xml_params();
@@ -11,8 +11,7 @@
 #include "xml_parameter_list.h"
 #include "xml_measurement.h"
 #include "xml_result.h"
-#include "read_file_request.h"
-#include "read_file_result.h"
+#include "xml_result_stream.h"
 #include "process_request.h"
 #include "process_result.h"
 #include "post_processing_builder.h"
@@ -41,8 +40,7 @@ private:
     std::list<Glib::RefPtr<XmlMeasurement> > _measurements;
     PostProcessingBuilder::PostProcessingQueue _pp_queue;
     PostProcessingBuilder::PostProcessingQueue::const_iterator _pp_it;
-    std::vector<Glib::ustring> _return_values;
-    Glib::RefPtr<ReadFileRequest> _read_req;
+    Glib::RefPtr<XmlResultStream> _result;
     Glib::RefPtr<ProcessRequest> _pp_proc;
     Glib::ustring _id;
     Glib::ustring _iid;
@@ -50,13 +48,12 @@ private:
 
     void process_xml_params();
     void build_pp_queue();
-    Glib::ustring build_result_xml(const PostProcessingEntry& entry, const std::string& content) const;
+    Glib::ustring build_result_xml(const PostProcessingEntry& entry, bool empty) const;
 
     void start_reading();
     void start_post_processing();
     void start_post_proc();
 
-    void on_read_finished(const Glib::RefPtr<ReadFileResult>& result);
     void on_post_proc_finished(const Glib::RefPtr<ProcessResult>& result);
 };
 
@@ -13,6 +13,7 @@
 #include "xml_query_set_file.h"
 #include "query_client.h"
 #include "file_handler.h"
+#include "base64_codec.h"
 #include "utils.h"
 
 CoreFunctionSetFile::CoreFunctionSetFile(
@@ -50,8 +51,13 @@ void CoreFunctionSetFile::check_file_list() const
         if (id.empty())
             EXCEPTION("No <id> for file given");
 
-        if (content.empty())
+        if (content.empty() &&
+            !(file->has_attachment() && file->get_attachment_size()))
             EXCEPTION("No content for file given");
+
+        if (file->has_attachment())
+            check_attachment_range(file->get_attachment_offset(),
+                                   file->get_attachment_size());
     }
 
     if (!_files.size())
@@ -69,7 +75,9 @@ void CoreFunctionSetFile::handle_one_file(Glib::RefPtr<XmlFile> file)
     const auto& update_param = _parameters.get<XmlStringParameter>("update");
 
     if (host == "SIC") {
-        const auto decoded = FileHandler::base64_decode(file->get_content());
+        SharedBuffer decoded = file->has_attachment()
+            ? attachment_buffer(file->get_attachment_offset(), file->get_attachment_size())
+            : SharedBuffer(FileHandler::base64_decode(file->get_content()));
         _write_proc = WriteFileRequest::create(file->get_id(), decoded);
         _write_proc->finished.connect(
             sigc::mem_fun(*this, &CoreFunctionSetFile::on_write_finish));
@@ -78,6 +86,11 @@ void CoreFunctionSetFile::handle_one_file(Glib::RefPtr<XmlFile> file)
         auto dc = QueryClient::get_instance();
 	Glib::RefPtr <XmlQuery> xq;
 
+        // the DC only understands base64 content
+        if (file->has_attachment() && file->get_content().empty())
+            file->get_content() = Base64Codec::encode(
+                attachment_range(file->get_attachment_offset(), file->get_attachment_size()));
+
 	if (update_param)
 	    xq = XmlQuerySetFile::create (file, update_param->get_str());
 	else
@@ -273,11 +273,12 @@ CoreFunctionUpdate::get_encoded_image ()
          * content is uuencoded file data, we can just return it.
          */
         return _image_param->get_content ();
-    } else if (_image_param->get_type () == "file") {
-        auto file = update_image_path();
-        auto file_content = FileHandler::get_file(file);
-
-        return FileHandler::base64_encode(file_content);
+    } else if (_image_param->get_type () == "file" && _image) {
+        /* file image:
+         * send the bytes, which have been verified, the file may have
+         * changed in the meantime.
+         */
+        return FileHandler::base64_encode(*_image);
     } else {
         /* shall never be reached
          */
@@ -339,13 +340,18 @@ void CoreFunctionUpdate::on_reboot_query_finish(const Glib::RefPtr<XmlResult>& r
 void CoreFunctionUpdate::handle_dc()
 {
     try {
-        /* first make sure the data is residing in a file
+        /* read the image once, it is verified and sent from memory
          */
-        _sig_verify_fname = ensure_image_in_file ("/tmp/dcfirmware");
+        if (_image_param->get_type () == "binary")
+            _image = std::make_shared<const std::string>(FileHandler::base64_decode (_image_param->get_content ()));
+        else if (_image_param->get_type () == "file")
+            _image = std::make_shared<const std::string>(FileHandler::get_file (update_image_path ()));
+        else
+            EXCEPTION("Unknown image type: " << _image_param->get_type ());
 
         /* now create request
          */
-        _sig_verify_proc = UpdateSignatureCheckRequest::create (_sig_verify_fname, _image_param->get_signature ());
+        _sig_verify_proc = UpdateSignatureCheckRequest::create (_image, _image_param->get_signature ());
         _sig_verify_proc->finished.connect (
             sigc::mem_fun(*this, &CoreFunctionUpdate::on_dc_signature_verified));
         _sig_verify_proc->start_check ();
@@ -357,14 +363,6 @@ void CoreFunctionUpdate::handle_dc()
 
 void CoreFunctionUpdate::on_dc_signature_verified (const Glib::RefPtr <SignatureCheckResult> & result)
 {
-    /* check, whether we need to cleanup the update
-     * file that was written to disk from the xml base64 encoded
-     * stuff
-     */
-    if (_sig_verify_fname == "/tmp/dcfirmware") {
-        FileHandler::del_file ("/tmp/dcfirmware");
-    }
-
     /* now check verification result
      */
     if (!result->result ()) {
@@ -380,6 +378,7 @@ void CoreFunctionUpdate::on_dc_signature_verified (const Glib::RefPtr <Signature
      */
     auto dc = QueryClient::get_instance();
     auto encoded_image = get_encoded_image ();
+    _image.reset();
 
     if (encoded_image.empty()) {
         XML_RESULT_INTERNAL_DEVICE_ERROR("Unable to obtain image data");
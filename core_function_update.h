@@ -2,6 +2,7 @@
 #define _CORE_FUNCTION_UPDATE_H_
 
 #include <string>
+#include <memory>
 
 #include <glibmm/refptr.h>
 #include <glibmm/ustring.h>
@@ -51,7 +52,7 @@ private:
     Glib::RefPtr<ProcessRequest> _update_proc;
 
     Glib::RefPtr<UpdateSignatureCheckRequest> _sig_verify_proc;
-    Glib::ustring _sig_verify_fname;
+    std::shared_ptr<const std::string> _image;
 
     bool check_xml_and_get_values();
     void handle_sic();
@@ -0,0 +1,766 @@
+//-----------------------------------------------------------------------------
+///
+/// \brief  Simulated devicecontroller
+///
+///         Plays the role of the devicecontroller on a pty, so the daemon can
+///         be load tested without hardware. The daemon opens the slave side
+///         like the real serial device (see sim_dc.cc).
+///
+///         Both IPC protocols are spoken:
+///
+///             * framed RS422 protocol of SerialInterfaceHandler; every
+///               payload frame gets confirmed, wrong CRCs are NAKed and
+///               unconfirmed frames are resent.
+///             * length prefixed protocol of UsbInterfaceHandler.
+///
+///         Every <function/> is answered with a canned <reply/> after a
+///         configurable latency per fid. Replies are taken from a file per
+///         fid, from "<fid>.xml" of a directory (e.g. responsexmls/) or
+///         are a plain status 200.
+///
+///         The link can be throttled to a baud rate (10 bits per byte) in
+///         both directions and CRC errors can be injected into the frames
+///         sent and received.
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>                  // O_RDWR
+#include <unistd.h>
+#include <termios.h>                // cfmakeraw
+#include <sys/stat.h>
+#include <arpa/inet.h>              // ntohl, htonl
+#include <algorithm>
+#include <libxml++/libxml++.h>
+
+//---Own------------------------------
+
+#include "dc_simulator.h"
+#include "crc32.h"
+#include "file_handler.h"
+#include "xml_helpers.h"
+#include "log.h"
+#include "utils.h"
+
+
+//---Defines-------------------------------------------------------------------
+
+
+#define DC_SIMULATOR_READ_SIZE              0x1000
+#define DC_SIMULATOR_PACE_INTERVAL          10      // ms
+#define DC_SIMULATOR_CONFIRMATION_TIMEOUT   500     // ms, like the daemon
+#define DC_SIMULATOR_ERROR_MAX              3
+#define DC_SIMULATOR_TIMEOUT_MAX            5
+#define DC_SIMULATOR_DEFAULT_REPLY          "<reply status=\"200\"/>"
+
+
+//---Implementation------------------------------------------------------------
+
+
+DcSimulator::DcSimulator( const SDcSimulatorConfig &_config )
+    : config(_config)
+    , rng(_config.seed)
+    , masterFd(-1)
+    , slaveFd(-1)
+    , txActive(false)
+    , waitForAck(false)
+    , currentMid(0)
+    , errorCounter(0)
+    , timeoutCounter(0)
+    , busy(false)
+{
+    if( config.maxPayloadSize <= 0 )
+        config.maxPayloadSize=SERIAL_MAX_PAYLOAD_SIZE;
+
+    senderMessage=Glib::RefPtr<CSerialMessage> ( new CSerialMessage( config.maxPayloadSize ) );
+    receiverMessage=Glib::RefPtr<CSerialMessage> ( new CSerialMessage( config.maxPayloadSize ) );
+
+    // Fail early on broken response files
+    for( auto &&profile : config.profiles )
+    {
+        if( !profile.second.response.empty() )
+            responses[profile.first]=loadResponse( profile.second.response );
+    }
+
+    openPty();
+
+    rxConnection=Glib::signal_io().connect(sigc::mem_fun(*this, &DcSimulator::onInput),
+                                           masterFd, Glib::IO_IN);
+}
+
+
+Glib::RefPtr<DcSimulator> DcSimulator::create( const SDcSimulatorConfig &_config ) /* static */
+{
+    return( Glib::RefPtr<DcSimulator>( new DcSimulator( _config ) ) );
+}
+
+
+DcSimulator::~DcSimulator()
+{
+    rxConnection.disconnect();
+    rxPauseConnection.disconnect();
+    txConnection.disconnect();
+    confirmationConnection.disconnect();
+
+    if( !config.link.empty() )
+        unlink( config.link.c_str() );
+
+    if( slaveFd >= 0 )
+        close( slaveFd );
+    if( masterFd >= 0 )
+        close( masterFd );
+}
+
+
+/// \brief  Create the pty pair
+///
+///         The slave stays open, so the master does not see a hangup while
+///         the daemon reopens the device. It is put into raw mode before the
+///         daemon configures it, otherwise early frames would be echoed.
+void DcSimulator::openPty()
+{
+    struct termios settings;
+    struct stat sb;
+
+    masterFd=posix_openpt( O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC );
+    if( masterFd < 0 )
+        EXCEPTION("Could not open pty: " << strerror(errno));
+
+    if( grantpt( masterFd ) || unlockpt( masterFd ) || !ptsname( masterFd ) )
+        EXCEPTION("Could not unlock pty: " << strerror(errno));
+
+    slaveName=ptsname( masterFd );
+
+    slaveFd=open( slaveName.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC );
+    if( slaveFd < 0 )
+        EXCEPTION("Could not open " << slaveName << ": " << strerror(errno));
+
+    tcgetattr( slaveFd, &settings );
+    cfmakeraw( &settings );
+    tcsetattr( slaveFd, TCSANOW, &settings );
+
+    if( config.link.empty() )
+        return;
+
+    if( !lstat( config.link.c_str(), &sb ) )
+    {
+        if( !S_ISLNK( sb.st_mode ) )
+            EXCEPTION("Will not replace " << config.link << ", it is no symlink");
+        unlink( config.link.c_str() );
+    }
+
+    if( symlink( slaveName.c_str(), config.link.c_str() ) )
+        EXCEPTION("Could not link " << config.link << ": " << strerror(errno));
+}
+
+
+bool DcSimulator::chance( double rate )
+{
+    if( rate <= 0 )
+        return( false );
+
+    return( std::uniform_real_distribution<double>(0, 1)( rng ) < rate );
+}
+
+
+//---Link----------------------------------------------------------------------
+
+
+bool DcSimulator::onInput( Glib::IOCondition condition )
+{
+    char buffer[DC_SIMULATOR_READ_SIZE];
+    gsize max=sizeof(buffer);
+    ssize_t ret;
+
+    (void)condition;
+
+    // Take only what the line could have transported since the last read
+    if( config.baud > 0 )
+        max=std::min<gsize>( max, std::max( 1, config.baud / 1000 ) );
+
+    ret=read( masterFd, buffer, max );
+    if( ret < 0 )
+    {
+        if( errno != EAGAIN && errno != EINTR )
+            lError("DcSimulator: read failed: %s\n", strerror(errno));
+        return( true );
+    }
+
+    rxData.append( buffer, ret );
+    stats.bytesReceived+=ret;
+
+    if( config.protocol == eDcSimulatorProtocolUsb )
+        handleUsbInput();
+    else
+        handleFramedInput();
+
+    if( config.baud > 0 )
+    {
+        rxPauseConnection=Glib::signal_timeout().connect(
+            sigc::mem_fun(*this, &DcSimulator::onResumeInput), DC_SIMULATOR_PACE_INTERVAL);
+        return( false );
+    }
+
+    return( true );
+}
+
+
+bool DcSimulator::onResumeInput()
+{
+    rxConnection=Glib::signal_io().connect(sigc::mem_fun(*this, &DcSimulator::onInput),
+                                           masterFd, Glib::IO_IN);
+    return( false );
+}
+
+
+gsize DcSimulator::writeOutput( gsize max )
+{
+    ssize_t ret;
+
+    ret=write( masterFd, txData.data(), std::min( max, txData.size() ) );
+    if( ret < 0 )
+    {
+        if( errno != EAGAIN && errno != EINTR )
+            lError("DcSimulator: write failed: %s\n", strerror(errno));
+        return( 0 );
+    }
+
+    txData.erase( 0, ret );
+    stats.bytesSent+=ret;
+
+    return( ret );
+}
+
+
+bool DcSimulator::onOutput( Glib::IOCondition condition )
+{
+    (void)condition;
+
+    writeOutput( txData.size() );
+    if( !txData.empty() )
+        return( true );
+
+    txActive=false;
+    return( false );
+}
+
+
+bool DcSimulator::onOutputPaced()
+{
+    writeOutput( std::max( 1, config.baud / 1000 ) );
+    if( !txData.empty() )
+        return( true );
+
+    txActive=false;
+    return( false );
+}
+
+
+void DcSimulator::queueOutput( const std::string &data )
+{
+    txData+=data;
+    flushOutput();
+}
+
+
+void DcSimulator::flushOutput()
+{
+    if( txActive || txData.empty() )
+        return;
+
+    if( config.baud > 0 )
+    {
+        txActive=true;
+        if( onOutputPaced() )
+            txConnection=Glib::signal_timeout().connect(
+                sigc::mem_fun(*this, &DcSimulator::onOutputPaced), DC_SIMULATOR_PACE_INTERVAL);
+        return;
+    }
+
+    writeOutput( txData.size() );
+    if( txData.empty() )
+        return;
+
+    // pty buffer is full, continue when the daemon has read
+    txActive=true;
+    txConnection=Glib::signal_io().connect(sigc::mem_fun(*this, &DcSimulator::onOutput),
+                                           masterFd, Glib::IO_OUT);
+}
+
+
+//---USB protocol--------------------------------------------------------------
+
+
+void DcSimulator::handleUsbInput()
+{
+    while( rxData.size() >= sizeof(guint32) )
+    {
+        guint32 size;
+
+        memcpy( &size, rxData.data(), sizeof(size) );
+        size=ntohl( size );
+
+        if( rxData.size() < sizeof(size) + size )
+            break;
+
+        std::string payload=rxData.substr( sizeof(size), size );
+        rxData.erase( 0, sizeof(size) + size );
+        stats.framesReceived++;
+
+        handleMessage( payload );
+    }
+}
+
+
+//---Framed protocol-----------------------------------------------------------
+
+
+void DcSimulator::handleFramedInput()
+{
+    const gsize minSize=sizeof(SSerialHeader) + sizeof(SSerialFooter);
+
+    for(;;)
+    {
+        gsize start=rxData.find( (char)eSerialCodeStart );
+        if( start == std::string::npos )
+        {
+            rxData.clear();
+            return;
+        }
+        if( start )
+        {
+            lError("DcSimulator: %d bytes out of frame\n", (int)start);
+            rxData.erase( 0, start );
+        }
+
+        gsize stop=rxData.find( (char)eSerialCodeStop, sizeof(SSerialHeader) );
+        if( stop == std::string::npos )
+            return;
+
+        std::string frame=rxData.substr( 0, stop + 1 );
+        rxData.erase( 0, stop + 1 );
+
+        if( frame.size() < minSize )
+        {
+            lError("DcSimulator: dropping short frame\n");
+            continue;
+        }
+
+        digestFrame( frame );
+    }
+}
+
+
+static int parseAscii( const char *data, gsize size, int base )
+{
+    std::string str( data, size );
+
+    return( strtol( str.c_str(), NULL, base ) );
+}
+
+
+void DcSimulator::digestFrame( const std::string &frame )
+{
+    const SSerialHeader *header=(const SSerialHeader *)frame.data();
+    const SSerialFooter *footer=(const SSerialFooter *)&frame.data()[ frame.size() - sizeof(*footer) ];
+    gsize payloadSize=frame.size() - sizeof(*header) - sizeof(*footer);
+    std::string payload=frame.substr( sizeof(*header), payloadSize );
+
+    int mid=parseAscii( header->asciiMid, sizeof(header->asciiMid), 10 );
+    int i=parseAscii( header->asciiIndex, sizeof(header->asciiIndex), 10 );
+    int n=parseAscii( header->asciiNumber, sizeof(header->asciiNumber), 10 );
+    guint32 crc32Value=strtoul( std::string( footer->crc32, sizeof(footer->crc32) ).c_str(), NULL, 16 );
+    guint32 crc32Should=crc32( 0, frame.data(), sizeof(*header) + payloadSize );
+
+    stats.framesReceived++;
+
+    if( header->type == eSerialCodePayload )
+    {
+        bool injected=chance( config.rxCrcErrorRate );
+
+        if( injected || crc32Value != crc32Should )
+        {
+            if( injected )
+                stats.crcErrorsInjected++;
+            sendConfirmFrame( mid, i, n, eSerialCodeNAK, "CS" );
+            receiverMessage->discard();
+            return;
+        }
+
+        if( i == 1 )
+            receiverMessage->initReceiverMessage( n );
+        receiverMessage->pushFrame( i, n, payload );
+
+        sendConfirmFrame( mid, i, n, eSerialCodeACK, NULL );
+
+        if( receiverMessage->messageFinished() )
+        {
+            Glib::ustring message=receiverMessage->getPayload();
+
+            receiverMessage->discard();
+            handleMessage( message );
+        }
+        return;
+    }
+
+    if( header->type != eSerialCodeConfirmation )
+    {
+        lError("DcSimulator: unknown frame type 0x%02X\n", header->type);
+        return;
+    }
+
+    if( crc32Value != crc32Should )
+    {
+        // like the daemon; nothing we can do about it
+        lError("DcSimulator: confirmation with wrong CRC\n");
+        return;
+    }
+
+    if( !waitForAck )
+    {
+        lError("DcSimulator: got confirmation without waiting for one\n");
+        return;
+    }
+
+    confirmationConnection.disconnect();
+
+    if( payload.empty() || payload[0] != eSerialCodeACK || mid != currentMid )
+    {
+        stats.naksReceived++;
+
+        if( errorCounter < DC_SIMULATOR_ERROR_MAX )
+        {
+            errorCounter++;
+            resendPayloadFrame();
+            return;
+        }
+
+        lError("DcSimulator: giving up on message for tid %d\n", senderMessage->tid());
+        stats.dropped++;
+        senderMessage->discard();
+        waitForAck=false;
+        errorCounter=0;
+        timeoutCounter=0;
+        sendLoop();
+        return;
+    }
+
+    errorCounter=0;
+    timeoutCounter=0;
+    waitForAck=false;
+
+    if( senderMessage->dataLeft() )
+    {
+        sendPayloadFrameFromMessage();
+        return;
+    }
+
+    stats.replies++;
+    sendLoop();
+}
+
+
+/// \brief  Send a frame, see SerialInterfaceHandler::sendFrame()
+void DcSimulator::sendFrame( int mid, int type, int i, int n, const std::string &str, bool wrongCrc )
+{
+    char header[sizeof(SSerialHeader) + 1];
+    char footer[sizeof(SSerialFooter) + 1];
+    guint32 crc32Value;
+    std::string frame;
+
+    snprintf( header, sizeof(header), "%c%c%04d%04d%04d",
+              (char)eSerialCodeStart, (char)type, mid, i, n );
+
+    frame.reserve( sizeof(SSerialHeader) + str.size() + sizeof(SSerialFooter) );
+    frame.append( header, sizeof(SSerialHeader) );
+    frame+=str;
+
+    crc32Value=crc32( 0, frame.data(), frame.size() );
+    if( wrongCrc )
+    {
+        crc32Value^=1;
+        stats.crcErrorsInjected++;
+    }
+
+    snprintf( footer, sizeof(footer), "%08X%c", crc32Value, (char)eSerialCodeStop );
+    frame.append( footer, sizeof(SSerialFooter) );
+
+    stats.framesSent++;
+    queueOutput( frame );
+}
+
+
+void DcSimulator::sendConfirmFrame( int mid, int i, int n, ESerialCode ack, const char *code )
+{
+    std::string str;
+
+    str.push_back( (char)ack );
+    if( ack != eSerialCodeACK )
+    {
+        str+=code;
+        stats.naksSent++;
+    }
+
+    sendFrame( mid, eSerialCodeConfirmation, i, n, str, false );
+}
+
+
+void DcSimulator::sendPayloadFrameFromMessage()
+{
+    senderMessage->popFrame();
+
+    currentMid=( currentMid + 1 ) % 1000;
+    waitForAck=true;
+
+    resendPayloadFrame();
+}
+
+
+/// \brief  (Re-)send the current frame of senderMessage
+///
+///         The confirmation timeout starts when the frame has left the
+///         throttled line.
+void DcSimulator::resendPayloadFrame()
+{
+    int timeout=DC_SIMULATOR_CONFIRMATION_TIMEOUT;
+
+    if( errorCounter || timeoutCounter )
+        stats.resends++;
+
+    sendFrame( currentMid, eSerialCodePayload,
+               senderMessage->getTransceived(), senderMessage->numberOfFrames(),
+               senderMessage->getFramePayload(), chance( config.txCrcErrorRate ) );
+
+    if( config.baud > 0 )
+        timeout+=(guint64)txData.size() * 10000 / config.baud;
+
+    confirmationConnection.disconnect();
+    confirmationConnection=Glib::signal_timeout().connect(
+        sigc::mem_fun(*this, &DcSimulator::onConfirmationTimeout), timeout);
+}
+
+
+bool DcSimulator::onConfirmationTimeout()
+{
+    timeoutCounter++;
+
+    if( timeoutCounter < DC_SIMULATOR_TIMEOUT_MAX )
+    {
+        resendPayloadFrame();
+        return( false );
+    }
+
+    lError("DcSimulator: no confirmation for tid %d, dropping it\n", senderMessage->tid());
+    stats.dropped++;
+    senderMessage->discard();
+    waitForAck=false;
+    errorCounter=0;
+    timeoutCounter=0;
+    sendLoop();
+
+    return( false );
+}
+
+
+void DcSimulator::sendLoop()
+{
+    if( waitForAck || transmitMessages.empty() )
+        return;
+
+    senderMessage->initSenderMessage( transmitMessages.front().first,
+                                      transmitMessages.front().second );
+    transmitMessages.pop_front();
+
+    sendPayloadFrameFromMessage();
+}
+
+
+//---Requests------------------------------------------------------------------
+
+
+void DcSimulator::sendMessage( const Glib::ustring &str, int tid )
+{
+    if( config.protocol == eDcSimulatorProtocolFramed )
+    {
+        transmitMessages.push_back( std::make_pair( str, tid ) );
+        sendLoop();
+        return;
+    }
+
+    guint32 size=htonl( str.bytes() );
+    std::string frame( (const char *)&size, sizeof(size) );
+
+    frame+=str.raw();
+    stats.framesSent++;
+    stats.replies++;
+    queueOutput( frame );
+}
+
+
+void DcSimulator::handleMessage( const Glib::ustring &payload )
+{
+    xmlpp::DomParser parser;
+    xmlpp::Element *element=NULL;
+    SPending pending;
+
+    try {
+        parser.parse_memory( payload );
+        element=parser.get_document()->get_root_node();
+    } catch( const std::exception &ex ) {
+        lError("DcSimulator: could not parse message: %s\n", ex.what());
+        return;
+    }
+
+    if( !element || element->get_name() != "task" )
+    {
+        lError("DcSimulator: invalid message received, ignoring it\n");
+        return;
+    }
+
+    pending.tid=atoi( element->get_attribute_value("tid").c_str() );
+
+    element=NULL;
+    for( auto &&node : parser.get_document()->get_root_node()->get_children() )
+    {
+        element=dynamic_cast<xmlpp::Element *>( node );
+        if( element )
+            break;
+    }
+
+    if( !element )
+    {
+        lError("DcSimulator: could not get child for task\n");
+        return;
+    }
+
+    if( element->get_name() == "reply" )
+    {
+        // answer to a request of a DC, we never send any
+        lDebug("DcSimulator: ignoring reply for tid %d\n", pending.tid);
+        return;
+    }
+
+    if( element->get_name() != "function" )
+    {
+        lError("DcSimulator: unknown message received: %s\n", element->get_name().c_str());
+        return;
+    }
+
+    pending.fid=element->get_attribute_value("fid");
+
+    stats.requests++;
+    stats.requestsPerFid[pending.fid]++;
+
+    if( config.sequential && busy )
+    {
+        requestQueue.push_back( pending );
+        return;
+    }
+
+    startRequest( pending );
+}
+
+
+void DcSimulator::startRequest( const SPending &pending )
+{
+    const SDcSimulatorProfile &profile=getProfile( pending.fid );
+    int delay=profile.latency;
+
+    if( profile.jitter > 0 )
+        delay+=std::uniform_int_distribution<int>( -profile.jitter, profile.jitter )( rng );
+    if( delay < 0 )
+        delay=0;
+
+    busy=true;
+
+    Glib::signal_timeout().connect(
+        sigc::bind( sigc::mem_fun(*this, &DcSimulator::onRequestDone), pending ), delay);
+}
+
+
+bool DcSimulator::onRequestDone( SPending pending )
+{
+    sendMessage( Glib::ustring::compose("<task tid=\"%1\">%2</task>",
+                                        pending.tid, getResponse( pending.fid )),
+                 pending.tid );
+
+    busy=false;
+
+    if( !requestQueue.empty() )
+    {
+        SPending next=requestQueue.front();
+
+        requestQueue.pop_front();
+        startRequest( next );
+    }
+
+    return( false );
+}
+
+
+const SDcSimulatorProfile &DcSimulator::getProfile( const Glib::ustring &fid ) const
+{
+    auto it=config.profiles.find( fid );
+
+    if( it == config.profiles.end() )
+        return( config.defaults );
+
+    return( it->second );
+}
+
+
+const Glib::ustring &DcSimulator::getResponse( const Glib::ustring &fid )
+{
+    auto it=responses.find( fid );
+
+    if( it != responses.end() )
+        return( it->second );
+
+    Glib::ustring response=DC_SIMULATOR_DEFAULT_REPLY;
+
+    if( !config.responseDir.empty() )
+    {
+        std::string fileName=config.responseDir + "/" + fid.raw() + ".xml";
+
+        try {
+            if( FileHandler::file_exists( fileName ) )
+                response=loadResponse( fileName );
+        } catch( const std::exception &ex ) {
+            lError("DcSimulator: %s\n", ex.what());
+        }
+    }
+
+    return( responses[fid]=response );
+}
+
+
+Glib::ustring DcSimulator::loadResponse( const std::string &fileName ) /* static */
+{
+    xmlpp::DomParser parser;
+
+    try {
+        parser.parse_file( fileName );
+    } catch( const std::exception &ex ) {
+        EXCEPTION("Could not parse response " << fileName << ": " << ex.what());
+    }
+
+    auto *root=parser.get_document()->get_root_node();
+    if( !root || root->get_name() != "reply" )
+        EXCEPTION("Response " << fileName << " is no <reply/>");
+
+    return( element_to_string( root, 0, 0 ) );
+}
+
+
+//---fin.----------------------------------------------------------------------
@@ -0,0 +1,196 @@
+#ifndef DC_SIMULATOR_H
+#define DC_SIMULATOR_H
+//-----------------------------------------------------------------------------
+///
+/// \brief  Simulated devicecontroller
+///
+///         See implementation for further details
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+#include <string>
+#include <map>
+#include <deque>
+#include <random>
+#include <glibmm/ustring.h>
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+#include <glibmm/main.h>
+
+//---Own------------------------------
+
+#include "serial_interface_handler.h"
+#include "serial_message.h"
+
+
+//---Declaration---------------------------------------------------------------
+
+
+enum EDcSimulatorProtocol
+{
+    eDcSimulatorProtocolFramed      = 0x01,    // RS422, see SerialInterfaceHandler
+    eDcSimulatorProtocolUsb         = 0x02,    // length prefixed, see UsbInterfaceHandler
+};
+
+
+/// \brief  Behaviour of the simulator for one fid
+struct SDcSimulatorProfile
+{
+    SDcSimulatorProfile()
+        : latency(0)
+        , jitter(0)
+    {}
+
+    int latency;                    // ms until the reply is sent
+    int jitter;                     // ms, uniformly added or subtracted
+    std::string response;           // file with the <reply/>, empty for status 200
+};
+
+
+struct SDcSimulatorConfig
+{
+    SDcSimulatorConfig()
+        : protocol(eDcSimulatorProtocolFramed)
+        , baud(0)
+        , maxPayloadSize(SERIAL_MAX_PAYLOAD_SIZE)
+        , txCrcErrorRate(0)
+        , rxCrcErrorRate(0)
+        , sequential(false)
+        , seed(0)
+    {}
+
+    EDcSimulatorProtocol protocol;
+    std::string link;               // symlink to the pty slave, may be empty
+    std::string responseDir;        // <fid>.xml is used as response, may be empty
+    int baud;                       // 0: unthrottled
+    int maxPayloadSize;             // numberOfBytesPerFrameMax of the daemon
+    double txCrcErrorRate;          // payload frames sent with a wrong crc
+    double rxCrcErrorRate;          // payload frames answered with NAK "CS"
+    bool sequential;                // handle one request at a time like the DC
+    unsigned seed;
+
+    SDcSimulatorProfile defaults;
+    std::map<Glib::ustring, SDcSimulatorProfile> profiles;
+};
+
+
+struct SDcSimulatorStats
+{
+    SDcSimulatorStats()
+        : requests(0), replies(0), framesSent(0), framesReceived(0)
+        , crcErrorsInjected(0), naksSent(0), naksReceived(0), resends(0)
+        , dropped(0), bytesSent(0), bytesReceived(0)
+    {}
+
+    guint64 requests;
+    guint64 replies;
+    guint64 framesSent;
+    guint64 framesReceived;
+    guint64 crcErrorsInjected;
+    guint64 naksSent;
+    guint64 naksReceived;
+    guint64 resends;
+    guint64 dropped;
+    guint64 bytesSent;
+    guint64 bytesReceived;
+    std::map<Glib::ustring, guint64> requestsPerFid;
+};
+
+
+class DcSimulator: public Glib::Object
+{
+    private:
+        struct SPending
+        {
+            int tid;
+            Glib::ustring fid;
+        };
+
+        SDcSimulatorConfig config;
+        SDcSimulatorStats stats;
+        std::mt19937 rng;
+
+        int masterFd;
+        int slaveFd;
+        std::string slaveName;
+
+        // receiving
+        std::string rxData;
+        Glib::RefPtr<CSerialMessage> receiverMessage;
+        sigc::connection rxConnection;
+        sigc::connection rxPauseConnection;
+
+        // sending, txData is written to the pty as the baud rate allows
+        std::string txData;
+        sigc::connection txConnection;
+        bool txActive;
+        std::deque< std::pair< Glib::ustring, int > > transmitMessages;
+        Glib::RefPtr<CSerialMessage> senderMessage;
+        bool waitForAck;
+        int currentMid;
+        int errorCounter;
+        int timeoutCounter;
+        sigc::connection confirmationConnection;
+
+        // requests waiting for their latency to pass
+        std::deque<SPending> requestQueue;
+        bool busy;
+        std::map<Glib::ustring, Glib::ustring> responses;
+
+        void openPty();
+        bool onInput(Glib::IOCondition condition);
+        bool onResumeInput();
+        bool onOutput(Glib::IOCondition condition);
+        bool onOutputPaced();
+        gsize writeOutput(gsize max);
+        void queueOutput(const std::string &data);
+        void flushOutput();
+
+        void handleFramedInput();
+        void handleUsbInput();
+        void digestFrame(const std::string &frame);
+        void sendFrame(int mid, int type, int i, int n, const std::string &str, bool wrongCrc);
+        void sendConfirmFrame(int mid, int i, int n, ESerialCode ack, const char *code);
+        void sendPayloadFrameFromMessage();
+        void resendPayloadFrame();
+        bool onConfirmationTimeout();
+        void sendLoop();
+
+        void handleMessage(const Glib::ustring &payload);
+        void startRequest(const SPending &pending);
+        bool onRequestDone(SPending pending);
+        void sendMessage(const Glib::ustring &str, int tid);
+
+        const SDcSimulatorProfile &getProfile(const Glib::ustring &fid) const;
+        const Glib::ustring &getResponse(const Glib::ustring &fid);
+        static Glib::ustring loadResponse(const std::string &fileName);
+        bool chance(double rate);
+
+    public:
+        DcSimulator( const SDcSimulatorConfig &_config );
+        ~DcSimulator();
+
+        static Glib::RefPtr<DcSimulator> create( const SDcSimulatorConfig &_config );
+
+        const std::string &getSlaveName() const
+        {
+            return( slaveName );
+        }
+
+        const SDcSimulatorStats &getStats() const
+        {
+            return( stats );
+        }
+};
+
+
+//-----------------------------------------------------------------------------
+#endif // ? ! DC_SIMULATOR_H
@@ -0,0 +1,246 @@
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <sstream>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include "deletion_service.h"
+#include "conf_handler.h"
+#include "file_handler.h"
+#include "utils.h"
+
+// see getdents64(2), not wrapped by older glibc versions
+struct linux_dirent64
+{
+    ino64_t        d_ino;
+    off64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[];
+};
+
+static const std::size_t DIRENT_BUFFER_SIZE = 16384;
+
+// see ioprio_set(2)
+#define IOPRIO_WHO_PROCESS  1
+#define IOPRIO_CLASS_IDLE   3
+#define IOPRIO_CLASS_SHIFT  13
+
+DeletionService::RefPtr DeletionService::instance(nullptr);
+
+DeletionService::DeletionService() :
+    Glib::Object(),
+    _counter{0},
+    _running{0},
+    _stop{false}
+{
+    auto conf_handler = ConfHandler::get_instance();
+    _trash_dir = conf_handler->getDirectory("trash");
+
+    if (!_trash_dir.empty()) {
+        try {
+            FileHandler::create_directory(_trash_dir);
+        } catch (const std::exception& ex) {
+            PRINT_ERROR("No trash directory, deleting in place: " << ex.what());
+            _trash_dir.clear();
+        }
+    }
+
+    resume();
+
+    _worker = std::thread(&DeletionService::worker, this);
+}
+
+DeletionService::~DeletionService()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cond.notify_all();
+
+    if (_worker.joinable())
+        _worker.join();
+}
+
+void DeletionService::resume()
+{
+    if (_trash_dir.empty())
+        return;
+
+    try {
+        auto entries = FileHandler::list_directory(_trash_dir);
+        for (auto&& entry : entries)
+            enqueue(_trash_dir + "/" + entry);
+
+        if (!entries.empty())
+            PRINT_INFO("Resuming deletion of " << entries.size() << " trash entries");
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Failed to resume deletions: " << ex.what());
+    }
+}
+
+void DeletionService::remove(const std::string& path)
+{
+    struct stat sb;
+
+    if (lstat(path.c_str(), &sb))
+        return;
+
+    if (!_trash_dir.empty()) {
+        std::stringstream ss;
+        ss << _trash_dir << "/" << FileHandler::basename(path) << "." << time(nullptr)
+           << "." << _counter++;
+
+        if (!rename(path.c_str(), ss.str().c_str())) {
+            enqueue(ss.str());
+            return;
+        }
+
+        if (errno != EXDEV)
+            EXCEPTION("Failed to move " << path << " to trash: " << strerror(errno));
+    }
+
+    enqueue(path);
+}
+
+void DeletionService::enqueue(const std::string& path)
+{
+    std::size_t depth;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(path);
+        depth = _queue.size() + _running;
+    }
+    _cond.notify_one();
+
+    PRINT_DEBUG("DeletionService: queued " << path << ", queue depth " << depth);
+}
+
+std::size_t DeletionService::queue_depth() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queue.size() + _running;
+}
+
+void DeletionService::worker()
+{
+    // do not compete with the interfaces for CPU and disk
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0,
+            IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+
+    for (;;) {
+        std::string path;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, [this] { return _stop || !_queue.empty(); });
+            if (_stop)
+                return;
+
+            path = _queue.front();
+            _queue.pop_front();
+            ++_running;
+        }
+
+        try {
+            if (!remove_tree(path, &_stop))
+                PRINT_DEBUG("DeletionService: stopped in " << path);
+        } catch (const std::exception& ex) {
+            PRINT_ERROR("Failed to delete " << path << ": " << ex.what());
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_running;
+    }
+}
+
+static bool remove_at(int dir_fd, const char *name, const std::string& path,
+                      const std::atomic<bool> *stop)
+{
+    int fd = openat(dir_fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+
+    if (fd < 0) {
+        if (errno == ENOENT)
+            return true;
+
+        // not a directory (or a symlink): plain unlink
+        if (errno != ENOTDIR && errno != ELOOP)
+            throw std::runtime_error("Failed to open " + path + ": " + strerror(errno));
+
+        if (unlinkat(dir_fd, name, 0) && errno != ENOENT)
+            throw std::runtime_error("Failed to unlink " + path + ": " + strerror(errno));
+        return true;
+    }
+
+    try {
+        // one buffer per directory level, on the heap: deep trees must not
+        // overflow the stack of the worker thread
+        std::vector<char> buf(DIRENT_BUFFER_SIZE);
+
+        for (;;) {
+            long n = syscall(SYS_getdents64, fd, buf.data(), buf.size());
+            if (n < 0)
+                throw std::runtime_error("Failed to read directory " + path + ": " + strerror(errno));
+            if (n == 0)
+                break;
+
+            for (long pos = 0; pos < n; ) {
+                // a large directory must not delay the shutdown
+                if (stop && *stop) {
+                    close(fd);
+                    return false;
+                }
+
+                auto entry = reinterpret_cast<linux_dirent64 *>(buf.data() + pos);
+                pos += entry->d_reclen;
+
+                if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+                    continue;
+
+                bool is_dir = entry->d_type == DT_DIR;
+                if (entry->d_type == DT_UNKNOWN) {
+                    struct stat sb;
+                    if (!fstatat(fd, entry->d_name, &sb, AT_SYMLINK_NOFOLLOW))
+                        is_dir = S_ISDIR(sb.st_mode);
+                }
+
+                auto entry_path = path + "/" + entry->d_name;
+                if (is_dir) {
+                    if (!remove_at(fd, entry->d_name, entry_path, stop)) {
+                        close(fd);
+                        return false;
+                    }
+                } else if (unlinkat(fd, entry->d_name, 0) && errno != ENOENT)
+                    throw std::runtime_error("Failed to unlink " + entry_path + ": " + strerror(errno));
+            }
+        }
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+
+    close(fd);
+
+    if (unlinkat(dir_fd, name, AT_REMOVEDIR) && errno != ENOENT)
+        throw std::runtime_error("Failed to remove " + path + ": " + strerror(errno));
+
+    return true;
+}
+
+bool DeletionService::remove_tree(const std::string& path, const std::atomic<bool> *stop)
+{
+    return remove_at(AT_FDCWD, path.c_str(), path, stop);
+}
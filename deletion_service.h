@@ -0,0 +1,90 @@
+#ifndef _DELETION_SERVICE_H_
+#define _DELETION_SERVICE_H_
+
+#include <string>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+
+/**
+ * \brief Removes directory trees in the background.
+ *
+ * A directory passed to remove() is renamed into the trash directory
+ * (configuration directory id "trash"), so it disappears at once. The
+ * contents are then deleted by a low priority worker thread. Entries left
+ * in the trash directory, e.g. after a power cut, are picked up again on
+ * startup.
+ *
+ * If the trash directory is not configured or on another filesystem, the
+ * directory is deleted in place by the worker.
+ *
+ * On destruction the worker stops after the current directory entry, the
+ * rest of the trash is removed after the next startup.
+ */
+class DeletionService : public Glib::Object
+{
+public:
+    using RefPtr = Glib::RefPtr<DeletionService>;
+
+    static inline RefPtr& get_instance()
+    {
+        if (!instance)
+            instance = create();
+        return instance;
+    }
+
+    ~DeletionService();
+
+    /**
+     * Remove a directory (or file) like `rm -rf`. Returns as soon as path
+     * is gone from its parent directory.
+     *
+     * @param path directory
+     */
+    void remove(const std::string& path);
+
+    /**
+     * Number of directories waiting for or in deletion.
+     */
+    std::size_t queue_depth() const;
+
+    /**
+     * Removes a directory tree using openat/unlinkat and getdents.
+     *
+     * @param path directory or file
+     * @param stop checked before each entry, may be nullptr
+     * @return false, if stopped before path was removed
+     */
+    static bool remove_tree(const std::string& path, const std::atomic<bool> *stop = nullptr);
+
+private:
+    static RefPtr instance;
+
+    std::string _trash_dir;
+    unsigned _counter;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cond;
+    std::deque<std::string> _queue;
+    std::size_t _running;
+    std::atomic<bool> _stop;
+    std::thread _worker;
+
+    DeletionService();
+
+    static inline RefPtr create()
+    {
+        return RefPtr(new DeletionService());
+    }
+
+    void resume();
+    void enqueue(const std::string& path);
+    void worker();
+};
+
+#endif /* _DELETION_SERVICE_H_ */
@@ -1,9 +1,12 @@
 #include <string>
 #include <sstream>
+#include <limits>
 
 #include "disk_usage_manager.h"
 
 #include "file_handler.h"
+#include "measurement_catalog.h"
+#include "deletion_service.h"
 #include "log_handler.h"
 #include "conf_handler.h"
 #include "monitor_manager.h"
@@ -15,7 +18,8 @@ DiskUsageManager::RefPtr DiskUsageManager::instance(nullptr);
 DiskUsageManager::DiskUsageManager() :
     Glib::Object(),
     _number_of_measurements_max{100}, _number_of_measurements_keep{5},
-    _number_of_log_max{20}, _number_of_log_keep{5}
+    _number_of_log_max{20}, _number_of_log_keep{5},
+    _measurements_bytes_max{0}, _evicting{false}
 {
     update_config();
     auto conf_handler = ConfHandler::get_instance();
@@ -23,6 +27,13 @@ DiskUsageManager::DiskUsageManager() :
         sigc::mem_fun(*this, &DiskUsageManager::on_config_change_announce));
     conf_handler->confChanged.connect(
         sigc::mem_fun(*this, &DiskUsageManager::on_config_changed));
+
+    try {
+        MeasurementCatalog::get_instance()->changed.connect(
+            sigc::mem_fun(*this, &DiskUsageManager::on_catalog_changed));
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("No measurement catalog, byte quota disabled: " << ex.what());
+    }
 }
 
 void DiskUsageManager::update_config()
@@ -31,9 +42,15 @@ void DiskUsageManager::update_config()
     get_config_value("numberOfMeasurementsKeep");
     get_config_value("numberOfLogMax");
     get_config_value("numberOfLogKeep");
+    get_config_value("measurementsBytesMax");
 }
 
-void DiskUsageManager::remove_flagged_measurements() const
+void DiskUsageManager::remove_flagged_measurements()
+{
+    evict_measurements(_number_of_measurements_keep);
+}
+
+void DiskUsageManager::evict_measurements(std::size_t max_count)
 {
     try {
         auto conf_handler = ConfHandler::get_instance();
@@ -41,35 +58,51 @@ void DiskUsageManager::remove_flagged_measurements() const
         if (path.empty())
             return;
 
-        auto dir = FileHandler::list_directory(path);
-        auto nr_of_measurements = dir.size();
-
-        for (auto&& file : dir) {
-            auto entry = path + "/" + file;
+        auto catalog = MeasurementCatalog::get_instance();
+        auto deletion_service = DeletionService::get_instance();
+        auto evictions = catalog->select_evictions(max_count, _measurements_bytes_max);
 
-            if (nr_of_measurements <= _number_of_measurements_keep)
-                break;
+        // catalog changes below must not start another eviction
+        _evicting = true;
 
-            if (!FileHandler::directory_exists(entry))
-                continue;
-
-            if (!FileHandler::file_exists(entry + "/.delete"))
+        // oldest flagged first, only looks at what gets removed
+        for (auto&& iid : evictions) {
+            try {
+                deletion_service->remove(path + "/" + iid);
+            } catch (const std::exception& ex) {
+                PRINT_ERROR("Failed to remove measurement " << iid << ": " << ex.what());
                 continue;
+            }
 
-            FileHandler::remove_directory(entry);
-            --nr_of_measurements;
+            catalog->remove(iid);
 
             try {
-                IdMapper::get_instance()->remove_mapping(file);
+                IdMapper::get_instance()->remove_mapping(iid);
             } catch (const std::exception& ex) {
-                PRINT_ERROR("Failed to remove id mapping for " << file);
+                PRINT_ERROR("Failed to remove id mapping for " << iid);
             }
         }
+
+        _evicting = false;
     } catch (const std::exception& ex) {
+        _evicting = false;
         PRINT_ERROR("Error ocurred while removing flagged measurements: " << ex.what());
     }
 }
 
+void DiskUsageManager::on_catalog_changed()
+{
+    if (_evicting || !_measurements_bytes_max)
+        return;
+
+    auto catalog = MeasurementCatalog::get_instance();
+    if (catalog->total_bytes() <= _measurements_bytes_max)
+        return;
+
+    // byte quota only, the count is handled by the directory monitor alarm
+    evict_measurements(std::numeric_limits<std::size_t>::max());
+}
+
 void DiskUsageManager::logs_truncate() const
 {
     try {
@@ -83,7 +116,7 @@ void DiskUsageManager::logs_truncate() const
 }
 void DiskUsageManager::get_config_value(const std::string& name)
 {
-    int val;
+    long long val;
     std::stringstream ss;
     std::string param;
 
@@ -105,6 +138,8 @@ void DiskUsageManager::get_config_value(const std::string& name)
         _number_of_log_max = val;
     if (name == "numberOfLogKeep")
         _number_of_log_keep = val;
+    if (name == "measurementsBytesMax" && val >= 0)
+        _measurements_bytes_max = val;
 }
 
 void DiskUsageManager::on_config_change_announce(
@@ -115,6 +150,7 @@ void DiskUsageManager::on_config_change_announce(
          || ( par_id == "numberOfMeasurementsKeep")
          || ( par_id == "numberOfLogMax" )
          || ( par_id == "numberOfLogKeep")
+         || ( par_id == "measurementsBytesMax")
 	 || ( par_id == "all" ))
         handlerMask |= HANDLER_MASK_DU_MANAGER;
 }
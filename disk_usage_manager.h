@@ -5,6 +5,8 @@
 #include <glibmm/object.h>
 #include <glibmm/ustring.h>
 
+#include <cstddef>
+
 /*
  * This class provides methods to free up some diskspace.
  */
@@ -21,10 +23,12 @@ public:
     }
 
     /*
-     * This functions removes all measurement directories which are flagged for
-     * deletion.
+     * This functions removes the oldest measurement directories which are
+     * flagged for deletion, until numberOfMeasurementsKeep and
+     * measurementsBytesMax are met. The directories are removed in the
+     * background, see DeletionService.
      */
-    void remove_flagged_measurements() const;
+    void remove_flagged_measurements();
 
     /**
      * Performs shortening of current log files.
@@ -51,6 +55,11 @@ public:
         return _number_of_log_keep;
     }
 
+    inline guint64 measurements_bytes_max() const noexcept
+    {
+        return _measurements_bytes_max;
+    }
+
 private:
     DiskUsageManager();
 
@@ -60,6 +69,8 @@ private:
     unsigned _number_of_measurements_keep;
     unsigned _number_of_log_max;
     unsigned _number_of_log_keep;
+    guint64 _measurements_bytes_max;
+    bool _evicting;
 
     static inline RefPtr create()
     {
@@ -70,6 +81,8 @@ private:
     void get_config_value(const std::string& name);
     void on_config_change_announce(const Glib::ustring& par_id, const Glib::ustring& value, int &handlerMask);
     void on_config_changed(const int handlerMask);
+    void evict_measurements(std::size_t max_count);
+    void on_catalog_changed();
 };
 
 #endif /* _DISK_USAGE_MANAGER_H_ */
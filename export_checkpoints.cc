@@ -0,0 +1,110 @@
+#include <libxml++/nodes/element.h>
+#include <libxml++/nodes/node.h>
+#include <libxml++/libxml++.h>
+#include <libxml/tree.h>
+
+#include <sstream>
+
+#include "file_handler.h"
+#include "conf_handler.h"
+#include "utils.h"
+
+#include "export_checkpoints.h"
+
+ExportCheckpoints::RefPtr ExportCheckpoints::instance(nullptr);
+
+void ExportCheckpoints::setup()
+{
+    try {
+        std::string dir = ConfHandler::get_instance()->getDirectory("log");
+        if (dir.empty())
+            EXCEPTION("Failed to find log directory");
+        if (!FileHandler::directory_exists(dir))
+            FileHandler::create_directory(dir);
+        _file_name = dir + "/export_checkpoints.xml";
+        _file_name_tmp = _file_name + ".tmp";
+
+        if (FileHandler::file_exists(_file_name)) {
+            _parser.parse_file(_file_name);
+            _root = _parser.get_document()->get_root_node();
+        } else {
+            _parser.parse_memory("<?xml version=\"1.0\" encoding=\"UTF-8\"?><checkpoints></checkpoints>");
+            _root = _parser.get_document()->get_root_node();
+        }
+    } catch (...) {
+        EXCEPTION("Failed to setup export checkpoints XML");
+    }
+}
+
+void ExportCheckpoints::save()
+{
+    _parser.get_document()->write_to_file_formatted(_file_name_tmp);
+    FileHandler::move_file(_file_name_tmp, _file_name);
+}
+
+xmlpp::Element *ExportCheckpoints::find_checkpoint(const Glib::ustring& dest,
+                                                   const Glib::ustring& type,
+                                                   const Glib::ustring& file)
+{
+    // compare attributes, file names may contain anything an XPath
+    // literal cannot
+    for (auto&& child : _root->get_children("checkpoint")) {
+        auto *elem = dynamic_cast<xmlpp::Element *>(child);
+        if (!elem)
+            continue;
+
+        if (elem->get_attribute_value("dest") == dest &&
+            elem->get_attribute_value("type") == type &&
+            elem->get_attribute_value("file") == file)
+            return elem;
+    }
+
+    return nullptr;
+}
+
+goffset ExportCheckpoints::get_offset(const Glib::ustring& dest,
+                                      const Glib::ustring& type,
+                                      const Glib::ustring& file,
+                                      guint64 inode, goffset size)
+{
+    auto *elem = find_checkpoint(dest, type, file);
+    if (!elem)
+        return 0;
+
+    guint64 cp_inode;
+    goffset cp_offset;
+    std::stringstream ss;
+    ss << elem->get_attribute_value("inode") << " "
+       << elem->get_attribute_value("offset");
+    ss >> cp_inode >> cp_offset;
+
+    if (ss.fail())
+        return 0;
+
+    // rotated or truncated -> start a new segment
+    if (cp_inode != inode || cp_offset > size)
+        return 0;
+
+    return cp_offset;
+}
+
+void ExportCheckpoints::set_offset(const Glib::ustring& dest,
+                                   const Glib::ustring& type,
+                                   const Glib::ustring& file,
+                                   guint64 inode, goffset offset)
+{
+    auto *elem = find_checkpoint(dest, type, file);
+
+    if (!elem) {
+        elem = dynamic_cast<xmlpp::Element *>(_root->add_child("checkpoint"));
+        if (!elem)
+            EXCEPTION("Failed to add export checkpoint");
+
+        elem->set_attribute("dest", dest);
+        elem->set_attribute("type", type);
+        elem->set_attribute("file", file);
+    }
+
+    elem->set_attribute("inode", std::to_string(inode));
+    elem->set_attribute("offset", std::to_string(offset));
+}
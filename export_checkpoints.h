@@ -0,0 +1,84 @@
+#ifndef _EXPORT_CHECKPOINTS_H_
+#define _EXPORT_CHECKPOINTS_H_
+
+#include <libxml++/document.h>
+#include <libxml++/parsers/domparser.h>
+
+#include <glibmm/ustring.h>
+#include <glibmm/refptr.h>
+#include <glibmm/object.h>
+
+#include <string>
+
+#include <glib.h>
+
+/**
+ * \brief This class remembers, per destination and export type, up to which
+ *        byte offset each log/monitor file has already been exported.
+ *
+ * A checkpoint is only valid as long as the file is the same one (inode)
+ * and did not shrink. Otherwise the file was rotated or truncated and a new
+ * segment starts at offset 0.
+ */
+class ExportCheckpoints : public Glib::Object
+{
+public:
+    using RefPtr = Glib::RefPtr<ExportCheckpoints>;
+
+    static inline RefPtr get_instance()
+    {
+        if (!instance)
+            instance = create();
+        return instance;
+    }
+
+    /**
+     * Get the offset to continue an incremental export from.
+     *
+     * @param dest  destination, e.g. lanFolder
+     * @param type  log or monitor
+     * @param file  log file path
+     * @param inode current inode of the file
+     * @param size  current size of the file
+     *
+     * @return offset of first byte not exported yet, 0 for a new segment
+     */
+    goffset get_offset(const Glib::ustring& dest, const Glib::ustring& type,
+                       const Glib::ustring& file, guint64 inode, goffset size);
+
+    /**
+     * Remember that the file has been exported up to offset. Call save()
+     * after all files of one export were set.
+     */
+    void set_offset(const Glib::ustring& dest, const Glib::ustring& type,
+                    const Glib::ustring& file, guint64 inode, goffset offset);
+
+    void save();
+
+private:
+    static RefPtr instance;
+
+    xmlpp::DomParser _parser;
+    xmlpp::Node *_root;
+    std::string _file_name;
+    std::string _file_name_tmp;
+
+    inline ExportCheckpoints() :
+        _root{nullptr}
+    {
+        setup();
+    }
+
+    static inline RefPtr create()
+    {
+        return RefPtr(new ExportCheckpoints());
+    }
+
+    void setup();
+
+    xmlpp::Element *find_checkpoint(const Glib::ustring& dest,
+                                    const Glib::ustring& type,
+                                    const Glib::ustring& file);
+};
+
+#endif /* _EXPORT_CHECKPOINTS_H_ */
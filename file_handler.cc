@@ -4,17 +4,18 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/ustring.h>
 #include <glibmm/miscutils.h>
-#include <glibmm/base64.h>
 #include <giomm/file.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
 #include <unistd.h>
 #include <errno.h>
 #include <pwd.h>
 #include <grp.h>
 
 #include "file_handler.h"
+#include "base64_codec.h"
 
 #include "utils.h"
 
@@ -144,12 +145,12 @@ void FileHandler::copy_file(const std::string& path1, const std::string& path2)
 
 std::string FileHandler::base64_encode(const std::string& input)
 {
-    return Glib::Base64::encode(input, false);
+    return Base64Codec::encode(input);
 }
 
 std::string FileHandler::base64_decode(const std::string& input)
 {
-    return Glib::Base64::decode(input);
+    return Base64Codec::decode(input);
 }
 
 bool FileHandler::file_exists(const std::string& name)
@@ -179,6 +180,29 @@ bool FileHandler::socket_exists(const std::string& name)
     return S_ISSOCK(sb.st_mode);
 }
 
+bool FileHandler::is_remote_filesystem(const std::string& name)
+{
+    // see statfs(2)
+    static const unsigned long CIFS_MAGIC_NUMBER = 0xFF534D42;
+    static const unsigned long SMB2_MAGIC_NUMBER = 0xFE534D42;
+    static const unsigned long SMB_SUPER_MAGIC   = 0x517B;
+    static const unsigned long NFS_SUPER_MAGIC   = 0x6969;
+    struct statfs sfs;
+
+    if (statfs(name.c_str(), &sfs))
+        return false;
+
+    switch (static_cast<unsigned long>(sfs.f_type)) {
+    case CIFS_MAGIC_NUMBER:
+    case SMB2_MAGIC_NUMBER:
+    case SMB_SUPER_MAGIC:
+    case NFS_SUPER_MAGIC:
+        return true;
+    default:
+        return false;
+    }
+}
+
 std::string FileHandler::basename(const std::string& file_name)
 {
     auto file = Gio::File::create_for_path(file_name);
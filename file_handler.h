@@ -131,6 +131,17 @@ public:
      */
     static bool socket_exists(const std::string& name);
 
+    /**
+     * This functions checks whether a path lives on a network filesystem
+     * (CIFS/SMB, NFS). Such filesystems do not deliver inotify events for
+     * changes made by other hosts.
+     *
+     * @param name path of a file or directory
+     *
+     * @return true if remote, false if local or unknown
+     */
+    static bool is_remote_filesystem(const std::string& name);
+
     /**
      * Gets basename. This functions uses Gio::File, instead of basename(3).
      *
@@ -73,5 +73,33 @@ out:
     connection_closed.emit();
 }
 
+void FileInterfaceConnection::emit_result_stream(const Glib::RefPtr<XmlResultStream>& result, int tid)
+{
+    (void) tid;
+
+    PRINT_DEBUG ("FileInterfaceConnection::emit_result_stream() out_path=" << _out_path);
+    if (_out_path.empty())
+        goto out;
+
+    try {
+        std::ofstream os(_out_path, std::ios::binary | std::ios::trunc);
+        if (!os.good())
+            EXCEPTION("Failed to open file: " << _out_path);
+
+        result->write_to([&os] (const char *data, std::size_t len) {
+            os.write(data, len);
+        });
+
+        os.close();
+        if (os.fail())
+            EXCEPTION("Failed to write file: " << _out_path);
+    } catch (std::exception & e) {
+	PRINT_ERROR ("FileInterfaceConnection::emit_result_stream() failed to write to path: " << e.what ());
+    }
+
+out:
+    connection_closed.emit();
+}
+
 void FileInterfaceConnection::cancel()
 {}
@@ -35,6 +35,7 @@ public:
     }
 
     void emit_result(const Glib::ustring& result, int tid) override;
+    void emit_result_stream(const Glib::RefPtr<XmlResultStream>& result, int tid) override;
     void cancel() override;
 
     void read_file();
@@ -1,3 +1,5 @@
+#include <sstream>
+
 #include "file_interface_handler.h"
 
 #include "file_interface_connection.h"
@@ -14,6 +16,8 @@ FileInterfaceHandler::FileInterfaceHandler(
         sigc::mem_fun(*this, &FileInterfaceHandler::incoming_file));
     _file_service->new_file_content.connect(
         sigc::mem_fun(*this, &FileInterfaceHandler::incoming_file_content));
+    _file_service->new_request_batch.connect(
+        sigc::mem_fun(*this, &FileInterfaceHandler::incoming_request_batch));
 }
 
 Glib::RefPtr<FileInterfaceHandler> FileInterfaceHandler::create(
@@ -75,6 +79,36 @@ void FileInterfaceHandler::incoming_file_content(
     file_connection->stream_complete();
 }
 
+void FileInterfaceHandler::incoming_request_batch(
+    ZixInterface inf, const IngestBatchResult::EntryList& entries)
+{
+    PRINT_DEBUG ("FileInterfaceHandler::incoming_request_batch (" << entries.size() << " entries)");
+    if (inf != _inf)
+        return;
+
+    // keep the order of the batch, the xml_processor queues requests
+    // in the order they arrive
+    for (auto&& entry : entries) {
+        auto iface_connection = FileInterfaceConnection::create_for_path(entry.in_path, entry.out_path);
+
+        register_connection(iface_connection);
+
+        iface_connection->connection_closed.connect(
+            sigc::bind<std::weak_ptr<InterfaceConnection> >(
+                sigc::mem_fun(*this, &FileInterfaceHandler::closed_connection),
+                std::weak_ptr<InterfaceConnection>(iface_connection)));
+
+        // empty or malformed, the xml_processor replies with BadRequest
+        if (!entry.parser) {
+            std::istringstream is(entry.content);
+            iface_connection->request_ready.emit(is, 0);
+            continue;
+        }
+
+        dispatch_document(iface_connection, entry.parser);
+    }
+}
+
 void FileInterfaceHandler::closed_connection(std::weak_ptr<InterfaceConnection> conn)
 {
     deregister_connection(conn);
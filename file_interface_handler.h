@@ -26,6 +26,7 @@ private:
     void incoming_file(ZixInterface inf, const std::string& in_path, const std::string& out_path);
     void incoming_file_content(ZixInterface inf, const std::string& in_path,
                                const std::string& content, const std::string& out_path);
+    void incoming_request_batch(ZixInterface inf, const IngestBatchResult::EntryList& entries);
     void closed_connection(std::weak_ptr<InterfaceConnection> conn);
 };
 
@@ -0,0 +1,83 @@
+#ifndef _FILE_OPERATION_RESULT_H_
+#define _FILE_OPERATION_RESULT_H_
+
+#include <string>
+#include <vector>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+
+/**
+ * Result of an operation run by AsyncFileHandler. Depending on the
+ * operation content (get_file) or listing (list_directory) is filled.
+ */
+class FileOperationResult : public Glib::Object
+{
+public:
+    FileOperationResult() :
+        _error{false}, _duration_ms{0}
+    {}
+
+    inline static Glib::RefPtr<FileOperationResult> create()
+    {
+        return Glib::RefPtr<FileOperationResult>(new FileOperationResult());
+    }
+
+    inline const std::string& content() const
+    {
+        return _content;
+    }
+
+    inline std::string& content()
+    {
+        return _content;
+    }
+
+    inline const std::vector<std::string>& listing() const
+    {
+        return _listing;
+    }
+
+    inline std::vector<std::string>& listing()
+    {
+        return _listing;
+    }
+
+    inline const std::string& error_msg() const
+    {
+        return _error_msg;
+    }
+
+    inline bool error() const
+    {
+        return _error;
+    }
+
+    inline void set_error(const std::string& error_msg)
+    {
+        _error = true;
+        _error_msg = error_msg;
+    }
+
+    /**
+     * Time the operation took in the worker thread.
+     */
+    inline gint64 duration_ms() const
+    {
+        return _duration_ms;
+    }
+
+    inline void set_duration_ms(gint64 duration_ms)
+    {
+        _duration_ms = duration_ms;
+    }
+
+private:
+    std::string _content;
+    std::vector<std::string> _listing;
+    std::string _error_msg;
+    bool _error;
+    gint64 _duration_ms;
+};
+
+#endif /* _FILE_OPERATION_RESULT_H_ */
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "zix_interface.h"
+#include "ingest_batch_result.h"
 
 class FileService : public Glib::Object
 {
@@ -24,6 +25,7 @@ public:
 
     sigc::signal<void, ZixInterface, const std::string&, const std::string&> new_file;
     sigc::signal<void, ZixInterface, const std::string&, const std::string&, const std::string&> new_file_content;
+    sigc::signal<void, ZixInterface, const IngestBatchResult::EntryList&> new_request_batch;
 
 private:
     static RefPtr instance;
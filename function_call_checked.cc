@@ -0,0 +1,148 @@
+
+#include "function_call_checked.h"
+
+#include "xml_result_bad_request.h"
+#include "xml_result_ok.h"
+
+FunctionCallChecked::FunctionCallChecked (Glib::RefPtr <FunctionCall> call,
+					  Glib::RefPtr <SignatureCheckRequest> scr,
+					  Glib::RefPtr <RestrictionCheckRequest> rcr,
+					  const Glib::ustring & interface)
+    : FunctionCall ()
+    , _call (call)
+    , _scr (scr)
+    , _rcr (rcr)
+    , _interface (interface)
+    , _pending (0)
+    , _rejected (false)
+{ }
+
+Glib::RefPtr <FunctionCall>
+FunctionCallChecked::create (Glib::RefPtr <FunctionCall> call,
+			     Glib::RefPtr <SignatureCheckRequest> scr,
+			     Glib::RefPtr <RestrictionCheckRequest> rcr,
+			     const Glib::ustring & interface)
+{
+    return Glib::RefPtr <FunctionCall> (new FunctionCallChecked (call, scr, rcr, interface));
+}
+
+FunctionCallChecked::~FunctionCallChecked ()
+{ }
+
+void
+FunctionCallChecked::start_call ()
+{
+    _pending = (_scr ? 1 : 0) + (_rcr ? 1 : 0);
+
+    if (_pending == 0) {
+	_call->finished.connect (sigc::mem_fun (*this, &FunctionCallChecked::main_call_finished));
+	_call->start_call();
+	return;
+    }
+
+    /* checks may finish right away and our owner
+     * may drop us upon the result
+     */
+    reference ();
+
+    if (_scr) {
+	_scr->finished.connect(sigc::mem_fun(*this, &FunctionCallChecked::signature_check_finished));
+	_scr->start_check(_interface);
+    }
+
+    if (_rcr) {
+	if (_rejected) {
+	    // no need to query the DC anymore
+	    check_finished (Glib::RefPtr <XmlResult> ());
+	} else {
+	    _rcr->finished.connect(sigc::mem_fun(*this, &FunctionCallChecked::restriction_check_finished));
+	    _rcr->start_check(_interface);
+	}
+    }
+
+    unreference ();
+}
+
+void
+FunctionCallChecked::signature_check_finished(Glib::RefPtr<SignatureCheckResult> result)
+{
+    Glib::RefPtr <XmlResult> rejection;
+
+    if (!result->result()) {
+        // signature check failed
+        rejection = XmlResultBadRequest::create(
+            Glib::ustring::compose(
+                "Signature check failed: %1", result->error_msg()));
+    }
+
+    check_finished (rejection);
+}
+
+void
+FunctionCallChecked::restriction_check_finished(Glib::RefPtr<RestrictionCheckResult> result)
+{
+    if (!result->result()) {
+        /* restriction check failed
+	 * however... this is not fatal
+	 *
+	 * we return XmlResultOk and dont
+	 * start the main call. A failed
+	 * signature check wins, so wait
+	 * for it before reporting.
+	 */
+        _restriction_rejection = XmlResultOk::create(
+            Glib::ustring::compose(
+                "Restriction check failed: %1", result->error_msg()));
+    }
+
+    check_finished (Glib::RefPtr <XmlResult> ());
+}
+
+/**
+ * Called once per check, rejection is set for a failed signature check
+ * only.
+ */
+void
+FunctionCallChecked::check_finished (Glib::RefPtr <XmlResult> rejection)
+{
+    --_pending;
+
+    if (_rejected) {
+	/* the call has been finished already,
+	 * we only waited for this check to end
+	 */
+	if (_pending == 0)
+	    unreference ();
+	return;
+    }
+
+    if (rejection) {
+	_rejected = true;
+
+	/* stay alive until the other check ended, it may
+	 * still have a process or query running
+	 */
+	if (_pending > 0)
+	    reference ();
+
+	finished.emit (rejection);
+	return;
+    }
+
+    if (_pending > 0)
+	return;
+
+    if (_restriction_rejection) {
+	finished.emit (_restriction_rejection);
+	return;
+    }
+
+    _call->finished.connect (sigc::mem_fun (*this, &FunctionCallChecked::main_call_finished));
+    _call->start_call();
+}
+
+void
+FunctionCallChecked::main_call_finished (Glib::RefPtr <XmlResult> result)
+{
+    finished.emit (result);
+}
@@ -0,0 +1,56 @@
+#ifndef LIBZIX_FUNCTION_CALL_CHECKED_H
+#define LIBZIX_FUNCTION_CALL_CHECKED_H
+
+#include "core_function_call.h"
+
+#include "xml_restriction.h"
+
+#include "signature_check_request.h"
+#include "signature_check_result.h"
+#include "restriction_check_request.h"
+#include "restriction_check_result.h"
+
+/**
+ * Runs the signature check and the restriction check of a call
+ * concurrently. The call is only started when both checks passed.
+ *
+ * A failed signature check takes precedence: it finishes the call with
+ * BadRequest right away. A failed restriction check is only reported
+ * once the signature check passed, so a request failing both checks
+ * always gets BadRequest, whichever check ends first.
+ *
+ * Either check request may be empty.
+ */
+class FunctionCallChecked : public FunctionCall
+{
+    public:
+	FunctionCallChecked (Glib::RefPtr <FunctionCall> call,
+			     Glib::RefPtr <SignatureCheckRequest> scr,
+			     Glib::RefPtr <RestrictionCheckRequest> rcr,
+			     const Glib::ustring & interface);
+
+	~FunctionCallChecked ();
+
+	static Glib::RefPtr <FunctionCall> create (Glib::RefPtr <FunctionCall> call,
+						   Glib::RefPtr <SignatureCheckRequest> scr,
+						   Glib::RefPtr <RestrictionCheckRequest> rcr,
+						   const Glib::ustring & interface);
+
+	void start_call ();
+
+    private:
+	Glib::RefPtr <FunctionCall> _call;
+	Glib::RefPtr <SignatureCheckRequest> _scr;
+	Glib::RefPtr <RestrictionCheckRequest> _rcr;
+	Glib::ustring _interface;
+
+	int _pending;
+	bool _rejected;
+	Glib::RefPtr <XmlResult> _restriction_rejection;
+
+	void signature_check_finished(Glib::RefPtr<SignatureCheckResult> result);
+	void restriction_check_finished(Glib::RefPtr<RestrictionCheckResult> result);
+	void check_finished (Glib::RefPtr <XmlResult> rejection);
+	void main_call_finished (Glib::RefPtr <XmlResult> result);
+};
+#endif
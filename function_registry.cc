@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "function_registry.h"
+
+#include "core_function_log.h"
+#include "core_function_get_files_list.h"
+#include "core_function_del_file.h"
+#include "core_function_get_file.h"
+#include "core_function_set_file.h"
+#include "core_function_get_conf.h"
+#include "core_function_set_conf.h"
+#include "core_function_data_sync.h"
+#include "core_function_data_out.h"
+#include "core_function_data_free.h"
+#include "core_function_data_in.h"
+#include "core_function_wrap_dc.h"
+#include "core_function_get_measurement.h"
+#include "core_function_get_measurements_list.h"
+#include "core_function_procedure.h"
+#include "core_function_exit.h"
+#include "core_function_update.h"
+
+using Inf     = ZixInterface::Inf;
+using Entry   = FunctionRegistry::Entry;
+using InfMask = FunctionRegistry::InfMask;
+
+constexpr FunctionRegistry::Id FunctionRegistry::UNKNOWN;
+
+static constexpr InfMask IPC               = FunctionRegistry::mask(Inf::IPC);
+static constexpr InfMask LAN_WEBSERVICE    = FunctionRegistry::mask(Inf::LANwebservice);
+static constexpr InfMask LAN_WEBSERVER     = FunctionRegistry::mask(Inf::LANwebserver);
+static constexpr InfMask LAN_SHARED_FOLDER = FunctionRegistry::mask(Inf::LANsharedfolder);
+static constexpr InfMask LAN_SOCKET        = FunctionRegistry::mask(Inf::LANsocket);
+static constexpr InfMask USB               = FunctionRegistry::mask(Inf::USB);
+static constexpr InfMask COM1              = FunctionRegistry::mask(Inf::COM1);
+static constexpr InfMask COM2              = FunctionRegistry::mask(Inf::COM2);
+
+static constexpr InfMask LAN_WEB  = LAN_WEBSERVICE | LAN_WEBSERVER;
+static constexpr InfMask FOLDERS  = LAN_SHARED_FOLDER | USB;
+static constexpr InfMask EXTERNAL = LAN_WEB | LAN_SOCKET | FOLDERS;
+static constexpr InfMask COM      = COM1 | COM2;
+// the webserver does not sign its requests
+static constexpr InfMask SIGNING  = EXTERNAL & ~LAN_WEBSERVER;
+
+// interfaces with an access list, the others (printer, unknown) may call everything
+static constexpr InfMask ACCESS_CHECKED = IPC | EXTERNAL | COM;
+
+// Sorted by fid. Interfaces not listed do not have access, need no signature
+// and no restriction check.
+static constexpr Entry table[] = {
+    // fid                 prio access                 signature        restriction      factory
+    { "dataFree",            1, IPC,                   0,               0,               &CoreFunctionDataFree::factory },
+    { "dataIn",              1, IPC,                   0,               0,               &CoreFunctionDataIn::factory },
+    { "dataOut",             1, IPC | LAN_WEB,         0,               0,               &CoreFunctionDataOut::factory },
+    { "dataSync",            2, IPC,                   0,               0,               &CoreFunctionDataSync::factory },
+    { "delFile",             1, EXTERNAL,              SIGNING,         EXTERNAL,        &CoreFunctionDelFile::factory },
+    { "delMeasurement",      1, EXTERNAL,              0,               0,               &CoreFunctionWrapDC::factory_del_measurement },
+    { "delProfile",          1, EXTERNAL,              0,               0,               &CoreFunctionWrapDC::factory_del_profile },
+    { "delTemplate",         1, EXTERNAL,              0,               EXTERNAL,        &CoreFunctionWrapDC::factory_del_template },
+    { "exit",                0, 0,                     0,               0,               &CoreFunctionExit::factory },
+    { "getCalibration",      1, EXTERNAL | COM,        0,               0,               &CoreFunctionWrapDC::factory_get_calibration },
+    { "getConf",             3, IPC | LAN_WEB,         0,               0,               &CoreFunctionGetConf::factory },
+    { "getDefaults",         1, EXTERNAL | COM,        0,               0,               &CoreFunctionWrapDC::factory_get_defaults },
+    { "getFile",             1, EXTERNAL,              SIGNING,         0,               &CoreFunctionGetFile::factory },
+    { "getFilesList",        1, EXTERNAL,              SIGNING,         0,               &CoreFunctionGetFilesList::factory },
+    { "getMeasurement",      1, EXTERNAL | COM,        0,               0,               &CoreFunctionGetMeasurement::factory },
+    { "getMeasurementsList", 0, EXTERNAL | COM,        0,               0,               &CoreFunctionGetMeasurementsList::factory },
+    { "getParameter",        1, EXTERNAL | COM,        0,               0,               &CoreFunctionWrapDC::factory_get_parameter },
+    { "getParametersList",   1, EXTERNAL | COM,        0,               0,               &CoreFunctionWrapDC::factory_get_parameters_list },
+    { "getProfile",          1, EXTERNAL | COM,        0,               0,               &CoreFunctionWrapDC::factory_get_profile },
+    { "getProfilesList",     1, EXTERNAL | COM,        0,               0,               &CoreFunctionWrapDC::factory_get_profiles_list },
+    { "getTemplate",         1, EXTERNAL,              SIGNING,         0,               &CoreFunctionWrapDC::factory_get_template },
+    { "getTemplatesList",    1, EXTERNAL | COM,        0,               0,               &CoreFunctionWrapDC::factory_get_templates_list },
+    { "guiIO",               3, IPC | EXTERNAL,        IPC | SIGNING,   0,               &CoreFunctionWrapDC::factory_gui_io },
+    { "log",                 0, IPC,                   0,               0,               &CoreFunctionLog::factory },
+    { "procedure",           1, FOLDERS,               FOLDERS,         FOLDERS,         &CoreFunctionProcedure::factory },
+    { "setCalibration",      1, EXTERNAL,              SIGNING,         EXTERNAL,        &CoreFunctionWrapDC::factory_set_calibration },
+    { "setConf",             3, IPC | LAN_WEBSERVER,   0,               0,               &CoreFunctionSetConf::factory },
+    { "setDefaults",         1, EXTERNAL,              SIGNING,         EXTERNAL,        &CoreFunctionWrapDC::factory_set_defaults },
+    { "setFile",             1, EXTERNAL,              SIGNING,         EXTERNAL,        &CoreFunctionSetFile::factory },
+    { "setMeasurement",      1, EXTERNAL,              0,               0,               &CoreFunctionWrapDC::factory_set_measurement },
+    { "setMeasurementsList", 1, EXTERNAL,              0,               0,               &CoreFunctionWrapDC::factory_set_measurements_list },
+    { "setParameter",        1, EXTERNAL,              0,               0,               &CoreFunctionWrapDC::factory_set_parameter },
+    { "setProfile",          1, EXTERNAL,              0,               0,               &CoreFunctionWrapDC::factory_set_profile },
+    { "setProfilesList",     1, EXTERNAL,              0,               0,               &CoreFunctionWrapDC::factory_set_profiles_list },
+    { "setTemplate",         1, EXTERNAL,              SIGNING,         EXTERNAL,        &CoreFunctionWrapDC::factory_set_template },
+    { "setTemplatesList",    1, EXTERNAL,              SIGNING,         EXTERNAL,        &CoreFunctionWrapDC::factory_set_templates_list },
+    { "update",              0, EXTERNAL | COM,        SIGNING | COM,   EXTERNAL | COM,  &CoreFunctionUpdate::factory },
+};
+
+static constexpr std::size_t table_size = sizeof(table) / sizeof(table[0]);
+
+static constexpr bool fid_less(const char *a, const char *b)
+{
+    return *a == *b ? *a != '\0' && fid_less(a + 1, b + 1)
+                    : static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b);
+}
+
+static constexpr bool sorted(std::size_t i)
+{
+    return i >= table_size || (fid_less(table[i - 1].fid, table[i].fid) && sorted(i + 1));
+}
+
+static_assert(sorted(1), "the function table has to be sorted by fid");
+
+FunctionRegistry::Id FunctionRegistry::lookup(const Glib::ustring& fid) noexcept
+{
+    const char *name = fid.c_str();
+    auto it = std::lower_bound(std::begin(table), std::end(table), name,
+                               [] (const Entry& e, const char *n) { return strcmp(e.fid, n) < 0; });
+
+    if (it == std::end(table) || strcmp(it->fid, name) != 0)
+        return UNKNOWN;
+
+    return it - std::begin(table);
+}
+
+const Entry *FunctionRegistry::get(Id id) noexcept
+{
+    if (id < 0 || static_cast<std::size_t>(id) >= table_size)
+        return nullptr;
+
+    return &table[id];
+}
+
+std::size_t FunctionRegistry::size() noexcept
+{
+    return table_size;
+}
+
+int FunctionRegistry::prio(Id id) noexcept
+{
+    auto entry = get(id);
+
+    return entry ? entry->prio : 0;
+}
+
+bool FunctionRegistry::can_be_accessed(Id id, const ZixInterface& inf) noexcept
+{
+    auto entry = get(id);
+
+    if (!(ACCESS_CHECKED & mask(inf.id())))
+        return true;
+
+    return entry && (entry->access & mask(inf.id()));
+}
+
+bool FunctionRegistry::signature_needed(Id id, const ZixInterface& inf) noexcept
+{
+    auto entry = get(id);
+
+    return entry && (entry->signature & mask(inf.id()));
+}
+
+bool FunctionRegistry::restriction_needed(Id id, const ZixInterface& inf) noexcept
+{
+    auto entry = get(id);
+
+    return entry && (entry->restriction & mask(inf.id()));
+}
@@ -0,0 +1,88 @@
+#ifndef _FUNCTION_REGISTRY_H_
+#define _FUNCTION_REGISTRY_H_
+
+#include <cstddef>
+
+#include <glibmm/refptr.h>
+#include <glibmm/ustring.h>
+
+#include "zix_interface.h"
+
+class CoreFunctionCall;
+class XmlParameterList;
+class XmlDescription;
+
+namespace xmlpp
+{
+    class Element;
+}
+
+/**
+ * \brief Properties of all functions callable via xml
+ *
+ * One constexpr table, sorted by fid, holds for every function its
+ * priority, the interfaces it may be called from, the interfaces which
+ * require a signature or a restriction check and the factory of its
+ * CoreFunctionCall. A request looks up its fid once and keeps the
+ * returned id, everything else is an index into the table. Interfaces
+ * are bits of ZixInterface::Inf.
+ *
+ * A new function is added with one line in function_registry.cc.
+ */
+class FunctionRegistry
+{
+public:
+    using Id      = int;
+    using InfMask = unsigned int;
+    using Factory = Glib::RefPtr<CoreFunctionCall> (*)(XmlParameterList parameters,
+                                                       Glib::RefPtr<XmlDescription> description,
+                                                       const Glib::ustring& textbody,
+                                                       const xmlpp::Element *en);
+
+    static constexpr Id UNKNOWN = -1;
+
+    struct Entry
+    {
+        const char *fid;
+        int prio;
+        InfMask access;
+        InfMask signature;
+        InfMask restriction;
+        Factory factory;
+    };
+
+    static constexpr InfMask mask(ZixInterface::Inf inf)
+    {
+        return 1u << static_cast<unsigned int>(inf);
+    }
+
+    /**
+     * @return id of fid, UNKNOWN if there is no such function
+     */
+    static Id lookup(const Glib::ustring& fid) noexcept;
+
+    /**
+     * @return nullptr for UNKNOWN
+     */
+    static const Entry *get(Id id) noexcept;
+
+    static std::size_t size() noexcept;
+
+    /**
+     * Priority of the function, 0 for UNKNOWN.
+     */
+    static int prio(Id id) noexcept;
+
+    /**
+     * Interfaces without an access list may call every function.
+     */
+    static bool can_be_accessed(Id id, const ZixInterface& inf) noexcept;
+    static bool signature_needed(Id id, const ZixInterface& inf) noexcept;
+    static bool restriction_needed(Id id, const ZixInterface& inf) noexcept;
+
+private:
+    FunctionRegistry()
+    {}
+};
+
+#endif /* _FUNCTION_REGISTRY_H_ */
@@ -1,13 +1,31 @@
 
 #include "gio_istream_adapter.h"
 
+#include <arpa/inet.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+
+/* bytes read at once, in length prefixed mode up to the remaining frame
+ * size is requested, but at most MAX_READ_SIZE
+ */
+static const gsize READ_SIZE = 16 * 1024;
+static const gsize MAX_READ_SIZE = 256 * 1024;
+
+const gsize GioIstreamAdapter::FRAME_HEADER_SIZE;
+const gsize GioIstreamAdapter::MAX_FRAME_SIZE;
 
 GioIstreamAdapter::GioIstreamAdapter (Glib::RefPtr <Gio::InputStream> gio_istream)
     : Glib::ObjectBase (typeid (GioIstreamAdapter))
     , _gio_istream (gio_istream)
+    , _length_prefixed (false)
+    , _invalid (false)
+    , _buffered (0)
+    , _frame_size (0)
+    , _xml_size (0)
 {
-    _gio_istream->read_bytes_async (1024, sigc::mem_fun (*this, &GioIstreamAdapter::received_bytes));
+    _gio_istream->read_bytes_async (read_size (), sigc::mem_fun (*this, &GioIstreamAdapter::received_bytes));
 }
 
 Glib::RefPtr <GioIstreamAdapter>
@@ -16,63 +34,199 @@ GioIstreamAdapter::create (Glib::RefPtr <Gio::InputStream> gio_istream)
     return Glib::RefPtr <GioIstreamAdapter> (new GioIstreamAdapter (gio_istream));
 }
 
+void
+GioIstreamAdapter::set_length_prefixed ()
+{
+    _length_prefixed = true;
+}
+
+std::list <Glib::RefPtr <Glib::Bytes> >
+GioIstreamAdapter::slice (const std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list, gsize begin, gsize end)
+{
+    std::list <Glib::RefPtr <Glib::Bytes> > ret;
+    gsize pos = 0;
+
+    for (auto && bytes : bytes_list) {
+	gsize size = bytes->get_size ();
+	gsize from = std::max (begin, pos);
+	gsize to = std::min (end, pos + size);
+
+	if (from == pos && to == pos + size)
+	    ret.push_back (bytes);
+	else if (from < to)
+	    ret.push_back (Glib::wrap (g_bytes_new_from_bytes (bytes->gobj (), from - pos, to - from)));
+	pos += size;
+    }
+
+    return ret;
+}
+
+gsize
+GioIstreamAdapter::read_size () const
+{
+    if (!_length_prefixed || _frame_size <= _buffered)
+	return READ_SIZE;
+
+    return std::min (std::max (_frame_size - _buffered, READ_SIZE), MAX_READ_SIZE);
+}
+
 /**
  * Check last element of _bytes_list for zero
+ *
+ * The elements before have been checked when they were received.
  */
 int
 GioIstreamAdapter::bytes_list_check_zero ()
 {
-    gsize i;
     gsize size;
 
     if (_bytes_list.empty())
         return -1;
 
-    uint8_t *ptr = (uint8_t *) _bytes_list.back()->get_data (size);
+    auto ptr = static_cast <const char *> (_bytes_list.back()->get_data (size));
+    auto zero = static_cast <const char *> (memchr (ptr, 0, size));
 
-    for (i=0; i<size; i++) {
-	if (ptr[i] == 0x0)
-	    return i;
-    }
+    if (!zero)
+	return -1;
 
-    /* fallthrough,
-     * did not find zero
-     */
-    return -1;
+    return zero - ptr;
 }
 
 /**
- * Split last Element of _bytes_list, and return all but the new last Element.
+ * Remove the first size bytes of _bytes_list and return them, then drop
+ * another skip bytes. The data is not copied, a split element is shared.
  */
 std::list <Glib::RefPtr <Glib::Bytes> >
-GioIstreamAdapter::pop_bytes_list (uint32_t index)
+GioIstreamAdapter::pop_bytes_list (gsize size, gsize skip)
 {
-    std::list <Glib::RefPtr <Glib::Bytes> > retval = _bytes_list;
-    Glib::RefPtr <Glib::Bytes> last = retval.back();
+    std::list <Glib::RefPtr <Glib::Bytes> > retval;
 
-    retval.pop_back();
-    _bytes_list.clear();
+    assert (size + skip <= _buffered);
+    _buffered -= size + skip;
 
-    gsize last_size;
-    const uint8_t * last_data = (const uint8_t *) last->get_data (last_size);
+    while (size + skip > 0) {
+	auto & front = _bytes_list.front ();
+	gsize front_size = front->get_size ();
+	gsize take = std::min (front_size, size + skip);
 
-    if (index > 0) {
-	auto new_last = Glib::Bytes::create (last_data, index);
-	retval.push_back (new_last);
-    }
+	if (size > 0) {
+	    gsize len = std::min (take, size);
 
-    if (index != (last_size - 1)) {
-	auto remain = Glib::Bytes::create (last_data + index + 1, last_size - index - 1);
-	_bytes_list.push_back (remain);
+	    if (len == front_size)
+		retval.push_back (front);
+	    else
+		retval.push_back (Glib::wrap (g_bytes_new_from_bytes (front->gobj (), 0, len)));
+	    size -= len;
+	    skip -= take - len;
+	} else {
+	    skip -= take;
+	}
+
+	if (take == front_size)
+	    _bytes_list.pop_front ();
+	else
+	    front = Glib::wrap (g_bytes_new_from_bytes (front->gobj (), take, front_size - take));
     }
 
     return retval;
 }
 
+/**
+ * Emit the next NUL terminated request, if complete.
+ */
+bool
+GioIstreamAdapter::pop_request ()
+{
+    int index = bytes_list_check_zero ();
+
+    if (index == -1)
+	return false;
+
+    gsize size = _buffered - _bytes_list.back ()->get_size () + index;
+
+    auto pop_list = pop_bytes_list (size, 1);
+    stream_read.emit (pop_list);
+
+    return true;
+}
+
+/**
+ * Emit the next length prefixed frame, if complete.
+ */
+bool
+GioIstreamAdapter::pop_frame ()
+{
+    if (_frame_size == 0) {
+	guint32 header[2];
+	gsize pos = 0;
+
+	if (_buffered < FRAME_HEADER_SIZE)
+	    return false;
+
+	for (auto && bytes : _bytes_list) {
+	    gsize size;
+	    auto data = bytes->get_data (size);
+	    gsize len = std::min (size, FRAME_HEADER_SIZE - pos);
+
+	    memcpy (reinterpret_cast <char *> (header) + pos, data, len);
+	    pos += len;
+	    if (pos == FRAME_HEADER_SIZE)
+		break;
+	}
+
+	/* the sum may not fit into gsize on 32 bit targets
+	 */
+	guint64 xml_size = ntohl (header[0]);
+	guint64 attachment_size = ntohl (header[1]);
+
+	if (xml_size + attachment_size > MAX_FRAME_SIZE) {
+	    _invalid = true;
+	    frame_invalid.emit ();
+	    return false;
+	}
+
+	_xml_size = xml_size;
+	_frame_size = FRAME_HEADER_SIZE + xml_size + attachment_size;
+    }
+
+    if (_buffered < _frame_size)
+	return false;
+
+    auto frame = pop_bytes_list (_frame_size, 0);
+    auto xml = slice (frame, FRAME_HEADER_SIZE, FRAME_HEADER_SIZE + _xml_size);
+    auto attachment_list = slice (frame, FRAME_HEADER_SIZE + _xml_size, _frame_size);
+    Glib::RefPtr <Glib::Bytes> attachment;
+
+    if (attachment_list.size () == 1) {
+	attachment = attachment_list.front ();
+    } else if (attachment_list.size () > 1) {
+	/* consumers want a single buffer, copy once
+	 */
+	gsize size = _frame_size - FRAME_HEADER_SIZE - _xml_size;
+	auto data = static_cast <char *> (g_malloc (size));
+	gsize pos = 0;
+
+	for (auto && bytes : attachment_list) {
+	    gsize len;
+	    auto src = bytes->get_data (len);
+
+	    memcpy (data + pos, src, len);
+	    pos += len;
+	}
+	attachment = Glib::wrap (g_bytes_new_take (data, size));
+    }
+
+    _frame_size = 0;
+    _xml_size = 0;
+
+    frame_read.emit (xml, attachment);
+
+    return true;
+}
+
 void
 GioIstreamAdapter::received_bytes (Glib::RefPtr<Gio::AsyncResult>& result)
 {
-    int index;
     auto source =  Glib::RefPtr <Gio::InputStream>::cast_dynamic (result->get_source_object ());
 
     assert (source);
@@ -85,27 +239,30 @@ GioIstreamAdapter::received_bytes (Glib::RefPtr<Gio::AsyncResult>& result)
 
     if (bytes->get_size() == 0) {
 	/* end of file
-	 * emit done signa
+	 * emit done signa, an incomplete frame is dropped
 	 */
-	stream_read.emit (_bytes_list);
+	if (!_length_prefixed)
+	    stream_read.emit (_bytes_list);
     stream_eof.emit();
 	return;
     }
 
     _bytes_list.push_back (bytes);
+    _buffered += bytes->get_size ();
 
-    /* now check whether we see a zero terminator,
-     * and emit all bytes up to that zero
+    /* now check whether we see a zero terminator or a complete frame,
+     * and emit all bytes up to its end
      *
-     * rinse and repeat until we see no more zeros
+     * rinse and repeat until there are no more. The mode may change
+     * while a request is handled.
      */
-    while ((index = bytes_list_check_zero ()) != -1)
-    {
-	auto pop_list = pop_bytes_list (index);
-	stream_read.emit (pop_list);
-    }
+    while (_length_prefixed ? pop_frame () : pop_request ())
+	;
+
+    if (_invalid)
+	return;
 
     /* start another read
      */
-    source->read_bytes_async (1024, sigc::mem_fun (*this, &GioIstreamAdapter::received_bytes));
+    source->read_bytes_async (read_size (), sigc::mem_fun (*this, &GioIstreamAdapter::received_bytes));
 }
@@ -15,6 +15,11 @@
  * This class reads out a Gio::InputStream into a std::list
  * of Glib::RefPtr <Glib::Bytes>. Reads until EOF.
  * Then emits stream_read signal with Data as Parameter.
+ *
+ * By default requests are NUL terminated. After set_length_prefixed()
+ * each frame starts with two 32 bit lengths in network byte order, the
+ * size of the xml part and the size of the binary attachment following
+ * it. Complete frames are emitted with frame_read.
  */
 class GioIstreamAdapter : public Glib::Object
 {
@@ -26,11 +31,45 @@ class GioIstreamAdapter : public Glib::Object
 	 */
 	static Glib::RefPtr <GioIstreamAdapter> create (Glib::RefPtr <Gio::InputStream> gio_istream);
 
+	/**
+	 * Size of the length prefix of a frame
+	 */
+	static const gsize FRAME_HEADER_SIZE = 8;
+
+	/**
+	 * Maximum size of xml part plus attachment of a single frame
+	 */
+	static const gsize MAX_FRAME_SIZE = 512 * 1024 * 1024;
+
+	/**
+	 * Switch to length prefixed frames, bytes already received after
+	 * the current request are parsed as frames.
+	 */
+	void set_length_prefixed ();
+
+	/**
+	 * Bytes list for the range [begin, end), sharing the data of bytes_list.
+	 */
+	static std::list <Glib::RefPtr <Glib::Bytes> > slice (const std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list,
+							     gsize begin, gsize end);
+
 	/**
 	 * Signal is emitted, whenever a single request was received
 	 */
 	sigc::signal<void, std::list <Glib::RefPtr <Glib::Bytes> > > stream_read;
 
+	/**
+	 * Signal is emitted, whenever a length prefixed frame was received:
+	 * xml part and attachment (empty, if the frame has none)
+	 */
+	sigc::signal<void, std::list <Glib::RefPtr <Glib::Bytes> >, Glib::RefPtr <Glib::Bytes> > frame_read;
+
+	/**
+	 * Signal is emitted, when a frame header announces more than
+	 * MAX_FRAME_SIZE bytes. Nothing is read afterwards.
+	 */
+	sigc::signal<void> frame_invalid;
+
     /**
      * Signal is emitted, whenever EOF is read
      */
@@ -41,9 +80,18 @@ class GioIstreamAdapter : public Glib::Object
 	Glib::RefPtr <Gio::InputStream> _gio_istream;
 
     private:
+	bool _length_prefixed;
+	bool _invalid;
+	gsize _buffered;
+	gsize _frame_size;
+	gsize _xml_size;
+
 	void received_bytes (Glib::RefPtr<Gio::AsyncResult>& result);
 
+	bool pop_request ();
+	bool pop_frame ();
 	int bytes_list_check_zero ();
-	std::list <Glib::RefPtr <Glib::Bytes> > pop_bytes_list (uint32_t index);
+	std::list <Glib::RefPtr <Glib::Bytes> > pop_bytes_list (gsize size, gsize skip);
+	gsize read_size () const;
 };
 #endif
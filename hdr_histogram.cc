@@ -0,0 +1,269 @@
+
+#include "hdr_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+static int
+count_leading_zeros (guint64 value)
+{
+    return __builtin_clzll (value);
+}
+
+HdrHistogram::HdrHistogram (gint64 lowest, gint64 highest, int significant_digits)
+    : _lowest (lowest)
+    , _highest (highest)
+    , _total_count (0)
+    , _min (std::numeric_limits <gint64>::max ())
+    , _max (0)
+{
+    if (lowest < 1 || highest < 2 * lowest || significant_digits < 1 || significant_digits > 5)
+	throw std::invalid_argument ("HdrHistogram: invalid range or precision");
+
+    gint64 largest_single_unit = 2 * static_cast <gint64> (std::pow (10, significant_digits));
+    int sub_bucket_count_magnitude = static_cast <int> (std::ceil (std::log2 (largest_single_unit)));
+
+    _unit_magnitude = static_cast <int> (std::floor (std::log2 (lowest)));
+    _sub_bucket_half_count_magnitude = std::max (sub_bucket_count_magnitude, 1) - 1;
+    _sub_bucket_count = G_GINT64_CONSTANT (1) << (_sub_bucket_half_count_magnitude + 1);
+    _sub_bucket_half_count = _sub_bucket_count / 2;
+    _sub_bucket_mask = (_sub_bucket_count - 1) << _unit_magnitude;
+
+    /* buckets needed to cover highest, each one doubles the range
+     */
+    gint64 smallest_untrackable = _sub_bucket_count << _unit_magnitude;
+    _bucket_count = 1;
+    while (smallest_untrackable <= highest) {
+	if (smallest_untrackable > std::numeric_limits <gint64>::max () / 2) {
+	    ++_bucket_count;
+	    break;
+	}
+	smallest_untrackable <<= 1;
+	++_bucket_count;
+    }
+
+    _counts.resize ((_bucket_count + 1) * _sub_bucket_half_count, 0);
+}
+
+int
+HdrHistogram::bucket_index (gint64 value) const
+{
+    int pow2_ceiling = 64 - count_leading_zeros (value | _sub_bucket_mask);
+
+    return pow2_ceiling - _unit_magnitude - (_sub_bucket_half_count_magnitude + 1);
+}
+
+int
+HdrHistogram::counts_index (int bucket_index, int sub_bucket_index) const
+{
+    int bucket_base_index = (bucket_index + 1) << _sub_bucket_half_count_magnitude;
+
+    return bucket_base_index + sub_bucket_index - _sub_bucket_half_count;
+}
+
+int
+HdrHistogram::counts_index_for (gint64 value) const
+{
+    int bucket = bucket_index (value);
+    int sub_bucket = static_cast <int> (value >> (bucket + _unit_magnitude));
+
+    return counts_index (bucket, sub_bucket);
+}
+
+gint64
+HdrHistogram::value_at_index (int index) const
+{
+    int bucket = (index >> _sub_bucket_half_count_magnitude) - 1;
+    gint64 sub_bucket = (index & (_sub_bucket_half_count - 1)) + _sub_bucket_half_count;
+
+    if (bucket < 0) {
+	sub_bucket -= _sub_bucket_half_count;
+	bucket = 0;
+    }
+
+    return sub_bucket << (bucket + _unit_magnitude);
+}
+
+gint64
+HdrHistogram::equivalent_range (gint64 value) const
+{
+    int bucket = bucket_index (value);
+    gint64 sub_bucket = value >> (bucket + _unit_magnitude);
+    int adjusted_bucket = sub_bucket >= _sub_bucket_count ? bucket + 1 : bucket;
+
+    return G_GINT64_CONSTANT (1) << (_unit_magnitude + adjusted_bucket);
+}
+
+gint64
+HdrHistogram::lowest_equivalent (gint64 value) const
+{
+    int bucket = bucket_index (value);
+    gint64 sub_bucket = value >> (bucket + _unit_magnitude);
+
+    return sub_bucket << (bucket + _unit_magnitude);
+}
+
+gint64
+HdrHistogram::highest_equivalent (gint64 value) const
+{
+    return lowest_equivalent (value) + equivalent_range (value) - 1;
+}
+
+gint64
+HdrHistogram::median_equivalent (gint64 value) const
+{
+    return lowest_equivalent (value) + equivalent_range (value) / 2;
+}
+
+void
+HdrHistogram::record (gint64 value, gint64 count)
+{
+    value = std::max <gint64> (0, std::min (value, _highest));
+
+    _counts[counts_index_for (value)] += count;
+    _total_count += count;
+    _min = std::min (_min, value);
+    _max = std::max (_max, value);
+}
+
+void
+HdrHistogram::add (const HdrHistogram & other)
+{
+    for (std::size_t i = 0; i < other._counts.size (); ++i)
+	if (other._counts[i])
+	    record (other.value_at_index (i), other._counts[i]);
+
+    /* keep the exact extremes, not the bucket values
+     */
+    if (other._total_count) {
+	_min = std::min (_min, std::min (other._min, _highest));
+	_max = std::max (_max, std::min (other._max, _highest));
+    }
+}
+
+void
+HdrHistogram::reset ()
+{
+    std::fill (_counts.begin (), _counts.end (), 0);
+    _total_count = 0;
+    _min = std::numeric_limits <gint64>::max ();
+    _max = 0;
+}
+
+gint64
+HdrHistogram::min () const
+{
+    return _total_count ? _min : 0;
+}
+
+gint64
+HdrHistogram::max () const
+{
+    return _max;
+}
+
+double
+HdrHistogram::mean () const
+{
+    if (!_total_count)
+	return 0;
+
+    double sum = 0;
+    for (std::size_t i = 0; i < _counts.size (); ++i)
+	if (_counts[i])
+	    sum += static_cast <double> (median_equivalent (value_at_index (i))) * _counts[i];
+
+    return sum / _total_count;
+}
+
+double
+HdrHistogram::stddev () const
+{
+    if (!_total_count)
+	return 0;
+
+    double m = mean ();
+    double sum = 0;
+    for (std::size_t i = 0; i < _counts.size (); ++i)
+	if (_counts[i]) {
+	    double dev = median_equivalent (value_at_index (i)) - m;
+	    sum += dev * dev * _counts[i];
+	}
+
+    return std::sqrt (sum / _total_count);
+}
+
+gint64
+HdrHistogram::value_at_percentile (double percentile) const
+{
+    percentile = std::min (std::max (percentile, 0.0), 100.0);
+
+    gint64 count_at = static_cast <gint64> (percentile / 100 * _total_count + 0.5);
+    gint64 total = 0;
+
+    count_at = std::max <gint64> (count_at, 1);
+    for (std::size_t i = 0; i < _counts.size (); ++i) {
+	total += _counts[i];
+	if (total >= count_at)
+	    return std::min (highest_equivalent (value_at_index (i)), _max);
+    }
+
+    return 0;
+}
+
+void
+HdrHistogram::write_percentiles (std::ostream & os, int ticks_per_half_distance,
+				 double unit_ratio) const
+{
+    std::ios::fmtflags flags = os.flags ();
+
+    os << std::fixed
+       << std::setw (12) << "Value" << " " << std::setw (14) << "Percentile" << " "
+       << std::setw (10) << "TotalCount" << " " << std::setw (14) << "1/(1-Percentile)"
+       << "\n\n";
+
+    /* the percentile steps get finer towards 100, see HdrHistogram's
+     * PercentileIterator
+     */
+    gint64 total = 0;
+    std::size_t index = 0;
+    double percentile = 0;
+
+    while (_total_count) {
+	gint64 count_at = std::max <gint64> (1, static_cast <gint64> (percentile / 100 * _total_count + 0.5));
+
+	while (index < _counts.size () && total + _counts[index] < count_at)
+	    total += _counts[index++];
+	if (index >= _counts.size ())
+	    break;
+
+	gint64 value = std::min (highest_equivalent (value_at_index (index)), _max);
+	gint64 reached = total + _counts[index];
+
+	os << std::setprecision (3) << std::setw (12) << value / unit_ratio << " "
+	   << std::setprecision (12) << std::setw (14) << percentile / 100 << " "
+	   << std::setw (10) << reached;
+	if (reached < _total_count)
+	    os << " " << std::setprecision (2) << std::setw (14) << 1 / (1 - percentile / 100);
+	os << "\n";
+
+	if (reached >= _total_count)
+	    break;
+
+	double half_distance = std::pow (2, std::floor (std::log2 (100 / (100 - percentile))) + 1);
+	percentile += 100 / (ticks_per_half_distance * half_distance);
+    }
+
+    os << std::setprecision (3)
+       << "#[Mean    = " << std::setw (12) << mean () / unit_ratio
+       << ", StdDeviation   = " << std::setw (12) << stddev () / unit_ratio << "]\n"
+       << "#[Max     = " << std::setw (12) << max () / unit_ratio
+       << ", Total count    = " << std::setw (12) << _total_count << "]\n"
+       << "#[Buckets = " << std::setw (12) << _bucket_count
+       << ", SubBuckets     = " << std::setw (12) << _sub_bucket_count << "]\n";
+
+    os.flags (flags);
+}
@@ -0,0 +1,69 @@
+#ifndef LIBZIX_HDR_HISTOGRAM_H
+#define LIBZIX_HDR_HISTOGRAM_H
+
+#include <glib.h>
+
+#include <ostream>
+#include <vector>
+
+/**
+ * \brief High dynamic range histogram
+ *
+ * Records values between lowest and highest with a fixed number of
+ * significant decimal digits, in constant memory and time per value
+ * (the layout of HdrHistogram by Gil Tene). Values above highest are
+ * recorded as highest.
+ */
+class HdrHistogram
+{
+    public:
+	HdrHistogram (gint64 lowest, gint64 highest, int significant_digits);
+
+	void record (gint64 value, gint64 count = 1);
+	void add (const HdrHistogram & other);
+	void reset ();
+
+	gint64 total_count () const { return _total_count; }
+	gint64 min () const;
+	gint64 max () const;
+	double mean () const;
+	double stddev () const;
+
+	/**
+	 * Highest value of the bucket, which contains the given percentile
+	 * (0..100) of the recorded values.
+	 */
+	gint64 value_at_percentile (double percentile) const;
+
+	/**
+	 * Write the percentile distribution in the .hgrm format of
+	 * HdrHistogram, values are divided by unit_ratio.
+	 */
+	void write_percentiles (std::ostream & os, int ticks_per_half_distance = 5,
+				double unit_ratio = 1) const;
+
+    private:
+	int bucket_index (gint64 value) const;
+	int counts_index (int bucket_index, int sub_bucket_index) const;
+	int counts_index_for (gint64 value) const;
+	gint64 value_at_index (int index) const;
+	gint64 lowest_equivalent (gint64 value) const;
+	gint64 highest_equivalent (gint64 value) const;
+	gint64 median_equivalent (gint64 value) const;
+	gint64 equivalent_range (gint64 value) const;
+
+	gint64 _lowest;
+	gint64 _highest;
+	int _unit_magnitude;
+	int _sub_bucket_half_count_magnitude;
+	gint64 _sub_bucket_count;
+	gint64 _sub_bucket_half_count;
+	gint64 _sub_bucket_mask;
+	int _bucket_count;
+	std::vector <gint64> _counts;
+	gint64 _total_count;
+	gint64 _min;
+	gint64 _max;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <libxml/parser.h>
+
+#include "ingest_batch_request.h"
+#include "utils.h"
+
+IngestBatchRequest::IngestBatchRequest(const EntryList& entries)
+    : _entries(entries)
+{
+    // libxml2 has to be initialized from the main thread before parsers
+    // are used in other threads
+    xmlInitParser();
+
+    _done.connect(sigc::mem_fun(*this, &IngestBatchRequest::on_done));
+}
+
+IngestBatchRequest::~IngestBatchRequest()
+{
+    if (_worker.joinable())
+        _worker.join();
+}
+
+Glib::RefPtr<IngestBatchRequest> IngestBatchRequest::create(const EntryList& entries)
+{
+    return Glib::RefPtr<IngestBatchRequest>(new IngestBatchRequest(entries));
+}
+
+std::string IngestBatchRequest::read_whole_file(const std::string& path)
+{
+    struct stat sb;
+    std::string content;
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Failed to open file " + path + ": " + strerror(errno));
+
+    if (fstat(fd, &sb)) {
+        int err = errno;
+        close(fd);
+        throw std::runtime_error("Failed to stat file " + path + ": " + strerror(err));
+    }
+
+    content.resize(sb.st_size);
+
+    std::size_t pos = 0;
+    while (pos < content.size()) {
+        ssize_t ret = read(fd, &content[pos], content.size() - pos);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret < 0) {
+            int err = errno;
+            close(fd);
+            throw std::runtime_error("Failed to read file " + path + ": " + strerror(err));
+        }
+        if (ret == 0)
+            break;
+        pos += ret;
+    }
+    content.resize(pos);
+
+    close(fd);
+
+    return content;
+}
+
+void IngestBatchRequest::start_read()
+{
+    PRINT_DEBUG("IngestBatchRequest::start_read(): " << _entries.size() << " files");
+    _worker = std::thread(&IngestBatchRequest::run, this);
+}
+
+void IngestBatchRequest::run()
+{
+    // NOTE: runs in worker thread, no logging or signals in here
+    for (auto&& entry : _entries) {
+        std::string content;
+
+        try {
+            content = read_whole_file(entry.in_path);
+        } catch (const std::exception& ex) {
+            entry.error = ex.what();
+            entry.read_failed = true;
+            continue;
+        }
+
+        try {
+            auto parser = std::make_shared<xmlpp::DomParser>();
+            parser->parse_memory_raw(
+                reinterpret_cast<const unsigned char *>(content.data()),
+                content.size());
+            entry.parser = parser;
+        } catch (const std::exception& ex) {
+            entry.error = ex.what();
+            entry.content = std::move(content);
+        }
+    }
+
+    _done.emit();
+}
+
+void IngestBatchRequest::on_done()
+{
+    if (_worker.joinable())
+        _worker.join();
+
+    auto signal = IngestBatchResult::create(_entries);
+    finished.emit(signal);
+}
@@ -0,0 +1,61 @@
+#ifndef _INGEST_BATCH_REQUEST_H_
+#define _INGEST_BATCH_REQUEST_H_
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+#include <glibmm/dispatcher.h>
+
+#include <sigc++/signal.h>
+
+#include "ingest_entry.h"
+#include "ingest_batch_result.h"
+
+/**
+ * This class reads a batch of request files and parses them into DOM
+ * documents on a worker thread. Each file is read with a single read(2).
+ * The end of the operation will be channeled by the `finished` signal in
+ * the main loop, with the entries in their original order.
+ *
+ * Example of usage:
+ *   auto req = IngestBatchRequest::create(entries);
+ *   req->finished.connect(sigc::ptr_fun(&foobar));
+ *   req->start_read();
+ */
+class IngestBatchRequest : public Glib::Object
+{
+public:
+    using EntryList = IngestBatchResult::EntryList;
+
+    explicit IngestBatchRequest(const EntryList& entries);
+
+    ~IngestBatchRequest();
+
+    static Glib::RefPtr<IngestBatchRequest> create(const EntryList& entries);
+
+    /**
+     * Read the whole file with a single read.
+     *
+     * @param path file
+     *
+     * @return file content
+     */
+    static std::string read_whole_file(const std::string& path);
+
+    void start_read();
+
+    sigc::signal<void, const Glib::RefPtr<IngestBatchResult>& > finished;
+
+private:
+    EntryList _entries;
+    std::thread _worker;
+    Glib::Dispatcher _done;
+
+    void run();
+    void on_done();
+};
+
+#endif /* _INGEST_BATCH_REQUEST_H_ */
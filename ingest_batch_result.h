@@ -0,0 +1,38 @@
+#ifndef _INGEST_BATCH_RESULT_H_
+#define _INGEST_BATCH_RESULT_H_
+
+#include <vector>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+
+#include "ingest_entry.h"
+
+class IngestBatchResult : public Glib::Object
+{
+public:
+    using EntryList = std::vector<IngestEntry>;
+
+    IngestBatchResult(const EntryList& entries) :
+        _entries(entries)
+    {}
+
+    inline static Glib::RefPtr<IngestBatchResult>
+    create(const EntryList& entries)
+    {
+        return Glib::RefPtr<IngestBatchResult>(new IngestBatchResult(entries));
+    }
+
+    /**
+     * Entries in the order they were passed to the request.
+     */
+    inline const EntryList& entries() const
+    {
+        return _entries;
+    }
+
+private:
+    EntryList _entries;
+};
+
+#endif /* _INGEST_BATCH_RESULT_H_ */
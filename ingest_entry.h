@@ -0,0 +1,36 @@
+#ifndef _INGEST_ENTRY_H_
+#define _INGEST_ENTRY_H_
+
+#include <string>
+#include <memory>
+
+#include <libxml++/parsers/domparser.h>
+
+/**
+ * \brief One request file read and parsed by IngestBatchRequest.
+ *
+ * After reading, either parser holds the parsed request document or
+ * error describes why the file could not be read (read_failed) or parsed.
+ * Files which could be read but not parsed keep their content, the
+ * XmlProcessor answers them like any other malformed request.
+ */
+class IngestEntry
+{
+public:
+    IngestEntry() :
+        read_failed{false}
+    {}
+
+    IngestEntry(const std::string& s1, const std::string& s2) :
+        in_path{s1}, out_path{s2}, read_failed{false}
+    {}
+
+    std::string in_path;
+    std::string out_path;
+    std::shared_ptr<xmlpp::DomParser> parser;
+    std::string content;
+    std::string error;
+    bool read_failed;
+};
+
+#endif /* _INGEST_ENTRY_H_ */
@@ -2,8 +2,21 @@
 #include "interface_connection.h"
 
 InterfaceConnection::InterfaceConnection (const Glib::ustring & resume_reply_file)
-    : _resume_reply_file (resume_reply_file)
+    : _supports_attachments (false)
+    , _resume_reply_file (resume_reply_file)
 { }
 
 InterfaceConnection::~InterfaceConnection ()
 { }
+
+void
+InterfaceConnection::emit_result_stream (const Glib::RefPtr <XmlResultStream> & result, int tid)
+{
+    emit_result (result->to_xml (), tid);
+}
+
+void
+InterfaceConnection::emit_result_buffer (const SharedBuffer & result, int tid)
+{
+    emit_result (result.to_ustring (), tid);
+}
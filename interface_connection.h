@@ -5,9 +5,13 @@
 
 #include <glibmm/object.h>
 #include <glibmm/ustring.h>
+#include <glibmm/bytes.h>
 
 #include <sigc++/signal.h>
 
+#include "xml_result_stream.h"
+#include "shared_buffer.h"
+
 /**
  * \brief Baseclass for Interface Connections
  *
@@ -22,20 +26,47 @@ class InterfaceConnection : virtual public Glib::Object
 	InterfaceConnection (const Glib::ustring & resume_reply_file);
 
 	sigc::signal <void, std::istream &, int> request_ready;
-	sigc::signal <void, const Glib::ustring &, int> response_ready;
+	sigc::signal <void, const Glib::RefPtr <XmlResult> &, int> response_ready;
 	sigc::signal <void> connection_errored;
 	sigc::signal <void> connection_closed;
 
 	virtual ~InterfaceConnection();
 	virtual void emit_result (const Glib::ustring &result, int tid) = 0;
+
+	/**
+	 * Emit a result containing file contents. Connections which can
+	 * write in chunks override this, the default emits result->to_xml().
+	 */
+	virtual void emit_result_stream (const Glib::RefPtr <XmlResultStream> & result, int tid);
+
+	/**
+	 * Emit a result built with XmlResult::to_buffer (). Connections which
+	 * can send the segments as they are override this, the default
+	 * flattens the buffer for emit_result().
+	 */
+	virtual void emit_result_buffer (const SharedBuffer & result, int tid);
 	virtual void cancel () = 0;
 
 	const Glib::ustring & get_resume_reply_file () { return _resume_reply_file; }
         const Glib::ustring & get_filename () { return _filename; }
 
+	/**
+	 * Binary attachment of the request currently emitted with
+	 * request_ready, empty if it has none.
+	 */
+	const Glib::RefPtr <Glib::Bytes> & get_attachment () const { return _attachment; }
+
+	/**
+	 * Whether replies may carry a binary attachment section, see
+	 * XmlResultStream::add_file_attachment.
+	 */
+	bool supports_attachments () const { return _supports_attachments; }
+
     protected:
         // original filename of xml request if comming from file interface
         Glib::ustring _filename;
+	Glib::RefPtr <Glib::Bytes> _attachment;
+	bool _supports_attachments;
 
     private:
 	Glib::ustring _resume_reply_file;
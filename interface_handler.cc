@@ -29,6 +29,12 @@ InterfaceHandler::register_connection (std::shared_ptr <InterfaceConnection> con
 					     false));
 }
 
+void
+InterfaceHandler::dispatch_document (std::shared_ptr <InterfaceConnection> conn, std::shared_ptr <xmlpp::DomParser> parser)
+{
+    _xml_processor->parse_document (parser, 0, 0, std::weak_ptr<InterfaceConnection>(conn), _name);
+}
+
 void
 InterfaceHandler::deregister_connection(std::weak_ptr<InterfaceConnection> conn)
 {
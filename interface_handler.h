@@ -37,10 +37,18 @@ public:
     static Glib::RefPtr<InterfaceHandler> getInterface( const Glib::ustring &name );
     static void register_handler( Glib::RefPtr<InterfaceHandler> );
 
+    const Glib::ustring & get_name () const { return _name; }
+
 protected:
     void register_connection (std::shared_ptr <InterfaceConnection> conn);
     void deregister_connection(std::weak_ptr <InterfaceConnection> conn);
 
+    /**
+     * Hand a document parsed outside of the connection over to the
+     * xml_processor, answering on the given (registered) connection.
+     */
+    void dispatch_document (std::shared_ptr <InterfaceConnection> conn, std::shared_ptr <xmlpp::DomParser> parser);
+
     ZixInterface _inf;
     Glib::ustring _name;
 private:
@@ -30,15 +30,36 @@ bool LanWatchdog::timeout_handler()
     if (!_activated || _in_progress)
         return true;
 
+    try {
+        // On local folders the monitor drives the scans, the timer only
+        // (re)installs it. Network shares are polled.
+        if (_monitors.empty()) {
+            if (watch_folder(this->get_root_folder() + "/" + _input_folder))
+                PRINT_DEBUG("Lan watchdog switched to change events");
+        } else if (!_dirty) {
+            return true;
+        }
+    } catch (const std::exception& ex) {
+        PRINT_ERROR(ex.what());
+        return true;
+    }
+
+    _dirty = false;
+    scan_input();
+
+    return true;
+}
+
+void LanWatchdog::scan_input()
+{
     PRINT_DEBUG("Running lan watch dog for folder " << _input_folder);
 
     try {
-        auto conf_handler = ConfHandler::get_instance();
         _folder_list = create_file_list(this->get_root_folder() + "/" + _input_folder);
         sort_file_list(_folder_list);
 
         if (_folder_list.empty())
-            return true;
+            return;
 
         _in_progress = true;
         _folder_it = _folder_list.cbegin();
@@ -47,6 +68,4 @@ bool LanWatchdog::timeout_handler()
         PRINT_ERROR(ex.what());
 	_in_progress = false;
     }
-
-    return true;
 }
@@ -13,8 +13,8 @@
 /**
  * \brief LanWatchdog.
  *
- * Handles Lan Shared Folder input in a periodic way which is specified by
- * a timeout.
+ * Handles Lan Shared Folder input. Network shares are polled in a periodic
+ * way which is specified by a timeout, local folders are watched for changes.
  */
 class LanWatchdog final : public Watchdog
 {
@@ -32,6 +32,8 @@ private:
 
     bool timeout_handler();
 
+    void scan_input() override;
+
     ZixInterface get_zix_interface() const override
     {
         return STR_ZIXINF_LANSHAREDFOLDER;
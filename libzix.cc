@@ -39,12 +39,17 @@
 #include "monitor_uptime.h"
 #include "monitor_directory.h"
 #include "monitor_disk_usage.h"
+#include "monitor_deletion_queue.h"
+#include "monitor_socket_writes.h"
+#include "monitor_signature_cache.h"
 #include "zix_interface.h"
 #include "utils.h"
 #include "core_function_call.h"
 #include "conf_handler.h"
 #include "file_handler.h"
 #include "disk_usage_manager.h"
+#include "deletion_service.h"
+#include "measurement_catalog.h"
 #include "samba_mounter.h"
 #include "printer_monitor.h"
 #include "webservice.h"
@@ -110,6 +115,17 @@ StateVariable sic_state ("statusSIC");
 
 static sigc::connection samba_mount_connection;
 
+/* The IPC devices can be overridden from the environment, e.g. with the
+ * pty of the simulated devicecontroller (sim_dc)
+ */
+static const char *
+ipc_device (const char *variable, const char *device)
+{
+    const char *value = g_getenv (variable);
+
+    return value ? value : device;
+}
+
 bool
 run_query_booting ()
 {
@@ -162,7 +178,6 @@ int init()
 
 
     // now call the internal register functions
-    CoreFunctionCall::init();
     XmlParameter::init();
 
     // xmlProcessor is needed for any InterfaceHandler
@@ -173,11 +188,13 @@ int init()
      */
     try {
         handlerUsbSerial = UsbInterfaceHandler::create(
-            STR_ZIXINF_IPC, USB_SERIAL_DEVICE, 115800, xmlProcessor, ESerialHandlerModeNormal);
+            STR_ZIXINF_IPC, ipc_device("LIBZIX_USB_SERIAL_DEVICE", USB_SERIAL_DEVICE),
+            115800, xmlProcessor, ESerialHandlerModeNormal);
     }
     catch ( ... )
     {
-        PRINT_ERROR("Could not install serial-usb interface " USB_SERIAL_DEVICE);
+        PRINT_ERROR("Could not install serial-usb interface "
+                    << ipc_device("LIBZIX_USB_SERIAL_DEVICE", USB_SERIAL_DEVICE));
     }
 
     // -> IPC via RS422; only if USB is not available
@@ -185,11 +202,13 @@ int init()
     {
         try {
             handlerSerial = SerialInterfaceHandler::create(
-                STR_ZIXINF_IPC, SERIAL_DEVICE, 115800, xmlProcessor, ESerialHandlerModeNormal);
+                STR_ZIXINF_IPC, ipc_device("LIBZIX_SERIAL_DEVICE", SERIAL_DEVICE),
+                115800, xmlProcessor, ESerialHandlerModeNormal);
         }
         catch ( ... )
         {
-            PRINT_ERROR("Could not install serial interface " SERIAL_DEVICE);
+            PRINT_ERROR("Could not install serial interface "
+                        << ipc_device("LIBZIX_SERIAL_DEVICE", SERIAL_DEVICE));
         }
     }
 
@@ -317,6 +336,11 @@ int init_part3 ()
     monitorManager->addMonitor( MonitorNetwork::create() );
     monitorManager->addMonitor( MonitorMemory::create() );
     monitorManager->addMonitor( MonitorUptime::create(  ) );
+    monitorManager->addMonitor( MonitorDeletionQueue::create(  ) );
+    monitorManager->addMonitor( MonitorSocketWrites::create( handlerDebug->get_name() ) );
+    monitorManager->addMonitor( MonitorSocketWrites::create( handlerWebService->get_name() ) );
+    monitorManager->addMonitor( MonitorSocketWrites::create( handlerWebServer->get_name() ) );
+    monitorManager->addMonitor( MonitorSignatureCache::create(  ) );
 
     monitorManager->findMonitor( "CPU" )->setAlarmThresholds( 50, 50, eAlarmSlopeTypeRising );
 
@@ -345,6 +369,12 @@ int init_part3 ()
             dir_monitor->setAlarmThresholds(DiskUsageManager::get_instance()->number_of_measurements_max());
             dataFreeHandler = DataFreeHandler::create(dir_monitor);
         }
+
+        // continue deletions interrupted by a shutdown
+        DeletionService::get_instance();
+
+        // catch up with changes done while we were not running
+        MeasurementCatalog::get_instance()->reconcile();
     } catch (const std::exception& ex) {
         PRINT_ERROR("Failed to setup measurements directory watch mechanism: " << ex.what());
     }
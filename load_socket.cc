@@ -0,0 +1,769 @@
+//----------------------------------------------------------------------------
+///
+/// \brief  Load generator for the socket interfaces
+///
+///         Opens --connections connections with SocketClient to the debug
+///         TCP port or to the unix sockets of the LAN webservice and
+///         webserver and sends requests from template files on an open
+///         loop schedule: Poisson or fixed rate arrivals that do not wait
+///         for replies. If every connection is busy the request waits in
+///         the generator, its latency is still measured from the scheduled
+///         arrival (corrected for coordinated omission). The latency from
+///         the actual send is recorded as well.
+///
+///         With --step the rate is raised every --step-duration seconds,
+///         the time series shows where the achieved rate stops following
+///         and the latency starts growing, i.e. the saturation point:
+///
+///             load_socket --address unix:/run/libzix/lan_webservice \
+///                         --template testxmls/get_conf_lan.xml \
+///                         --connections 16 --rate 50 --step 50 \
+///                         --duration 120 --timeseries ws.csv \
+///                         --hgrm ws.hgrm
+///
+///         "${seq}" and "${conn}" in templates are replaced by the request
+///         number and the connection index. With --pipeline > 1 requests
+///         are wrapped into <task tid="N"> to have more than one outstanding
+///         per connection. The lanSocket interface connects out to its peer
+///         and has nothing to connect to.
+///
+///         Prints a summary on exit, the .hgrm files can be plotted with
+///         the HdrHistogram plotter.
+///
+/// \date   [20261019] File created
+///
+//----------------------------------------------------------------------------
+
+
+#include <glibmm/main.h>
+#include <glibmm/init.h>
+#include <glibmm/fileutils.h>
+#include <giomm/init.h>
+#include <giomm/socketconnection.h>
+#include <giomm/inputstream.h>
+#include <giomm/outputstream.h>
+#include <glib-unix.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "socket_client.h"
+#include "hdr_histogram.h"
+
+
+typedef std::chrono::steady_clock Clock;
+
+// latencies are recorded in us, up to an hour
+static const gint64 HISTOGRAM_MAX_US = G_GINT64_CONSTANT(3600) * 1000 * 1000;
+static const gsize READ_SIZE = 64 * 1024;
+
+
+struct SRequest
+{
+    int tid;
+    Clock::time_point scheduled;
+    Clock::time_point sent;
+};
+
+
+struct SConnection
+{
+    int index;
+    Glib::RefPtr<SocketClient> client;
+    Glib::RefPtr<Gio::InputStream> input;
+    Glib::RefPtr<Gio::OutputStream> output;
+    std::vector<char> readBuffer;
+    std::string rxData;
+    std::string txData;             // not yet written
+    std::string txWriting;          // passed to write_async
+    std::deque<SRequest> inflight;  // in send order
+    bool dead;
+};
+
+
+struct SInterval
+{
+    SInterval()
+        : offered(0), sent(0), completed(0), errors(0)
+        , latency(1, HISTOGRAM_MAX_US, 2)
+    {}
+
+    guint64 offered;
+    guint64 sent;
+    guint64 completed;
+    guint64 errors;
+    HdrHistogram latency;
+};
+
+
+class LoadGenerator
+{
+    public:
+        enum ESchedule { eSchedulePoisson, eScheduleFixed };
+
+        LoadGenerator()
+            : connectionCount(10), pipeline(1), schedule(eSchedulePoisson)
+            , rate(10), step(0), stepDuration(10), duration(30), warmup(0)
+            , drainTimeout(10), seed(0)
+            , corrected(1, HISTOGRAM_MAX_US, 3), uncorrected(1, HISTOGRAM_MAX_US, 3)
+            , scheduled(0), sent(0), completed(0), errors(0), elapsed(0), nextTid(1)
+            , nextConnection(0), stopping(false)
+        {}
+
+        // configuration
+        std::string address;
+        int connectionCount;
+        int pipeline;
+        ESchedule schedule;
+        double rate;
+        double step;
+        int stepDuration;
+        int duration;
+        int warmup;
+        int drainTimeout;
+        unsigned seed;
+        std::vector<std::string> templates;
+
+        // results
+        HdrHistogram corrected;
+        HdrHistogram uncorrected;
+        std::map<std::string, guint64> statusCount;
+        std::vector<SInterval> intervals;
+        guint64 scheduled;
+        guint64 sent;
+        guint64 completed;
+        guint64 errors;
+        double elapsed;
+
+        void connect();
+        void run();
+        void stop();
+
+    private:
+        Glib::RefPtr<Glib::MainLoop> mainloop;
+        std::vector<SConnection> connections;
+        std::deque<Clock::time_point> backlog;
+        std::mt19937 rng;
+        Clock::time_point start;
+        Clock::time_point nextArrival;
+        int nextTid;
+        int nextConnection;
+        bool stopping;
+
+        double rateAt(double seconds) const;
+        SInterval &interval(Clock::time_point when);
+        bool onTick();
+        void dispatch();
+        void sendRequest(SConnection &connection, Clock::time_point when);
+        void startWrite(SConnection &connection);
+        void onWritten(Glib::RefPtr<Gio::AsyncResult> &result, int index);
+        void startRead(SConnection &connection);
+        void onRead(Glib::RefPtr<Gio::AsyncResult> &result, int index);
+        void handleReply(SConnection &connection, const std::string &reply);
+        void closeConnection(SConnection &connection, const Glib::ustring &reason);
+        void finishIfDone();
+};
+
+
+static std::string replaceAll( std::string str, const std::string &from,
+                               const std::string &to )
+{
+    for( size_t pos=0; ( pos=str.find( from, pos ) ) != std::string::npos;
+         pos+=to.size() )
+        str.replace( pos, from.size(), to );
+
+    return( str );
+}
+
+
+/// \brief  Value of the attribute "name" in the first tag of xml
+static std::string firstAttribute( const std::string &xml, size_t from,
+                                   const std::string &name )
+{
+    size_t end=xml.find( '>', from );
+    size_t pos=xml.find( " " + name + "=\"", from );
+
+    if( pos == std::string::npos || pos > end )
+        return( std::string() );
+
+    pos+=name.size() + 3;
+    return( xml.substr( pos, xml.find( '"', pos ) - pos ) );
+}
+
+
+void LoadGenerator::connect()
+{
+    connections.resize( connectionCount );
+
+    for( int i=0; i < connectionCount; i++ )
+    {
+        SConnection &connection=connections[i];
+
+        connection.index=i;
+        connection.client=SocketClient::create( Glib::ustring( address ) );
+        connection.input=connection.client->getConnection()->get_input_stream();
+        connection.output=connection.client->getConnection()->get_output_stream();
+        connection.readBuffer.resize( READ_SIZE );
+        connection.dead=false;
+    }
+}
+
+
+double LoadGenerator::rateAt( double seconds ) const
+{
+    if( step <= 0 || stepDuration <= 0 )
+        return( rate );
+
+    return( rate + step * static_cast<int>( seconds / stepDuration ) );
+}
+
+
+SInterval &LoadGenerator::interval( Clock::time_point when )
+{
+    size_t second=std::chrono::duration_cast<std::chrono::seconds>(
+            when - start ).count();
+
+    if( intervals.size() <= second )
+        intervals.resize( second + 1 );
+
+    return( intervals[second] );
+}
+
+
+void LoadGenerator::run()
+{
+    rng.seed( seed );
+    mainloop=Glib::MainLoop::create();
+
+    for( auto &&connection : connections )
+        startRead( connection );
+
+    start=Clock::now();
+    nextArrival=start;
+
+    // arrivals are released in 1 ms ticks, their scheduled time is exact
+    Glib::signal_timeout().connect(
+            sigc::mem_fun( *this, &LoadGenerator::onTick ), 1 );
+
+    mainloop->run();
+
+    std::chrono::duration<double> wall=Clock::now() - start;
+    elapsed=wall.count();
+}
+
+
+void LoadGenerator::stop()
+{
+    if( !stopping )
+    {
+        stopping=true;
+        Glib::signal_timeout().connect_seconds_once( [this]()
+        {
+            if( mainloop->is_running() )
+                mainloop->quit();
+        }, drainTimeout );
+    }
+    finishIfDone();
+}
+
+
+bool LoadGenerator::onTick()
+{
+    if( stopping )
+        return( false );
+
+    Clock::time_point now=Clock::now();
+    Clock::time_point end=start + std::chrono::seconds( duration );
+
+    while( nextArrival <= now && nextArrival < end )
+    {
+        double r=rateAt( std::chrono::duration<double>( nextArrival - start ).count() );
+        double gap;
+
+        backlog.push_back( nextArrival );
+        scheduled++;
+        interval( nextArrival ).offered++;
+
+        if( schedule == eSchedulePoisson )
+            gap=std::exponential_distribution<double>( r )( rng );
+        else
+            gap=1 / r;
+        nextArrival+=std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>( gap ) );
+    }
+
+    dispatch();
+
+    if( now >= end )
+    {
+        stop();
+        return( false );
+    }
+
+    return( true );
+}
+
+
+/// \brief  Send waiting requests on connections with room for them
+void LoadGenerator::dispatch()
+{
+    int tries=0;
+
+    while( !backlog.empty() && tries < connectionCount )
+    {
+        SConnection &connection=connections[nextConnection];
+
+        nextConnection=( nextConnection + 1 ) % connectionCount;
+
+        if( connection.dead
+            || static_cast<int>( connection.inflight.size() ) >= pipeline )
+        {
+            tries++;
+            continue;
+        }
+
+        sendRequest( connection, backlog.front() );
+        backlog.pop_front();
+        tries=0;
+    }
+}
+
+
+void LoadGenerator::sendRequest( SConnection &connection, Clock::time_point when )
+{
+    SRequest request;
+    int seq=nextTid++;
+    std::string xml=templates[( seq - 1 ) % templates.size()];
+
+    xml=replaceAll( xml, "${seq}", std::to_string( seq ) );
+    xml=replaceAll( xml, "${conn}", std::to_string( connection.index ) );
+
+    if( pipeline > 1 )
+        xml="<task tid=\"" + std::to_string( seq ) + "\">" + xml + "</task>";
+
+    request.tid=seq;
+    request.scheduled=when;
+    request.sent=Clock::now();
+    connection.inflight.push_back( request );
+
+    connection.txData+=xml;
+    connection.txData.push_back( '\0' );
+    startWrite( connection );
+
+    sent++;
+    interval( request.sent ).sent++;
+}
+
+
+void LoadGenerator::startWrite( SConnection &connection )
+{
+    if( !connection.txWriting.empty() || connection.txData.empty() || connection.dead )
+        return;
+
+    connection.txWriting.swap( connection.txData );
+    connection.output->write_async( connection.txWriting.data(),
+            connection.txWriting.size(),
+            sigc::bind( sigc::mem_fun( *this, &LoadGenerator::onWritten ),
+                        connection.index ) );
+}
+
+
+void LoadGenerator::onWritten( Glib::RefPtr<Gio::AsyncResult> &result, int index )
+{
+    SConnection &connection=connections[index];
+    gssize written;
+
+    try {
+        written=connection.output->write_finish( result );
+    } catch( const Glib::Error &ex ) {
+        closeConnection( connection, ex.what() );
+        return;
+    }
+
+    connection.txWriting.erase( 0, written );
+    if( !connection.txWriting.empty() )
+    {
+        // short write, keep the order
+        connection.txData.insert( 0, connection.txWriting );
+        connection.txWriting.clear();
+    }
+    startWrite( connection );
+}
+
+
+void LoadGenerator::startRead( SConnection &connection )
+{
+    connection.input->read_async( connection.readBuffer.data(),
+            connection.readBuffer.size(),
+            sigc::bind( sigc::mem_fun( *this, &LoadGenerator::onRead ),
+                        connection.index ) );
+}
+
+
+void LoadGenerator::onRead( Glib::RefPtr<Gio::AsyncResult> &result, int index )
+{
+    SConnection &connection=connections[index];
+    gssize count;
+
+    try {
+        count=connection.input->read_finish( result );
+    } catch( const Glib::Error &ex ) {
+        closeConnection( connection, ex.what() );
+        return;
+    }
+
+    if( count <= 0 )
+    {
+        closeConnection( connection, "closed by the daemon" );
+        return;
+    }
+
+    connection.rxData.append( connection.readBuffer.data(), count );
+
+    size_t pos;
+    while( ( pos=connection.rxData.find( '\0' ) ) != std::string::npos )
+    {
+        std::string reply=connection.rxData.substr( 0, pos );
+
+        connection.rxData.erase( 0, pos + 1 );
+        handleReply( connection, reply );
+    }
+
+    startRead( connection );
+    dispatch();
+    finishIfDone();
+}
+
+
+void LoadGenerator::handleReply( SConnection &connection, const std::string &reply )
+{
+    Clock::time_point now=Clock::now();
+    size_t begin=reply.find( '<' );
+    std::deque<SRequest>::iterator it=connection.inflight.begin();
+
+    if( begin == std::string::npos )
+        begin=0;
+
+    if( reply.compare( begin, 5, "<task" ) == 0 )
+    {
+        int tid=atoi( firstAttribute( reply, begin, "tid" ).c_str() );
+
+        while( it != connection.inflight.end() && it->tid != tid )
+            ++it;
+        begin=reply.find( '<', begin + 1 );
+        if( begin == std::string::npos )
+            begin=reply.size();
+    }
+
+    if( it == connection.inflight.end() )
+    {
+        std::cerr << "connection " << connection.index
+                  << ": reply without request" << std::endl;
+        return;
+    }
+
+    std::string status=firstAttribute( reply, begin, "status" );
+    bool recorded=it->scheduled >= start + std::chrono::seconds( warmup );
+    SInterval &current=interval( now );
+    gint64 latency=std::chrono::duration_cast<std::chrono::microseconds>(
+            now - it->scheduled ).count();
+    gint64 serviceTime=std::chrono::duration_cast<std::chrono::microseconds>(
+            now - it->sent ).count();
+
+    connection.inflight.erase( it );
+
+    completed++;
+    current.completed++;
+    current.latency.record( latency );
+    statusCount[status.empty() ? "none" : status]++;
+    if( status.empty() || atoi( status.c_str() ) >= 400 )
+    {
+        errors++;
+        current.errors++;
+    }
+
+    if( recorded )
+    {
+        corrected.record( latency );
+        uncorrected.record( serviceTime );
+    }
+}
+
+
+void LoadGenerator::closeConnection( SConnection &connection, const Glib::ustring &reason )
+{
+    if( connection.dead )
+        return;
+
+    std::cerr << "connection " << connection.index << ": " << reason << std::endl;
+
+    // its outstanding requests count as lost
+    connection.dead=true;
+    connection.inflight.clear();
+    connection.client->getConnection()->close();
+
+    bool alive=false;
+    for( auto &&other : connections )
+        alive|=!other.dead;
+
+    if( !alive )
+    {
+        backlog.clear();
+        stopping=true;
+        mainloop->quit();
+        return;
+    }
+
+    dispatch();
+    finishIfDone();
+}
+
+
+void LoadGenerator::finishIfDone()
+{
+    if( !stopping || !backlog.empty() )
+        return;
+
+    for( auto &&connection : connections )
+        if( !connection.inflight.empty() )
+            return;
+
+    mainloop->quit();
+}
+
+
+static LoadGenerator *generator;
+
+
+static gboolean onQuitSignal( gpointer data )
+{
+    (void)data;
+    generator->stop();
+
+    return( G_SOURCE_REMOVE );
+}
+
+
+static void usage( const char *name )
+{
+    std::cerr
+        << "usage: " << name << " [options] --template FILE...\n"
+        << "  --address ADDR          HOST[:PORT] or unix:PATH (default localhost:17001)\n"
+        << "  --template FILE         request to send, repeat for a round robin mix\n"
+        << "  --connections N         concurrent connections (default 10)\n"
+        << "  --pipeline N            outstanding requests per connection (default 1)\n"
+        << "  --rate R                requests per second (default 10)\n"
+        << "  --schedule poisson|fixed  arrival schedule (default poisson)\n"
+        << "  --step R                raise the rate by R every --step-duration\n"
+        << "  --step-duration S       seconds per rate step (default 10)\n"
+        << "  --duration S            seconds to send requests (default 30)\n"
+        << "  --warmup S              leave the first S seconds out of the histograms\n"
+        << "  --drain S               seconds to wait for replies at the end (default 10)\n"
+        << "  --seed N                seed for the Poisson schedule\n"
+        << "  --hgrm FILE             corrected latency distribution, FILE.uncorrected\n"
+        << "                          for the latency from sending\n"
+        << "  --timeseries FILE       per second CSV of rate, errors and latency\n";
+}
+
+
+static void printSummary( const LoadGenerator &gen )
+{
+    double seconds=gen.elapsed > 0 ? gen.elapsed : 1;
+
+    std::cout << std::fixed << std::setprecision( 1 )
+              << "scheduled " << gen.scheduled << "\n"
+              << "sent " << gen.sent << "\n"
+              << "completed " << gen.completed << "\n"
+              << "errors " << gen.errors << "\n"
+              << "lost " << gen.sent - gen.completed << "\n"
+              << "unsent " << gen.scheduled - gen.sent << "\n"
+              << "seconds " << gen.elapsed << "\n"
+              << "throughput " << gen.completed / seconds << "\n";
+
+    for( auto &&status : gen.statusCount )
+        std::cout << "status " << status.first << " " << status.second << "\n";
+
+    for( double p : { 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 } )
+        std::cout << "latency_p" << p << "_us "
+                  << gen.corrected.value_at_percentile( p ) << "\n";
+    for( double p : { 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 } )
+        std::cout << "service_p" << p << "_us "
+                  << gen.uncorrected.value_at_percentile( p ) << "\n";
+
+    std::cout << std::endl;
+}
+
+
+static bool writeTimeseries( const LoadGenerator &gen, const std::string &fileName )
+{
+    std::ofstream ofs( fileName );
+
+    ofs << "second,offered,sent,completed,errors,p50_us,p99_us,max_us\n";
+    for( size_t i=0; i < gen.intervals.size(); i++ )
+    {
+        const SInterval &iv=gen.intervals[i];
+
+        ofs << i << "," << iv.offered << "," << iv.sent << "," << iv.completed
+            << "," << iv.errors << "," << iv.latency.value_at_percentile( 50 )
+            << "," << iv.latency.value_at_percentile( 99 )
+            << "," << iv.latency.max() << "\n";
+    }
+
+    return( ofs.good() );
+}
+
+
+int main( int argc, char **argv )
+{
+    enum
+    {
+        OPT_ADDRESS=1, OPT_TEMPLATE, OPT_CONNECTIONS, OPT_PIPELINE, OPT_RATE,
+        OPT_SCHEDULE, OPT_STEP, OPT_STEP_DURATION, OPT_DURATION, OPT_WARMUP,
+        OPT_DRAIN, OPT_SEED, OPT_HGRM, OPT_TIMESERIES,
+    };
+    static const struct option options[]=
+    {
+        { "address",        required_argument, NULL, OPT_ADDRESS },
+        { "template",       required_argument, NULL, OPT_TEMPLATE },
+        { "connections",    required_argument, NULL, OPT_CONNECTIONS },
+        { "pipeline",       required_argument, NULL, OPT_PIPELINE },
+        { "rate",           required_argument, NULL, OPT_RATE },
+        { "schedule",       required_argument, NULL, OPT_SCHEDULE },
+        { "step",           required_argument, NULL, OPT_STEP },
+        { "step-duration",  required_argument, NULL, OPT_STEP_DURATION },
+        { "duration",       required_argument, NULL, OPT_DURATION },
+        { "warmup",         required_argument, NULL, OPT_WARMUP },
+        { "drain",          required_argument, NULL, OPT_DRAIN },
+        { "seed",           required_argument, NULL, OPT_SEED },
+        { "hgrm",           required_argument, NULL, OPT_HGRM },
+        { "timeseries",     required_argument, NULL, OPT_TIMESERIES },
+        { NULL, 0, NULL, 0 },
+    };
+
+    LoadGenerator gen;
+    std::string hgrmFile;
+    std::string timeseriesFile;
+    int opt;
+
+    gen.address="localhost:17001";
+
+    while( ( opt=getopt_long( argc, argv, "", options, NULL ) ) != -1 )
+    {
+        switch( opt )
+        {
+            case OPT_ADDRESS:
+                gen.address=optarg;
+                break;
+            case OPT_TEMPLATE:
+                try {
+                    gen.templates.push_back( Glib::file_get_contents( optarg ) );
+                } catch( const Glib::Error &ex ) {
+                    std::cerr << ex.what() << std::endl;
+                    return( EXIT_FAILURE );
+                }
+                break;
+            case OPT_CONNECTIONS:
+                gen.connectionCount=atoi( optarg );
+                break;
+            case OPT_PIPELINE:
+                gen.pipeline=atoi( optarg );
+                break;
+            case OPT_RATE:
+                gen.rate=atof( optarg );
+                break;
+            case OPT_SCHEDULE:
+                if( !strcmp( optarg, "poisson" ) )
+                    gen.schedule=LoadGenerator::eSchedulePoisson;
+                else if( !strcmp( optarg, "fixed" ) )
+                    gen.schedule=LoadGenerator::eScheduleFixed;
+                else
+                {
+                    usage( argv[0] );
+                    return( EXIT_FAILURE );
+                }
+                break;
+            case OPT_STEP:
+                gen.step=atof( optarg );
+                break;
+            case OPT_STEP_DURATION:
+                gen.stepDuration=atoi( optarg );
+                break;
+            case OPT_DURATION:
+                gen.duration=atoi( optarg );
+                break;
+            case OPT_WARMUP:
+                gen.warmup=atoi( optarg );
+                break;
+            case OPT_DRAIN:
+                gen.drainTimeout=atoi( optarg );
+                break;
+            case OPT_SEED:
+                gen.seed=strtoul( optarg, NULL, 10 );
+                break;
+            case OPT_HGRM:
+                hgrmFile=optarg;
+                break;
+            case OPT_TIMESERIES:
+                timeseriesFile=optarg;
+                break;
+            default:
+                usage( argv[0] );
+                return( EXIT_FAILURE );
+        }
+    }
+
+    if( gen.templates.empty() || gen.connectionCount < 1 || gen.pipeline < 1
+        || gen.rate <= 0 || gen.duration < 1 )
+    {
+        usage( argv[0] );
+        return( EXIT_FAILURE );
+    }
+
+    Glib::init();
+    Gio::init();
+
+    try {
+        gen.connect();
+    } catch( const std::exception &ex ) {
+        std::cerr << ex.what() << std::endl;
+        return( EXIT_FAILURE );
+    }
+
+    generator=&gen;
+    g_unix_signal_add( SIGINT, &onQuitSignal, NULL );
+    g_unix_signal_add( SIGTERM, &onQuitSignal, NULL );
+
+    gen.run();
+
+    printSummary( gen );
+
+    if( !hgrmFile.empty() )
+    {
+        std::ofstream corrected( hgrmFile );
+        std::ofstream uncorrected( hgrmFile + ".uncorrected" );
+
+        // values in ms like the HdrHistogram tools
+        gen.corrected.write_percentiles( corrected, 5, 1000 );
+        gen.uncorrected.write_percentiles( uncorrected, 5, 1000 );
+    }
+
+    if( !timeseriesFile.empty() && !writeTimeseries( gen, timeseriesFile ) )
+    {
+        std::cerr << "Failed to write " << timeseriesFile << std::endl;
+        return( EXIT_FAILURE );
+    }
+
+    return( EXIT_SUCCESS );
+}
+
+
+//---fin----------------------------------------------------------------------
@@ -28,6 +28,9 @@
 #include "log.h"
 #include "log_handler.h"
 #include <iostream>              // cout
+#include <thread>
+#include <mutex>
+#include <utility>
 
 
 //---Implementation------------------------------------------------------------
@@ -36,6 +39,13 @@
 ELogLevel eLogLevel=ELogLevelDebug;
 ELogMechanism eLogMechanism=ELogMechanismDirect;
 
+/* The LogHandler is not thread safe. Messages from worker threads are
+ * queued and written from the main loop.
+ */
+static const std::thread::id mainThreadId=std::this_thread::get_id();
+static std::mutex deferredMutex;
+static std::list< std::pair<Glib::ustring, Glib::ustring> > deferredMessages;
+
 void setInternLogLevel( ELogLevel _eLogLevel )
 {
     eLogLevel=_eLogLevel;
@@ -60,6 +70,8 @@ const char *logLevelStringMap[]=
    [ELogLevelLast] = "-----",
 };
 
+void loggerLibzix( const Glib::ustring &level, const Glib::ustring &str);
+
 void loggerLibzix( ELogLevel _eLogLevel, const char *format, va_list argp)
 {
    if (_eLogLevel > ELogLevelDebug) {
@@ -68,9 +80,8 @@ void loggerLibzix( ELogLevel _eLogLevel, const char *format, va_list argp)
        return;
    }
    char *str=g_strdup_vprintf (format, argp);
-   Glib::RefPtr <LogHandler> logHandler=LogHandler::get_instance();
 
-   logHandler->log_internal (logLevelStringMap[_eLogLevel], "Audit", str);
+   loggerLibzix (logLevelStringMap[_eLogLevel], str);
 
    free (str);
 
@@ -94,8 +105,34 @@ void loggerDirect( ELogLevel _eLogLevel, const char *format, va_list argp)
    return;
 }
 
+static gboolean flushDeferred( gpointer data )
+{
+   std::list< std::pair<Glib::ustring, Glib::ustring> > messages;
+   (void) data;
+
+   {
+      std::lock_guard<std::mutex> lock(deferredMutex);
+      messages.swap(deferredMessages);
+   }
+
+   Glib::RefPtr <LogHandler> logHandler=LogHandler::get_instance();
+   for( auto&& message : messages )
+      logHandler->log_internal(message.first, "Audit", message.second);
+
+   return(G_SOURCE_REMOVE);
+}
+
 void loggerLibzix( const Glib::ustring &level, const Glib::ustring &str)
 {
+   if( std::this_thread::get_id() != mainThreadId )
+   {
+      std::lock_guard<std::mutex> lock(deferredMutex);
+      if( deferredMessages.empty() )
+         g_idle_add(flushDeferred, nullptr);
+      deferredMessages.emplace_back(level, str);
+      return;
+   }
+
    Glib::RefPtr <LogHandler> logHandler=LogHandler::get_instance();
    logHandler->log_internal(level, "Audit",
                             str );
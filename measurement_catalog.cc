@@ -0,0 +1,344 @@
+#include <libxml++/libxml++.h>
+
+#include <glibmm/main.h>
+
+#include <stdexcept>
+#include <cstdlib>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "async_file_handler.h"
+#include "file_handler.h"
+#include "conf_handler.h"
+#include "utils.h"
+
+#include "measurement_catalog.h"
+
+MeasurementCatalog::RefPtr MeasurementCatalog::instance(nullptr);
+
+MeasurementCatalog::MeasurementCatalog() :
+    Glib::Object(),
+    _total_bytes{0},
+    _save_scheduled{false},
+    _reconciling{false}
+{
+    setup();
+}
+
+void MeasurementCatalog::setup()
+{
+    _measurement_dir = ConfHandler::get_instance()->getDirectory("measurements");
+    if (_measurement_dir.empty())
+        EXCEPTION("Failed to find measurements directory");
+
+    _file_name     = _measurement_dir + "/MC.xml";
+    _file_name_tmp = _file_name + ".tmp";
+
+    try {
+        if (FileHandler::file_exists(_file_name))
+            load();
+    } catch (const std::exception& ex) {
+        // rebuilt by reconcile()
+        PRINT_ERROR("Failed to load measurement catalog: " << ex.what());
+        _entries.clear();
+        _flagged.clear();
+        _total_bytes = 0;
+    }
+}
+
+void MeasurementCatalog::load()
+{
+    xmlpp::DomParser parser;
+
+    parser.parse_file(_file_name);
+    auto root = parser.get_document()->get_root_node();
+
+    for (auto&& node : root->get_children("measurement")) {
+        auto *elem = dynamic_cast<xmlpp::Element *>(node);
+        if (!elem)
+            continue;
+
+        MeasurementCatalogEntry entry(elem->get_attribute_value("iid"));
+        if (entry.iid.empty())
+            continue;
+
+        entry.ctime         = std::strtoll(elem->get_attribute_value("ctime").c_str(), nullptr, 10);
+        entry.bytes         = std::strtoull(elem->get_attribute_value("bytes").c_str(), nullptr, 10);
+        entry.derived_bytes = std::strtoull(elem->get_attribute_value("derived").c_str(), nullptr, 10);
+        entry.flagged       = elem->get_attribute_value("delete") == "yes";
+
+        put(entry);
+    }
+}
+
+void MeasurementCatalog::save()
+{
+    xmlpp::Document doc;
+    auto root = doc.create_root_node("catalog");
+
+    for (auto&& pair : _entries) {
+        const auto& entry = pair.second;
+        auto elem = root->add_child("measurement");
+
+        elem->set_attribute("iid", entry.iid);
+        elem->set_attribute("ctime", std::to_string(entry.ctime));
+        elem->set_attribute("bytes", std::to_string(entry.bytes));
+        elem->set_attribute("derived", std::to_string(entry.derived_bytes));
+        elem->set_attribute("delete", entry.flagged ? "yes" : "no");
+    }
+
+    doc.write_to_file_formatted(_file_name_tmp);
+    FileHandler::move_file(_file_name_tmp, _file_name);
+}
+
+void MeasurementCatalog::schedule_save()
+{
+    changed.emit();
+
+    if (_save_scheduled)
+        return;
+
+    // collect changes of e.g. a dataFree for all measurements
+    _save_scheduled = true;
+    Glib::signal_timeout().connect_once(
+        sigc::mem_fun(*this, &MeasurementCatalog::on_save_timeout), 1000);
+}
+
+void MeasurementCatalog::on_save_timeout()
+{
+    _save_scheduled = false;
+
+    try {
+        save();
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Failed to save measurement catalog: " << ex.what());
+    }
+}
+
+void MeasurementCatalog::put(const MeasurementCatalogEntry& entry)
+{
+    erase(entry.iid);
+
+    _entries[entry.iid] = entry;
+    _total_bytes += entry.total_bytes();
+    if (entry.flagged)
+        _flagged.emplace(entry.ctime, entry.iid);
+}
+
+void MeasurementCatalog::erase(const std::string& iid)
+{
+    auto it = _entries.find(iid);
+    if (it == _entries.end())
+        return;
+
+    _total_bytes -= it->second.total_bytes();
+    _flagged.erase(std::make_pair(it->second.ctime, iid));
+    _entries.erase(it);
+}
+
+MeasurementCatalogEntry MeasurementCatalog::scan_measurement(const std::string& dir,
+                                                             const std::string& iid)
+{
+    MeasurementCatalogEntry entry(iid);
+    struct stat sb;
+
+    auto path = dir + "/" + iid;
+    DIR *d = opendir(path.c_str());
+    if (!d)
+        throw std::runtime_error("Failed to open measurement " + path);
+
+    // the directory mtime changes with every file added (e.g. .delete),
+    // the measurement was created when its oldest data file was written
+    gint64 primary_time = 0;
+    gint64 oldest_time = 0;
+    gint64 dir_time = 0;
+    if (!fstat(dirfd(d), &sb))
+        dir_time = sb.st_mtime;
+
+    const std::string xml_name = iid + ".xml";
+
+    while (auto *de = readdir(d)) {
+        std::string name = de->d_name;
+
+        if (name == "." || name == "..")
+            continue;
+
+        if (name == ".delete") {
+            entry.flagged = true;
+            continue;
+        }
+
+        if (fstatat(dirfd(d), de->d_name, &sb, AT_SYMLINK_NOFOLLOW) || !S_ISREG(sb.st_mode))
+            continue;
+
+        // same classification as dataSync uses to drop post-processing results
+        bool primary = name == xml_name ||
+            (name.compare(0, iid.size(), iid) == 0 && name.size() >= 4 &&
+             name.compare(name.size() - 4, 4, ".bmp") == 0);
+
+        if (primary) {
+            entry.bytes += sb.st_size;
+            if (!primary_time || sb.st_mtime < primary_time)
+                primary_time = sb.st_mtime;
+        } else {
+            entry.derived_bytes += sb.st_size;
+        }
+        if (!oldest_time || sb.st_mtime < oldest_time)
+            oldest_time = sb.st_mtime;
+    }
+
+    closedir(d);
+
+    entry.ctime = primary_time ? primary_time : oldest_time ? oldest_time : dir_time;
+
+    return entry;
+}
+
+void MeasurementCatalog::update(const std::string& iid)
+{
+    if (iid.empty())
+        return;
+
+    try {
+        auto entry = scan_measurement(_measurement_dir, iid);
+
+        touch(iid);
+
+        // keep the time we first saw the measurement
+        auto it = _entries.find(iid);
+        if (it != _entries.end())
+            entry.ctime = it->second.ctime;
+
+        put(entry);
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Failed to update catalog for " << iid << ": " << ex.what());
+        return;
+    }
+
+    schedule_save();
+}
+
+void MeasurementCatalog::set_flagged(const std::string& iid, bool flagged)
+{
+    auto it = _entries.find(iid);
+    if (it == _entries.end()) {
+        update(iid);
+        return;
+    }
+
+    auto entry = it->second;
+    entry.flagged = flagged;
+    put(entry);
+    touch(iid);
+
+    schedule_save();
+}
+
+void MeasurementCatalog::remove(const std::string& iid)
+{
+    if (_entries.find(iid) == _entries.end())
+        return;
+
+    erase(iid);
+    touch(iid);
+    schedule_save();
+}
+
+void MeasurementCatalog::touch(const std::string& iid)
+{
+    if (_reconciling)
+        _touched.insert(iid);
+}
+
+std::vector<std::string> MeasurementCatalog::select_evictions(std::size_t max_count,
+                                                              guint64 max_bytes) const
+{
+    std::vector<std::string> result;
+    std::size_t count = _entries.size();
+    guint64 bytes = _total_bytes;
+
+    for (auto&& flagged : _flagged) {
+        if (count <= max_count && (!max_bytes || bytes <= max_bytes))
+            break;
+
+        result.push_back(flagged.second);
+        bytes -= _entries.at(flagged.second).total_bytes();
+        --count;
+    }
+
+    return result;
+}
+
+void MeasurementCatalog::reconcile()
+{
+    auto entries = std::make_shared<EntryList>();
+    auto dir = _measurement_dir;
+
+    // changes made while the worker scans win over its snapshot
+    _reconciling = true;
+    _touched.clear();
+
+    // runs in a worker thread
+    auto operation = [dir, entries] (FileOperationResult&) {
+        for (auto&& file : FileHandler::list_directory(dir)) {
+            if (!FileHandler::directory_exists(dir + "/" + file))
+                continue;
+
+            entries->push_back(scan_measurement(dir, file));
+        }
+    };
+
+    AsyncFileHandler::get_instance()->run("reconcile measurement catalog", operation,
+        sigc::bind(sigc::mem_fun(*this, &MeasurementCatalog::on_reconciled), entries));
+}
+
+void MeasurementCatalog::on_reconciled(const Glib::RefPtr<FileOperationResult>& result,
+                                       std::shared_ptr<EntryList> entries)
+{
+    std::set<std::string> touched;
+
+    touched.swap(_touched);
+    _reconciling = false;
+
+    if (result->error()) {
+        PRINT_ERROR("Failed to reconcile measurement catalog: " << result->error_msg());
+        return;
+    }
+
+    std::set<std::string> scanned;
+
+    for (auto&& entry : *entries) {
+        scanned.insert(entry.iid);
+
+        // updated or removed by dataSync/dataFree during the scan
+        if (touched.count(entry.iid))
+            continue;
+
+        auto copy = entry;
+
+        // keep the creation time we already know
+        auto it = _entries.find(entry.iid);
+        if (it != _entries.end())
+            copy.ctime = it->second.ctime;
+
+        put(copy);
+    }
+
+    // measurements deleted behind our back
+    std::vector<std::string> gone;
+    for (auto&& pair : _entries) {
+        if (!scanned.count(pair.first) && !touched.count(pair.first))
+            gone.push_back(pair.first);
+    }
+    for (auto&& iid : gone)
+        erase(iid);
+
+    PRINT_DEBUG("Measurement catalog: " << _entries.size() << " measurements, "
+                << _total_bytes << " bytes");
+
+    schedule_save();
+}
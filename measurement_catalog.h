@@ -0,0 +1,146 @@
+#ifndef _MEASUREMENT_CATALOG_H_
+#define _MEASUREMENT_CATALOG_H_
+
+#include <libxml++/document.h>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+
+#include <sigc++/signal.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <utility>
+#include <memory>
+
+#include "measurement_catalog_entry.h"
+#include "file_operation_result.h"
+
+/**
+ * \brief Keeps track of all measurements, their size and deletion flag.
+ *
+ * The catalog is stored in the measurement directory (MC.xml) and kept up
+ * to date by dataSync, dataFree and post-processing. On startup it is
+ * reconciled with the directory contents in the background.
+ *
+ * Flagged measurements are indexed by age, so selecting measurements for
+ * eviction does not need to look at the whole store.
+ */
+class MeasurementCatalog : public Glib::Object
+{
+public:
+    using RefPtr = Glib::RefPtr<MeasurementCatalog>;
+    using EntryList = std::vector<MeasurementCatalogEntry>;
+
+    static inline RefPtr get_instance()
+    {
+        if (!instance)
+            instance = create();
+        return instance;
+    }
+
+    /**
+     * Re-reads the sizes of a single measurement directory.
+     *
+     * @param iid measurement
+     */
+    void update(const std::string& iid);
+
+    /**
+     * Sets the deletion flag of a measurement.
+     *
+     * @param iid     measurement
+     * @param flagged new flag
+     */
+    void set_flagged(const std::string& iid, bool flagged = true);
+
+    /**
+     * Forget a measurement, e.g. after it has been deleted.
+     *
+     * @param iid measurement
+     */
+    void remove(const std::string& iid);
+
+    /**
+     * Selects the oldest flagged measurements until the catalog is within
+     * the given limits. The measurements are not removed from the catalog.
+     *
+     * @param max_count number of measurements to keep at most
+     * @param max_bytes total size to keep at most, 0 for no limit
+     *
+     * @return iids, oldest first
+     */
+    std::vector<std::string> select_evictions(std::size_t max_count, guint64 max_bytes) const;
+
+    /**
+     * Compares the catalog with the measurement directory. Runs in the
+     * background, measurements updated or removed meanwhile keep their
+     * current entry.
+     */
+    void reconcile();
+
+    inline std::size_t count() const noexcept
+    {
+        return _entries.size();
+    }
+
+    inline guint64 total_bytes() const noexcept
+    {
+        return _total_bytes;
+    }
+
+    /**
+     * Reads the sizes of a measurement directory. Does not touch the
+     * catalog and may be called from any thread.
+     *
+     * @param dir measurement directory
+     * @param iid measurement
+     *
+     * @return entry
+     */
+    static MeasurementCatalogEntry scan_measurement(const std::string& dir, const std::string& iid);
+
+    /**
+     * Emitted after the catalog changed.
+     */
+    sigc::signal<void> changed;
+
+private:
+    static RefPtr instance;
+
+    std::string _measurement_dir;
+    std::string _file_name;
+    std::string _file_name_tmp;
+
+    std::map<std::string, MeasurementCatalogEntry> _entries;
+    // (ctime, iid) of flagged measurements
+    std::set<std::pair<gint64, std::string> > _flagged;
+    guint64 _total_bytes;
+    bool _save_scheduled;
+    // iids changed while reconcile() runs
+    std::set<std::string> _touched;
+    bool _reconciling;
+
+    MeasurementCatalog();
+
+    static inline RefPtr create()
+    {
+        return RefPtr(new MeasurementCatalog());
+    }
+
+    void setup();
+    void load();
+    void save();
+    void schedule_save();
+    void on_save_timeout();
+
+    void put(const MeasurementCatalogEntry& entry);
+    void erase(const std::string& iid);
+    void touch(const std::string& iid);
+    void on_reconciled(const Glib::RefPtr<FileOperationResult>& result,
+                       std::shared_ptr<EntryList> entries);
+};
+
+#endif /* _MEASUREMENT_CATALOG_H_ */
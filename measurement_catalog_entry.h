@@ -0,0 +1,42 @@
+#ifndef _MEASUREMENT_CATALOG_ENTRY_H_
+#define _MEASUREMENT_CATALOG_ENTRY_H_
+
+#include <string>
+
+#include <glib.h>
+
+/**
+ * \brief Size and state of one measurement directory, see
+ *        MeasurementCatalog.
+ */
+class MeasurementCatalogEntry
+{
+public:
+    MeasurementCatalogEntry() :
+        ctime{0}, bytes{0}, derived_bytes{0}, flagged{false}
+    {}
+
+    explicit MeasurementCatalogEntry(const std::string& s) :
+        iid{s}, ctime{0}, bytes{0}, derived_bytes{0}, flagged{false}
+    {}
+
+    /**
+     * Total size of all files, including derived artifacts.
+     */
+    inline guint64 total_bytes() const noexcept
+    {
+        return bytes + derived_bytes;
+    }
+
+    std::string iid;
+    // creation time, seconds since the epoch
+    gint64 ctime;
+    // measurement data (iid.xml, images)
+    guint64 bytes;
+    // post-processing results
+    guint64 derived_bytes;
+    // flagged for deletion by dataFree
+    bool flagged;
+};
+
+#endif /* _MEASUREMENT_CATALOG_ENTRY_H_ */
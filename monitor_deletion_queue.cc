@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+///
+/// \brief  Monitor for background deletions
+///
+///         Reports the number of directories waiting in the
+///         DeletionService.
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+
+//---Own------------------------------
+
+#include "monitor_deletion_queue.h"
+#include "deletion_service.h"
+
+
+//---Implementation------------------------------------------------------------
+
+
+MonitorDeletionQueue::MonitorDeletionQueue( )
+    :Monitor( "DeletionQueue")
+{
+    depth=0;
+};
+
+
+Glib::RefPtr <Monitor>MonitorDeletionQueue::create(  ) /* static */
+{
+    return ( Glib::RefPtr <Monitor>( new MonitorDeletionQueue() ) );
+}
+
+
+void MonitorDeletionQueue::updateValues() /* virtual */
+{
+    depth=DeletionService::get_instance()->queue_depth();
+    setValid(true);
+}
+
+
+Glib::ustring MonitorDeletionQueue::getLogString() /* virtual */
+{
+    Glib::ustring ret;
+
+    ret=Glib::ustring::compose("Queued: %1", depth);
+
+    return(ret);
+}
+
+
+long MonitorDeletionQueue::getTriggerValue() /* virtual */
+{
+    return(depth);
+}
+
+
+//---fin.----------------------------------------------------------------------
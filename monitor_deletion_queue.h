@@ -0,0 +1,49 @@
+#ifndef MONITOR_DELETION_QUEUE_H
+#define MONITOR_DELETION_QUEUE_H
+//-----------------------------------------------------------------------------
+///
+/// \brief  Monitor for background deletions
+///
+///         Reports the number of directories waiting in the
+///         DeletionService.
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+#include <glibmm/refptr.h>
+
+
+//---Own------------------------------
+
+#include "monitor.h"
+
+
+//---Declaration---------------------------------------------------------------
+
+
+class MonitorDeletionQueue: public Monitor
+{
+    private:
+
+        long int depth;
+
+    public:
+        MonitorDeletionQueue( );
+        static Glib::RefPtr <Monitor>create(  );
+
+        virtual void updateValues();
+        virtual Glib::ustring getLogString();
+
+        virtual long getTriggerValue();
+};
+
+
+//-----------------------------------------------------------------------------
+#endif // ? ! MONITOR_DELETION_QUEUE_H
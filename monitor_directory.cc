@@ -16,6 +16,10 @@
 //---General--------------------------
 
 #include <glibmm/refptr.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
 
 //---Own------------------------------
 
@@ -28,7 +32,7 @@
 MonitorDirectory::MonitorDirectory( const Glib::ustring &_dirName )
     :Monitor( "Directory: " + _dirName)
     ,dirName(_dirName)
-    ,dir(dirName)
+    ,subdirCount(0)
 {
     // Nothing to do here
 };
@@ -42,16 +46,34 @@ Glib::RefPtr <Monitor>MonitorDirectory::create( const Glib::ustring &_dirName )
 
 void MonitorDirectory::updateValues() /* virtual */
 {
+    struct dirent *dirEntry;
+    struct stat sb;
+    DIR *dir;
+
     subdirCount=0;
 
-    // "." and ".." are not part of the list;
-    // The list is updated automatically; no need to reconstruct the object.
-    for (auto&& dirEntry : dir)
+    dir=opendir( dirName.c_str() );
+    if( !dir )
+    {
+        setValid(false);
+        return;
+    }
+
+    // d_type saves a stat per entry; symlinks and some filesystems need it
+    while( ( dirEntry=readdir(dir) ) )
     {
-        // printf("### File: %s\n", dirEntry.c_str() );
-        if( Glib::file_test ( dirName + "/" +dirEntry, Glib::FILE_TEST_IS_DIR) )
+        if( !strcmp(dirEntry->d_name, ".") || !strcmp(dirEntry->d_name, "..") )
+            continue;
+
+        if( dirEntry->d_type == DT_DIR )
+            subdirCount++;
+        else if( ( dirEntry->d_type == DT_UNKNOWN || dirEntry->d_type == DT_LNK )
+                 && !fstatat( dirfd(dir), dirEntry->d_name, &sb, 0 )
+                 && S_ISDIR( sb.st_mode ) )
             subdirCount++;
     }
+    closedir(dir);
+
     setValid(true);
 
     return;
@@ -37,7 +37,6 @@ class MonitorDirectory: public Monitor
     private:
 
         Glib::ustring dirName;
-        Glib::Dir dir;
         int subdirCount;
 
     public:
@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------------
+///
+/// \brief  Monitor for the cache of verified signatures
+///
+///         Reports hits, misses, evictions and invalidations since the
+///         last update.
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+
+//---Own------------------------------
+
+#include "monitor_signature_cache.h"
+
+
+//---Implementation------------------------------------------------------------
+
+
+MonitorSignatureCache::MonitorSignatureCache( )
+    :Monitor( "SignatureCache" )
+{
+    last=SignatureCache::get_instance()->stats();
+    delta=SignatureCache::Stats();
+};
+
+
+Glib::RefPtr <Monitor>MonitorSignatureCache::create( ) /* static */
+{
+    return ( Glib::RefPtr <Monitor>( new MonitorSignatureCache( ) ) );
+}
+
+
+void MonitorSignatureCache::updateValues() /* virtual */
+{
+    SignatureCache::Stats now=SignatureCache::get_instance()->stats();
+
+    delta.hits=now.hits-last.hits;
+    delta.misses=now.misses-last.misses;
+    delta.evictions=now.evictions-last.evictions;
+    delta.invalidations=now.invalidations-last.invalidations;
+    delta.entries=now.entries;
+
+    last=now;
+    setValid(true);
+}
+
+
+Glib::ustring MonitorSignatureCache::getLogString() /* virtual */
+{
+    Glib::ustring ret;
+
+    ret=Glib::ustring::compose("Hits: %1; Misses: %2; Evictions: %3; "
+                               "Invalidations: %4; Entries: %5",
+                               delta.hits,
+                               delta.misses,
+                               delta.evictions,
+                               delta.invalidations,
+                               delta.entries);
+
+    return(ret);
+}
+
+
+long MonitorSignatureCache::getTriggerValue() /* virtual */
+{
+    return(delta.misses);
+}
+
+
+//---fin.----------------------------------------------------------------------
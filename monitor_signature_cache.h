@@ -0,0 +1,52 @@
+#ifndef MONITOR_SIGNATURE_CACHE_H
+#define MONITOR_SIGNATURE_CACHE_H
+//-----------------------------------------------------------------------------
+///
+/// \brief  Monitor for the cache of verified signatures
+///
+///         Reports hits, misses, evictions and invalidations since the
+///         last update.
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+#include <glibmm/refptr.h>
+#include <glibmm/ustring.h>
+
+
+//---Own------------------------------
+
+#include "monitor.h"
+#include "signature_cache.h"
+
+
+//---Declaration---------------------------------------------------------------
+
+
+class MonitorSignatureCache: public Monitor
+{
+    private:
+
+        SignatureCache::Stats last;
+        SignatureCache::Stats delta;
+
+    public:
+        MonitorSignatureCache( );
+        static Glib::RefPtr <Monitor>create( );
+
+        virtual void updateValues();
+        virtual Glib::ustring getLogString();
+
+        virtual long getTriggerValue();
+};
+
+
+//-----------------------------------------------------------------------------
+#endif // ? ! MONITOR_SIGNATURE_CACHE_H
@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+///
+/// \brief  Monitor for reply writes of a socket interface
+///
+///         Reports write latency, queued bytes and dropped clients of
+///         all connections of one interface.
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+
+//---Own------------------------------
+
+#include "monitor_socket_writes.h"
+
+
+//---Implementation------------------------------------------------------------
+
+
+MonitorSocketWrites::MonitorSocketWrites( const Glib::ustring &interface )
+    :Monitor( Glib::ustring::compose("SocketWrites %1", interface) )
+{
+    stats=SocketWriteStats::get( interface );
+    snapshot=SocketWriteStats::Snapshot();
+};
+
+
+Glib::RefPtr <Monitor>MonitorSocketWrites::create( const Glib::ustring &interface ) /* static */
+{
+    return ( Glib::RefPtr <Monitor>( new MonitorSocketWrites( interface ) ) );
+}
+
+
+void MonitorSocketWrites::updateValues() /* virtual */
+{
+    snapshot=stats->take();
+    setValid(true);
+}
+
+
+Glib::ustring MonitorSocketWrites::getLogString() /* virtual */
+{
+    Glib::ustring ret;
+
+    ret=Glib::ustring::compose("Replies: %1; Latency avg: %2 ms; Latency max: %3 ms; "
+                               "Queued: %4; Queued max: %5; Dropped: %6",
+                               snapshot.replies,
+                               (long) snapshot.latency_avg_ms,
+                               (long) snapshot.latency_max_ms,
+                               snapshot.queued_bytes,
+                               snapshot.queued_bytes_max,
+                               snapshot.disconnects);
+
+    return(ret);
+}
+
+
+long MonitorSocketWrites::getTriggerValue() /* virtual */
+{
+    return(snapshot.queued_bytes_max);
+}
+
+
+//---fin.----------------------------------------------------------------------
@@ -0,0 +1,52 @@
+#ifndef MONITOR_SOCKET_WRITES_H
+#define MONITOR_SOCKET_WRITES_H
+//-----------------------------------------------------------------------------
+///
+/// \brief  Monitor for reply writes of a socket interface
+///
+///         Reports write latency, queued bytes and dropped clients of
+///         all connections of one interface.
+///
+/// \date   [20261019] File created
+///
+//-----------------------------------------------------------------------------
+
+
+//---Includes------------------------------------------------------------------
+
+
+//---General--------------------------
+
+#include <glibmm/refptr.h>
+#include <glibmm/ustring.h>
+
+
+//---Own------------------------------
+
+#include "monitor.h"
+#include "socket_write_stats.h"
+
+
+//---Declaration---------------------------------------------------------------
+
+
+class MonitorSocketWrites: public Monitor
+{
+    private:
+
+        SocketWriteStats::RefPtr stats;
+        SocketWriteStats::Snapshot snapshot;
+
+    public:
+        MonitorSocketWrites( const Glib::ustring &interface );
+        static Glib::RefPtr <Monitor>create( const Glib::ustring &interface );
+
+        virtual void updateValues();
+        virtual Glib::ustring getLogString();
+
+        virtual long getTriggerValue();
+};
+
+
+//-----------------------------------------------------------------------------
+#endif // ? ! MONITOR_SOCKET_WRITES_H
@@ -2,6 +2,11 @@
 
 #include <sys/types.h>
 #include <signal.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 
 #include <glibmm/stringutils.h>
 
@@ -16,6 +21,9 @@ ProcessRequest::ProcessRequest(
     const std::string& stdout_file, bool capture_stderr)
   : _argv{argv}
   , _stdout_file{stdout_file}
+  , _stdin_pos{0}
+  , _feed_stdin{false}
+  , _stdin{-1}
   , _timeouted{false}
   , _capture_stdout{capture_stdout}
   , _capture_stderr{capture_stderr}
@@ -70,6 +78,14 @@ void ProcessRequest::start_process()
     _src_out->attach(Glib::MainContext::get_default());
     _src_err->attach(Glib::MainContext::get_default());
 
+    // feed stdin, if requested
+    if (_feed_stdin) {
+        fcntl(_stdin, F_SETFL, fcntl(_stdin, F_GETFL) | O_NONBLOCK);
+        _stdin_watch = Glib::signal_io().connect(
+            sigc::mem_fun(*this, &ProcessRequest::handle_stdin), _stdin,
+            Glib::IO_OUT | Glib::IO_ERR | Glib::IO_HUP);
+    }
+
     // set timeout, if requested
     if (_timeout > 0)
         Glib::signal_timeout().connect_seconds_once(
@@ -89,6 +105,79 @@ ProcessRequest::set_no_log_error ()
     _no_log_error = true;
 }
 
+void ProcessRequest::set_stdin_data(const std::string& data)
+{
+    _stdin_data = data;
+    _stdin_pos  = 0;
+    _feed_stdin = true;
+}
+
+void ProcessRequest::close_stdin()
+{
+    _stdin_watch.disconnect();
+
+    if (_stdin >= 0)
+        close(_stdin);
+    _stdin = -1;
+}
+
+/**
+ * Write to the stdin pipe without being killed by SIGPIPE, if the child
+ * exits before reading everything.
+ */
+static ssize_t write_pipe(int fd, const char *buf, std::size_t len)
+{
+    sigset_t pipe_set, old_set;
+    sigset_t pending;
+
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+    sigpending(&pending);
+    bool was_pending = sigismember(&pending, SIGPIPE);
+
+    ssize_t ret = write(fd, buf, len);
+    int err = errno;
+
+    if (ret < 0 && err == EPIPE && !was_pending) {
+        struct timespec no_wait = { 0, 0 };
+        sigtimedwait(&pipe_set, nullptr, &no_wait);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+    errno = err;
+
+    return ret;
+}
+
+bool ProcessRequest::handle_stdin(Glib::IOCondition cond)
+{
+    UNUSED(cond);
+
+    while (_stdin_pos < _stdin_data.size()) {
+        ssize_t ret = write_pipe(_stdin, _stdin_data.data() + _stdin_pos,
+                                 _stdin_data.size() - _stdin_pos);
+
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret < 0 && errno == EAGAIN)
+            return true;
+        if (ret < 0) {
+            PRINT_DEBUG("ProcessRequest::handle_stdin(): " << strerror(errno));
+            break;
+        }
+        _stdin_pos += ret;
+    }
+
+    // eof for the child, the watch is removed by returning false
+    _stdin_watch = sigc::connection();
+    close_stdin();
+    _stdin_data.clear();
+
+    return false;
+}
+
 void ProcessRequest::child_watch_handler(GPid pid, int child_status)
 {
     Glib::RefPtr<ProcessResult> result;
@@ -187,7 +276,7 @@ void ProcessRequest::child_watch_handler(GPid pid, int child_status)
     _src_out->destroy();
     _src_err->destroy();
 
-    close (_stdin);
+    close_stdin();
 
     PRINT_DEBUG("Result stdout:     " << result->stdout() );
     PRINT_DEBUG("Result stdout_buf: " << _stdout_buf );
@@ -69,6 +69,12 @@ public:
      */
     void set_no_log_error ();
 
+    /**
+     * Write data to stdin of the process, which is closed afterwards.
+     * Must be called before start_process().
+     */
+    void set_stdin_data(const std::string& data);
+
     sigc::signal<void, const Glib::RefPtr<ProcessResult>& > finished;
 
 private:
@@ -78,6 +84,10 @@ private:
     std::string _stdout_buf;
     std::string _stdout_file;
     std::string _stderr_buf;
+    std::string _stdin_data;
+    std::size_t _stdin_pos;
+    bool _feed_stdin;
+    sigc::connection _stdin_watch;
     Glib::RefPtr<Glib::IOChannel> _ch_out;
     Glib::RefPtr<Glib::IOChannel> _ch_err;
     Glib::RefPtr<Glib::IOSource> _src_out;
@@ -95,6 +105,8 @@ private:
     void child_watch_handler(GPid pid, int child_status);
     bool handle_stdout(const Glib::IOCondition& cond);
     bool handle_stderr(const Glib::IOCondition& cond);
+    bool handle_stdin(Glib::IOCondition cond);
+    void close_stdin();
     void handle_timeout();
 };
 
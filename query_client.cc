@@ -77,3 +77,9 @@ QueryClient::get_instance ()
 
     return instance;
 }
+
+void
+QueryClient::set_instance (Glib::RefPtr <QueryClient> client)
+{
+    instance = client;
+}
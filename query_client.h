@@ -52,6 +52,11 @@ class QueryClient : public Glib::Object
 	virtual Glib::RefPtr <Query> create_query (Glib::RefPtr <XmlQuery> xq, bool use_timeout = true) = 0;
 
 	static Glib::RefPtr <QueryClient> get_instance ();
+	/**
+	 * Replace the client returned by get_instance, e.g. to run
+	 * benchmarks against QueryClientDummy on a target build.
+	 */
+	static void set_instance (Glib::RefPtr <QueryClient> client);
 
 	sigc::signal <void>  resetted;
 	virtual void reset_connection () = 0;
@@ -1,6 +1,7 @@
 
 #include "query_client_dummy.h"
 #include "serial_interface_handler.h"
+#include "log.h"
 
 #include "xml_result_ok.h"
 #include "xml_result_bad_request.h"
@@ -54,10 +55,7 @@ QueryClientDummy::reset_connection ()
 void
 QueryClientDummy::execute(Glib::RefPtr<Query> query)
 {
-    printf ("QueryDummy::execute ()\n");
-    printf ("-------------------------------------------------\n");
-    printf ("%s\n", query->xml_query().c_str ());
-    printf ("-------------------------------------------------\n");
+    lDebug ("QueryDummy::execute ()\n%s\n", query->xml_query().c_str ());
 
     query->finished.emit(XmlResultOk::create(query->xml_query()));
 
@@ -23,7 +23,6 @@
 #include "usbserial_interface_handler.h"
 
 #include "xml_result_ok.h"
-#include "xml_result_parsed.h"
 #include "xml_result_bad_request.h"
 #include "xml_result_timeout.h"
 
@@ -203,10 +202,9 @@ QueryClientSerial::on_query_sent(int tid)
 }
 
 void
-QueryClientSerial::on_response_ready(const Glib::ustring& responseString, int tid)
+QueryClientSerial::on_response_ready(const Glib::RefPtr<XmlResult>& result, int tid)
 {
     lDebug("QueryClientSerial::on_response_ready(tid=%d)\n", tid);
-    lDebug("%s\n", responseString.c_str ());
 
     auto it = _query_map.find(tid);
     if (it == std::end(_query_map)) {
@@ -222,7 +220,7 @@ QueryClientSerial::on_response_ready(const Glib::ustring& responseString, int ti
 
     query->disconnect_signals();
 
-    query->finished.emit(XmlResultParsed::create(responseString));
+    query->finished.emit(result);
 }
 
 bool
@@ -52,7 +52,7 @@ class QueryClientSerial : public QueryClient
 
     void execute(Glib::RefPtr<Query> query) override;
 
-    void on_response_ready(const Glib::ustring& responseString, int tid);
+    void on_response_ready(const Glib::RefPtr<XmlResult>& result, int tid);
     void on_query_sent(int tid);
     bool on_query_timeout(int tid);
     void on_query_error(int tid);
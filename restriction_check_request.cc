@@ -10,76 +10,6 @@
 
 #include "restriction_check_request.h"
 
-// Note: This contains only the true values, everything else is considered false
-const RestrictionCheckRequest::RestCheckMap RestrictionCheckRequest::rest_check_map =
-{
-    { STR_ZIXINF_LANWEBSERVICE, {
-            { "update", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplate", true },
-            { "delFile", true }
-        },
-    },
-    { STR_ZIXINF_LANWEBSERVER, {
-            { "update", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplate", true },
-            { "delFile", true }
-        },
-    },
-    { STR_ZIXINF_LANSHAREDFOLDER, {
-            { "update", true },
-            { "procedure", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplate", true },
-            { "delFile", true }
-        },
-    },
-    { STR_ZIXINF_LANSOCKET, {
-            { "update", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplate", true },
-            { "delFile", true }
-        },
-    },
-    { STR_ZIXINF_USB, {
-            { "update", true },
-            { "procedure", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplate", true },
-            { "delFile", true }
-        },
-    },
-    { STR_ZIXINF_COM1, {
-            { "update", true },
-       },
-    },
-    { STR_ZIXINF_COM2, {
-            { "update", true },
-       },
-    },
-};
-
 void RestrictionCheckRequest::start_query_dc()
 {
     auto dc = QueryClient::get_instance();
@@ -92,17 +22,7 @@ void RestrictionCheckRequest::start_query_dc()
 
 bool RestrictionCheckRequest::check_needed(const ZixInterface& channel) const
 {
-    auto it1 = rest_check_map.find(channel.to_string());
-    if (it1 == rest_check_map.end()) {
-        PRINT_DEBUG("Unknown Interface used: " << channel.to_string());
-        return false;
-    }
-
-    auto it2 = it1->second.find(_fid);
-    if (it2 == it1->second.end())
-        return false;
-
-    return it2->second;
+    return FunctionRegistry::restriction_needed(_function, channel);
 }
 
 void RestrictionCheckRequest::start_check(const ZixInterface& channel)
@@ -15,21 +15,24 @@
 #include "query_client.h"
 #include "restriction_check_result.h"
 #include "zix_interface.h"
+#include "function_registry.h"
 
 class RestrictionCheckRequest : public Glib::Object
 {
 public:
     using RefPtr       = Glib::RefPtr<RestrictionCheckRequest>;
-    using RestCheckMap = std::map<std::string, std::map<std::string, bool> >;
 
-    explicit RestrictionCheckRequest(const XmlFunction::XmlRestrictionList & restrictions, const Glib::ustring & fid) :
+    explicit RestrictionCheckRequest(const XmlFunction::XmlRestrictionList & restrictions, const Glib::ustring & fid,
+                                     FunctionRegistry::Id function) :
         _restrictions(restrictions),
-	_fid(fid)
+	_fid(fid),
+	_function(function)
     {}
 
-    static inline RefPtr create(const XmlFunction::XmlRestrictionList & restrictions, const Glib::ustring & fid)
+    static inline RefPtr create(const XmlFunction::XmlRestrictionList & restrictions, const Glib::ustring & fid,
+                                FunctionRegistry::Id function)
     {
-        return RefPtr(new RestrictionCheckRequest(restrictions, fid));
+        return RefPtr(new RestrictionCheckRequest(restrictions, fid, function));
     }
 
     void start_check(const ZixInterface& channel);
@@ -37,10 +40,9 @@ public:
     sigc::signal<void, const Glib::RefPtr<RestrictionCheckResult>& > finished;
 
 private:
-    static const RestCheckMap rest_check_map;
-
     XmlFunction::XmlRestrictionList _restrictions;
     Glib::ustring _fid;
+    FunctionRegistry::Id _function;
     Glib::RefPtr<Query> _write_query;
 
     bool check_needed(const ZixInterface& channel) const;
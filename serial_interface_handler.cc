@@ -70,6 +70,9 @@
 #include "xml_helpers.h"
 #include "procedure_step_handler.h"
 #include "xml_result_timeout.h"
+#include "xml_result_parsed.h"
+#include "xml_result_internal_device_error.h"
+#include "task_envelope.h"
 #include "time_utilities.h"
 #include "serial_helper.h"
 
@@ -361,10 +364,24 @@ gboolean SerialInterfaceHandler::handleInputData(gchar *data, gsize size)
 
 void SerialInterfaceHandler::emit_result( const Glib::ustring &result, int tid) /* virtual */
 {
-    lDebug("### emit result: %s\n", result.c_str() );
-    transmitMessages.push(
-        std::make_pair(ustring::compose("<task tid=\"%1\">%2</task>", tid, result),
-                       tid));
+    emit_result_buffer( SharedBuffer(result), tid );
+}
+
+
+/// \brief  Queue a result wrapped in a task
+///
+///         The result is referenced by the message, frames are copied from
+///         it while sending.
+void SerialInterfaceHandler::emit_result_buffer( const SharedBuffer &result, int tid) /* virtual */
+{
+    SharedBuffer message( std::string(ustring::compose("<task tid=\"%1\">", tid).raw()) );
+
+    if( doInternLog( ELogLevelDebug ) )
+        lDebug("### emit result: %s\n", result.to_string().c_str() );
+
+    message.append( result );
+    message.append( std::string("</task>") );
+    transmitMessages.push( std::make_pair(message, tid) );
     sendLoop();
 }
 
@@ -490,7 +507,7 @@ void SerialInterfaceHandler::sendFrame( int mid, int type, int i, int n, const s
     {
         lWarn("Injecting wrong crc (%d)\n", _injectWrongCrc);
         crc32_value=0x12345678;
-        _injectWrongCrc=0;
+        _injectWrongCrc--;
     }
 
     footer=ustring::compose("%1%2"
@@ -866,52 +883,40 @@ bool SerialInterfaceHandler::FTO_timeout_handler()
 
 void SerialInterfaceHandler::emitMessage (const Glib::ustring &payload)
 {
-    std::stringstream ss;
-    xmlpp::Element *element;
-    xmlpp::DomParser parser;
-    int tid;
+    const std::string &raw = payload.raw();
+    TaskEnvelope task;
 
     // Unfortunately we have to know if the message is an "request" or an
     // "respone" because they are handeled in different channels.
-    try{
-        parser.parse_memory( payload );
-    }
-    catch( ... )
-    {
-        lError("Error: Could not parse xml code!");
-        return;
-    }
-
-    element=parser.get_document()->get_root_node();
-    assert(element);
-
-    if( element->get_name() != "task" ) {
+    // The <task> is only scanned, the wrapped element is parsed once by
+    // the channel it is handed to.
+    if( !TaskEnvelope::scan( raw.data(), raw.size(), task ) ) {
         PRINT_ERROR ("Invalid message received, ignoring it");
         return;
     }
 
-    ss << element->get_attribute_value("tid");
-    ss >> tid;
-    element=dynamic_cast<xmlpp::Element *> ( element->get_first_child() );
-
-    if(!element)
+    if( task.kind == TaskEnvelope::FUNCTION )
     {
-        lError( "Could not get child for task\n" );
-        return;
+        UStringIStream is_buf ( raw.substr( task.offset, task.size ) );
+        std::istream is(&is_buf);
+        dcTaskId=task.tid;
+        lDebug("Getting function for tid %d\n", task.tid );
+        request_ready.emit ( is, task.tid );
     }
-
-    if( element->get_name() == "function" )
+    else if( task.kind == TaskEnvelope::REPLY )
     {
-        UStringIStream is_buf ( element_to_string(element, 0, 0) );
-        std::istream is(&is_buf);
-        dcTaskId=tid;
-        lDebug("Getting function: %s\n", element_to_string(element, 0, 0).c_str() );
-        request_ready.emit ( is, tid );
+        Glib::RefPtr <XmlResult> result;
+
+        try {
+            result = XmlResultParsed::create( SharedBuffer( raw.substr( task.offset, task.size ) ) );
+        } catch (std::exception & e) {
+            lError("Error: Could not parse reply: %s", e.what() );
+            result = XmlResultInternalDeviceError::create( e.what() );
+        }
+        response_ready.emit ( result, task.tid );
     }
-    else if( element->get_name() == "reply" )
-        response_ready.emit ( element_to_string(element, 0, 0), tid );
     else
-        lError("Unknown Message received: %s", element->get_name().c_str() );
+        lError("Unknown Message received: %s", task.name.c_str() );
 
     return;
 }
@@ -953,7 +958,7 @@ void SerialInterfaceHandler::sendMessage(const Glib::ustring &str, int tid)
         PRINT_ERROR ("RS422InterfaceHandler::sendMessage(): unable to convert message " << e.what ());
     }
 
-    transmitMessages.push (std::make_pair(str, tid));
+    transmitMessages.push (std::make_pair(SharedBuffer(str), tid));
 
     sendLoop();
 
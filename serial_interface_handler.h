@@ -183,7 +183,7 @@ class SerialInterfaceHandler: public InterfaceHandler
         // receiveMessages are not necessary at the moment; we directly emit an
         // message when it arrives
         // std::queue < const Glib::ustring > receiveMessages;
-        std::queue < std::pair< Glib::ustring, int > > transmitMessages;
+        std::queue < std::pair< SharedBuffer, int > > transmitMessages;
 
         Glib::RefPtr<CSerialMessage> senderMessage;
         Glib::RefPtr<CSerialMessage> receiverMessage;
@@ -205,9 +205,10 @@ class SerialInterfaceHandler: public InterfaceHandler
         void reset_error_counters();
 
     public:
-        void injectWrongCrc()
+        /// \brief  send the next frames with a wrong crc
+        void injectWrongCrc( int frames = 1 )
         {
-            _injectWrongCrc=1;
+            _injectWrongCrc=frames;
         }
         SerialInterfaceHandler(ZixInterface inf, const char *deviceName, int deviceSpeed, Glib::RefPtr <XmlProcessor> xml_processor, ESerialHandlerMode _eSerialHandlerMode );
         ~SerialInterfaceHandler();
@@ -220,6 +221,7 @@ class SerialInterfaceHandler: public InterfaceHandler
 
         gboolean handleInputData(gchar *input, gsize size);
         virtual void emit_result( const Glib::ustring &result, int tid );
+        virtual void emit_result_buffer( const SharedBuffer &result, int tid );
         void discardReceiveFrame();
         void sendPayloadFrame(int i, int n, const std::string *str);
         void sendConfirmFrame( ESerialCode ack, const char *code);
@@ -41,6 +41,7 @@ CSerialMessage::CSerialMessage(int _maxFrameSize)
     numFrames=0;
     maxFrameSize=_maxFrameSize;
     transceived=0;
+    sendOffset=0;
 
     return;
 }
@@ -51,6 +52,8 @@ void CSerialMessage::discard()
 {
     payload.erase();
     framePayload.erase();
+    sendPayload=SharedBuffer();
+    sendOffset=0;
 
     transceived=numFrames=0;
 
@@ -69,11 +72,20 @@ int CSerialMessage::getTransceived()
 
 
 void CSerialMessage::initSenderMessage( const Glib::ustring &newPayload, int tid )
+{
+    initSenderMessage( SharedBuffer(newPayload), tid );
+}
+
+
+/// \brief  Start sending a message
+///
+///         The payload is referenced, popFrame() copies one frame at a time.
+void CSerialMessage::initSenderMessage( const SharedBuffer &newPayload, int tid )
 {
     discard();
-    payload=newPayload;
-    numFrames= payload.size() / maxFrameSize;
-    if( payload.size() % maxFrameSize )
+    sendPayload=newPayload;
+    numFrames= sendPayload.size() / maxFrameSize;
+    if( sendPayload.size() % maxFrameSize )
         numFrames++;
     taskid = tid;
 }
@@ -92,19 +104,19 @@ void CSerialMessage::initReceiverMessage(int _numFrames)
 bool CSerialMessage::popFrame()
 {
 
-    if( ! payload.length() )
+    if( sendOffset >= sendPayload.size() )
     {
         lError("Error: pop: no data left\n");
         return(true);
     }
 
-    framePayload = payload.substr(0, maxFrameSize);
-    payload.erase(0, framePayload.length() );
+    sendPayload.read(sendOffset, maxFrameSize, framePayload);
+    sendOffset+=framePayload.length();
     transceived++;
 
-    lHighDebug("POP: frame payload:\"%s\"; remaining payload:\"%s\"\n",
+    lHighDebug("POP: frame payload:\"%s\"; remaining payload: %d bytes\n",
            framePayload.c_str(),
-           payload.c_str()
+           (int)(sendPayload.size() - sendOffset)
            );
 
     return(false);
@@ -132,11 +144,13 @@ bool CSerialMessage::pushFrame(int index, int num, const std::string &newFramePa
 ///         false:  No data left to be send.
 gboolean CSerialMessage::dataLeft()
 {
-    if ( ( transceived < numFrames ) && ( ! payload.length() ) )
+    std::size_t left = sendPayload.size() - sendOffset;
+
+    if ( ( transceived < numFrames ) && ( ! left ) )
         lError("### Error: frames to be send but no data\n");
 
-    if ( ( transceived >= numFrames ) && ( payload.length() ) )
-        lError("### Error: no frames to be send but data left; transceived: %d; data left: '%s'\n", transceived, payload.c_str() );
+    if ( ( transceived >= numFrames ) && ( left ) )
+        lError("### Error: no frames to be send but data left; transceived: %d; data left: %d bytes\n", transceived, (int)left );
 
     if ( transceived < numFrames )
         return(true);
@@ -25,6 +25,8 @@
 
 //---Own------------------------------
 
+#include "shared_buffer.h"
+
 
 
 //---Declaration---------------------------------------------------------------
@@ -51,10 +53,15 @@ class CSerialMessage: public Glib::Object
 	std::string payload;
         std::string framePayload;
 
+        // senders payload, frames are read from it at sendOffset
+        SharedBuffer sendPayload;
+        std::size_t sendOffset;
+
     public:
         CSerialMessage(int _maxFrameSize);
 
         void initSenderMessage( const Glib::ustring &newPayload, int tid );
+        void initSenderMessage( const SharedBuffer &newPayload, int tid );
         //void initSenderMessage( Glib::RefPtr<const Glib::ustring> &newPayload );
 
         void initReceiverMessage(int _numFrames);
@@ -0,0 +1,141 @@
+#include <algorithm>
+
+#include "shared_buffer.h"
+
+SharedBuffer::Counters SharedBuffer::_counters;
+
+static void free_string(gpointer data)
+{
+    delete static_cast<std::string *>(data);
+}
+
+SharedBuffer::SharedBuffer() :
+    _size{0}
+{}
+
+SharedBuffer::SharedBuffer(std::string&& data) :
+    _size{0}
+{
+    append(std::move(data));
+}
+
+SharedBuffer::SharedBuffer(const Glib::ustring& text) :
+    _size{0}
+{
+    account(text.bytes());
+    append(std::string(text.raw()));
+}
+
+SharedBuffer::SharedBuffer(const Segment& segment) :
+    _size{0}
+{
+    append(segment);
+}
+
+SharedBuffer SharedBuffer::copy(const char *data, std::size_t len)
+{
+    account(len);
+
+    return SharedBuffer(Glib::Bytes::create(data, len));
+}
+
+void SharedBuffer::append(const SharedBuffer& other)
+{
+    _segments.insert(_segments.end(), other._segments.begin(), other._segments.end());
+    _size += other._size;
+}
+
+void SharedBuffer::append(std::string&& data)
+{
+    if (data.empty())
+        return;
+
+    // the string is moved to the heap, its storage is handed over
+    auto owner = new std::string(std::move(data));
+
+    append(Glib::wrap(g_bytes_new_with_free_func(owner->data(), owner->size(),
+                                                 &free_string, owner)));
+}
+
+void SharedBuffer::append(const Segment& segment)
+{
+    if (!segment || !segment->get_size())
+        return;
+
+    _segments.push_back(segment);
+    _size += segment->get_size();
+}
+
+SharedBuffer::Segment SharedBuffer::bytes() const
+{
+    if (_segments.size() == 1)
+        return _segments.front();
+
+    SharedBuffer flat(to_string());
+
+    return flat.empty() ? Glib::Bytes::create(nullptr, 0) : flat._segments.front();
+}
+
+void SharedBuffer::read(std::size_t offset, std::size_t len, std::string& out) const
+{
+    out.clear();
+
+    for (auto&& segment : _segments) {
+        gsize size = 0;
+        auto data = static_cast<const char *>(segment->get_data(size));
+
+        if (offset >= size) {
+            offset -= size;
+            continue;
+        }
+
+        std::size_t n = std::min<std::size_t>(size - offset, len - out.size());
+        out.append(data + offset, n);
+        offset = 0;
+
+        if (out.size() == len)
+            break;
+    }
+}
+
+std::string SharedBuffer::to_string() const
+{
+    std::string ret;
+
+    account(_size);
+    read(0, _size, ret);
+
+    return ret;
+}
+
+Glib::ustring SharedBuffer::to_ustring() const
+{
+    // to_string() accounts for flattening a rope
+    if (_segments.size() != 1)
+        return Glib::ustring(to_string());
+
+    gsize size = 0;
+    auto data = static_cast<const char *>(_segments.front()->get_data(size));
+
+    account(size);
+    return Glib::ustring(data, data + size);
+}
+
+const SharedBuffer::Counters& SharedBuffer::counters()
+{
+    return _counters;
+}
+
+void SharedBuffer::reset_counters()
+{
+    _counters = Counters();
+}
+
+void SharedBuffer::account(std::size_t len)
+{
+    if (!len)
+        return;
+
+    _counters.copies++;
+    _counters.bytes += len;
+}
@@ -0,0 +1,99 @@
+#ifndef _SHARED_BUFFER_H_
+#define _SHARED_BUFFER_H_
+
+#include <string>
+#include <vector>
+
+#include <glibmm/refptr.h>
+#include <glibmm/bytes.h>
+#include <glibmm/ustring.h>
+
+/**
+ * \brief Immutable, reference counted byte buffer
+ *
+ * A SharedBuffer is a rope of Glib::Bytes segments. Copying or appending
+ * buffers only references the segments, so a payload can travel from the
+ * parser to a file or an interface without being duplicated. Strings are
+ * adopted without copying when passed as rvalue.
+ *
+ * Every operation which duplicates payload (copy(), the ustring
+ * constructor, flattening a rope with bytes(), to_string() and
+ * to_ustring()) is accounted in counters(). read() fills caller buffers
+ * of bounded size, e.g. serial frames, and is not accounted.
+ *
+ * Example of usage:
+ *   SharedBuffer reply(std::move(head));
+ *   reply.append(body);
+ *   reply.append(std::string("</reply>\n"));
+ *   for (auto&& segment : reply.segments())
+ *       queue(segment);
+ */
+class SharedBuffer
+{
+public:
+    using Segment = Glib::RefPtr<Glib::Bytes>;
+
+    struct Counters
+    {
+        Counters() : copies(0), bytes(0) {}
+
+        std::size_t copies;
+        std::size_t bytes;
+    };
+
+    SharedBuffer();
+    explicit SharedBuffer(std::string&& data);
+    explicit SharedBuffer(const Glib::ustring& text);
+    explicit SharedBuffer(const Segment& segment);
+
+    /**
+     * Buffer holding a copy of data.
+     */
+    static SharedBuffer copy(const char *data, std::size_t len);
+
+    void append(const SharedBuffer& other);
+    void append(std::string&& data);
+    void append(const Segment& segment);
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    const std::vector<Segment>& segments() const
+    {
+        return _segments;
+    }
+
+    /**
+     * Contiguous content. Referenced for buffers of a single segment,
+     * a rope is flattened.
+     */
+    Segment bytes() const;
+
+    /**
+     * Replace out with at most len bytes starting at offset.
+     */
+    void read(std::size_t offset, std::size_t len, std::string& out) const;
+
+    std::string to_string() const;
+    Glib::ustring to_ustring() const;
+
+    static const Counters& counters();
+    static void reset_counters();
+
+private:
+    std::vector<Segment> _segments;
+    std::size_t _size;
+
+    static Counters _counters;
+
+    static void account(std::size_t len);
+};
+
+#endif /* _SHARED_BUFFER_H_ */
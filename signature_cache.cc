@@ -0,0 +1,147 @@
+#include <stdexcept>
+#include <iterator>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "signature_engine.h"
+#include "file_handler.h"
+#include "utils.h"
+
+#include "signature_cache.h"
+
+SignatureCache::RefPtr SignatureCache::instance(nullptr);
+
+const std::size_t SignatureCache::MAX_ENTRIES;
+
+static gint64 mtime_ns(const struct stat& sb)
+{
+    return static_cast<gint64>(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec;
+}
+
+/* Earlier versions saved update image results to a file. A verdict
+ * read back from /opt/transfer could have been written by anyone, so
+ * results are only kept in memory and the file is dropped.
+ */
+SignatureCache::SignatureCache() :
+    Glib::Object()
+{
+    try {
+        if (FileHandler::file_exists(ZIX_SIGNATURE_CACHE_FILE))
+            FileHandler::del_file(ZIX_SIGNATURE_CACHE_FILE);
+    } catch (const std::exception& ex) {
+        PRINT_ERROR("Failed to remove signature cache: " << ex.what());
+    }
+}
+
+bool SignatureCache::keyring_mtime(const std::string& keyring, gint64& mtime)
+{
+    struct stat sb;
+
+    if (stat(keyring.c_str(), &sb))
+        return false;
+
+    mtime = mtime_ns(sb);
+    return true;
+}
+
+std::string SignatureCache::make_key(const std::string& digest, const std::string& signature,
+                                     const std::string& keyring)
+{
+    std::string material;
+
+    material.reserve(digest.size() + signature.size() + keyring.size() + 2);
+    material += digest;
+    material.push_back('\0');
+    material += signature;
+    material.push_back('\0');
+    material += keyring;
+
+    return SignatureEngine::digest(G_CHECKSUM_SHA256, material);
+}
+
+void SignatureCache::erase(std::list<Entry>::iterator it)
+{
+    _index.erase(it->key);
+    _lru.erase(it);
+}
+
+/**
+ * Drop the entries of keyring, if it has been modified since they were
+ * stored.
+ */
+void SignatureCache::purge_stale(const std::string& keyring, gint64 mtime)
+{
+    auto seen = _keyrings.find(keyring);
+
+    if (seen != _keyrings.end() && seen->second == mtime)
+        return;
+    _keyrings[keyring] = mtime;
+
+    for (auto it = _lru.begin(); it != _lru.end(); ) {
+        auto cur = it++;
+
+        if (cur->keyring != keyring || cur->keyring_mtime == mtime)
+            continue;
+
+        erase(cur);
+        ++_stats.invalidations;
+    }
+}
+
+bool SignatureCache::lookup(const std::string& digest, const std::string& signature,
+                            const std::string& keyring, bool& valid)
+{
+    gint64 mtime;
+
+    if (!keyring_mtime(keyring, mtime)) {
+        ++_stats.misses;
+        return false;
+    }
+
+    purge_stale(keyring, mtime);
+
+    auto it = _index.find(make_key(digest, signature, keyring));
+    if (it == _index.end()) {
+        ++_stats.misses;
+        return false;
+    }
+
+    _lru.splice(_lru.begin(), _lru, it->second);
+    valid = it->second->valid;
+    ++_stats.hits;
+
+    return true;
+}
+
+void SignatureCache::store(const std::string& digest, const std::string& signature,
+                           const std::string& keyring, bool valid)
+{
+    gint64 mtime;
+
+    if (!keyring_mtime(keyring, mtime))
+        return;
+
+    purge_stale(keyring, mtime);
+
+    auto key = make_key(digest, signature, keyring);
+    auto it = _index.find(key);
+
+    if (it != _index.end())
+        erase(it->second);
+
+    Entry entry;
+    entry.key           = key;
+    entry.keyring       = keyring;
+    entry.keyring_mtime = mtime;
+    entry.valid         = valid;
+
+    _lru.push_front(entry);
+    _index[key] = _lru.begin();
+
+    while (_lru.size() > MAX_ENTRIES) {
+        erase(std::prev(_lru.end()));
+        ++_stats.evictions;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef _SIGNATURE_CACHE_H_
+#define _SIGNATURE_CACHE_H_
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+
+#include <string>
+#include <list>
+#include <map>
+#include <unordered_map>
+
+#define ZIX_SIGNATURE_CACHE_FILE "/opt/transfer/libzix_signature_cache.xml"
+
+/**
+ * \brief Results of signature verifications
+ *
+ * Entries are keyed by the SHA-256 digest of the signed payload, the
+ * signature and the keyring used. An entry is only valid as long as the
+ * modification time of its keyring does not change. The least recently
+ * used entries are dropped beyond MAX_ENTRIES.
+ *
+ * Results are kept in memory only, a verdict must not come from a file
+ * others could write. The digest has to be taken over the content, never
+ * over file metadata.
+ */
+class SignatureCache : public Glib::Object
+{
+public:
+    using RefPtr = Glib::RefPtr<SignatureCache>;
+
+    static const std::size_t MAX_ENTRIES = 256;
+
+    struct Stats
+    {
+        Stats() : hits(0), misses(0), evictions(0), invalidations(0), entries(0) {}
+
+        guint64 hits;
+        guint64 misses;
+        guint64 evictions;
+        guint64 invalidations;
+        std::size_t entries;
+    };
+
+    static inline RefPtr get_instance()
+    {
+        if (!instance)
+            instance = create();
+        return instance;
+    }
+
+    /**
+     * Look up an earlier verification.
+     *
+     * @param digest    SHA-256 of the signed payload
+     * @param signature signature as given in the request
+     * @param keyring   keyring or public key file used for verification
+     * @param valid     result of the earlier verification
+     *
+     * @return false, if not cached
+     */
+    bool lookup(const std::string& digest, const std::string& signature,
+                const std::string& keyring, bool& valid);
+
+    /**
+     * Remember a verification result. Nothing is stored, if the keyring
+     * does not exist.
+     */
+    void store(const std::string& digest, const std::string& signature,
+               const std::string& keyring, bool valid);
+
+    inline Stats stats() const noexcept
+    {
+        Stats ret = _stats;
+        ret.entries = _lru.size();
+        return ret;
+    }
+
+private:
+    struct Entry
+    {
+        std::string key;
+        std::string keyring;
+        gint64 keyring_mtime;
+        bool valid;
+    };
+
+    static RefPtr instance;
+
+    std::list<Entry> _lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+    // last seen modification time per keyring
+    std::map<std::string, gint64> _keyrings;
+    Stats _stats;
+
+    SignatureCache();
+
+    static inline RefPtr create()
+    {
+        return RefPtr(new SignatureCache());
+    }
+
+    static bool keyring_mtime(const std::string& keyring, gint64& mtime);
+    static std::string make_key(const std::string& digest, const std::string& signature,
+                                const std::string& keyring);
+
+    void purge_stale(const std::string& keyring, gint64 mtime);
+    void erase(std::list<Entry>::iterator it);
+};
+
+#endif /* _SIGNATURE_CACHE_H_ */
@@ -3,90 +3,15 @@
 #include "log_handler.h"
 #include "ustring_utils.h"
 #include "utils.h"
+#include "signature_engine.h"
+#include "signature_cache.h"
 
 #include "signature_check_request.h"
 
-const std::vector<std::string> SignatureCheckRequest::default_gpg_args =
-{ "gpg", "--verify", "--keyring", "/etc/zix/keyring.gpg", "--ignore-time-conflict", "--no-default-keyring" };
+constexpr const char *SignatureCheckRequest::keyring;
 
-// Note: This contains only the true values, everything else is considered false
-const SignatureCheckRequest::SigCheckMap SignatureCheckRequest::sig_check_map =
-{
-    { STR_ZIXINF_IPC, {
-            { "guiIO", true },
-        },
-    },
-    { STR_ZIXINF_LANWEBSERVICE, {
-	    { "update", true },
-	    { "getTemplate", true },
-	    { "getFilesList", true },
-	    { "getFile", true },
-	    { "setCalibration", true },
-	    { "setDefaults", true },
-	    { "setTemplatesList", true },
-	    { "setTemplate", true },
-	    { "setFile", true },
-	    { "delTemplatesList", true },
-	    { "delFile", true },
-	    { "guiIO", true },
-	},
-    },
-    { STR_ZIXINF_LANSHAREDFOLDER, {
-            { "update", true },
-            { "procedure", true },
-            { "getTemplate", true },
-            { "getFilesList", true },
-            { "getFile", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplatesList", true },
-            { "delFile", true },
-            { "guiIO", true },
-        },
-    },
-    { STR_ZIXINF_LANSOCKET, {
-            { "update", true },
-            { "getTemplate", true },
-            { "getFilesList", true },
-            { "getFile", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplatesList", true },
-            { "delFile", true },
-            { "guiIO", true },
-        },
-    },
-    { STR_ZIXINF_USB, {
-            { "update", true },
-            { "procedure", true },
-            { "getTemplate", true },
-            { "getFilesList", true },
-            { "getFile", true },
-            { "setCalibration", true },
-            { "setDefaults", true },
-            { "setTemplatesList", true },
-            { "setTemplate", true },
-            { "setFile", true },
-            { "delTemplatesList", true },
-            { "delFile", true },
-            { "guiIO", true },
-        },
-    },
-    { STR_ZIXINF_COM1, {
-            { "update", true },
-       },
-    },
-    { STR_ZIXINF_COM2, {
-            { "update", true },
-       },
-    },
-};
+const std::vector<std::string> SignatureCheckRequest::default_gpg_args =
+{ "gpg", "--batch", "--verify", "--keyring", keyring, "--ignore-time-conflict", "--no-default-keyring" };
 
 Glib::ustring SignatureCheckRequest::get_signature() const
 {
@@ -107,18 +32,7 @@ Glib::ustring SignatureCheckRequest::get_xml_without_signature() const
 
 bool SignatureCheckRequest::check_needed(const ZixInterface& channel) const
 {
-    auto stage1 = sig_check_map.find(channel.to_string());
-
-    if (stage1 == sig_check_map.end()) {
-        PRINT_DEBUG("Unknown Interface used: " << channel.to_string());
-        return false;
-    }
-
-    auto stage2 = stage1->second.find(_fid);
-    if (stage2 == stage1->second.end())
-        return false;
-
-    return stage2->second;
+    return FunctionRegistry::signature_needed(_function, channel);
 }
 
 void SignatureCheckRequest::cleanup() const
@@ -127,8 +41,6 @@ void SignatureCheckRequest::cleanup() const
     try {
         if (!_sig_file.empty())
             FileHandler::del_file(_sig_file);
-        if (!_xml_file.empty())
-            FileHandler::del_file(_xml_file);
     } catch (...) {
         PRINT_ERROR("Couldn't remove temporary files...");
     }
@@ -139,9 +51,11 @@ void SignatureCheckRequest::verify_via_gpg()
     std::vector<std::string> gpg_args(default_gpg_args);
 
     gpg_args.emplace_back(_sig_file);
-    gpg_args.emplace_back(_xml_file);
+    gpg_args.emplace_back("-");
 
     _gpg_proc = ProcessRequest::create(gpg_args, ProcessRequest::DEFAULT_TIMEOUT);
+    _gpg_proc->set_stdin_data(_xml);
+    _xml.clear();
     _gpg_proc->finished.connect(
         sigc::mem_fun(*this, &SignatureCheckRequest::on_gpg_proc_finish));
     _gpg_proc->start_process();
@@ -149,9 +63,15 @@ void SignatureCheckRequest::verify_via_gpg()
 
 void SignatureCheckRequest::on_gpg_proc_finish(const Glib::RefPtr<ProcessResult>& result)
 {
+    auto cache = SignatureCache::get_instance();
+
     cleanup();
 
     if (!result->success()) {
+        // exit status 1 is a bad signature, anything else may be temporary
+        if (result->get_exited_normally() && result->get_child_status() == 1)
+            cache->store(_digest, get_signature(), keyring, false);
+
         finished.emit(
             SignatureCheckResult::create(
                 false, Glib::ustring::compose("Gpg verification failed: %1",
@@ -159,14 +79,18 @@ void SignatureCheckRequest::on_gpg_proc_finish(const Glib::RefPtr<ProcessResult>
         return;
     }
 
+    cache->store(_digest, get_signature(), keyring, true);
+
     finished.emit(SignatureCheckResult::create(true, ""));
 }
 
 void SignatureCheckRequest::start_check(const ZixInterface& channel)
 {
-    Glib::RefPtr<Gio::UnixOutputStream> temp_stream1, temp_stream2;
+    Glib::RefPtr<Gio::UnixOutputStream> temp_stream;
     std::string error_msg;
     bool error = false;
+    bool cached = false;
+    bool valid = false;
 
     if (!check_needed(channel)) {
         finished.emit(SignatureCheckResult::create(true, ""));
@@ -175,29 +99,32 @@ void SignatureCheckRequest::start_check(const ZixInterface& channel)
 
     try {
         gsize bytes_written;
-        Glib::ustring signature, xml_without_sig;
+        Glib::ustring signature;
 
-        // 1. Open two temporary files
-        temp_stream1 = FileHandler::get_temp_file_write(_sig_file);
-        temp_stream2 = FileHandler::get_temp_file_write(_xml_file);
-
-        // 2. Get signature and write to first file
+        // 1. Get signature
         signature = get_signature();
         if (signature.empty())
             EXCEPTION("Signature tag not found in XML request");
-        if (use_binary_sig)
-            signature = FileHandler::base64_decode(signature);
-        temp_stream1->write_all(signature.data(), signature.bytes(), bytes_written);
 
-        // 3. Get Fid XML without signature tag and write to second file
-        xml_without_sig = get_xml_without_signature();
-        temp_stream2->write_all(xml_without_sig.data(), xml_without_sig.bytes(), bytes_written);
+        // 2. Get Fid XML without signature tag, it is passed on stdin
+        _xml = get_xml_without_signature();
+        _digest = SignatureEngine::digest(G_CHECKSUM_SHA256, _xml);
+
+        // 3. Verified before?
+        cached = SignatureCache::get_instance()->lookup(_digest, signature, keyring, valid);
 
-        temp_stream1->close();
-        temp_stream2->close();
+        if (!cached) {
+            // 4. Write signature to a temporary file
+            if (use_binary_sig)
+                signature = FileHandler::base64_decode(signature);
 
-        // 4. Call gpg in order to verify XML by signature
-        verify_via_gpg();
+            temp_stream = FileHandler::get_temp_file_write(_sig_file);
+            temp_stream->write_all(signature.data(), signature.bytes(), bytes_written);
+            temp_stream->close();
+
+            // 5. Call gpg in order to verify XML by signature
+            verify_via_gpg();
+        }
     } catch (const std::exception& ex) {
         error     = true;
         error_msg = ex.what();
@@ -210,6 +137,13 @@ void SignatureCheckRequest::start_check(const ZixInterface& channel)
     if (error) {
         cleanup();
         finished.emit(SignatureCheckResult::create(false, error_msg));
+        return;
+    }
+
+    if (cached) {
+        _xml.clear();
+        finished.emit(SignatureCheckResult::create(
+            valid, valid ? "" : "Gpg verification failed: bad signature (cached)"));
     }
 
     // success!
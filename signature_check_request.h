@@ -21,37 +21,40 @@
 #include "process_result.h"
 #include "xml_function.h"
 #include "zix_interface.h"
+#include "function_registry.h"
 
 /**
  * This class can be used in order to check whether the signature for
  * a given <function /> is valid.
  *
- * We use gpg to achieve that:
+ * We use gpg to achieve that, the xml is passed on stdin:
  *
- * -> gpg --verify --keyring /etc/zix/keyring.gpg --no-default-keyring <signature_file> <xml_file>
+ * -> gpg --batch --verify --keyring /etc/zix/keyring.gpg --no-default-keyring <signature_file> -
+ *
+ * Results are kept in the SignatureCache, a payload verified before with
+ * the same signature and keyring is not passed to gpg again.
  */
 class SignatureCheckRequest : public Glib::Object
 {
 public:
     using RefPtr      = Glib::RefPtr<SignatureCheckRequest>;
-    using SigCheckMap = std::map<std::string, std::map<std::string, bool> >;
 
     inline SignatureCheckRequest (const Glib::ustring & signature,
 				  const ZixInterface & channel,
-				  const Glib::ustring & fid,
+				  FunctionRegistry::Id function,
 				  const xmlpp::Element *root)
 	: _signature{signature}
 	, _channel{channel}
-	, _fid{fid}
+	, _function{function}
 	, _root{root}
     {}
 
     static inline RefPtr create (const Glib::ustring & signature,
 				 const ZixInterface & channel,
-				 const Glib::ustring & fid,
+				 FunctionRegistry::Id function,
 				 const xmlpp::Element *root)
     {
-        return RefPtr(new SignatureCheckRequest(signature, channel, fid, root));
+        return RefPtr(new SignatureCheckRequest(signature, channel, function, root));
     }
 
     void start_check(const ZixInterface& channel);
@@ -60,7 +63,7 @@ public:
 
 private:
     static const std::vector<std::string> default_gpg_args;
-    static const SigCheckMap sig_check_map;
+    static constexpr const char *keyring = "/etc/zix/keyring.gpg";
     /**
      * Gpg signatures can be ascii (.asc) or binary (.sig). We expect binary
      * ones in Base64 encoded format.
@@ -73,14 +76,14 @@ private:
     Glib::RefPtr<ProcessRequest> _gpg_proc;
     Glib::ustring _signature;
     ZixInterface _channel;
-    Glib::ustring _fid;
+    FunctionRegistry::Id _function;
     const xmlpp::Element *_root;
     std::string _sig_file;
-    std::string _xml_file;
+    std::string _xml;
+    std::string _digest;
 
     Glib::ustring get_signature() const;
     Glib::ustring get_xml_without_signature() const;
-    void write_xml_without_sig_tag() const;
     void verify_via_gpg();
     bool check_needed(const ZixInterface& channel) const;
     void cleanup() const;
@@ -4,6 +4,7 @@
 #include "ustring_utils.h"
 #include "utils.h"
 #include "conf_handler.h"
+#include "signature_engine.h"
 
 #include "signature_creation_request.h"
 
@@ -11,23 +12,13 @@
 const std::vector<std::string> SignatureCreationRequest::default_gpg_args =
 { "gpg", "--batch", "--yes", "--keyring", "/etc/zix/keyring_signing.gpg", "--no-default-keyring" };
 
-const std::vector<std::string> SignatureCreationRequest::default_hmac_args =
-{ "openssl", "dgst", "-sha1" };
-
 Glib::ustring SignatureCreationRequest::get_signature() const
 {
     auto content = FileHandler::get_file(_sig_file);
     return FileHandler::base64_encode(content);
 }
 
-Glib::ustring SignatureCreationRequest::get_hmac_signature() const
-{
-    auto content = FileHandler::get_file(_sig_file);
-    auto s = content.rfind(' ');
-    return FileHandler::base64_encode(content.substr(s+1));
-}
-
-void SignatureCreationRequest::write_xml_without_signature()
+std::string SignatureCreationRequest::get_xml_without_signature() const
 {
     xmlpp::DomParser parser;
 
@@ -44,14 +35,17 @@ void SignatureCreationRequest::write_xml_without_signature()
         EXCEPTION("Invalid input XML");
     root->remove_child(sig_child);
 
-    // get temp file
-    auto stream = FileHandler::get_temp_file_write(_xml_without_sig_file);
-    stream->close();
+    return doc->write_to_string();
+}
 
-    // write xml without signature tag
-    doc->write_to_file(_xml_without_sig_file);
+void SignatureCreationRequest::write_xml_without_signature(const std::string& xml)
+{
+    gsize bytes_written;
 
-    return;
+    // get temp file and write xml without signature tag
+    auto stream = FileHandler::get_temp_file_write(_xml_without_sig_file);
+    stream->write_all(xml.data(), xml.size(), bytes_written);
+    stream->close();
 }
 
 void SignatureCreationRequest::cleanup() const
@@ -71,45 +65,17 @@ void SignatureCreationRequest::cleanup() const
 
 void SignatureCreationRequest::create_signature_via_hmac()
 {
-    std::vector<std::string> hmac_args(default_hmac_args);
     auto conf = ConfHandler::get_instance();
     auto mac_addr=conf->getConfParameter("macAddress");
 
-    // get temp file for signature
-    auto stream = FileHandler::get_temp_file_write(_sig_file);
-    stream->close();
-
-    // call gpg
-    hmac_args.emplace_back("-hmac");
-    hmac_args.emplace_back(mac_addr);
-    hmac_args.emplace_back(_xml_without_sig_file);
-
-    _sig_proc = ProcessRequest::create(hmac_args, ProcessRequest::DEFAULT_TIMEOUT, true, _sig_file);
-    _sig_proc->finished.connect(
-        sigc::mem_fun(*this, &SignatureCreationRequest::on_hmac_proc_finish));
-    _sig_proc->start_process();
-}
-
-void SignatureCreationRequest::on_hmac_proc_finish(const Glib::RefPtr<ProcessResult>& result)
-{
-    if (!result->success()) {
-        cleanup();
-        finished.emit(
-            SignatureCreationResult::create(
-                false, Glib::ustring::compose(
-                    "Signature creation via openssl failed: %1", result->error_reason())));
-        return;
-    }
-
     try {
-        exchange_signature_in_xml (get_hmac_signature ());
+        exchange_signature_in_xml(
+            SignatureEngine::hmac_signature(mac_addr, get_xml_without_signature()));
     } catch (const std::exception& ex) {
-        cleanup();
         finished.emit(SignatureCreationResult::create(false, ex.what()));
         return;
     }
 
-    cleanup();
     finished.emit(SignatureCreationResult::create(true, ""));
 }
 
@@ -184,16 +150,15 @@ void SignatureCreationRequest::exchange_signature_in_xml(const Glib::ustring & s
 
 void SignatureCreationRequest::start_creation()
 {
+    // no process involved, finishes right away
+    if (_mode == MODE_HMAC) {
+        create_signature_via_hmac();
+        return;
+    }
+
     try {
-        write_xml_without_signature();
-	switch (_mode) {
-	    case MODE_GPG:
-		create_signature_via_gpg();
-		break;
-	    case MODE_HMAC:
-		create_signature_via_hmac();
-		break;
-	}
+        write_xml_without_signature(get_xml_without_signature());
+        create_signature_via_gpg();
     } catch (const std::exception& ex) {
         finished.emit(SignatureCreationResult::create(false, ex.what()));
     }
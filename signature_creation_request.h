@@ -25,9 +25,12 @@
  * file will be overridden and contain the valid signature after
  * SignatureCreationRequest will be successful.
  *
- * We use gpg to achieve that:
+ * MODE_GPG uses gpg to achieve that:
  *
  * -> gpg --keyring /etc/zix/keyring.gpg --no-default-keyring --output <signature_file> --detach-sig <xml_file>
+ *
+ * MODE_HMAC computes a HMAC-SHA1 keyed with the mac address in-process,
+ * see SignatureEngine::hmac_signature.
  */
 class SignatureCreationRequest : public Glib::Object
 {
@@ -51,7 +54,6 @@ public:
 
 private:
     static const std::vector<std::string> default_gpg_args;
-    static const std::vector<std::string> default_hmac_args;
 
     Glib::RefPtr<ProcessRequest> _sig_proc;
     std::string _xml_file;
@@ -60,15 +62,14 @@ private:
     Mode _mode;
 
     Glib::ustring get_signature() const;
-    Glib::ustring get_hmac_signature() const;
-    void write_xml_without_signature();
+    std::string get_xml_without_signature() const;
+    void write_xml_without_signature(const std::string& xml);
     void create_signature_via_gpg();
     void create_signature_via_hmac();
     void exchange_signature_in_xml(const Glib::ustring & signature) const;
     void cleanup() const;
 
     void on_gpg_proc_finish(const Glib::RefPtr<ProcessResult>& result);
-    void on_hmac_proc_finish(const Glib::RefPtr<ProcessResult>& result);
 };
 
 #endif /* _SIGNATURE_CREATION_REQUEST_H_ */
@@ -0,0 +1,38 @@
+#include <stdexcept>
+
+#include "signature_engine.h"
+#include "file_handler.h"
+
+std::string SignatureEngine::digest(GChecksumType type, const std::string& data)
+{
+    gchar *hex = g_compute_checksum_for_data(
+        type, reinterpret_cast<const guchar *>(data.data()), data.size());
+
+    if (!hex)
+        throw std::runtime_error("Unsupported checksum type");
+
+    std::string ret(hex);
+    g_free(hex);
+
+    return ret;
+}
+
+std::string SignatureEngine::hmac(GChecksumType type, const std::string& key, const std::string& data)
+{
+    gchar *hex = g_compute_hmac_for_data(
+        type, reinterpret_cast<const guchar *>(key.data()), key.size(),
+        reinterpret_cast<const guchar *>(data.data()), data.size());
+
+    if (!hex)
+        throw std::runtime_error("Unsupported HMAC type");
+
+    std::string ret(hex);
+    g_free(hex);
+
+    return ret;
+}
+
+Glib::ustring SignatureEngine::hmac_signature(const std::string& key, const std::string& data)
+{
+    return FileHandler::base64_encode(hmac(G_CHECKSUM_SHA1, key, data) + "\n");
+}
@@ -0,0 +1,36 @@
+#ifndef _SIGNATURE_ENGINE_H_
+#define _SIGNATURE_ENGINE_H_
+
+#include <string>
+
+#include <glib.h>
+#include <glibmm/ustring.h>
+
+/**
+ * \brief In-process digests and HMACs via GChecksum/GHmac
+ *
+ * Replaces spawning openssl for data which is already in memory.
+ */
+class SignatureEngine
+{
+public:
+    /**
+     * Lowercase hex digest of data.
+     */
+    static std::string digest(GChecksumType type, const std::string& data);
+
+    /**
+     * Lowercase hex HMAC of data.
+     */
+    static std::string hmac(GChecksumType type, const std::string& key, const std::string& data);
+
+    /**
+     * HMAC-SHA1 signature as used in <signature> of generated files.
+     *
+     * Same format as the former `openssl dgst -sha1 -hmac <key>` call: the
+     * base64 encoded hex digest including the trailing newline.
+     */
+    static Glib::ustring hmac_signature(const std::string& key, const std::string& data);
+};
+
+#endif /* _SIGNATURE_ENGINE_H_ */
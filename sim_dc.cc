@@ -0,0 +1,283 @@
+//----------------------------------------------------------------------------
+///
+/// \brief  Simulated devicecontroller for load tests
+///
+///         Creates a pty and answers the requests of the daemon like the
+///         devicecontroller would, see DcSimulator. Start it before the
+///         daemon and point the daemon to the pty, e.g.
+///
+///             sim_dc --link /tmp/ttyDC --latency 20 --latency getFile=200 \
+///                    --jitter 5 --baud 115200 \
+///                    --response getMeasurementsList=responsexmls/gml1.xml &
+///             LIBZIX_SERIAL_DEVICE=/tmp/ttyDC libzix_daemon
+///
+///         or with "--protocol usb" and LIBZIX_USB_SERIAL_DEVICE for the
+///         length prefixed protocol.
+///
+///         Statistics are printed on SIGINT/SIGTERM and every "--stats"
+///         seconds.
+///
+/// \date   [20261019] File created
+///
+//----------------------------------------------------------------------------
+
+
+#include <glibmm/main.h>
+#include <glibmm/init.h>
+#include <glib-unix.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <map>
+
+#include "dc_simulator.h"
+#include "log.h"
+
+
+static Glib::RefPtr<Glib::MainLoop> mainloop;
+
+
+static void usage( const char *name )
+{
+    std::cerr
+        << "usage: " << name << " [options]\n"
+        << "  --protocol framed|usb   IPC protocol (default framed)\n"
+        << "  --link PATH             symlink to the pty for the daemon\n"
+        << "  --responses DIR         answer with DIR/<fid>.xml if present\n"
+        << "  --response FID=FILE     answer FID with FILE\n"
+        << "  --latency [FID=]MS      time until the reply is sent\n"
+        << "  --jitter [FID=]MS       uniform jitter added to the latency\n"
+        << "  --sequential            handle one request at a time\n"
+        << "  --baud RATE             throttle the link to RATE baud\n"
+        << "  --max-payload BYTES     frame size, numberOfBytesPerFrameMax\n"
+        << "  --crc-errors RATE       share of sent frames with a wrong CRC\n"
+        << "  --rx-crc-errors RATE    share of received frames NAKed with CS\n"
+        << "  --seed N                seed for jitter and error injection\n"
+        << "  --stats SECONDS         print statistics periodically\n"
+        << "  --verbose               debug log\n";
+}
+
+
+/// \brief  Split "[FID=]VALUE"
+static bool splitFid( const char *arg, Glib::ustring &fid, std::string &value )
+{
+    const char *eq=strchr( arg, '=' );
+
+    if( !eq )
+    {
+        fid.clear();
+        value=arg;
+        return( true );
+    }
+
+    fid=std::string( arg, eq - arg );
+    value=eq + 1;
+
+    return( !fid.empty() && !value.empty() );
+}
+
+
+static void printStats( const Glib::RefPtr<DcSimulator> &sim )
+{
+    const SDcSimulatorStats &stats=sim->getStats();
+
+    std::cout << "requests " << stats.requests << "\n"
+              << "replies " << stats.replies << "\n"
+              << "frames_sent " << stats.framesSent << "\n"
+              << "frames_received " << stats.framesReceived << "\n"
+              << "bytes_sent " << stats.bytesSent << "\n"
+              << "bytes_received " << stats.bytesReceived << "\n"
+              << "crc_errors_injected " << stats.crcErrorsInjected << "\n"
+              << "naks_sent " << stats.naksSent << "\n"
+              << "naks_received " << stats.naksReceived << "\n"
+              << "resends " << stats.resends << "\n"
+              << "dropped " << stats.dropped << "\n";
+
+    for( auto &&fid : stats.requestsPerFid )
+        std::cout << "fid " << fid.first << " " << fid.second << "\n";
+
+    std::cout << std::endl;
+}
+
+
+static gboolean onQuitSignal( gpointer data )
+{
+    (void)data;
+    mainloop->quit();
+
+    return( G_SOURCE_REMOVE );
+}
+
+
+int main( int argc, char **argv )
+{
+    enum
+    {
+        OPT_PROTOCOL=1, OPT_LINK, OPT_RESPONSES, OPT_RESPONSE, OPT_LATENCY,
+        OPT_JITTER, OPT_SEQUENTIAL, OPT_BAUD, OPT_MAX_PAYLOAD, OPT_CRC_ERRORS,
+        OPT_RX_CRC_ERRORS, OPT_SEED, OPT_STATS, OPT_VERBOSE,
+    };
+    static const struct option options[]=
+    {
+        { "protocol",       required_argument, NULL, OPT_PROTOCOL },
+        { "link",           required_argument, NULL, OPT_LINK },
+        { "responses",      required_argument, NULL, OPT_RESPONSES },
+        { "response",       required_argument, NULL, OPT_RESPONSE },
+        { "latency",        required_argument, NULL, OPT_LATENCY },
+        { "jitter",         required_argument, NULL, OPT_JITTER },
+        { "sequential",     no_argument,       NULL, OPT_SEQUENTIAL },
+        { "baud",           required_argument, NULL, OPT_BAUD },
+        { "max-payload",    required_argument, NULL, OPT_MAX_PAYLOAD },
+        { "crc-errors",     required_argument, NULL, OPT_CRC_ERRORS },
+        { "rx-crc-errors",  required_argument, NULL, OPT_RX_CRC_ERRORS },
+        { "seed",           required_argument, NULL, OPT_SEED },
+        { "stats",          required_argument, NULL, OPT_STATS },
+        { "verbose",        no_argument,       NULL, OPT_VERBOSE },
+        { NULL, 0, NULL, 0 },
+    };
+
+    SDcSimulatorConfig config;
+    // per fid values, -1 is taken from the defaults
+    std::map<Glib::ustring, SDcSimulatorProfile> profiles;
+    int statsInterval=0;
+    int opt;
+
+    auto profile=[&]( const Glib::ustring &fid ) -> SDcSimulatorProfile &
+    {
+        if( fid.empty() )
+            return( config.defaults );
+
+        if( !profiles.count( fid ) )
+        {
+            profiles[fid].latency=-1;
+            profiles[fid].jitter=-1;
+        }
+        return( profiles[fid] );
+    };
+
+    setInternLogLevel( ELogLevelInfo );
+
+    while( ( opt=getopt_long( argc, argv, "", options, NULL ) ) != -1 )
+    {
+        Glib::ustring fid;
+        std::string value;
+
+        switch( opt )
+        {
+            case OPT_PROTOCOL:
+                if( !strcmp( optarg, "usb" ) )
+                    config.protocol=eDcSimulatorProtocolUsb;
+                else if( !strcmp( optarg, "framed" ) )
+                    config.protocol=eDcSimulatorProtocolFramed;
+                else
+                {
+                    usage( argv[0] );
+                    return( EXIT_FAILURE );
+                }
+                break;
+            case OPT_LINK:
+                config.link=optarg;
+                break;
+            case OPT_RESPONSES:
+                config.responseDir=optarg;
+                break;
+            case OPT_RESPONSE:
+                if( !splitFid( optarg, fid, value ) || fid.empty() )
+                {
+                    usage( argv[0] );
+                    return( EXIT_FAILURE );
+                }
+                profile( fid ).response=value;
+                break;
+            case OPT_LATENCY:
+            case OPT_JITTER:
+                if( !splitFid( optarg, fid, value ) )
+                {
+                    usage( argv[0] );
+                    return( EXIT_FAILURE );
+                }
+                if( opt == OPT_LATENCY )
+                    profile( fid ).latency=atoi( value.c_str() );
+                else
+                    profile( fid ).jitter=atoi( value.c_str() );
+                break;
+            case OPT_SEQUENTIAL:
+                config.sequential=true;
+                break;
+            case OPT_BAUD:
+                config.baud=atoi( optarg );
+                break;
+            case OPT_MAX_PAYLOAD:
+                config.maxPayloadSize=atoi( optarg );
+                break;
+            case OPT_CRC_ERRORS:
+                config.txCrcErrorRate=atof( optarg );
+                break;
+            case OPT_RX_CRC_ERRORS:
+                config.rxCrcErrorRate=atof( optarg );
+                break;
+            case OPT_SEED:
+                config.seed=strtoul( optarg, NULL, 10 );
+                break;
+            case OPT_STATS:
+                statsInterval=atoi( optarg );
+                break;
+            case OPT_VERBOSE:
+                setInternLogLevel( ELogLevelDebug );
+                break;
+            default:
+                usage( argv[0] );
+                return( EXIT_FAILURE );
+        }
+    }
+
+    for( auto &&entry : profiles )
+    {
+        if( entry.second.latency < 0 )
+            entry.second.latency=config.defaults.latency;
+        if( entry.second.jitter < 0 )
+            entry.second.jitter=config.defaults.jitter;
+    }
+    config.profiles=profiles;
+
+    Glib::init();
+
+    Glib::RefPtr<DcSimulator> sim;
+    try {
+        sim=DcSimulator::create( config );
+    } catch( const std::exception &ex ) {
+        std::cerr << ex.what() << std::endl;
+        return( EXIT_FAILURE );
+    }
+
+    std::cout << "pty " << sim->getSlaveName() << std::endl;
+
+    mainloop=Glib::MainLoop::create();
+
+    g_unix_signal_add( SIGINT, &onQuitSignal, NULL );
+    g_unix_signal_add( SIGTERM, &onQuitSignal, NULL );
+
+    if( statsInterval > 0 )
+    {
+        Glib::signal_timeout().connect_seconds( [sim]()
+        {
+            printStats( sim );
+            return( true );
+        }, statsInterval );
+    }
+
+    mainloop->run();
+
+    printStats( sim );
+
+    sim.reset();
+    mainloop.reset();
+
+    return( EXIT_SUCCESS );
+}
+
+
+//---fin----------------------------------------------------------------------
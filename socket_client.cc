@@ -14,6 +14,8 @@
 //---Includes------------------------------------------------------------------
 
 
+#include <giomm/unixsocketaddress.h>
+
 #include "socket_client.h"
 #include "socket_interface_connection.h"
 #include "gio_istream_adapter.h"
@@ -52,6 +54,32 @@ SocketClient::create (int port)
 }
 
 
+SocketClient::SocketClient( const Glib::ustring &address )
+    : Glib::ObjectBase (typeid (SocketClient))
+{
+    _client = Gio::SocketClient::create();
+    try
+    {
+        if( address.compare( 0, 5, "unix:" ) == 0 )
+            _connection = _client->connect(
+                    Gio::UnixSocketAddress::create( address.substr( 5 ) ) );
+        else
+            _connection = _client->connect_to_host( address, 17001 );
+    }
+    catch( const Glib::Error &ex )
+    {
+        throw std::logic_error( "Could not connect to " + address + ": " + ex.what() );
+    }
+}
+
+
+Glib::RefPtr <SocketClient>
+SocketClient::create ( const Glib::ustring &address )
+{
+    return Glib::RefPtr <SocketClient> (new SocketClient(address) );
+}
+
+
 SocketClient::~SocketClient()
 {
 }
@@ -46,6 +46,19 @@ class SocketClient : public Glib::Object
 
     static Glib::RefPtr <SocketClient> create ( int port );
 
+    /**
+     * Connect to "unix:PATH" or "HOST[:PORT]", port 17001 if missing.
+     * Nothing is printed, e.g. for the many connections of load_socket.
+     */
+    SocketClient ( const Glib::ustring &address );
+
+    static Glib::RefPtr <SocketClient> create ( const Glib::ustring &address );
+
+    Glib::RefPtr<Gio::SocketConnection> getConnection()
+    {
+        return( _connection );
+    }
+
     virtual ~SocketClient();
 
     int sendRequest(const Glib::ustring &request, Glib::RefPtr<XmlResult> &result);
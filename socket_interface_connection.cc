@@ -1,36 +1,234 @@
 
+#include <algorithm>
+
+#include <arpa/inet.h>
+
+#include <libxml++/parsers/domparser.h>
+
 #include "socket_interface_connection.h"
 #include "procedure_step_handler.h"
 
 #include "byteslist_istream.h"
+#include "task_envelope.h"
+#include "xml_result_ok.h"
+#include "xml_result_not_found.h"
+#include "xml_result_bad_request.h"
+#include "utils.h"
+
+/**
+ * Length prefix of a reply frame.
+ */
+static std::string
+frame_header (std::size_t xml_size, std::size_t attachment_size)
+{
+    guint32 header[2] = { htonl (xml_size), htonl (attachment_size) };
+
+    return std::string (reinterpret_cast <const char *> (header), sizeof (header));
+}
 
-SocketInterfaceConnection::SocketInterfaceConnection (const Glib::RefPtr <Gio::SocketConnection> & connection)
+SocketInterfaceConnection::SocketInterfaceConnection (const Glib::RefPtr <Gio::SocketConnection> & connection,
+						      const Glib::ustring & interface,
+						      std::size_t write_buffer_max)
     : InterfaceConnection (ZIX_PROC_RESULT_FILE)
     , _connection (connection)
+    , _write_stats (SocketWriteStats::get (interface))
+    , _eof (false)
+    , _closed (false)
+    , _negotiable (true)
+    , _length_prefixed (false)
 {
     auto input_stream = connection->get_input_stream();
 
     _adapter = GioIstreamAdapter::create (input_stream);
     _adapter->stream_read.connect (sigc::mem_fun (*this, &SocketInterfaceConnection::stream_complete));
+    _adapter->frame_read.connect (sigc::mem_fun (*this, &SocketInterfaceConnection::frame_complete));
+    _adapter->frame_invalid.connect (sigc::mem_fun (*this, &SocketInterfaceConnection::frame_invalid));
     _adapter->stream_eof.connect (sigc::mem_fun (*this, &SocketInterfaceConnection::stream_eof));
+
+    _write_queue = SocketWriteQueue::create (connection->get_output_stream (), write_buffer_max, _write_stats);
+    _write_queue->errored.connect (sigc::mem_fun (*this, &SocketInterfaceConnection::write_failed));
+    _write_queue->drained.connect (sigc::mem_fun (*this, &SocketInterfaceConnection::write_drained));
 }
 
 SocketInterfaceConnection::~SocketInterfaceConnection ()
-{ }
+{
+    _write_queue->cancel ();
+}
 
 void
 SocketInterfaceConnection::emit_result (const Glib::ustring & result, int tid)
 {
-    (void) tid;
+    if (_closed)
+	return;
+
+    bool pushed;
+
+    if (_length_prefixed) {
+	std::string head, tail;
+
+	if (untag (tid)) {
+	    head = Glib::ustring::compose ("<task tid=\"%1\">", tid).raw ();
+	    tail = "</task>";
+	}
+
+	std::string reply = frame_header (head.size () + result.bytes () + tail.size (), 0);
+	reply.reserve (reply.size () + head.size () + result.bytes () + tail.size ());
+	reply += head;
+	reply += result.raw ();
+	reply += tail;
+	pushed = _write_queue->push (reply.data (), reply.size ());
+    } else if (untag (tid)) {
+	std::string reply = Glib::ustring::compose ("<task tid=\"%1\">", tid).raw ();
+	reply.reserve (reply.size () + result.bytes () + 8);
+	reply += result.raw ();
+	reply += "</task>";
+	pushed = _write_queue->push (reply.data (), reply.size () + 1);
+    } else {
+	/* the terminating NUL of the string data is the end of the reply
+	 */
+	pushed = _write_queue->push (result.data (), result.bytes () + 1);
+    }
+
+    if (!pushed)
+	write_overflow ();
+}
+
+void
+SocketInterfaceConnection::emit_result_buffer (const SharedBuffer & result, int tid)
+{
+    if (_closed)
+	return;
+
+    SharedBuffer reply;
+    std::string head, tail;
+
+    if (untag (tid)) {
+	head = Glib::ustring::compose ("<task tid=\"%1\">", tid).raw ();
+	tail = "</task>";
+    }
+
+    if (_length_prefixed) {
+	head = frame_header (head.size () + result.size () + tail.size (), 0) + head;
+    } else {
+	/* the terminating NUL is the end of the reply
+	 */
+	tail.push_back ('\0');
+    }
+
+    /* the result segments are queued as they are
+     */
+    reply.append (std::move (head));
+    reply.append (result);
+    reply.append (std::move (tail));
+
+    if (!_write_queue->push (reply))
+	write_overflow ();
+}
+
+void
+SocketInterfaceConnection::emit_result_stream (const Glib::RefPtr <XmlResultStream> & result, int tid)
+{
+    if (_closed)
+	return;
+
+    /* the reply is encoded piece by piece, whenever the previous piece
+     * has been written
+     */
+    const XmlResultStream & stream = *result.operator-> ();
+    auto cursor = std::make_shared <XmlResultStream::Cursor> (stream);
+    std::string head, tail;
+    bool started = false, terminated = false;
+    bool attachments = _length_prefixed;
+
+    if (untag (tid)) {
+	head = Glib::ustring::compose ("<task tid=\"%1\">", tid).raw ();
+	tail = "</task>";
+    }
+
+    if (_length_prefixed) {
+	std::size_t xml_size = head.size () + stream.xml_size () + tail.size ();
+
+	if (xml_size > G_MAXUINT32 || stream.attachment_size () > G_MAXUINT32) {
+	    emit_result (XmlResultNotFound::create ("Reply exceeds maximum frame size")->to_xml (), 0);
+	    return;
+	}
+	head = frame_header (xml_size, stream.attachment_size ()) + head;
+    } else {
+	tail.push_back ('\0');
+    }
+
+    auto producer = [result, cursor, head, tail, started, terminated, attachments] (std::string & piece) mutable {
+	if (!started) {
+	    started = true;
+	    if (!head.empty ()) {
+		piece = head;
+		return true;
+	    }
+	}
+	if (cursor->next (piece))
+	    return true;
+	if (!terminated) {
+	    terminated = true;
+	    if (!tail.empty ()) {
+		piece = tail;
+		return true;
+	    }
+	}
+	return attachments && cursor->next_attachment (piece);
+    };
+
+    try {
+	if (!_write_queue->push (producer))
+	    write_overflow ();
+    } catch (const std::exception & e) {
+	PRINT_ERROR ("SocketInterfaceConnection::emit_result_stream() failed: " << e.what ());
+	emit_result (XmlResultNotFound::create (e.what ())->to_xml (), tid);
+    }
+}
+
+void
+SocketInterfaceConnection::write_overflow ()
+{
+    PRINT_WARNING ("SocketInterfaceConnection: client does not read its replies, "
+		   << _write_queue->buffered_bytes () << " bytes queued, closing connection");
+
+    _write_stats->disconnected ();
+    close_connection ();
+}
+
+void
+SocketInterfaceConnection::write_failed (const Glib::ustring & msg)
+{
+    PRINT_WARNING ("SocketInterfaceConnection: writing reply failed: " << msg);
+
+    close_connection ();
+}
+
+void
+SocketInterfaceConnection::write_drained ()
+{
+    /* the client closed its side, but waited for the pending replies
+     */
+    if (_eof)
+	close_connection ();
+}
+
+void
+SocketInterfaceConnection::close_connection ()
+{
+    if (_closed)
+	return;
+    _closed = true;
+
+    _write_queue->cancel ();
 
-    auto output_stream = _connection->get_output_stream ();
+    try {
+	_connection->get_socket ()->close ();
+    } catch (const Glib::Error & e) {
+	PRINT_DEBUG ("SocketInterfaceConnection: close failed: " << e.what ());
+    }
 
-    char c = '\0';
-    Glib::ustring::size_type written = 0;
-    while (written < result.length())
-        written += output_stream->write (result.substr(written));
-    output_stream->write (&c, 1);
-    output_stream->flush ();
+    connection_closed.emit();
 }
 
 void
@@ -40,14 +238,157 @@ SocketInterfaceConnection::cancel ()
 
 
 std::shared_ptr <InterfaceConnection>
-SocketInterfaceConnection::create (const Glib::RefPtr <Gio::SocketConnection> & connection)
+SocketInterfaceConnection::create (const Glib::RefPtr <Gio::SocketConnection> & connection,
+				   const Glib::ustring & interface,
+				   std::size_t write_buffer_max)
+{
+    return std::shared_ptr <InterfaceConnection> (new SocketInterfaceConnection (connection, interface, write_buffer_max));
+}
+
+void
+SocketInterfaceConnection::frame_invalid ()
 {
-    return std::shared_ptr <InterfaceConnection> (new SocketInterfaceConnection (connection));
+    PRINT_WARNING ("SocketInterfaceConnection: frame exceeds maximum size, closing connection");
+
+    auto result = XmlResultBadRequest::create ("Frame too large");
+    emit_result (result->to_xml (), 0);
+
+    stream_eof ();
 }
 
 void SocketInterfaceConnection::stream_eof()
 {
-    connection_closed.emit();
+    _eof = true;
+
+    if (!_write_queue->depth ())
+	close_connection ();
+}
+
+/**
+ * Copy up to len bytes starting at offset begin out of the bytes list.
+ */
+static std::string
+copy_bytes (const std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list, gsize begin, gsize len)
+{
+    std::string ret;
+    gsize pos = 0;
+
+    for (auto && bytes : bytes_list) {
+	gsize size;
+	auto data = static_cast <const char *> (bytes->get_data (size));
+
+	if (pos + size > begin && ret.size () < len) {
+	    gsize from = begin > pos ? begin - pos : 0;
+	    ret.append (data + from, std::min (size - from, len - ret.size ()));
+	}
+	pos += size;
+    }
+
+    return ret;
+}
+
+/**
+ * If the request is wrapped into <task tid="N">, replace bytes_list by the
+ * content of the task element and return N in tid, 0 if the tid attribute
+ * is missing or malformed.
+ *
+ * Only the first and last bytes are looked at, the request is parsed later
+ * by the XmlProcessor.
+ */
+static bool
+unwrap_task (std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list, int & tid)
+{
+    static const gsize MAX_TAG_SIZE = 256;
+    static const char whitespace[] = " \t\r\n";
+
+    gsize total = 0;
+    for (auto && bytes : bytes_list)
+	total += bytes->get_size ();
+
+    auto head = copy_bytes (bytes_list, 0, MAX_TAG_SIZE);
+    TaskEnvelope task;
+
+    if (!TaskEnvelope::scan_start_tag (head.data (), head.size (), task))
+	return false;
+
+    gsize tail_begin = total > MAX_TAG_SIZE ? total - MAX_TAG_SIZE : 0;
+    auto tail = copy_bytes (bytes_list, tail_begin, MAX_TAG_SIZE);
+    auto end = tail.find_last_not_of (whitespace);
+
+    if (end == std::string::npos || end < 6 || tail.compare (end - 6, 7, "</task>") != 0)
+	return false;
+
+    gsize content_end = tail_begin + end - 6;
+    if (content_end < task.offset)
+	return false;
+
+    tid = task.tid;
+    bytes_list = GioIstreamAdapter::slice (bytes_list, task.offset, content_end);
+    return true;
+}
+
+bool
+SocketInterfaceConnection::untag (int tid)
+{
+    return tid > 0 && _tagged_tids.erase (tid);
+}
+
+/**
+ * Handle <framing mode="..."/>, if it is the request.
+ *
+ * @return false, if bytes_list is some other request
+ */
+bool
+SocketInterfaceConnection::negotiate_framing (const std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list)
+{
+    static const gsize MAX_FRAMING_SIZE = 256;
+
+    gsize total = 0;
+    for (auto && bytes : bytes_list)
+	total += bytes->get_size ();
+
+    if (total > MAX_FRAMING_SIZE)
+	return false;
+
+    auto text = copy_bytes (bytes_list, 0, total);
+    auto start = text.find_first_not_of (" \t\r\n");
+
+    if (start == std::string::npos || text.compare (start, 8, "<framing") != 0)
+	return false;
+
+    Glib::ustring mode;
+
+    try {
+	xmlpp::DomParser parser;
+
+	parser.parse_memory (text);
+
+	auto root = parser.get_document ()->get_root_node ();
+	if (root->get_name () != "framing")
+	    return false;
+	mode = root->get_attribute_value ("mode");
+    } catch (const std::exception & e) {
+	emit_result (XmlResultBadRequest::create (e.what ())->to_xml (), 0);
+	return true;
+    }
+
+    if (mode != "length" && mode != "nul") {
+	emit_result (XmlResultBadRequest::create ("Unknown framing mode " + mode)->to_xml (), 0);
+	return true;
+    }
+
+    /* the reply still uses the old framing
+     */
+    emit_result (XmlResultOk::create ()->to_xml (), 0);
+
+    if (mode == "length") {
+	PRINT_DEBUG ("SocketInterfaceConnection: switching to length prefixed framing");
+	_length_prefixed = true;
+	_supports_attachments = true;
+	_adapter->set_length_prefixed ();
+    }
+
+    return true;
 }
 
 void
@@ -56,9 +397,46 @@ SocketInterfaceConnection::stream_complete (std::list <Glib::RefPtr <Glib::Bytes
     if (bytes_list.size () == 0)
 	return;
 
+    if (_negotiable) {
+	_negotiable = false;
+	if (negotiate_framing (bytes_list))
+	    return;
+    }
+
+    handle_request (bytes_list);
+}
+
+void
+SocketInterfaceConnection::frame_complete (std::list <Glib::RefPtr <Glib::Bytes> > bytes_list,
+					   Glib::RefPtr <Glib::Bytes> attachment)
+{
+    if (bytes_list.size () == 0)
+	return;
+
+    /* picked up by the XmlRequest while request_ready is emitted
+     */
+    _attachment = attachment;
+    handle_request (bytes_list);
+    _attachment.reset ();
+}
+
+void
+SocketInterfaceConnection::handle_request (std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list)
+{
+    int tid = 0;
+
+    if (unwrap_task (bytes_list, tid)) {
+	if (tid <= 0 || _tagged_tids.count (tid)) {
+	    auto result = XmlResultBadRequest::create ("Invalid or duplicate task tid");
+	    emit_result (result->to_xml (), 0);
+	    return;
+	}
+	_tagged_tids.insert (tid);
+    }
+
     BytesListIStream is_buf (bytes_list);
     std::istream is (&is_buf);
 
-    request_ready.emit (is, 0);
+    request_ready.emit (is, tid);
 }
 
@@ -7,26 +7,69 @@
 #include <glibmm/ustring.h>
 
 #include <memory>
+#include <set>
 
 #include "interface_connection.h"
 #include "gio_istream_adapter.h"
+#include "socket_write_queue.h"
 
+/**
+ * \brief Connection of a socket interface
+ *
+ * Requests and replies are NUL terminated. A client may have several
+ * requests outstanding: if a request is wrapped in <task tid="N">...</task>
+ * (N > 0, like on the serial interfaces), its reply is wrapped the same
+ * way and may arrive out of order. Untagged requests are answered with
+ * plain replies.
+ *
+ * If the first request of a connection is <framing mode="length"/>, it is
+ * answered with an ok reply and all following requests and replies are
+ * length prefixed instead: two 32 bit sizes in network byte order, the
+ * xml and an optional binary attachment section of the given sizes. Files
+ * in the attachment are referred to with <attachment offset="..."
+ * size="..."/> elements, offsets relative to the start of the attachment.
+ */
 class SocketInterfaceConnection : public InterfaceConnection
 {
     public:
-	SocketInterfaceConnection (const Glib::RefPtr <Gio::SocketConnection> & connection);
+	SocketInterfaceConnection (const Glib::RefPtr <Gio::SocketConnection> & connection,
+				   const Glib::ustring & interface,
+				   std::size_t write_buffer_max);
 	~SocketInterfaceConnection ();
 
-	static std::shared_ptr <InterfaceConnection> create (const Glib::RefPtr <Gio::SocketConnection> & connection);
+	static std::shared_ptr <InterfaceConnection> create (const Glib::RefPtr <Gio::SocketConnection> & connection,
+							     const Glib::ustring & interface,
+							     std::size_t write_buffer_max = SocketWriteQueue::DEFAULT_MAX_BUFFERED);
 
 	void emit_result (const Glib::ustring & result, int tid);
+	void emit_result_stream (const Glib::RefPtr <XmlResultStream> & result, int tid);
+	void emit_result_buffer (const SharedBuffer & result, int tid);
 	void cancel ();
 
     private:
 	Glib::RefPtr <Gio::SocketConnection> _connection;
 	Glib::RefPtr <GioIstreamAdapter> _adapter;
+	Glib::RefPtr <SocketWriteQueue> _write_queue;
+	SocketWriteStats::RefPtr _write_stats;
+	bool _eof;
+	bool _closed;
+	bool _negotiable;
+	bool _length_prefixed;
+	std::set <int> _tagged_tids;
 
 	void stream_complete (std::list <Glib::RefPtr <Glib::Bytes> > bytes_list);
+	void frame_complete (std::list <Glib::RefPtr <Glib::Bytes> > bytes_list,
+			     Glib::RefPtr <Glib::Bytes> attachment);
+	void frame_invalid ();
     void stream_eof();
+
+	bool negotiate_framing (const std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list);
+	void handle_request (std::list <Glib::RefPtr <Glib::Bytes> > & bytes_list);
+
+	bool untag (int tid);
+	void write_overflow ();
+	void write_failed (const Glib::ustring & msg);
+	void write_drained ();
+	void close_connection ();
 };
 #endif
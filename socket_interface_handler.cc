@@ -3,12 +3,14 @@
 #include "socket_interface_connection.h"
 #include "byteslist_istream.h"
 #include "hexio.h"
+#include "conf_handler.h"
 #include "utils.h"
 
 SocketInterfaceHandler::SocketInterfaceHandler(
     ZixInterface inf, int port, Glib::RefPtr <XmlProcessor> xml_processor)
     : Glib::ObjectBase (typeid (SocketInterfaceHandler))
     , InterfaceHandler (inf, inf.to_string(), xml_processor)
+    , _write_buffer_max (ConfHandler::get_instance()->getSocketWriteBufferMax())
 {
     try {
         Glib::RefPtr<Gio::SocketAddress> effective_addr;
@@ -43,7 +45,7 @@ SocketInterfaceHandler::incoming_connection (
 {
     (void) source_object;
 
-    auto iface_connection = SocketInterfaceConnection::create (connection);
+    auto iface_connection = SocketInterfaceConnection::create (connection, _name, _write_buffer_max);
     register_connection (iface_connection);
 
     iface_connection->connection_closed.connect(
@@ -42,6 +42,7 @@ private:
     Glib::RefPtr<Gio::SocketService> _service;
     Glib::RefPtr<Gio::InetSocketAddress> _socket_addr;
     Glib::RefPtr<Gio::InetAddress> _inet_addr;
+    std::size_t _write_buffer_max;
 
     bool incoming_connection (const Glib::RefPtr<Gio::SocketConnection>& connection,
                               const Glib::RefPtr<Glib::Object>& source_object);
@@ -0,0 +1,240 @@
+#include <giomm/error.h>
+
+#include "socket_write_queue.h"
+#include "utils.h"
+
+const std::size_t SocketWriteQueue::DEFAULT_MAX_BUFFERED;
+const std::size_t SocketWriteQueue::MERGE_SIZE;
+
+SocketWriteQueue::SocketWriteQueue(const Glib::RefPtr<Gio::OutputStream>& stream,
+                                   std::size_t max_buffered,
+                                   const SocketWriteStats::RefPtr& stats) :
+    _stream{stream},
+    _cancellable{Gio::Cancellable::create()},
+    _stats{stats},
+    _max_buffered{max_buffered},
+    _buffered{0},
+    _writing{false}
+{}
+
+SocketWriteQueue::~SocketWriteQueue()
+{
+    cancel();
+}
+
+Glib::RefPtr<SocketWriteQueue> SocketWriteQueue::create(const Glib::RefPtr<Gio::OutputStream>& stream,
+                                                        std::size_t max_buffered,
+                                                        const SocketWriteStats::RefPtr& stats)
+{
+    return Glib::RefPtr<SocketWriteQueue>(new SocketWriteQueue(stream, max_buffered, stats));
+}
+
+bool SocketWriteQueue::accept(std::size_t len) const
+{
+    if (_cancellable->is_cancelled())
+        return false;
+
+    return _entries.empty() || _buffered + len <= _max_buffered;
+}
+
+void SocketWriteQueue::enqueue(Entry& entry, const std::string& data)
+{
+    entry.bytes = Glib::Bytes::create(data.data(), data.size());
+    _buffered += data.size();
+    _stats->queued(data.size());
+}
+
+bool SocketWriteQueue::push(const char *data, std::size_t len)
+{
+    if (!accept(len))
+        return false;
+
+    Entry entry;
+    entry.bytes  = Glib::Bytes::create(data, len);
+    entry.queued = std::chrono::steady_clock::now();
+
+    _buffered += len;
+    _stats->queued(len);
+    _entries.push_back(entry);
+
+    start_write();
+    return true;
+}
+
+bool SocketWriteQueue::push(const SharedBuffer& buffer)
+{
+    if (buffer.empty())
+        return true;
+
+    if (!accept(buffer.size()))
+        return false;
+
+    Entry entry;
+    std::string small;
+
+    entry.queued = std::chrono::steady_clock::now();
+
+    for (auto&& segment : buffer.segments()) {
+        gsize size = 0;
+        auto data = static_cast<const char *>(segment->get_data(size));
+
+        if (size < MERGE_SIZE) {
+            small.append(data, size);
+            continue;
+        }
+
+        if (!small.empty()) {
+            entry.segments.push_back(Glib::Bytes::create(small.data(), small.size()));
+            small.clear();
+        }
+        entry.segments.push_back(segment);
+    }
+    if (!small.empty())
+        entry.segments.push_back(Glib::Bytes::create(small.data(), small.size()));
+
+    entry.bytes = entry.segments.front();
+    entry.segments.pop_front();
+
+    _buffered += buffer.size();
+    _stats->queued(buffer.size());
+    _entries.push_back(entry);
+
+    start_write();
+    return true;
+}
+
+bool SocketWriteQueue::push(const Producer& producer)
+{
+    std::string piece;
+    Entry entry;
+
+    entry.queued = std::chrono::steady_clock::now();
+    entry.producer = producer;
+
+    // skip empty pieces, the first one decides about the limit
+    while (piece.empty())
+        if (!entry.producer(piece))
+            return true;
+
+    if (!accept(piece.size()))
+        return false;
+
+    enqueue(entry, piece);
+    _entries.push_back(entry);
+
+    start_write();
+    return true;
+}
+
+std::size_t SocketWriteQueue::buffered_bytes() const
+{
+    return _buffered;
+}
+
+std::size_t SocketWriteQueue::depth() const
+{
+    return _entries.size();
+}
+
+void SocketWriteQueue::cancel()
+{
+    _cancellable->cancel();
+
+    _stats->dequeued(_buffered);
+    _buffered = 0;
+    _entries.clear();
+}
+
+void SocketWriteQueue::start_write()
+{
+    if (_writing || _entries.empty())
+        return;
+
+    _writing = true;
+    _stream->write_bytes_async(_entries.front().bytes,
+                               sigc::mem_fun(*this, &SocketWriteQueue::on_written),
+                               _cancellable);
+}
+
+void SocketWriteQueue::fail(const Glib::ustring& msg)
+{
+    _stats->dequeued(_buffered);
+    _buffered = 0;
+    _entries.clear();
+
+    // might destroy this queue
+    errored.emit(msg);
+}
+
+void SocketWriteQueue::on_written(Glib::RefPtr<Gio::AsyncResult>& result)
+{
+    gssize written = 0;
+
+    _writing = false;
+
+    try {
+        written = _stream->write_bytes_finish(result);
+    } catch (const Gio::Error& ex) {
+        if (ex.code() != Gio::Error::CANCELLED)
+            fail(ex.what());
+        return;
+    } catch (const Glib::Error& ex) {
+        fail(ex.what());
+        return;
+    }
+
+    // cancelled after the write completed
+    if (_entries.empty())
+        return;
+
+    auto& entry = _entries.front();
+    gsize size = entry.bytes->get_size();
+
+    _buffered -= written;
+    _stats->dequeued(written);
+
+    if (static_cast<gsize>(written) < size) {
+        // short write, continue with the rest
+        entry.bytes = Glib::wrap(g_bytes_new_from_bytes(entry.bytes->gobj(), written, size - written));
+        start_write();
+        return;
+    }
+
+    if (!entry.segments.empty()) {
+        entry.bytes = entry.segments.front();
+        entry.segments.pop_front();
+        start_write();
+        return;
+    }
+
+    if (entry.producer) {
+        std::string piece;
+        bool more;
+
+        try {
+            while ((more = entry.producer(piece)) && piece.empty())
+                ;
+        } catch (const std::exception& ex) {
+            fail(ex.what());
+            return;
+        }
+
+        if (more) {
+            enqueue(entry, piece);
+            start_write();
+            return;
+        }
+    }
+
+    std::chrono::duration<double, std::milli> latency =
+        std::chrono::steady_clock::now() - entry.queued;
+    _stats->reply_written(latency.count());
+    _entries.pop_front();
+
+    if (_entries.empty()) {
+        drained.emit();
+        return;
+    }
+
+    start_write();
+}
@@ -0,0 +1,137 @@
+#ifndef _SOCKET_WRITE_QUEUE_H_
+#define _SOCKET_WRITE_QUEUE_H_
+
+#include <deque>
+#include <string>
+#include <chrono>
+#include <functional>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+#include <glibmm/bytes.h>
+#include <giomm/outputstream.h>
+#include <giomm/cancellable.h>
+#include <giomm/asyncresult.h>
+
+#include <sigc++/signal.h>
+
+#include "socket_write_stats.h"
+#include "shared_buffer.h"
+
+/**
+ * \brief Writes replies to a socket without blocking the main loop
+ *
+ * Queued data is written with write_bytes_async, one write at a time.
+ * The number of buffered bytes per queue is limited, so a client which
+ * does not read its replies can not make the daemon buffer without bound.
+ * Large replies can be queued as a producer, which is asked for the next
+ * piece only after the previous one has been written.
+ *
+ * Example of usage:
+ *   auto queue = SocketWriteQueue::create(output_stream, max, stats);
+ *   queue->errored.connect(sigc::ptr_fun(&foobar));
+ *   if (!queue->push(data, len))
+ *       // client too slow
+ */
+class SocketWriteQueue : public Glib::Object
+{
+public:
+    /**
+     * Replaces its argument with the next piece of data, returns false
+     * when there is no more data.
+     */
+    using Producer = std::function<bool (std::string&)>;
+
+    static const std::size_t DEFAULT_MAX_BUFFERED = 64 * 1024 * 1024;
+
+    /**
+     * Adjacent buffer segments smaller than this are merged into one write.
+     */
+    static const std::size_t MERGE_SIZE = 4 * 1024;
+
+    SocketWriteQueue(const Glib::RefPtr<Gio::OutputStream>& stream,
+                     std::size_t max_buffered, const SocketWriteStats::RefPtr& stats);
+
+    ~SocketWriteQueue();
+
+    static Glib::RefPtr<SocketWriteQueue> create(const Glib::RefPtr<Gio::OutputStream>& stream,
+                                                 std::size_t max_buffered,
+                                                 const SocketWriteStats::RefPtr& stats);
+
+    /**
+     * Queue a copy of data. A reply is always accepted by an empty queue.
+     *
+     * @return false, if the buffered bytes would exceed the limit,
+     *         nothing is queued then
+     */
+    bool push(const char *data, std::size_t len);
+
+    /**
+     * Queue the segments of buffer without copying them, only small
+     * segments are merged.
+     *
+     * @return false, if the buffered bytes would exceed the limit,
+     *         nothing is queued then
+     */
+    bool push(const SharedBuffer& buffer);
+
+    /**
+     * Queue a reply produced piece by piece. Only the current piece is
+     * buffered. Throws, if the producer fails on the first piece.
+     *
+     * @return false, if the buffered bytes would exceed the limit
+     */
+    bool push(const Producer& producer);
+
+    /**
+     * Bytes waiting to be written.
+     */
+    std::size_t buffered_bytes() const;
+
+    /**
+     * Number of replies waiting to be written.
+     */
+    std::size_t depth() const;
+
+    /**
+     * Cancel the pending write and drop all queued data. Nothing can be
+     * queued afterwards.
+     */
+    void cancel();
+
+    /**
+     * Emitted with an error message, if writing or producing data failed.
+     * The queue is empty then.
+     */
+    sigc::signal<void, const Glib::ustring&> errored;
+
+    /**
+     * Emitted when all queued data has been written.
+     */
+    sigc::signal<void> drained;
+
+private:
+    struct Entry
+    {
+        Glib::RefPtr<Glib::Bytes> bytes;
+        std::deque<Glib::RefPtr<Glib::Bytes> > segments;
+        Producer producer;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    Glib::RefPtr<Gio::OutputStream> _stream;
+    Glib::RefPtr<Gio::Cancellable> _cancellable;
+    SocketWriteStats::RefPtr _stats;
+    std::deque<Entry> _entries;
+    std::size_t _max_buffered;
+    std::size_t _buffered;
+    bool _writing;
+
+    bool accept(std::size_t len) const;
+    void enqueue(Entry& entry, const std::string& data);
+    void start_write();
+    void on_written(Glib::RefPtr<Gio::AsyncResult>& result);
+    void fail(const Glib::ustring& msg);
+};
+
+#endif /* _SOCKET_WRITE_QUEUE_H_ */
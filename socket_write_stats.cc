@@ -0,0 +1,63 @@
+#include <algorithm>
+
+#include "socket_write_stats.h"
+
+std::map<Glib::ustring, SocketWriteStats::RefPtr> SocketWriteStats::instances;
+
+SocketWriteStats::SocketWriteStats() :
+    _replies{0}, _latency_sum_ms{0}, _latency_max_ms{0},
+    _queued_bytes{0}, _queued_bytes_max{0}, _disconnects{0}
+{}
+
+SocketWriteStats::RefPtr SocketWriteStats::get(const Glib::ustring& name)
+{
+    auto& stats = instances[name];
+
+    if (!stats)
+        stats = RefPtr(new SocketWriteStats());
+
+    return stats;
+}
+
+void SocketWriteStats::reply_written(double latency_ms)
+{
+    ++_replies;
+    _latency_sum_ms += latency_ms;
+    _latency_max_ms = std::max(_latency_max_ms, latency_ms);
+}
+
+void SocketWriteStats::queued(std::size_t bytes)
+{
+    _queued_bytes += bytes;
+    _queued_bytes_max = std::max(_queued_bytes_max, _queued_bytes);
+}
+
+void SocketWriteStats::dequeued(std::size_t bytes)
+{
+    _queued_bytes -= std::min(_queued_bytes, bytes);
+}
+
+void SocketWriteStats::disconnected()
+{
+    ++_disconnects;
+}
+
+SocketWriteStats::Snapshot SocketWriteStats::take()
+{
+    Snapshot snapshot;
+
+    snapshot.replies          = _replies;
+    snapshot.latency_avg_ms   = _replies ? _latency_sum_ms / _replies : 0;
+    snapshot.latency_max_ms   = _latency_max_ms;
+    snapshot.queued_bytes     = _queued_bytes;
+    snapshot.queued_bytes_max = _queued_bytes_max;
+    snapshot.disconnects      = _disconnects;
+
+    _replies          = 0;
+    _latency_sum_ms   = 0;
+    _latency_max_ms   = 0;
+    _queued_bytes_max = _queued_bytes;
+    _disconnects      = 0;
+
+    return snapshot;
+}
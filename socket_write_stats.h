@@ -0,0 +1,63 @@
+#ifndef _SOCKET_WRITE_STATS_H_
+#define _SOCKET_WRITE_STATS_H_
+
+#include <map>
+#include <cstddef>
+
+#include <glibmm/object.h>
+#include <glibmm/refptr.h>
+#include <glibmm/ustring.h>
+
+/**
+ * \brief Reply write statistics of one socket interface
+ *
+ * Updated by the SocketWriteQueue of every connection of the interface,
+ * read out by MonitorSocketWrites. Main loop only.
+ */
+class SocketWriteStats : public Glib::Object
+{
+public:
+    using RefPtr = Glib::RefPtr<SocketWriteStats>;
+
+    /**
+     * Values since the last call to take().
+     */
+    struct Snapshot
+    {
+        std::size_t replies;
+        double latency_avg_ms;
+        double latency_max_ms;
+        std::size_t queued_bytes;
+        std::size_t queued_bytes_max;
+        std::size_t disconnects;
+    };
+
+    /**
+     * Statistics of interface name, created on first use.
+     */
+    static RefPtr get(const Glib::ustring& name);
+
+    void reply_written(double latency_ms);
+    void queued(std::size_t bytes);
+    void dequeued(std::size_t bytes);
+    void disconnected();
+
+    /**
+     * Return the values of the current interval and start a new one.
+     */
+    Snapshot take();
+
+private:
+    static std::map<Glib::ustring, RefPtr> instances;
+
+    std::size_t _replies;
+    double _latency_sum_ms;
+    double _latency_max_ms;
+    std::size_t _queued_bytes;
+    std::size_t _queued_bytes_max;
+    std::size_t _disconnects;
+
+    SocketWriteStats();
+};
+
+#endif /* _SOCKET_WRITE_STATS_H_ */
@@ -1,7 +1,10 @@
 
+#include <algorithm>
+
+#include <glibmm/main.h>
+
 #include "state_variable.h"
 
-#include "xml_query_set_parameter.h"
 #include "xml_query_replay_status.h"
 #include "utils.h"
 
@@ -15,6 +18,10 @@
 
 StateVariable * StateVariable::_master = 0;
 std::set <StateVariable *> StateVariable::_submitted;
+std::vector <StateVariable *> StateVariable::_scheduled;
+std::vector <StateVariable *> StateVariable::_in_flight;
+Glib::RefPtr <Query> StateVariable::_batch_query;
+bool StateVariable::_flush_scheduled = false;
 
 void
 StateVariable::set_master (StateVariable *master)
@@ -30,7 +37,10 @@ StateVariable::StateVariable (const Glib::ustring & name)
 { }
 
 StateVariable::~StateVariable ()
-{ }
+{
+    _scheduled.erase (std::remove (_scheduled.begin (), _scheduled.end (), this), _scheduled.end ());
+    _in_flight.erase (std::remove (_in_flight.begin (), _in_flight.end (), this), _in_flight.end ());
+}
 
 Glib::RefPtr <XmlQuery>
 StateVariable::create_replay_query ()
@@ -86,31 +96,13 @@ StateVariable::set_state (const Glib::ustring & state)
 
     _pending_state = state;
 
-    if (_state_query) {
-	/* there is currently a query in progress.
-	 * we already setup _pending_state,
-	 * so after that query is through, a new query will start.
-	 */
-	return;
-    }
-
-    /* no query in progress, we start one
-     */
-
-    _query_state = _pending_state;
-
-    auto dc = QueryClient::get_instance ();
-    auto xq = XmlQuerySetParameter::create (_name, _query_state);
-
-    _state_query = dc->create_query (xq);
-    _state_query->finished.connect (sigc::mem_fun (*this, & StateVariable::on_query_finish));
-    dc->execute(_state_query);
+    schedule ();
 }
 
 void
 StateVariable::set_state (const Glib::ustring & state, sigc::slot <void, Glib::RefPtr <XmlResult> > callback)
 {
-    if (_state_query) {
+    if (in_flight ()) {
 	/* there is already a query in progress, try to use _pending_callback
 	 */
 	if (_pending_callback) {
@@ -128,11 +120,116 @@ StateVariable::set_state (const Glib::ustring & state, sigc::slot <void, Glib::R
 	}
     }
 
-    _query_done_connection = _query_done.connect (callback);
+    _query_done.connect (callback);
 
     set_state (state);
 }
 
+bool
+StateVariable::in_flight () const
+{
+    return std::find (_in_flight.begin (), _in_flight.end (), this) != _in_flight.end ();
+}
+
+void
+StateVariable::schedule ()
+{
+    if (in_flight ()) {
+	/* we already setup _pending_state,
+	 * so after that query is through, we are scheduled again.
+	 */
+	return;
+    }
+
+    if (std::find (_scheduled.begin (), _scheduled.end (), this) == _scheduled.end ())
+	_scheduled.push_back (this);
+
+    start_flush ();
+}
+
+void
+StateVariable::start_flush ()
+{
+    /* while a query is in progress, changes are collected
+     * and sent, when it is through.
+     */
+    if (_flush_scheduled || _batch_query || _scheduled.empty ())
+	return;
+
+    /* collect the changes of monitors firing together,
+     * e.g. the network going down
+     */
+    _flush_scheduled = true;
+    Glib::signal_timeout ().connect_once (sigc::ptr_fun (& StateVariable::on_flush), COALESCE_MS);
+}
+
+void
+StateVariable::on_flush ()
+{
+    _flush_scheduled = false;
+
+    if (_batch_query || _scheduled.empty ())
+	return;
+
+    /* the master is sent last, like in create_replay_query ()
+     */
+    _in_flight.swap (_scheduled);
+    std::stable_partition (_in_flight.begin (), _in_flight.end (),
+			   [] (StateVariable *var) { return var != StateVariable::_master; });
+
+    std::vector <Glib::ustring> ids;
+    std::vector <Glib::ustring> values;
+
+    for (StateVariable * var : _in_flight) {
+	var->_query_state = var->_pending_state;
+
+	if (var->_pending_callback) {
+	    var->_query_done.connect (var->_pending_callback);
+	    var->_pending_callback = sigc::slot <void, Glib::RefPtr <XmlResult> > ();
+	}
+
+	ids.push_back (var->_name);
+	values.push_back (var->_query_state);
+    }
+
+    PRINT_DEBUG ("StateVariable: sending " << ids.size () << " states");
+
+    auto dc = QueryClient::get_instance ();
+    auto xq = XmlQueryReplayStatus::create (ids, values);
+
+    _batch_query = dc->create_query (xq);
+    _batch_query->finished.connect (sigc::ptr_fun (& StateVariable::on_batch_finish));
+    dc->execute(_batch_query);
+}
+
+void
+StateVariable::on_batch_finish (const Glib::RefPtr <XmlResult> & result)
+{
+    /* reset before the callbacks, they may set states again
+     */
+    std::vector <StateVariable *> finished;
+
+    finished.swap (_in_flight);
+    _batch_query.reset ();
+
+    for (StateVariable * var : finished)
+	var->on_query_finish (result);
+
+    start_flush ();
+}
+
+void
+StateVariable::emit_query_done (const Glib::RefPtr <XmlResult> & result)
+{
+    /* disconnect the callbacks before calling them,
+     * they may connect a new one with set_state ()
+     */
+    auto done = _query_done;
+
+    _query_done = sigc::signal <void, Glib::RefPtr <XmlResult> > ();
+    done.emit (result);
+}
+
 void
 StateVariable::on_query_finish (const Glib::RefPtr <XmlResult> & result)
 {
@@ -141,20 +238,14 @@ StateVariable::on_query_finish (const Glib::RefPtr <XmlResult> & result)
      */
 
     if (result->get_status () != 200) {
-	if (_query_done_connection.connected ()) {
-	    /* emit the error to the callback
-	     */
-	    _query_done.emit (result);
-	    _query_done_connection.disconnect ();
-	}
+	/* emit the error to the callback
+	 */
+	emit_query_done (result);
+
 	/* on error, we only report/log it
 	 */
 	PRINT_ERROR ("Error setting StateVar result: " << result->to_xml());
 
-	/* before exiting we reset _state_query
-	*/
-	_state_query.reset ();
-
 	return;
     }
 
@@ -164,34 +255,14 @@ StateVariable::on_query_finish (const Glib::RefPtr <XmlResult> & result)
     _current_state = _query_state;
 
     /* now call the callback, if needed
-     * and disconnect afterwards
      */
-    if (_query_done_connection.connected ()) {
-	_query_done.emit (result);
-	_query_done_connection.disconnect ();
-    }
-
-    /* callbacks emitted, we can now assume that we dont recurse
-     */
-    _state_query.reset ();
+    emit_query_done (result);
 
     if (_pending_state != _current_state) {
 	/* when there is a pending state change,
-	 * we start it now
+	 * it goes into the next query
 	 */
-
-	_query_state = _pending_state;
-
-	auto dc = QueryClient::get_instance ();
-	auto xq = XmlQuerySetParameter::create (_name, _query_state);
-
-	if (_pending_callback) {
-	    _query_done_connection = _query_done.connect (_pending_callback);
-	}
-
-	_state_query = dc->create_query (xq);
-	_state_query->finished.connect (sigc::mem_fun (*this, & StateVariable::on_query_finish));
-	dc->execute(_state_query);
+	schedule ();
     }
 
     if (this != StateVariable::_master) {
@@ -2,6 +2,7 @@
 #define STATE_VARIABLE_H
 
 #include <set>
+#include <vector>
 
 #include <glibmm/ustring.h>
 #include <glibmm/refptr.h>
@@ -9,9 +10,20 @@
 #include "xml_result.h"
 #include "query_client.h"
 
+/**
+ * \brief Status parameter of zix, mirrored to the DC
+ *
+ * Changes of all StateVariables within COALESCE_MS are sent to the DC
+ * with one XmlQueryReplayStatus, carrying the latest value of every
+ * changed variable. While that query runs, further changes are collected
+ * for the next one. A callback passed to set_state() is called with the
+ * result of the query, which carries that state.
+ */
 class StateVariable
 {
     public:
+	static const unsigned COALESCE_MS = 50;
+
 	StateVariable (const Glib::ustring & name);
 	~StateVariable ();
 
@@ -25,6 +37,13 @@ class StateVariable
 	static std::set <StateVariable *> _submitted;
 	static StateVariable *_master;
 
+	// changed since the last query, in order of the change
+	static std::vector <StateVariable *> _scheduled;
+	// part of _batch_query
+	static std::vector <StateVariable *> _in_flight;
+	static Glib::RefPtr <Query> _batch_query;
+	static bool _flush_scheduled;
+
 	Glib::ustring _name;
 	Glib::ustring _current_state;
 	Glib::ustring _query_state;
@@ -33,11 +52,15 @@ class StateVariable
 	sigc::slot <void, Glib::RefPtr <XmlResult> > _pending_callback;
 
 	sigc::signal <void, Glib::RefPtr <XmlResult> > _query_done;
-	sigc::connection _query_done_connection;
-
-	Glib::RefPtr <Query> _state_query;
 
+	bool in_flight () const;
+	void schedule ();
+	void emit_query_done (const Glib::RefPtr <XmlResult> & result);
 	void on_query_finish (const Glib::RefPtr <XmlResult> & result);
+
+	static void start_flush ();
+	static void on_flush ();
+	static void on_batch_finish (const Glib::RefPtr <XmlResult> & result);
 };
 
 #endif
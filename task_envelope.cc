@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "task_envelope.h"
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_name_end(char c)
+{
+    return is_space(c) || c == '>' || c == '/' || c == '=';
+}
+
+static const char *skip_space(const char *p, const char *end)
+{
+    while (p < end && is_space(*p))
+        ++p;
+
+    return p;
+}
+
+static const char *skip_past(const char *p, const char *end, const char *pattern)
+{
+    const char *hit = std::search(p, end, pattern, pattern + strlen(pattern));
+
+    return hit == end ? end : hit + strlen(pattern);
+}
+
+static bool starts_with(const char *p, const char *end, const char *pattern)
+{
+    std::size_t len = strlen(pattern);
+
+    return std::size_t(end - p) >= len && memcmp(p, pattern, len) == 0;
+}
+
+/* whitespace, xml declaration and comments in front of an element
+ */
+static const char *skip_misc(const char *p, const char *end)
+{
+    for (;;) {
+        p = skip_space(p, end);
+        if (starts_with(p, end, "<?"))
+            p = skip_past(p, end, "?>");
+        else if (starts_with(p, end, "<!--"))
+            p = skip_past(p, end, "-->");
+        else
+            return p;
+    }
+}
+
+static const char *scan_name(const char *p, const char *end, std::string& name)
+{
+    const char *start = p;
+
+    while (p < end && !is_name_end(*p))
+        ++p;
+    name.assign(start, p - start);
+
+    return p;
+}
+
+/* decimal number > 0 which fits into an int, nothing else
+ */
+static bool parse_tid(const char *p, const char *end, int& tid)
+{
+    long long value = 0;
+
+    if (p == end)
+        return false;
+
+    for (; p < end; ++p) {
+        if (*p < '0' || *p > '9')
+            return false;
+        value = value * 10 + (*p - '0');
+        if (value > INT_MAX)
+            return false;
+    }
+    if (value == 0)
+        return false;
+
+    tid = static_cast<int>(value);
+    return true;
+}
+
+TaskEnvelope::TaskEnvelope() :
+    tid{0},
+    tid_valid{false},
+    kind{OTHER},
+    offset{0},
+    size{0}
+{}
+
+bool TaskEnvelope::scan_start_tag(const char *data, std::size_t size, TaskEnvelope& envelope)
+{
+    const char *end = data + size;
+    const char *p = skip_misc(data, end);
+    std::string name;
+    bool seen_tid = false;
+
+    envelope = TaskEnvelope();
+
+    if (!starts_with(p, end, "<"))
+        return false;
+    p = scan_name(p + 1, end, name);
+    if (name != "task")
+        return false;
+
+    for (;;) {
+        p = skip_space(p, end);
+        if (p == end || *p == '/')
+            return false;
+        if (*p == '>')
+            break;
+
+        p = scan_name(p, end, name);
+        if (name.empty())
+            return false;
+        p = skip_space(p, end);
+        if (p == end || *p != '=')
+            return false;
+        p = skip_space(p + 1, end);
+        if (p == end || (*p != '"' && *p != '\''))
+            return false;
+
+        const char *value = p + 1;
+        p = std::find(value, end, *p);
+        if (p == end)
+            return false;
+
+        // a second tid makes the first one meaningless
+        if (name == "tid") {
+            envelope.tid_valid = !seen_tid && parse_tid(value, p, envelope.tid);
+            if (!envelope.tid_valid)
+                envelope.tid = 0;
+            seen_tid = true;
+        }
+        ++p;
+    }
+
+    envelope.offset = p + 1 - data;
+
+    return true;
+}
+
+bool TaskEnvelope::scan(const char *data, std::size_t size, TaskEnvelope& envelope)
+{
+    const char *end = data + size;
+
+    if (!scan_start_tag(data, size, envelope))
+        return false;
+
+    // the wrapped element
+    const char *content = skip_misc(data + envelope.offset, end);
+    if (!starts_with(content, end, "<") || content + 1 == end || is_name_end(content[1]))
+        return false;
+    scan_name(content + 1, end, envelope.name);
+
+    // </task> has to close the message
+    static const char close_tag[] = "</task";
+    const char *close = std::find_end(content, end, close_tag, close_tag + strlen(close_tag));
+    if (close == end)
+        return false;
+    const char *p = skip_space(close + strlen(close_tag), end);
+    if (p == end || *p != '>')
+        return false;
+    p = skip_space(p + 1, end);
+    while (p < end && *p == '\0')
+        ++p;
+    if (p != end)
+        return false;
+
+    if (envelope.name == "function")
+        envelope.kind = FUNCTION;
+    else if (envelope.name == "reply")
+        envelope.kind = REPLY;
+    envelope.offset = content - data;
+    envelope.size = close - content;
+
+    return true;
+}
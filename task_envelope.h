@@ -0,0 +1,57 @@
+#ifndef _TASK_ENVELOPE_H_
+#define _TASK_ENVELOPE_H_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * \brief <task tid="N">...</task> wrapper of messages on the serial interfaces
+ *
+ * scan() reads the tid and the name of the wrapped element with a prefix
+ * scan of the message, without parsing it. The attributes of <task> are
+ * read like an xml parser would, so e.g. xtid="1" is no tid. The wrapped element is parsed
+ * once by whoever consumes it: the request by the XmlProcessor, the reply
+ * by XmlResultParsed.
+ *
+ * Example of usage:
+ *   TaskEnvelope task;
+ *   if (TaskEnvelope::scan(raw.data(), raw.size(), task) &&
+ *       task.kind == TaskEnvelope::REPLY)
+ *       parse(raw.data() + task.offset, task.size);
+ */
+class TaskEnvelope
+{
+public:
+    enum Kind {
+        FUNCTION,
+        REPLY,
+        OTHER
+    };
+
+    TaskEnvelope();
+
+    /**
+     * @return false if data is no <task> element wrapping an element.
+     *         A missing or malformed tid is 0.
+     */
+    static bool scan(const char *data, std::size_t size, TaskEnvelope& envelope);
+
+    /**
+     * Reads only the <task ...> start tag, offset is set behind it.
+     *
+     * @return false if data does not start with a complete <task> start tag
+     */
+    static bool scan_start_tag(const char *data, std::size_t size, TaskEnvelope& envelope);
+
+    int tid;
+    // tid is a single attribute holding a decimal number > 0
+    bool tid_valid;
+    Kind kind;
+    // name of the wrapped element
+    std::string name;
+    // the wrapped element, up to the closing </task>
+    std::size_t offset;
+    std::size_t size;
+};
+
+#endif /* _TASK_ENVELOPE_H_ */
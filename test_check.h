@@ -0,0 +1,49 @@
+#ifndef _TEST_CHECK_H_
+#define _TEST_CHECK_H_
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "utils.h"
+
+/**
+ * Checks for the test executables: check() logs and counts a failed
+ * condition and the test goes on, main() returns check_result().
+ *
+ * Example of usage:
+ *   check(reply == expected, "reply to the first request");
+ *   ...
+ *   return check_result();
+ */
+inline int& check_failures()
+{
+    static int failures = 0;
+
+    return failures;
+}
+
+inline void check(bool condition, const std::string& what)
+{
+    if (condition)
+        return;
+
+    PRINT_ERROR("Check failed: " << what);
+    check_failures()++;
+}
+
+/**
+ * Print the outcome, EXIT_FAILURE if any check failed.
+ */
+inline int check_result()
+{
+    if (check_failures()) {
+        std::cerr << check_failures() << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "ok" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#endif /* _TEST_CHECK_H_ */
@@ -0,0 +1,204 @@
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+#include <giomm/init.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "export_checkpoints.h"
+#include "archive_write_request.h"
+#include "utils.h"
+#include "test_check.h"
+
+/**
+ * Checks the checkpoints of incremental log/monitor exports: the offset
+ * of a growing file, a new segment after rotation or truncation, file
+ * names which need quoting and the delta packed after a full export.
+ * The checkpoints are not saved, the exported log files are temporary.
+ *
+ * Needs the zix configuration for the log directory.
+ *
+ * Execute like this: ./test_export_checkpoints
+ */
+
+static const Glib::ustring DEST = "testExportCheckpoints";
+static const Glib::ustring TYPE = "log";
+
+static std::string temp_path(const std::string& name)
+{
+    return Glib::build_filename(Glib::get_tmp_dir(),
+                                name + "." + std::to_string(getpid()));
+}
+
+static void append(const std::string& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::app | std::ios::binary);
+
+    out << data;
+}
+
+static struct stat file_stat(const std::string& path)
+{
+    struct stat sb;
+
+    if (stat(path.c_str(), &sb))
+        PRINT_ERROR("stat failed: " << path);
+
+    return sb;
+}
+
+static goffset offset_of(const std::string& path)
+{
+    auto sb = file_stat(path);
+
+    return ExportCheckpoints::get_instance()->get_offset(DEST, TYPE, path,
+                                                         sb.st_ino, sb.st_size);
+}
+
+static void commit(const std::string& path)
+{
+    auto sb = file_stat(path);
+
+    ExportCheckpoints::get_instance()->set_offset(DEST, TYPE, path,
+                                                  sb.st_ino, sb.st_size);
+}
+
+/* content of the only member of a tar.gz archive
+ */
+static std::string read_archive(const std::string& archive)
+{
+    std::string content;
+    std::string cmd = "tar -xzOf '" + archive + "'";
+    FILE *pipe = popen(cmd.c_str(), "r");
+    char buf[4096];
+    std::size_t len;
+
+    if (!pipe)
+        return content;
+    while ((len = fread(buf, 1, sizeof(buf), pipe)) > 0)
+        content.append(buf, len);
+    pclose(pipe);
+
+    return content;
+}
+
+void test_delta_offsets()
+{
+    auto path = temp_path("test_export_checkpoints_delta");
+
+    unlink(path.c_str());
+    append(path, std::string(1000, 'a'));
+
+    check(offset_of(path) == 0, "unknown file starts a new segment");
+
+    commit(path);
+    check(offset_of(path) == 1000, "unchanged file continues at its end");
+
+    append(path, std::string(500, 'b'));
+    check(offset_of(path) == 1000, "grown file continues at the checkpoint");
+
+    commit(path);
+    check(offset_of(path) == 1500, "checkpoint advanced");
+
+    unlink(path.c_str());
+}
+
+void test_rotation()
+{
+    auto path = temp_path("test_export_checkpoints_rotation");
+    auto rotated = path + ".1";
+
+    unlink(path.c_str());
+    append(path, std::string(1000, 'a'));
+    commit(path);
+
+    // logrotate: move away and start a new file of the same size
+    rename(path.c_str(), rotated.c_str());
+    append(path, std::string(1000, 'c'));
+    check(offset_of(path) == 0, "new inode starts a new segment");
+
+    commit(path);
+    check(offset_of(path) == 1000, "rotated file continues");
+
+    // copytruncate
+    if (truncate(path.c_str(), 10))
+        PRINT_ERROR("truncate failed: " << path);
+    check(offset_of(path) == 0, "truncated file starts a new segment");
+
+    unlink(path.c_str());
+    unlink(rotated.c_str());
+}
+
+void test_quoted_names()
+{
+    auto path = temp_path("test_export_checkpoints_it's \"quoted\" [1]");
+
+    unlink(path.c_str());
+    append(path, std::string(100, 'q'));
+
+    try {
+        check(offset_of(path) == 0, "quoted name starts a new segment");
+        commit(path);
+        check(offset_of(path) == 100, "quoted name continues");
+    } catch (const std::exception& ex) {
+        check(false, std::string("quoted name throws: ") + ex.what());
+    }
+
+    unlink(path.c_str());
+}
+
+void test_full_then_incremental()
+{
+    auto path = temp_path("test_export_checkpoints_export");
+    auto archive = temp_path("test_export_checkpoints_export") + ".tar.gz";
+    std::string delta(300, 'd');
+
+    unlink(path.c_str());
+    append(path, std::string(2000, 'f'));
+
+    // a full export advances the checkpoints
+    commit(path);
+
+    append(path, delta);
+
+    goffset from = offset_of(path);
+    goffset length = file_stat(path).st_size - from;
+    check(from == 2000 && length == goffset(delta.size()), "delta range");
+
+    std::vector<ArchiveEntry> entries = { ArchiveEntry(path, from, length) };
+    auto request = ArchiveWriteRequest::create(entries, archive);
+    auto loop = Glib::MainLoop::create();
+    bool error = true;
+
+    request->finished.connect([&] (const Glib::RefPtr<ArchiveWriteResult>& result) {
+        error = result->error();
+        loop->quit();
+    });
+    request->start_write();
+    loop->run();
+
+    check(!error, "incremental archive written");
+    check(read_archive(archive) == delta, "archive holds only the delta");
+
+    unlink(path.c_str());
+    unlink(archive.c_str());
+}
+
+int main(void)
+{
+    Glib::init();
+    Gio::init();
+
+    test_delta_offsets();
+    test_rotation();
+    test_quoted_names();
+    test_full_then_incremental();
+
+    return check_result();
+}
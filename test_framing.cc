@@ -0,0 +1,115 @@
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <giomm/init.h>
+#include <giomm/memoryinputstream.h>
+
+#include <string>
+#include <list>
+#include <arpa/inet.h>
+
+#include "gio_istream_adapter.h"
+#include "utils.h"
+#include "test_check.h"
+
+/**
+ * Checks length prefixed frames read by GioIstreamAdapter: a frame with
+ * attachment is split into xml part and attachment, headers announcing
+ * more than MAX_FRAME_SIZE are rejected, also when the sum of both
+ * sizes wraps around in 32 bit.
+ *
+ * Execute like this: ./test_framing
+ */
+
+struct Outcome
+{
+    int frames = 0;
+    int invalid = 0;
+    bool eof = false;
+    std::string xml;
+    std::string attachment;
+};
+
+static std::string header(guint32 xml_size, guint32 attachment_size)
+{
+    guint32 sizes[2] = { htonl(xml_size), htonl(attachment_size) };
+
+    return std::string(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+}
+
+static std::string to_string(const std::list<Glib::RefPtr<Glib::Bytes> >& bytes_list)
+{
+    std::string ret;
+
+    for (auto&& bytes : bytes_list) {
+        gsize size;
+        auto data = static_cast<const char *>(bytes->get_data(size));
+        ret.append(data, size);
+    }
+
+    return ret;
+}
+
+static Outcome read_frames(const std::string& input)
+{
+    auto stream = Gio::MemoryInputStream::create();
+    stream->add_data(input);
+
+    auto adapter = GioIstreamAdapter::create(stream);
+    auto context = Glib::MainContext::get_default();
+    Outcome outcome;
+
+    adapter->set_length_prefixed();
+    adapter->frame_read.connect([&] (std::list<Glib::RefPtr<Glib::Bytes> > xml,
+                                     Glib::RefPtr<Glib::Bytes> attachment) {
+        outcome.frames++;
+        outcome.xml = to_string(xml);
+        if (attachment)
+            outcome.attachment = to_string({ attachment });
+    });
+    adapter->frame_invalid.connect([&] () { outcome.invalid++; });
+    adapter->stream_eof.connect([&] () { outcome.eof = true; });
+
+    for (int i = 0; i < 1000 && !outcome.eof && !outcome.invalid; ++i)
+        context->iteration(true);
+
+    return outcome;
+}
+
+void test_frame()
+{
+    auto outcome = read_frames(header(6, 3) + "<ok/>\n" + "bin");
+
+    check(outcome.frames == 1 && outcome.invalid == 0, "frame read");
+    check(outcome.xml == "<ok/>\n", "xml part");
+    check(outcome.attachment == "bin", "attachment");
+}
+
+void test_oversized()
+{
+    auto outcome = read_frames(header(GioIstreamAdapter::MAX_FRAME_SIZE, 1) + "<x/>");
+
+    check(outcome.frames == 0 && outcome.invalid == 1, "oversized frame rejected");
+
+    outcome = read_frames(header(0xFFFFFFFF, 0) + "<x/>");
+    check(outcome.frames == 0 && outcome.invalid == 1, "oversized xml part rejected");
+}
+
+void test_wrapping_sizes()
+{
+    // 0xFFFFFFF8 + 0x10 is 8 in 32 bit
+    auto outcome = read_frames(header(0xFFFFFFF8, 0x10) + std::string(64, 'x'));
+
+    check(outcome.frames == 0 && outcome.invalid == 1, "wrapping sizes rejected");
+}
+
+int main(void)
+{
+    Glib::init();
+    Gio::init();
+
+    test_frame();
+    test_oversized();
+    test_wrapping_sizes();
+
+    return check_result();
+}
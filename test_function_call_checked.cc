@@ -0,0 +1,215 @@
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <giomm/init.h>
+
+#include <libxml++/libxml++.h>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <unistd.h>
+
+#include "function_call_checked.h"
+#include "function_registry.h"
+#include "query_client.h"
+#include "xml_restriction.h"
+#include "xml_function.h"
+#include "xml_result_bad_request.h"
+#include "xml_result_ok.h"
+#include "utils.h"
+#include "test_check.h"
+
+/**
+ * Checks the precedence of the signature and the restriction check of a
+ * call: a request failing both checks gets BadRequest, no matter which
+ * check ends first, and finishes exactly once. A failed restriction
+ * check alone still gets Ok without starting the call.
+ *
+ * The restriction check queries a client, which answers only when the
+ * test tells it to. The signature check fails in gpg, so it ends
+ * asynchronously as well.
+ *
+ * Needs gpg.
+ *
+ * Execute like this: ./test_function_call_checked
+ */
+
+// base64 of bytes gpg does not accept as a signature
+static const char *SIGNATURE = "AAAAAAAAAAAAAAAA";
+
+static const std::string REQUEST =
+    std::string("<function fid=\"delFile\">") +
+    "<signature>" + SIGNATURE + "</signature>"
+    "<restriction><parameter id=\"locked\" exp=\"0\"/></restriction>"
+    "</function>";
+
+static void iterate_until(const std::function<bool ()>& done)
+{
+    auto context = Glib::MainContext::get_default();
+
+    for (int i = 0; i < 5000 && !done(); ++i) {
+        while (context->iteration(false))
+            ;
+        if (!done())
+            usleep(1000);
+    }
+}
+
+/* keeps its queries until the test answers them
+ */
+class PendingQueryClient : public QueryClient
+{
+public:
+    static Glib::RefPtr<PendingQueryClient> create()
+    {
+        return Glib::RefPtr<PendingQueryClient>(new PendingQueryClient());
+    }
+
+    Glib::RefPtr<Query> create_query(Glib::RefPtr<XmlQuery> xq, bool) override
+    {
+        return Glib::RefPtr<Query>(new Query(xq));
+    }
+
+    void reset_connection() override
+    {}
+
+    void execute(Glib::RefPtr<Query> query) override
+    {
+        queries.push_back(query);
+    }
+
+    void fail_all()
+    {
+        auto pending = std::move(queries);
+
+        queries.clear();
+        for (auto&& query : pending)
+            query->finished.emit(XmlResultBadRequest::create("Parameter not available"));
+    }
+
+    std::vector<Glib::RefPtr<Query> > queries;
+};
+
+class MainCall : public FunctionCall
+{
+public:
+    static Glib::RefPtr<MainCall> create()
+    {
+        return Glib::RefPtr<MainCall>(new MainCall());
+    }
+
+    void start_call() override
+    {
+        started = true;
+        finished.emit(XmlResultOk::create());
+    }
+
+    bool started = false;
+};
+
+class CheckedCall
+{
+public:
+    CheckedCall(const Glib::ustring& interface)
+    {
+        _parser.parse_memory(REQUEST);
+
+        auto *root = _parser.get_document()->get_root_node();
+        auto function = FunctionRegistry::lookup("delFile");
+        XmlFunction::XmlRestrictionList restrictions;
+
+        for (auto&& node : root->get_children("restriction"))
+            restrictions.push_back(XmlRestriction::create(dynamic_cast<const xmlpp::Element *>(node)));
+
+        scr = SignatureCheckRequest::create(SIGNATURE, interface, function, root);
+        rcr = RestrictionCheckRequest::create(restrictions, "delFile", function);
+        main = MainCall::create();
+        call = FunctionCallChecked::create(main, scr, rcr, interface);
+
+        scr->finished.connect([this] (const Glib::RefPtr<SignatureCheckResult>&) {
+            signature_done = true;
+        });
+        call->finished.connect([this] (Glib::RefPtr<XmlResult> result) {
+            results.push_back(result);
+        });
+    }
+
+    Glib::RefPtr<SignatureCheckRequest> scr;
+    Glib::RefPtr<RestrictionCheckRequest> rcr;
+    Glib::RefPtr<MainCall> main;
+    Glib::RefPtr<FunctionCall> call;
+
+    bool signature_done = false;
+    std::vector<Glib::RefPtr<XmlResult> > results;
+
+private:
+    xmlpp::DomParser _parser;
+};
+
+static bool is_bad_request(const std::vector<Glib::RefPtr<XmlResult> >& results)
+{
+    return results.size() == 1 && results[0]->get_status() == 400 &&
+        results[0]->to_xml().find("Signature check failed") != Glib::ustring::npos;
+}
+
+void test_restriction_fails_first(const Glib::RefPtr<PendingQueryClient>& client)
+{
+    CheckedCall checked(STR_ZIXINF_LANSOCKET);
+
+    checked.call->start_call();
+    check(client->queries.size() == 1, "restriction query sent");
+
+    client->fail_all();
+    check(checked.results.empty(), "restriction failure waits for the signature check");
+
+    iterate_until([&] () { return checked.signature_done; });
+    check(checked.signature_done, "signature check ended");
+    check(is_bad_request(checked.results), "signature failure wins, restriction first");
+    check(!checked.main->started, "call not started");
+}
+
+void test_signature_fails_first(const Glib::RefPtr<PendingQueryClient>& client)
+{
+    CheckedCall checked(STR_ZIXINF_LANSOCKET);
+
+    checked.call->start_call();
+    check(client->queries.size() == 1, "restriction query sent");
+
+    iterate_until([&] () { return checked.signature_done; });
+    check(checked.signature_done, "signature check ended");
+    check(is_bad_request(checked.results), "signature failure finishes at once");
+
+    client->fail_all();
+    check(is_bad_request(checked.results), "signature failure wins, signature first");
+    check(!checked.main->started, "call not started");
+}
+
+void test_restriction_fails_alone(const Glib::RefPtr<PendingQueryClient>& client)
+{
+    // no signature needed on the webserver
+    CheckedCall checked(STR_ZIXINF_LANWEBSERVER);
+
+    checked.call->start_call();
+    check(checked.signature_done && checked.results.empty(), "signature check passed");
+
+    client->fail_all();
+    check(checked.results.size() == 1 && checked.results[0]->get_status() == 200 &&
+          checked.results[0]->to_xml().find("Restriction check failed") != Glib::ustring::npos,
+          "restriction failure gets Ok");
+    check(!checked.main->started, "call not started");
+}
+
+int main(void)
+{
+    Glib::init();
+    Gio::init();
+
+    auto client = PendingQueryClient::create();
+    QueryClient::set_instance(client);
+
+    test_restriction_fails_first(client);
+    test_signature_fails_first(client);
+    test_restriction_fails_alone(client);
+
+    return check_result();
+}
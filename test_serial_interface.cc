@@ -44,7 +44,6 @@ int main(int argc, char **argv)
     Glib::init();
     Gio::init();
 
-    CoreFunctionCall::init();
     XmlParameter::init();
 
 
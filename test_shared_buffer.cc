@@ -0,0 +1,216 @@
+#include <libxml++/parsers/domparser.h>
+
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+#include <giomm/init.h>
+#include <giomm/file.h>
+
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "shared_buffer.h"
+#include "xml_measurement.h"
+#include "xml_result_ok.h"
+#include "write_file_request.h"
+#include "socket_write_queue.h"
+#include "socket_write_stats.h"
+#include "serial_message.h"
+#include "utils.h"
+#include "test_check.h"
+
+/**
+ * Checks that large payloads are not duplicated on their way through the
+ * request pipeline: measurement content to a file, return values into a
+ * reply and the reply onto a socket or into serial frames. Each step
+ * resets the copy counters of SharedBuffer and fails, if payload bytes
+ * have been copied. The counters themselves have to count a flattened
+ * rope once.
+ *
+ * Execute like this: ./test_shared_buffer
+ */
+
+static const std::size_t PAYLOAD_SIZE = 4 * 1024 * 1024;
+
+static void check_no_copies(const std::string& what)
+{
+    const auto& counters = SharedBuffer::counters();
+
+    check(counters.bytes == 0, what + " copied " + std::to_string(counters.bytes) +
+          " bytes in " + std::to_string(counters.copies) + " copies");
+}
+
+static void check_copied(std::size_t copies, std::size_t bytes, const std::string& what)
+{
+    const auto& counters = SharedBuffer::counters();
+
+    check(counters.copies == copies && counters.bytes == bytes,
+          what + " copied " + std::to_string(counters.bytes) + " bytes in " +
+          std::to_string(counters.copies) + " copies");
+}
+
+static std::string temp_path(const std::string& name)
+{
+    return Glib::build_filename(Glib::get_tmp_dir(),
+                                name + "." + std::to_string(getpid()));
+}
+
+static std::string make_payload(std::size_t size)
+{
+    std::string payload;
+
+    payload.reserve(size);
+    while (payload.size() < size)
+        payload += "<value name=\"temperature\">23.5</value>\n";
+    payload.resize(size - 1);
+    payload += "\n";
+
+    return payload;
+}
+
+void test_buffer()
+{
+    std::string data = make_payload(PAYLOAD_SIZE);
+    const char *storage = data.data();
+
+    SharedBuffer::reset_counters();
+
+    SharedBuffer payload(std::move(data));
+    SharedBuffer rope(std::string("<head>"));
+    rope.append(payload);
+    rope.append(std::string("</head>"));
+    SharedBuffer shared = rope;
+
+    gsize size;
+    check(payload.bytes()->get_data(size) == storage, "adopted string is referenced");
+    check(shared.size() == PAYLOAD_SIZE + 13, "rope size");
+    check_no_copies("building a rope");
+
+    std::string frame;
+    rope.read(6, 16, frame);
+    check(frame == std::string(storage, 16), "read across segments");
+}
+
+void test_accounting()
+{
+    SharedBuffer single(std::string("<value>1</value>"));
+    SharedBuffer rope(std::string("<head>"));
+    rope.append(single);
+    rope.append(std::string("</head>"));
+
+    SharedBuffer::reset_counters();
+    check(single.to_ustring() == "<value>1</value>", "single segment to ustring");
+    check_copied(1, single.size(), "single segment to ustring");
+
+    SharedBuffer::reset_counters();
+    check(rope.to_ustring() == "<head><value>1</value></head>", "rope to ustring");
+    check_copied(1, rope.size(), "rope to ustring");
+
+    SharedBuffer::reset_counters();
+    check(rope.to_string() == "<head><value>1</value></head>", "rope to string");
+    check_copied(1, rope.size(), "rope to string");
+}
+
+void test_measurement_to_file()
+{
+    std::string xml = "<measurement iid=\"00001\" format=\"xml\">" +
+        make_payload(PAYLOAD_SIZE) + "</measurement>";
+    xmlpp::DomParser parser;
+
+    parser.parse_memory(xml);
+
+    SharedBuffer::reset_counters();
+
+    auto measurement = XmlMeasurement::create(parser.get_document()->get_root_node());
+    auto path = temp_path("test_shared_buffer_measurement");
+    auto loop = Glib::MainLoop::create();
+    bool error = true;
+
+    auto request = WriteFileRequest::create(path, measurement->get_content());
+    request->finished.connect([&] (const Glib::RefPtr<WriteFileResult>& result) {
+        error = result->error();
+        loop->quit();
+    });
+    request->start_write();
+    loop->run();
+
+    check(!error, "measurement written");
+    check_no_copies("measurement to file");
+
+    check(Glib::file_get_contents(path) == measurement->get_content().to_string(),
+          "file content");
+    unlink(path.c_str());
+}
+
+void test_reply_to_socket()
+{
+    SharedBuffer payload(make_payload(PAYLOAD_SIZE));
+    std::vector<SharedBuffer> return_values = { payload };
+
+    SharedBuffer::reset_counters();
+
+    auto result = XmlResultOk::create("", return_values);
+    auto reply = result->to_buffer();
+
+    bool referenced = false;
+    for (auto&& segment : reply.segments())
+        referenced |= segment->gobj() == payload.segments().front()->gobj();
+    check(referenced, "return value is referenced by the reply");
+
+    auto path = temp_path("test_shared_buffer_reply");
+    auto stream = Gio::File::create_for_path(path)->replace();
+    auto queue = SocketWriteQueue::create(stream, SocketWriteQueue::DEFAULT_MAX_BUFFERED,
+                                          SocketWriteStats::get("test"));
+    auto loop = Glib::MainLoop::create();
+    bool error = false;
+
+    queue->drained.connect([&] () { loop->quit(); });
+    queue->errored.connect([&] (const Glib::ustring& msg) {
+        PRINT_ERROR("write failed: " << msg);
+        error = true;
+        loop->quit();
+    });
+    check(queue->push(reply), "reply queued");
+    loop->run();
+    stream->close();
+
+    check(!error, "reply written");
+    check_no_copies("reply to socket");
+
+    check(Glib::file_get_contents(path) == reply.to_string(), "written reply");
+    unlink(path.c_str());
+}
+
+void test_reply_to_serial()
+{
+    SharedBuffer payload(make_payload(PAYLOAD_SIZE));
+    CSerialMessage message(1024);
+    std::string received;
+
+    SharedBuffer::reset_counters();
+
+    message.initSenderMessage(payload, 1);
+    while (message.dataLeft()) {
+        message.popFrame();
+        received += message.getFramePayload();
+    }
+
+    check_no_copies("reply to serial frames");
+    check(received == payload.to_string(), "reassembled frames");
+}
+
+int main(void)
+{
+    Glib::init();
+    Gio::init();
+
+    test_buffer();
+    test_accounting();
+    test_measurement_to_file();
+    test_reply_to_socket();
+    test_reply_to_serial();
+
+    return check_result();
+}
@@ -29,7 +29,6 @@ int main(int argc, char **argv)
     /* libzix init function...
      * TODO: migrate into a single libzix::init()
      */
-    CoreFunctionCall::init();
     XmlParameter::init();
 
     auto xml_p = XmlProcessor::create ();
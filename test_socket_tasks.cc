@@ -0,0 +1,214 @@
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <giomm/init.h>
+#include <giomm/socket.h>
+#include <giomm/socketconnection.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "socket_interface_connection.h"
+#include "xml_result_bad_request.h"
+#include "utils.h"
+#include "test_check.h"
+
+/**
+ * Checks tid tagged requests on socket connections: replies which are
+ * emitted out of order carry the tid of their request, malformed,
+ * missing and duplicate tids are rejected with a BadRequest before the
+ * request reaches the XmlProcessor.
+ *
+ * The connection runs on one end of a socketpair, the test is the client
+ * on the other end and answers the requests itself.
+ *
+ * Execute like this: ./test_socket_tasks
+ */
+
+using Request = std::pair<int, std::string>;
+
+class Client
+{
+public:
+    Client()
+    {
+        int fds[2];
+
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+            EXCEPTION("socketpair failed");
+        _fd = fds[0];
+
+        auto socket = Gio::Socket::create_from_fd(fds[1]);
+        connection = SocketInterfaceConnection::create(Gio::SocketConnection::create(socket), "test");
+        connection->request_ready.connect([this] (std::istream& is, int tid) {
+            std::stringstream ss;
+            ss << is.rdbuf();
+            requests.emplace_back(tid, ss.str());
+        });
+    }
+
+    ~Client()
+    {
+        connection.reset();
+        close(_fd);
+    }
+
+    void send(const std::string& request)
+    {
+        std::string data = request + '\0';
+
+        if (write(_fd, data.data(), data.size()) != ssize_t(data.size()))
+            PRINT_ERROR("write failed");
+    }
+
+    /* next NUL terminated reply, empty on timeout
+     */
+    std::string receive()
+    {
+        for (int i = 0; i < 500; ++i) {
+            auto nul = _received.find('\0');
+            if (nul != std::string::npos) {
+                auto reply = _received.substr(0, nul);
+                _received.erase(0, nul + 1);
+                return reply;
+            }
+
+            iterate();
+
+            struct pollfd pfd = { _fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 10) > 0) {
+                char buf[4096];
+                ssize_t len = read(_fd, buf, sizeof(buf));
+                if (len > 0)
+                    _received.append(buf, len);
+            }
+        }
+
+        return "";
+    }
+
+    void wait_for_requests(std::size_t count)
+    {
+        for (int i = 0; i < 500 && requests.size() < count; ++i) {
+            iterate();
+            usleep(1000);
+        }
+    }
+
+    std::shared_ptr<InterfaceConnection> connection;
+    std::vector<Request> requests;
+
+private:
+    int _fd;
+    std::string _received;
+
+    static void iterate()
+    {
+        auto context = Glib::MainContext::get_default();
+
+        while (context->iteration(false))
+            ;
+    }
+};
+
+static std::string function(const std::string& fid)
+{
+    return "<function fid=\"" + fid + "\"/>";
+}
+
+static std::string reply(int n)
+{
+    return "<reply n=\"" + std::to_string(n) + "\"/>";
+}
+
+static std::string tagged(int tid, const std::string& xml)
+{
+    return "<task tid=\"" + std::to_string(tid) + "\">" + xml + "</task>";
+}
+
+void test_out_of_order()
+{
+    Client client;
+
+    client.send(tagged(1, function("a")));
+    client.send(tagged(2, function("b")));
+    client.send("<task  tid = '3' >\n" + function("c") + "\n</task>\n");
+    client.send(function("d"));
+
+    client.wait_for_requests(4);
+    check(client.requests.size() == 4, "all requests dispatched");
+    if (client.requests.size() != 4)
+        return;
+
+    check(client.requests[0] == Request(1, function("a")), "tid 1 unwrapped");
+    check(client.requests[1] == Request(2, function("b")), "tid 2 unwrapped");
+    check(client.requests[2] == Request(3, "\n" + function("c") + "\n"),
+          "tid 3 with spaces and single quotes");
+    check(client.requests[3] == Request(0, function("d")), "untagged request");
+
+    // answer in reverse order
+    client.connection->emit_result(reply(3), 3);
+    client.connection->emit_result(reply(0), 0);
+    client.connection->emit_result(reply(1), 1);
+    client.connection->emit_result(reply(2), 2);
+
+    check(client.receive() == tagged(3, reply(3)), "reply 3 first");
+    check(client.receive() == reply(0), "untagged reply is plain");
+    check(client.receive() == tagged(1, reply(1)), "reply 1");
+    check(client.receive() == tagged(2, reply(2)), "reply 2");
+}
+
+void test_malformed_tids()
+{
+    const std::vector<std::string> malformed = {
+        "<task xtid=\"4\">" + function("x") + "</task>",
+        "<task note=\"tid=4\">" + function("x") + "</task>",
+        "<task tid=\"4x\">" + function("x") + "</task>",
+        "<task tid=\" 4\">" + function("x") + "</task>",
+        "<task tid=\"0\">" + function("x") + "</task>",
+        "<task tid=\"-4\">" + function("x") + "</task>",
+        "<task tid=\"99999999999\">" + function("x") + "</task>",
+        "<task tid=\"4\" tid=\"5\">" + function("x") + "</task>",
+    };
+    auto bad_request = XmlResultBadRequest::create("Invalid or duplicate task tid")->to_xml();
+    Client client;
+
+    for (auto&& request : malformed) {
+        client.send(request);
+        check(client.receive() == bad_request, "rejected: " + request);
+    }
+    check(client.requests.empty(), "malformed requests are not dispatched");
+
+    // duplicate of an outstanding tid
+    client.send(tagged(7, function("y")));
+    client.send(tagged(7, function("z")));
+    check(client.receive() == bad_request, "duplicate tid rejected");
+
+    client.wait_for_requests(1);
+    check(client.requests.size() == 1 && client.requests[0] == Request(7, function("y")),
+          "first tid 7 dispatched");
+
+    // answered tids may be used again
+    client.connection->emit_result(reply(7), 7);
+    check(client.receive() == tagged(7, reply(7)), "reply 7");
+
+    client.send(tagged(7, function("w")));
+    client.wait_for_requests(2);
+    check(client.requests.size() == 2, "tid 7 reused");
+}
+
+int main(void)
+{
+    Glib::init();
+    Gio::init();
+
+    test_out_of_order();
+    test_malformed_tids();
+
+    return check_result();
+}
@@ -0,0 +1,205 @@
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <giomm/init.h>
+
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "state_variable.h"
+#include "query_client.h"
+#include "xml_result_ok.h"
+#include "utils.h"
+#include "test_check.h"
+
+/**
+ * Checks the batching of StateVariable changes: all changes within one
+ * COALESCE_MS window go to the DC as a single status query with the
+ * latest values, changes during a running query go into the next one,
+ * and every callback passed to set_state() is called exactly once, with
+ * the result of the query carrying its state.
+ *
+ * The DC is a query client which records the queries and answers only
+ * when the test tells it to.
+ *
+ * Execute like this: ./test_state_variable
+ */
+
+/* runs the main loop for ms, long enough for a window to close
+ */
+static void iterate(unsigned ms)
+{
+    auto context = Glib::MainContext::get_default();
+
+    for (unsigned i = 0; i < ms; ++i) {
+        while (context->iteration(false))
+            ;
+        usleep(1000);
+    }
+}
+
+static bool contains(const Glib::ustring& xml, const std::string& id, const std::string& value)
+{
+    return xml.find("<parameter id=\"" + id + "\" value=\"" + value + "\"/>") != Glib::ustring::npos;
+}
+
+/* keeps its queries until the test answers them
+ */
+class RecordingQueryClient : public QueryClient
+{
+public:
+    static Glib::RefPtr<RecordingQueryClient> create()
+    {
+        return Glib::RefPtr<RecordingQueryClient>(new RecordingQueryClient());
+    }
+
+    Glib::RefPtr<Query> create_query(Glib::RefPtr<XmlQuery> xq, bool) override
+    {
+        return Glib::RefPtr<Query>(new Query(xq));
+    }
+
+    void reset_connection() override
+    {}
+
+    void execute(Glib::RefPtr<Query> query) override
+    {
+        sent.push_back(query->xml_query());
+        _pending.push_back(query);
+    }
+
+    std::size_t pending() const
+    {
+        return _pending.size();
+    }
+
+    void answer(const Glib::RefPtr<XmlResult>& result)
+    {
+        auto pending = std::move(_pending);
+
+        _pending.clear();
+        for (auto&& query : pending)
+            query->finished.emit(result);
+    }
+
+    std::vector<Glib::ustring> sent;
+
+private:
+    std::vector<Glib::RefPtr<Query> > _pending;
+};
+
+class Callback
+{
+public:
+    sigc::slot<void, Glib::RefPtr<XmlResult> > slot()
+    {
+        return [this] (Glib::RefPtr<XmlResult> result) {
+            calls++;
+            last = result;
+        };
+    }
+
+    int calls = 0;
+    Glib::RefPtr<XmlResult> last;
+};
+
+void test_one_query_per_window(const Glib::RefPtr<RecordingQueryClient>& client,
+                               StateVariable& a, StateVariable& b, StateVariable& c)
+{
+    client->sent.clear();
+
+    a.set_state("one");
+    b.set_state("one");
+    a.set_state("two");
+    c.set_state("one");
+
+    check(client->sent.empty(), "no query before the window closed");
+    iterate(3 * StateVariable::COALESCE_MS);
+
+    check(client->sent.size() == 1, "one query for the window, got " +
+          std::to_string(client->sent.size()));
+    if (client->sent.size() != 1)
+        return;
+
+    auto xml = client->sent[0];
+    check(contains(xml, "testStateA", "two"), "latest value of A");
+    check(!contains(xml, "testStateA", "one"), "former value of A not sent");
+    check(contains(xml, "testStateB", "one") && contains(xml, "testStateC", "one"), "B and C sent");
+
+    // changes while the query runs wait for it
+    b.set_state("two");
+    c.set_state("two");
+    iterate(3 * StateVariable::COALESCE_MS);
+    check(client->sent.size() == 1, "no second query while the first runs");
+
+    client->answer(XmlResultOk::create());
+    iterate(3 * StateVariable::COALESCE_MS);
+    check(client->sent.size() == 2, "collected changes go into one query");
+    if (client->sent.size() == 2) {
+        check(contains(client->sent[1], "testStateB", "two") &&
+              contains(client->sent[1], "testStateC", "two") &&
+              !contains(client->sent[1], "testStateA", "two"), "only the changed states");
+    }
+
+    client->answer(XmlResultOk::create());
+    iterate(3 * StateVariable::COALESCE_MS);
+    check(client->sent.size() == 2 && client->pending() == 0, "nothing left to send");
+}
+
+void test_callbacks_once(const Glib::RefPtr<RecordingQueryClient>& client,
+                         StateVariable& a, StateVariable& b)
+{
+    Callback first, second, other, pending, rejected;
+
+    client->sent.clear();
+
+    // two callbacks for one variable and one for another, same window
+    a.set_state("on", first.slot());
+    a.set_state("off", second.slot());
+    b.set_state("on", other.slot());
+    iterate(3 * StateVariable::COALESCE_MS);
+    check(client->sent.size() == 1, "one query for all callbacks");
+
+    // a is in flight: the next callback waits for the next query,
+    // one more is rejected with its state
+    a.set_state("on", pending.slot());
+    a.set_state("unknown", rejected.slot());
+
+    auto ok = XmlResultOk::create();
+    client->answer(ok);
+    check(first.calls == 1 && second.calls == 1 && other.calls == 1, "callbacks of the query called");
+    check(first.last == ok && other.last == ok, "callbacks get the result");
+    check(pending.calls == 0, "pending callback waits for its query");
+
+    iterate(3 * StateVariable::COALESCE_MS);
+    check(client->sent.size() == 2, "pending state sent");
+    if (client->sent.size() == 2)
+        check(contains(client->sent[1], "testStateA", "on") &&
+              !contains(client->sent[1], "testStateB", "on"), "pending state sent");
+
+    client->answer(XmlResultOk::create());
+    iterate(3 * StateVariable::COALESCE_MS);
+
+    check(first.calls == 1 && second.calls == 1 && other.calls == 1, "callbacks called once");
+    check(pending.calls == 1, "pending callback called once");
+    check(rejected.calls == 0, "rejected callback not called");
+    check(client->sent.size() == 2, "no further query");
+}
+
+int main(void)
+{
+    Glib::init();
+    Gio::init();
+
+    auto client = RecordingQueryClient::create();
+    QueryClient::set_instance(client);
+
+    // fewer variables than needed for the master to become ready
+    StateVariable master("testStateMaster");
+    StateVariable a("testStateA"), b("testStateB"), c("testStateC");
+    StateVariable::set_master(&master);
+
+    test_one_query_per_window(client, a, b, c);
+    test_callbacks_once(client, a, b);
+
+    return check_result();
+}
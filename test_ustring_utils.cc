@@ -0,0 +1,204 @@
+#include <glibmm/init.h>
+#include <glibmm/ustring.h>
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstring>
+
+#include "ustring_utils.h"
+#include "xml_helpers.h"
+#include "utils.h"
+#include "test_check.h"
+
+/**
+ * Fuzzes xml_escape and UstringUtils, which work on the UTF-8 bytes,
+ * against the former implementations iterating by code point. Both have
+ * to give byte identical output for random mixes of ASCII, the
+ * characters the functions look for and multibyte sequences, e.g.
+ * U+00A0 which is a space beyond ASCII.
+ *
+ * find_first_of is checked against a plain loop at every offset, with
+ * short sets for the SSE2/NEON path and a long set for the scalar one.
+ *
+ * Execute like this: ./test_ustring_utils
+ */
+
+static const int ROUNDS = 20000;
+
+/* former implementations
+ */
+static Glib::ustring old_xml_escape(const Glib::ustring& raw)
+{
+    Glib::ustring ret;
+
+    for (auto ch : raw) {
+        switch (ch) {
+            case '&':  ret.append("&amp;"); break;
+            case '\'': ret.append("&apos;"); break;
+            case '"':  ret.append("&quot;"); break;
+            case '<':  ret.append("&lt;"); break;
+            case '>':  ret.append("&gt;"); break;
+            default:   ret.push_back(ch); break;
+        }
+    }
+    return ret;
+}
+
+static Glib::ustring old_trim(const Glib::ustring& input)
+{
+    Glib::ustring result;
+
+    result.reserve(input.size());
+    for (const auto& c : input)
+        if (!Glib::Unicode::isspace(c))
+            result.push_back(c);
+
+    return result;
+}
+
+static Glib::ustring old_strip_newlines_and_tabs(const Glib::ustring& input)
+{
+    Glib::ustring result;
+
+    result.reserve(input.size());
+    for (auto&& c : input) {
+        if (c == '\n' || c == '\t')
+            continue;
+        result.push_back(c);
+    }
+
+    return result;
+}
+
+static Glib::ustring old_condense_spaces(const Glib::ustring& input)
+{
+    Glib::ustring result;
+
+    result.reserve(input.size());
+    gunichar e = 0;
+    for (auto&& c : input) {
+        if (e == ' ' && c == ' ')
+            continue;
+        result.push_back(c);
+        e = c;
+    }
+
+    return result;
+}
+
+static Glib::ustring old_remove_indent_from_lines(const Glib::ustring& input)
+{
+    Glib::ustring result;
+    bool erase = true;
+
+    result.reserve(input.size());
+    for (const auto& c : input) {
+        if (c == '\n')
+            erase = true;
+        if (erase && (c == ' ' || c == '\t'))
+            continue;
+        if (c != ' ' && c != '\n')
+            erase = false;
+        result.push_back(c);
+    }
+
+    return result;
+}
+
+static std::size_t plain_find_first_of(const char *data, std::size_t size, const char *set,
+                                       bool non_ascii)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        unsigned char c = data[i];
+
+        if (c >= 0x80 ? non_ascii : strchr(set, c) != nullptr)
+            return i;
+    }
+
+    return size;
+}
+
+/* random valid UTF-8, mostly plain text so runs are long enough for
+ * the vector loops
+ */
+static Glib::ustring random_text(std::mt19937& rng)
+{
+    static const std::vector<std::string> pieces = {
+        " ", "  ", "\t", "\n", "\r", "\f", "\v", "\n  \t",
+        "&", "'", "\"", "<", ">", "&amp;",
+        "\xc3\xa4",             // U+00E4
+        "\xc2\xa0",             // U+00A0, no-break space
+        "\xe3\x80\x80",         // U+3000, ideographic space
+        "\xe2\x80\xa8",         // U+2028, line separator
+        "\xe2\x82\xac",         // U+20AC
+        "\xf0\x9f\x98\x80",     // U+1F600
+    };
+    std::uniform_int_distribution<int> length(0, 80);
+    std::uniform_int_distribution<int> kind(0, 3);
+    std::uniform_int_distribution<int> piece(0, pieces.size() - 1);
+    std::uniform_int_distribution<int> letter('0', 'z');
+    std::string text;
+
+    for (int n = length(rng); n > 0; --n) {
+        if (kind(rng))
+            text += char(letter(rng));
+        else
+            text += pieces[piece(rng)];
+    }
+
+    return Glib::ustring(text);
+}
+
+void test_find_first_of(std::mt19937& rng)
+{
+    static const char *sets[] = { "&'\"<>", "\n\t", " \t\n\r\f", "&'\"<>\n\t\r\f " };
+
+    for (int round = 0; round < ROUNDS / 10; ++round) {
+        auto text = random_text(rng).raw();
+
+        for (auto set : sets) {
+            for (std::size_t off = 0; off <= text.size(); ++off) {
+                const char *data = text.data() + off;
+                std::size_t size = text.size() - off;
+
+                check(UstringUtils::find_first_of(data, size, set) ==
+                      plain_find_first_of(data, size, set, false),
+                      "find_first_of: " + text);
+                check(UstringUtils::find_first_of(data, size, set, true) ==
+                      plain_find_first_of(data, size, set, true),
+                      "find_first_of non-ASCII: " + text);
+            }
+        }
+    }
+}
+
+void test_against_old(std::mt19937& rng)
+{
+    for (int round = 0; round < ROUNDS; ++round) {
+        auto text = random_text(rng);
+        const std::string& raw = text.raw();
+
+        check(xml_escape(text).raw() == old_xml_escape(text).raw(), "xml_escape: " + raw);
+        check(UstringUtils::trim(text).raw() == old_trim(text).raw(), "trim: " + raw);
+        check(UstringUtils::strip_newlines_and_tabs(text).raw() ==
+              old_strip_newlines_and_tabs(text).raw(), "strip_newlines_and_tabs: " + raw);
+        check(UstringUtils::condense_spaces(text).raw() == old_condense_spaces(text).raw(),
+              "condense_spaces: " + raw);
+        check(UstringUtils::remove_indent_from_lines(text).raw() ==
+              old_remove_indent_from_lines(text).raw(), "remove_indent_from_lines: " + raw);
+    }
+}
+
+int main(void)
+{
+    Glib::init();
+
+    // fixed seed, a failure can be reproduced
+    std::mt19937 rng(4711);
+
+    test_find_first_of(rng);
+    test_against_old(rng);
+
+    return check_result();
+}
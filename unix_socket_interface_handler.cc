@@ -7,12 +7,14 @@
 #include "byteslist_istream.h"
 #include "file_handler.h"
 #include "hexio.h"
+#include "conf_handler.h"
 #include "utils.h"
 
 UnixSocketInterfaceHandler::UnixSocketInterfaceHandler(
     ZixInterface inf, const std::string& path, Glib::RefPtr <XmlProcessor> xml_processor) :
     Glib::ObjectBase(typeid (UnixSocketInterfaceHandler)),
-    InterfaceHandler(inf, inf.to_string(), xml_processor)
+    InterfaceHandler(inf, inf.to_string(), xml_processor),
+    _write_buffer_max{ConfHandler::get_instance()->getSocketWriteBufferMax()}
 {
     // if socket exists (e.g. unclean shutdown of our daemon) -> delete it
     // otherwise, the creation code here will throw an exception
@@ -56,7 +58,7 @@ bool UnixSocketInterfaceHandler::incoming_connection (
 {
     (void) source_object;
 
-    auto iface_connection = SocketInterfaceConnection::create (connection);
+    auto iface_connection = SocketInterfaceConnection::create (connection, _name, _write_buffer_max);
     register_connection (iface_connection);
 
     iface_connection->connection_closed.connect(
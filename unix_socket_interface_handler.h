@@ -31,6 +31,7 @@ public:
 private:
     Glib::RefPtr<Gio::SocketService> _service;
     Glib::RefPtr<Gio::UnixSocketAddress> _unix_addr;
+    std::size_t _write_buffer_max;
 
     bool incoming_connection(const Glib::RefPtr<Gio::SocketConnection>& connection,
                              const Glib::RefPtr<Glib::Object>& source_object);
@@ -3,21 +3,25 @@
 #include "log_handler.h"
 #include "ustring_utils.h"
 #include "utils.h"
+#include "signature_cache.h"
+#include "signature_engine.h"
 
 #include "update_signature_check_request.h"
 
+constexpr const char *UpdateSignatureCheckRequest::public_key;
+
 const std::vector<std::string> UpdateSignatureCheckRequest::default_openssl_args =
-{ "openssl", "dgst", "-sha256", "-verify", "/etc/swupdate/public.pem", "-signature" };
+{ "openssl", "dgst", "-sha256", "-verify", public_key, "-signature" };
 
-UpdateSignatureCheckRequest::UpdateSignatureCheckRequest (const Glib::ustring & content_fname, const Glib::ustring & signature)
-    : _content_fname (content_fname)
+UpdateSignatureCheckRequest::UpdateSignatureCheckRequest (const std::shared_ptr <const std::string> & content, const Glib::ustring & signature)
+    : _content (content)
     , _signature (signature)
 { }
 
 Glib::RefPtr <UpdateSignatureCheckRequest>
-UpdateSignatureCheckRequest::create (const Glib::ustring & content_fname, const Glib::ustring & signature)
+UpdateSignatureCheckRequest::create (const std::shared_ptr <const std::string> & content, const Glib::ustring & signature)
 {
-    return Glib::RefPtr <UpdateSignatureCheckRequest> (new UpdateSignatureCheckRequest (content_fname, signature));
+    return Glib::RefPtr <UpdateSignatureCheckRequest> (new UpdateSignatureCheckRequest (content, signature));
 }
 
 void UpdateSignatureCheckRequest::cleanup() const
@@ -36,9 +40,9 @@ void UpdateSignatureCheckRequest::verify_via_openssl()
     std::vector<std::string> args(default_openssl_args);
 
     args.emplace_back(_sig_file);
-    args.emplace_back(_content_fname);
 
     _proc = ProcessRequest::create(args, ProcessRequest::DEFAULT_TIMEOUT);
+    _proc->set_stdin_data(*_content);
     _proc->finished.connect(
         sigc::mem_fun(*this, &UpdateSignatureCheckRequest::on_proc_finish));
     _proc->start_process();
@@ -46,9 +50,15 @@ void UpdateSignatureCheckRequest::verify_via_openssl()
 
 void UpdateSignatureCheckRequest::on_proc_finish(const Glib::RefPtr<ProcessResult>& result)
 {
+    auto cache = SignatureCache::get_instance();
+
     cleanup();
 
     if (!result->success()) {
+        // exit status 1 is a bad signature, anything else may be temporary
+        if (result->get_exited_normally() && result->get_child_status() == 1)
+            cache->store(_digest, _signature, public_key, false);
+
         finished.emit(
             SignatureCheckResult::create(
                 false, Glib::ustring::compose("openssl verification failed: %1",
@@ -56,6 +66,8 @@ void UpdateSignatureCheckRequest::on_proc_finish(const Glib::RefPtr<ProcessResul
         return;
     }
 
+    cache->store(_digest, _signature, public_key, true);
+
     finished.emit(SignatureCheckResult::create(true, ""));
 }
 
@@ -64,21 +76,30 @@ void UpdateSignatureCheckRequest::start_check()
     Glib::RefPtr<Gio::UnixOutputStream> temp_stream;
     std::string error_msg;
     bool error = false;
+    bool cached = false;
+    bool valid = false;
 
     try {
         Glib::ustring decoded_signature;
 	gsize bytes_written;
 
-	/* write decoded signature to temp_stream
-	 */
-        temp_stream = FileHandler::get_temp_file_write(_sig_file);
-	decoded_signature = FileHandler::base64_decode (_signature);
-        temp_stream->write_all(decoded_signature.data(), decoded_signature.bytes(), bytes_written);
-        temp_stream->close();
-
-        /* now call openssl to verify the signature
-	 */
-        verify_via_openssl();
+        /* same image verified before? The key is the content itself,
+         * file metadata on e.g. a FAT stick can be forged.
+         */
+        _digest = SignatureEngine::digest(G_CHECKSUM_SHA256, *_content);
+        cached = SignatureCache::get_instance()->lookup(_digest, _signature, public_key, valid);
+        if (!cached) {
+            /* write decoded signature to temp_stream
+             */
+            temp_stream = FileHandler::get_temp_file_write(_sig_file);
+            decoded_signature = FileHandler::base64_decode (_signature);
+            temp_stream->write_all(decoded_signature.data(), decoded_signature.bytes(), bytes_written);
+            temp_stream->close();
+
+            /* now call openssl to verify the signature
+             */
+            verify_via_openssl();
+        }
     } catch (const std::exception& ex) {
         error     = true;
         error_msg = ex.what();
@@ -95,6 +116,13 @@ void UpdateSignatureCheckRequest::start_check()
     if (error) {
         cleanup();
         finished.emit(SignatureCheckResult::create(false, error_msg));
+        return;
+    }
+
+    if (cached) {
+        finished.emit(SignatureCheckResult::create(
+            valid, valid ? "" : "openssl verification failed: bad signature (cached)"));
+        return;
     }
 
     /* the verification process is running now,
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 
 #include <glibmm/ustring.h>
 #include <glibmm/object.h>
@@ -27,16 +28,21 @@
  * This class can be used in order to check whether the signature for
  * a given <image /> is valid.
  *
- * We use openssl to achieve that:
+ * We use openssl to achieve that, the image is passed on stdin:
  *
- * -> openssl dgst -sha256 -verify /etc/swupdate/public.pem -signature <signature> <file>
+ * -> openssl dgst -sha256 -verify /etc/swupdate/public.pem -signature <signature>
+ *
+ * The image is verified from memory, so the caller can use exactly the
+ * bytes which have been verified. Results are kept in the SignatureCache,
+ * keyed by the SHA-256 of the image, so the same image is not verified
+ * again.
  */
 class UpdateSignatureCheckRequest : public Glib::Object
 {
 public:
-    UpdateSignatureCheckRequest (const Glib::ustring & content_fname, const Glib::ustring & signature);
+    UpdateSignatureCheckRequest (const std::shared_ptr <const std::string> & content, const Glib::ustring & signature);
 
-    static Glib::RefPtr <UpdateSignatureCheckRequest> create (const Glib::ustring & content_fname, const Glib::ustring & signature);
+    static Glib::RefPtr <UpdateSignatureCheckRequest> create (const std::shared_ptr <const std::string> & content, const Glib::ustring & signature);
 
     void start_check();
 
@@ -44,13 +50,15 @@ public:
 
 private:
     static const std::vector<std::string> default_openssl_args;
+    static constexpr const char *public_key = "/etc/swupdate/public.pem";
 
     Glib::RefPtr <ProcessRequest> _proc;
 
-    Glib::ustring _content_fname;
+    std::shared_ptr <const std::string> _content;
     Glib::ustring _signature;
 
     std::string _sig_file;
+    std::string _digest;
 
     Glib::ustring get_signature() const;
     void verify_via_openssl();
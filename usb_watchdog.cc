@@ -202,6 +202,14 @@ void UsbWatchdog::udisks_device_added(const Glib::ustring& device)
 
         _rescan_timer = Glib::signal_timeout().connect(sigc::mem_fun(*this, &UsbWatchdog::timeout_handler), 60 * 1000);
 
+        // react on new update images right away, not only on the timer
+        unwatch_folders();
+        for (auto&& input_folder : get_input_folder_paths(true)) {
+            auto path = _mount_path + "/" + input_folder;
+            if (FileHandler::directory_exists(path))
+                watch_folder(path);
+        }
+
         usb_handler();
     }
 }
@@ -229,6 +237,8 @@ void UsbWatchdog::udisks_device_removed(const Glib::ustring& device)
 	_usb_state.set_state ("nodevice");
         if (_rescan_timer.connected())
             _rescan_timer.disconnect();
+        unwatch_folders();
+        _unchanged_dirs.clear();
     }
 
     // remove device
@@ -287,7 +297,17 @@ bool UsbWatchdog::usb_handler(bool update_only)
 
 bool UsbWatchdog::timeout_handler()
 {
-    if (!_current_device.empty() && !_in_progress)
+    // monitors only see the top level of the update folders, so keep
+    // rescanning; unchanged directories are skipped by create_file_list()
+    if (!_current_device.empty() && !_in_progress) {
+        _dirty = false;
         usb_handler(true);
+    }
     return true;
 }
+
+void UsbWatchdog::scan_input()
+{
+    if (!_current_device.empty())
+        usb_handler(true);
+}
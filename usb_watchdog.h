@@ -70,6 +70,8 @@ private:
 
     bool timeout_handler();
 
+    void scan_input() override;
+
     sigc::connection _rescan_timer;
 
     void udisks_signal_dispatcher(
@@ -48,6 +48,9 @@
 #include "xml_helpers.h"
 #include "procedure_step_handler.h"
 #include "xml_result_timeout.h"
+#include "xml_result_parsed.h"
+#include "xml_result_internal_device_error.h"
+#include "task_envelope.h"
 #include "serial_helper.h"
 
 //---Forward declarations------------------------------------------------------
@@ -316,10 +319,26 @@ void UsbInterfaceHandler::emit_result( const Glib::ustring &result, int tid ) /*
 	return;
     }
 
-    lDebug("### emit result tid %d: %s\n", tid, result.c_str() );
-    transmitMessages.push(
-        std::make_pair(ustring::compose("<task tid=\"%1\">%2</task>", tid, result),
-                       tid));
+    emit_result_buffer( SharedBuffer(result), tid );
+}
+
+
+void UsbInterfaceHandler::emit_result_buffer( const SharedBuffer &result, int tid ) /* virtual */
+{
+    if (!_online) {
+	PRINT_DEBUG ("NOT online.. tried to send:");
+	PRINT_DEBUG (result.to_string ());
+	return;
+    }
+
+    SharedBuffer message( std::string(ustring::compose("<task tid=\"%1\">", tid).raw()) );
+
+    if( doInternLog( ELogLevelDebug ) )
+        lDebug("### emit result tid %d: %s\n", tid, result.to_string().c_str() );
+
+    message.append( result );
+    message.append( std::string("</task>") );
+    transmitMessages.push( std::make_pair(message, tid) );
     try {
 	sendLoop();
     } catch (Glib::Exception & e) {
@@ -333,39 +352,47 @@ void UsbInterfaceHandler::emit_result( const Glib::ustring &result, int tid ) /*
 ///
 ///         Does not handle any message fragmentation, counters, frame numbers.
 ///         It does the decimal/Ascii conversion and checksum generation.
-void UsbInterfaceHandler::sendFrame( const Glib::ustring *str )
+void UsbInterfaceHandler::sendFrame( const SharedBuffer &payload )
 {
-    gsize bytes_to_write = str->bytes();
-    guint32 size=htonl( bytes_to_write );
-
-    const char * send_str = str->c_str();
+    guint32 size=htonl( payload.size() );
     gsize bytes_written;
 
     lDebug("Sending frame via usb interface\n");
 
-    lHighDebug("Frame SND: payload_size=%d\n", bytes_to_write );
+    lHighDebug("Frame SND: payload_size=%d\n", (int)payload.size() );
 
     _iochannel->write((const char *)&size, sizeof(size), bytes_written);
     lHighDebug("Frame SND: wrote size. bytes_written=%d\n", (int)bytes_written );
 
-
-    while (bytes_to_write) {
-	Glib::IOStatus status = _iochannel->write (send_str, bytes_to_write, bytes_written);
-	lHighDebug("Frame SND: tried to write %d bytes, bytes_written=%d\n", (int) bytes_to_write, (int)bytes_written );
-
-	send_str += bytes_written;
-	bytes_to_write -= bytes_written;
-	if (status == Glib::IO_STATUS_ERROR) {
-	    lError ("Frame SND: error during write\n");
-	    break;
-	}
-	if (status == Glib::IO_STATUS_AGAIN) {
-	    _iochannel->flush();
+    /* the segments of the payload are written as they are
+     */
+    for (auto&& segment : payload.segments()) {
+	gsize segment_size = 0;
+	const char * segment_data = static_cast <const char *> (segment->get_data (segment_size));
+	const char * send_str = segment_data;
+	gsize bytes_to_write = segment_size;
+	Glib::IOStatus status = Glib::IO_STATUS_NORMAL;
+
+	while (bytes_to_write) {
+	    status = _iochannel->write (send_str, bytes_to_write, bytes_written);
+	    lHighDebug("Frame SND: tried to write %d bytes, bytes_written=%d\n", (int) bytes_to_write, (int)bytes_written );
+
+	    send_str += bytes_written;
+	    bytes_to_write -= bytes_written;
+	    if (status == Glib::IO_STATUS_ERROR) {
+		lError ("Frame SND: error during write\n");
+		break;
+	    }
+	    if (status == Glib::IO_STATUS_AGAIN) {
+		_iochannel->flush();
+	    }
 	}
-    }
+	if (status == Glib::IO_STATUS_ERROR)
+	    break;
 
-    if( doInternLog( ELogLevelHighDebug ) )
-        hexdump_mem( str->c_str(), str->size() );
+	if( doInternLog( ELogLevelHighDebug ) )
+	    hexdump_mem( segment_data, segment_size );
+    }
 
     _iochannel->flush();
     tcdrain (inputFileFd);
@@ -384,7 +411,7 @@ gboolean UsbInterfaceHandler::sendLoop()
 	auto&& msg = transmitMessages.front();
 	lHighDebug("Starting transmitting a new message\n");
 
-	sendFrame( &msg.first );
+	sendFrame( msg.first );
         if (is_sic_request(msg.second))
             request_sent.emit(msg.second);
 	transmitMessages.pop();
@@ -396,62 +423,45 @@ gboolean UsbInterfaceHandler::sendLoop()
 
 void UsbInterfaceHandler::emitMessage (const Glib::ustring &payload)
 {
-    std::stringstream ss;
-    xmlpp::Element *element;
-    xmlpp::DomParser parser;
-    int tid;
+    const std::string &raw = payload.raw ();
+    TaskEnvelope task;
 
     // Unfortunately we have to know if the message is an "request" or an
     // "respone" because they are handeled in different channels.
-
-    try {
-	parser.parse_memory( payload );
-    } catch (std::exception & e) {
-	PRINT_ERROR ("unable to parse message: " << e.what ());
-	return;
-
-    }
-    element=parser.get_document()->get_root_node();
-    if (!element) {
-	PRINT_ERROR ("no element at rootnode, aborting");
-	return;
-    }
-    assert(element);
-
-    if( element->get_name() != "task" ) {
+    // The <task> is only scanned, the wrapped element is parsed once by
+    // the channel it is handed to.
+    if (!TaskEnvelope::scan (raw.data (), raw.size (), task)) {
 	PRINT_ERROR ("Invalid message received, ignoring it");
         return;
     }
 
-    ss << element->get_attribute_value("tid");
-    ss >> tid;
-
-    element=dynamic_cast<xmlpp::Element *> ( element->get_first_child() );
+    if (task.kind == TaskEnvelope::FUNCTION) {
+        UStringIStream is_buf (raw.substr (task.offset, task.size));
+        std::istream is(&is_buf);
+        lDebug("Getting function for tid %d\n", task.tid);
+        request_ready.emit ( is, task.tid );
+    } else if (task.kind == TaskEnvelope::REPLY) {
+	PRINT_DEBUG ("Got a reply for tid " << task.tid);
 
-    if(!element)
-    {
-        lError( "Could not get child for task\n" );
-        return;
-    }
+	Glib::RefPtr <XmlResult> result;
+	try {
+	    result = XmlResultParsed::create (SharedBuffer (raw.substr (task.offset, task.size)));
+	} catch (std::exception & e) {
+	    PRINT_DEBUG ("unable to parse reply " << e.what ());
+	    result = XmlResultInternalDeviceError::create (e.what ());
+	}
 
-    if( element->get_name() == "function" ) {
-        UStringIStream is_buf ( element_to_string(element, 0, 0) );
-        std::istream is(&is_buf);
-        lDebug("Getting function: %s\n", element_to_string(element, 0, 0).c_str() );
-        request_ready.emit ( is, tid );
-    } else if( element->get_name() == "reply" ) {
-	PRINT_DEBUG ("Got a reply for tid " << tid);
 	try {
-	    response_ready.emit (element_to_string (element, 0, 0), tid);
-	    PRINT_DEBUG ("response emitted " << tid);
+	    response_ready.emit (result, task.tid);
+	    PRINT_DEBUG ("response emitted " << task.tid);
 	} catch (std::exception & e) {
 	    PRINT_DEBUG ("exception here " << e.what ());
 
 	    Glib::RefPtr <XmlResult> err_result=XmlResultInternalDeviceError::create (e.what ());
-	    response_ready.emit (err_result->to_xml (), tid);
+	    response_ready.emit (err_result, task.tid);
 	}
     } else {
-        lError("Unknown Message received: %s", element->get_name().c_str() );
+        lError("Unknown Message received: %s", task.name.c_str() );
     }
 
     return;
@@ -508,7 +518,7 @@ void UsbInterfaceHandler::sendMessage (const Glib::ustring &str, int tid)
 
     /* ok, we are online, do it
      */
-    transmitMessages.push (std::make_pair(str, tid));
+    transmitMessages.push (std::make_pair(SharedBuffer(str), tid));
 
     try {
 	PRINT_DEBUG ("### Going to send message:" << str.raw ());
@@ -543,7 +553,7 @@ UsbInterfaceHandler::reset_connection ()
      */
     PRINT_DEBUG ("Clearing TX Queue:");
     while (!transmitMessages.empty ()) {
-	PRINT_DEBUG ("TX queue content: " << transmitMessages.front ().first);
+	PRINT_DEBUG ("TX queue content: " << transmitMessages.front ().first.to_string ());
 	transmitMessages.pop ();
     }
 
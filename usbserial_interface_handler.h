@@ -73,7 +73,7 @@ class UsbInterfaceHandler:   public InterfaceHandler
         // receiveMessages are not necessary at the moment; we directly emit an
         // message when it arrives
         // std::queue < const Glib::ustring > receiveMessages;
-        std::queue < std::pair< Glib::ustring, int > > transmitMessages;
+        std::queue < std::pair< SharedBuffer, int > > transmitMessages;
 
         //Glib::RefPtr<CSerialMessage> senderMessage;
         //Glib::RefPtr<CSerialMessage> receiverMessage;
@@ -102,8 +102,9 @@ class UsbInterfaceHandler:   public InterfaceHandler
 
         void handleInputData(gchar *input, gsize size);
         virtual void emit_result (const Glib::ustring &result, int tid);
+        virtual void emit_result_buffer (const SharedBuffer &result, int tid);
         //void discardReceiveFrame();
-        void sendFrame( const Glib::ustring *str );
+        void sendFrame( const SharedBuffer &payload );
         int digestFrame();
         void discardReceiveFrame();
 
@@ -1,64 +1,201 @@
+#include <cstring>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#define USTRING_UTILS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define USTRING_UTILS_NEON 1
+#include <arm_neon.h>
+#endif
+
 #include "ustring_utils.h"
 
+/* All functions work on the UTF-8 bytes: the characters they look for are
+ * ASCII and ASCII bytes never occur inside a multibyte sequence, so the
+ * result is the same as iterating by code point.
+ */
+
+std::size_t UstringUtils::find_first_of(const char *data, std::size_t size, const char *set,
+                                        bool non_ascii)
+{
+    std::size_t set_size = strlen(set);
+    std::size_t i = 0;
+
+#if defined(USTRING_UTILS_SSE2)
+    __m128i needles[8];
+
+    for (std::size_t k = 0; k < set_size && k < 8; ++k)
+        needles[k] = _mm_set1_epi8(set[k]);
+
+    for (; set_size <= 8 && i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        int mask = non_ascii ? _mm_movemask_epi8(v) : 0;
+
+        for (std::size_t k = 0; k < set_size; ++k)
+            mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(v, needles[k]));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+#elif defined(USTRING_UTILS_NEON)
+    uint8x16_t needles[8];
+
+    for (std::size_t k = 0; k < set_size && k < 8; ++k)
+        needles[k] = vdupq_n_u8(set[k]);
+
+    for (; set_size <= 8 && i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+        uint8x16_t match = non_ascii ? vcgeq_u8(v, vdupq_n_u8(0x80)) : vdupq_n_u8(0);
+
+        for (std::size_t k = 0; k < set_size; ++k)
+            match = vorrq_u8(match, vceqq_u8(v, needles[k]));
+        // the position is found by the scalar loop below
+        if (vmaxvq_u8(match))
+            break;
+    }
+#endif
+
+    // ASCII bytes of set as bitmap
+    uint64_t bits[2] = { 0, 0 };
+    for (std::size_t k = 0; k < set_size; ++k) {
+        unsigned char c = set[k];
+        if (c < 0x80)
+            bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    for (; i < size; ++i) {
+        unsigned char c = data[i];
+
+        if (c >= 0x80) {
+            if (non_ascii)
+                return i;
+        } else if ((bits[c >> 6] >> (c & 63)) & 1) {
+            return i;
+        }
+    }
+
+    return size;
+}
+
 Glib::ustring UstringUtils::trim(const Glib::ustring& input)
 {
-    Glib::ustring result;
+    const std::string& in = input.raw();
+    const char *p = in.data(), *end = p + in.size();
+    std::string result;
+
+    // '\v' is no space for g_unichar_isspace()
+    static const char ascii_spaces[] = " \t\n\r\f";
 
-    result.reserve(input.size());
-    for (const auto& c : input)
-        if (!Glib::Unicode::isspace(c))
-            result.push_back(c);
+    std::size_t hit = find_first_of(p, end - p, ascii_spaces, true);
+    if (hit == in.size())
+        return input;
 
-    return result;
+    result.reserve(in.size());
+    while (p < end) {
+        hit = find_first_of(p, end - p, ascii_spaces, true);
+        result.append(p, hit);
+        p += hit;
+        if (p == end)
+            break;
+
+        if (static_cast<unsigned char>(*p) < 0x80) {
+            ++p;
+            continue;
+        }
+
+        // other whitespace is beyond ASCII, e.g. U+00A0 or U+3000
+        const char *next = g_utf8_next_char(p);
+        if (next > end)
+            next = end;
+        if (!Glib::Unicode::isspace(g_utf8_get_char(p)))
+            result.append(p, next - p);
+        p = next;
+    }
+
+    return Glib::ustring(result);
 }
 
 Glib::ustring UstringUtils::strip_newlines_and_tabs(const Glib::ustring& input)
 {
-    Glib::ustring result;
+    const std::string& in = input.raw();
+    const char *p = in.data(), *end = p + in.size();
+    std::string result;
 
-    // FIXME: utf8 support
-    result.reserve(input.size());
-    for (auto&& c : input) {
-        if (c == '\n' || c == '\t')
-            continue;
-        result.push_back(c);
+    std::size_t hit = find_first_of(p, end - p, "\n\t");
+    if (hit == in.size())
+        return input;
+
+    result.reserve(in.size());
+    while (p < end) {
+        hit = find_first_of(p, end - p, "\n\t");
+        result.append(p, hit);
+        p += hit + (p + hit < end);
     }
 
-    return result;
+    return Glib::ustring(result);
 }
 
 Glib::ustring UstringUtils::condense_spaces(const Glib::ustring& input)
 {
-    Glib::ustring result;
+    const std::string& in = input.raw();
+    const char *p = in.data(), *end = p + in.size();
 
-    // FIXME: utf8 support
-    result.reserve(input.size());
-    gunichar e = 0;
-    for (auto&& c : input) {
-        if (e == ' ' && c == ' ')
-            continue;
-        result.push_back(c);
-        e = c;
+    if (in.find("  ") == std::string::npos)
+        return input;
+
+    std::string result;
+
+    result.reserve(in.size());
+    while (p < end) {
+        const char *space = static_cast<const char *>(memchr(p, ' ', end - p));
+
+        if (!space) {
+            result.append(p, end - p);
+            break;
+        }
+
+        // keep the first space of a run
+        result.append(p, space + 1 - p);
+        for (p = space + 1; p < end && *p == ' '; ++p)
+            ;
     }
 
-    return result;
+    return Glib::ustring(result);
 }
 
 Glib::ustring UstringUtils::remove_indent_from_lines(const Glib::ustring& input)
 {
-    Glib::ustring result;
+    const std::string& in = input.raw();
+    const char *p = in.data(), *end = p + in.size();
+    std::string result;
     bool erase = true;
 
-    result.reserve(input.size());
-    for (const auto& c : input) {
-        if (c == '\n')
-            erase = true;
-        if (erase && (c == ' ' || c == '\t'))
-            continue;
-        if (c != ' ' && c != '\n')
+    result.reserve(in.size());
+    while (p < end) {
+        if (erase) {
+            // spaces and tabs at the start of a line, empty lines are kept
+            while (p < end && (*p == ' ' || *p == '\t'))
+                ++p;
+            if (p == end)
+                break;
+            if (*p == '\n') {
+                result.push_back('\n');
+                ++p;
+                continue;
+            }
             erase = false;
-        result.push_back(c);
+        }
+
+        const char *newline = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!newline) {
+            result.append(p, end - p);
+            break;
+        }
+
+        result.append(p, newline + 1 - p);
+        p = newline + 1;
+        erase = true;
     }
 
-    return result;
+    return Glib::ustring(result);
 }
@@ -1,6 +1,8 @@
 #ifndef _USTRING_UTILS_H_
 #define _USTRING_UTILS_H_
 
+#include <cstddef>
+
 #include <glibmm/ustring.h>
 
 class UstringUtils
@@ -14,6 +16,14 @@ public:
 
     static Glib::ustring remove_indent_from_lines(const Glib::ustring& input);
 
+    /**
+     * Offset of the first byte in data which is one of the ASCII
+     * characters in set, or any byte >= 0x80 if non_ascii is set. size if
+     * there is none. Lets callers copy unchanged runs of UTF-8 at once.
+     */
+    static std::size_t find_first_of(const char *data, std::size_t size, const char *set,
+                                     bool non_ascii = false);
+
 private:
     UstringUtils()
     {}
@@ -1,7 +1,13 @@
 #include <regex>
 #include <sstream>
-#include <fstream>
 #include <algorithm>
+#include <ctime>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <glibmm/main.h>
+#include <giomm/file.h>
 
 #include "conf_handler.h"
 #include "file_handler.h"
@@ -16,7 +22,28 @@ Watchdog::Watchdog (const std::string& resource, const std::string& input, bool
     , _in_progress{false}
     , _resource{resource}
     , _input_folder{input}
-{}
+    , _dirty{false}
+    , _scan_scheduled{false}
+    , _pattern_valid{false}
+{
+    ConfHandler::get_instance()->confChangeAnnounce.connect(
+        sigc::mem_fun(*this, &Watchdog::on_config_changed_announce));
+}
+
+void Watchdog::on_config_changed_announce(const Glib::ustring& par_id,
+                                          const Glib::ustring& value,
+                                          int& handler_mask)
+{
+    UNUSED(value);
+    UNUSED(handler_mask);
+
+    if (par_id == "instrumentCode" ||
+        par_id == "serialnumber" ||
+        par_id == "all") {
+        _pattern_valid = false;
+        _unchanged_dirs.clear();
+    }
+}
 
 Watchdog::InputProcessorList Watchdog::get_input_processors() const
 {
@@ -36,14 +63,34 @@ std::string Watchdog::build_regex_pattern() const
     return ss.str();
 }
 
+const std::regex& Watchdog::get_pattern() const
+{
+    if (!_pattern_valid) {
+        _pattern_re = std::regex(build_regex_pattern());
+        _pattern_valid = true;
+    }
+
+    return _pattern_re;
+}
+
 Watchdog::LanFolderList Watchdog::create_file_list(const std::string& folder) const
 {
     LanFolderList result;
+    struct stat sb;
+    gint64 mtime = -1;
+
+    // skip directories which did not change since they were found empty
+    if (!stat(folder.c_str(), &sb)) {
+        mtime = gint64(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec;
+        auto it = _unchanged_dirs.find(folder);
+        if (it != _unchanged_dirs.end() && it->second == mtime)
+            return result;
+    }
 
     auto files = FileHandler::list_directory(folder);
+    const auto& re = get_pattern();
 
     for (auto&& file : files) {
-        std::regex re(build_regex_pattern());
         std::smatch match;
 
         if (!std::regex_match(file, match, re))
@@ -52,6 +99,13 @@ Watchdog::LanFolderList Watchdog::create_file_list(const std::string& folder) co
         result.emplace_back(file, folder + "/" + file, match[3], match[2], match[1]);
     }
 
+    // Only trust the mtime if it is not too recent: a file created within
+    // the timestamp granularity of the last listing would be missed.
+    if (result.empty() && mtime >= 0 && sb.st_mtim.tv_sec + 2 < time(nullptr))
+        _unchanged_dirs[folder] = mtime;
+    else
+        _unchanged_dirs.erase(folder);
+
     return result;
 }
 
@@ -99,42 +153,72 @@ std::string Watchdog::get_log_folder() const
     return usb_log_folder[0].path();
 }
 
-void Watchdog::forward_entry_to_zix(const LanFolderEntry& entry)
+static bool is_zix_entry(const LanFolderEntry& entry)
 {
-    auto file_service = FileService::get_instance();
-
-    std::ifstream ifs(entry.path);
-    if (!ifs.good()) {
-        PRINT_ERROR("Failed to open file " << entry.path);
-        return;
-    }
-
-    std::string content, line;
-    while (std::getline(ifs, line))
-    {
-        content += line;
-        content += "\n";
-    }
+    return entry.pattern == "_zix.xml" || entry.pattern == "_zix.XML";
+}
 
-    if (ifs.bad()) {
-        PRINT_ERROR("Failed to read line from file " << entry.path);
-        return;
-    }
+void Watchdog::forward_batch_to_zix()
+{
+    IngestBatchRequest::EntryList entries;
 
-    // send xml content to ZIX queue
+    // collect the consecutive batch files starting at the current one, the
+    // list is sorted, so the order of execution is kept
+    _batch_end = _folder_it;
     try {
-        auto out_path = this->get_root_folder() + "/" + get_log_folder() + "/" +
-            get_log_file_name(entry);
+        auto log_path = this->get_root_folder() + "/" + get_log_folder() + "/";
 
-        file_service->new_file_content.emit(this->get_zix_interface(),
-                                            entry.path, content, out_path);
+        while (_batch_end != _folder_list.cend() && is_zix_entry(*_batch_end) &&
+               entries.size() < MAX_BATCH_SIZE) {
+            entries.emplace_back(_batch_end->path, log_path + get_log_file_name(*_batch_end));
+            ++_batch_end;
+        }
     } catch (const std::exception& ex) {
         PRINT_ERROR(ex.what());
+        next();
         return;
     }
 
-    // move/copy immediatley after reading
-    move_or_copy_xml_to_log_dir(entry);
+    _ingest_req = IngestBatchRequest::create(entries);
+    _ingest_req->finished.connect(
+        sigc::mem_fun(*this, &Watchdog::on_ingest_ready));
+    _ingest_req->start_read();
+}
+
+void Watchdog::on_ingest_ready(const Glib::RefPtr<IngestBatchResult>& result)
+{
+    auto file_service = FileService::get_instance();
+    IngestBatchResult::EntryList entries;
+
+    for (auto&& entry : result->entries()) {
+        if (entry.read_failed) {
+            PRINT_ERROR(entry.error);
+            continue;
+        }
+        entries.push_back(entry);
+    }
+
+    // send xml documents to ZIX queue
+    if (!entries.empty())
+        file_service->new_request_batch.emit(this->get_zix_interface(), entries);
+
+    // the request is still emitting `finished`, release it when idle,
+    // next() may already start the next one
+    _done_ingest_req = _ingest_req;
+    _ingest_req.reset();
+    Glib::signal_idle().connect_once(
+        sigc::mem_fun(*this, &Watchdog::release_done_ingest_req));
+
+    // move/copy immediatley after reading, the last one is handled by next()
+    for (; _folder_it + 1 != _batch_end; ++_folder_it)
+        move_or_copy_xml_to_log_dir(*_folder_it);
+
+    next();
+}
+
+void Watchdog::release_done_ingest_req()
+{
+    _done_ingest_req.reset();
 }
 
 void Watchdog::forward_entry_to_ip(const LanFolderEntry& entry, const InputProcessor& ip)
@@ -198,17 +282,108 @@ void Watchdog::next()
 
     // done
     _in_progress = false;
+
+    // changes arrived while we were busy?
+    if (_dirty)
+        schedule_scan();
+}
+
+bool Watchdog::watch_folder(const std::string& folder)
+{
+    // inotify does not see changes done by other CIFS clients
+    if (FileHandler::is_remote_filesystem(folder)) {
+        PRINT_DEBUG("Watchdog: " << folder << " is a network share, polling");
+        return false;
+    }
+
+    try {
+        auto monitor = Gio::File::create_for_path(folder)->monitor_directory();
+        monitor->signal_changed().connect(
+            sigc::mem_fun(*this, &Watchdog::on_folder_changed));
+        _monitors.push_back(monitor);
+        _watched_folders.push_back(folder);
+    } catch (const Glib::Error& ex) {
+        PRINT_WARNING("Failed to monitor " << folder << ", polling: " << ex.what());
+        return false;
+    }
+
+    PRINT_DEBUG("Watchdog: monitoring " << folder);
+    return true;
+}
+
+void Watchdog::unwatch_folders()
+{
+    for (auto&& monitor : _monitors)
+        monitor->cancel();
+    _monitors.clear();
+    _watched_folders.clear();
+}
+
+void Watchdog::schedule_scan()
+{
+    if (_scan_scheduled)
+        return;
+
+    // collect bursts of events (e.g. many files dropped at once)
+    _scan_scheduled = true;
+    Glib::signal_timeout().connect_once(
+        sigc::mem_fun(*this, &Watchdog::on_scan_timeout), 500);
+}
+
+void Watchdog::on_scan_timeout()
+{
+    _scan_scheduled = false;
+
+    if (!_activated)
+        return;
+
+    if (_in_progress) {
+        _dirty = true;
+        return;
+    }
+
+    _dirty = false;
+    scan_input();
+}
+
+void Watchdog::on_folder_changed(const Glib::RefPtr<Gio::File>& file,
+                                 const Glib::RefPtr<Gio::File>& other,
+                                 Gio::FileMonitorEvent event)
+{
+    UNUSED(other);
+
+    switch (event) {
+    case Gio::FILE_MONITOR_EVENT_CREATED:
+    case Gio::FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case Gio::FILE_MONITOR_EVENT_MOVED:
+        PRINT_DEBUG("Watchdog: change in " << file->get_path());
+        _unchanged_dirs.erase(file->get_parent()->get_path());
+        schedule_scan();
+        break;
+    case Gio::FILE_MONITOR_EVENT_DELETED:
+    case Gio::FILE_MONITOR_EVENT_UNMOUNTED:
+        // a watched folder itself might be gone, start over by polling
+        for (auto&& folder : _watched_folders) {
+            if (event == Gio::FILE_MONITOR_EVENT_UNMOUNTED ||
+                !FileHandler::directory_exists(folder)) {
+                PRINT_DEBUG("Watchdog: monitored folder " << folder << " vanished");
+                unwatch_folders();
+                break;
+            }
+        }
+        break;
+    default:
+        break;
+    }
 }
 
 void Watchdog::process_entry(const LanFolderEntry& entry)
 {
     PRINT_DEBUG ("Watchdog::process_entry seeing entry.pattern=" << entry.pattern);
 
-    // batch file
-    if (entry.pattern == "_zix.xml" ||
-        entry.pattern == "_zix.XML") {
-        forward_entry_to_zix(entry);
-        next();
+    // batch file(s)
+    if (is_zix_entry(entry)) {
+        forward_batch_to_zix();
         return;
     }
 
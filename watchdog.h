@@ -4,9 +4,12 @@
 #include <glibmm/object.h>
 #include <glibmm/refptr.h>
 #include <glibmm/ustring.h>
+#include <giomm/filemonitor.h>
 
 #include <string>
 #include <vector>
+#include <map>
+#include <regex>
 
 #include "lan_folder_entry.h"
 #include "input_processor.h"
@@ -14,6 +17,8 @@
 #include "process_result.h"
 #include "zix_interface.h"
 #include "file_destination.h"
+#include "ingest_batch_request.h"
+#include "ingest_batch_result.h"
 
 /**
  * \brief Base class for WatchDogs.
@@ -26,6 +31,7 @@ public:
     using LanFolderList = std::vector<LanFolderEntry>;
     using InputProcessorList = std::vector<InputProcessor>;
     using RefPtr = Glib::RefPtr<Watchdog>;
+    using MonitorList = std::vector<Glib::RefPtr<Gio::FileMonitor> >;
 
     Watchdog(const std::string& resource, const std::string& input, bool activate = true);
 
@@ -60,8 +66,26 @@ protected:
     LanFolderList _folder_list;
     LanFolderList::const_iterator _folder_it;
     Glib::RefPtr<ProcessRequest> _ip_proc;
+    Glib::RefPtr<IngestBatchRequest> _ingest_req;
+    // finished request, released when idle as it is still emitting
+    Glib::RefPtr<IngestBatchRequest> _done_ingest_req;
+    LanFolderList::const_iterator _batch_end;
+
+    // change detection: monitors on local filesystems, polling otherwise
+    MonitorList _monitors;
+    std::vector<std::string> _watched_folders;
+    bool _dirty;
+    bool _scan_scheduled;
+
+    // file name pattern, rebuilt when instrumentCode/serialnumber change
+    mutable std::regex _pattern_re;
+    mutable bool _pattern_valid;
+
+    // directories whose last scan found nothing, by mtime in ns
+    mutable std::map<std::string, gint64> _unchanged_dirs;
 
     std::string build_regex_pattern() const;
+    const std::regex& get_pattern() const;
     std::string get_log_file_name(const LanFolderEntry& entry) const;
     InputProcessorList get_input_processors() const;
 
@@ -71,13 +95,44 @@ protected:
     std::string get_log_folder() const;
 
     void move_or_copy_xml_to_log_dir(const LanFolderEntry& entry);
-    void forward_entry_to_zix(const LanFolderEntry& entry);
+    void forward_batch_to_zix();
     void forward_entry_to_ip(const LanFolderEntry& entry, const InputProcessor& ip);
     void process_entry(const LanFolderEntry& entry);
     void next();
 
     void on_ip_proc_ready(const Glib::RefPtr<ProcessResult>& result);
+    void on_ingest_ready(const Glib::RefPtr<IngestBatchResult>& result);
+    void release_done_ingest_req();
+
+    /**
+     * Maximum number of request files read/parsed in one go.
+     */
+    static const std::size_t MAX_BATCH_SIZE = 256;
+
+    /**
+     * Install a directory monitor for folder. Changes will trigger
+     * scan_input().
+     *
+     * @param folder directory to watch
+     *
+     * @return false, if the filesystem does not deliver change events (CIFS)
+     *         and the caller has to keep polling
+     */
+    bool watch_folder(const std::string& folder);
+    void unwatch_folders();
+    void schedule_scan();
+    void on_scan_timeout();
 
+    void on_folder_changed(const Glib::RefPtr<Gio::File>& file,
+                           const Glib::RefPtr<Gio::File>& other,
+                           Gio::FileMonitorEvent event);
+    void on_config_changed_announce(const Glib::ustring& par_id,
+                                    const Glib::ustring& value, int& handler_mask);
+
+    /**
+     * Scan the input folder(s) and process new entries.
+     */
+    virtual void scan_input() = 0;
     /**
      * Each watchdog should have a ZiXInterface assigned to it.
      */
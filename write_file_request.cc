@@ -1,7 +1,7 @@
 #include "write_file_request.h"
 
 Glib::RefPtr<WriteFileRequest>
-WriteFileRequest::create(const std::string& path, const std::string& content)
+WriteFileRequest::create(const std::string& path, const SharedBuffer& content)
 {
     return Glib::RefPtr<WriteFileRequest>(new WriteFileRequest(path, content));
 }
@@ -11,8 +11,8 @@ void WriteFileRequest::start_write()
     std::string etag;
 
     _file = Gio::File::create_for_path(_path);
-    _file->replace_contents_async(
-        sigc::mem_fun(*this, &WriteFileRequest::on_async_ready), _content, etag,
+    _file->replace_contents_bytes_async(
+        sigc::mem_fun(*this, &WriteFileRequest::on_async_ready), _content.bytes(), etag,
         false, Gio::FILE_CREATE_NONE);
 }
 
@@ -11,20 +11,22 @@
 #include <sigc++/signal.h>
 
 #include "write_file_result.h"
+#include "shared_buffer.h"
 
 /**
  * This class be used to write a complete file async. The end of the operation
- * will be channeled by the `finish` signal.
+ * will be channeled by the `finish` signal. The content is referenced, not
+ * copied, while it is written.
  */
 class WriteFileRequest : public Glib::Object
 {
 public:
-    WriteFileRequest(const std::string& path, const std::string& content) :
+    WriteFileRequest(const std::string& path, const SharedBuffer& content) :
         _path(path), _content(content)
     {}
 
     static Glib::RefPtr<WriteFileRequest>
-    create(const std::string& path, const std::string& content);
+    create(const std::string& path, const SharedBuffer& content);
 
     void start_write();
 
@@ -33,7 +35,7 @@ public:
 private:
     Glib::RefPtr<Gio::File> _file;
     std::string _path;
-    std::string _content;
+    SharedBuffer _content;
 
     void on_async_ready(const Glib::RefPtr<Gio::AsyncResult>& result);
 };
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include <cassert>
 
 #include "xml_file.h"
@@ -6,6 +7,9 @@
 
 XmlFile::XmlFile (const xmlpp::Element *en)
     : XmlParameter ("file", "file")
+    , _has_attachment (false)
+    , _attachment_offset (0)
+    , _attachment_size (0)
 {
     assert (en);
     assert (en->get_name() == "file");
@@ -14,6 +18,17 @@ XmlFile::XmlFile (const xmlpp::Element *en)
     _host    = en->get_attribute_value("host");
     _type    = en->get_attribute_value("type");
     _content = xml_element_pure_text(en);
+
+    for (auto&& node : en->get_children("attachment")) {
+        auto attachment = dynamic_cast<const xmlpp::Element *>(node);
+        if (!attachment)
+            continue;
+
+        // throws std::invalid_argument for garbage
+        _attachment_offset = std::stoull(attachment->get_attribute_value("offset"));
+        _attachment_size   = std::stoull(attachment->get_attribute_value("size"));
+        _has_attachment    = true;
+    }
 }
 
 XmlFile::~XmlFile ()
@@ -44,6 +59,9 @@ XmlFile::dump ()
     std::cout << "_id: "      << _id      << std::endl;
     std::cout << "_type: "    << _type    << std::endl;
     std::cout << "_content: " << _content << std::endl;
+    if (_has_attachment)
+        std::cout << "_attachment: " << _attachment_offset << "+"
+                  << _attachment_size << std::endl;
 }
 
 Glib::ustring
@@ -60,6 +78,9 @@ XmlFile::to_xml () const
         ret += Glib::ustring::compose("type=\"%1\" ", _type);
     if (!_content.empty())
         ret += Glib::ustring::compose(">\n%1</file>\n", _content);
+    else if (_has_attachment)
+        ret += Glib::ustring::compose(">\n<attachment offset=\"%1\" size=\"%2\"/>\n</file>\n",
+                                      _attachment_offset, _attachment_size);
     else
         ret += "/>\n";
 
@@ -4,18 +4,23 @@
 
 #include <glibmm/ustring.h>
 
+#include <cstddef>
+
 #include "xml_parameter.h"
 
 /**
  * \brief XmlParameter representing <file> argument.
  *
- * File may contain a host and id.
+ * File may contain a host and id. Instead of base64 encoded content, the
+ * file may refer to a range of the binary request attachment with an
+ * <attachment offset="..." size="..."/> child element.
  */
 class XmlFile : public XmlParameter
 {
 public:
     XmlFile(const Glib::ustring& id, const Glib::ustring& host) :
-        XmlParameter("file", "file"), _id{id}, _host{host}
+        XmlParameter("file", "file"), _id{id}, _host{host},
+        _has_attachment{false}, _attachment_offset{0}, _attachment_size{0}
     {}
 
     XmlFile(const xmlpp::Element *en);
@@ -66,6 +71,21 @@ public:
         return _content;
     }
 
+    inline bool has_attachment() const
+    {
+        return _has_attachment;
+    }
+
+    inline std::size_t get_attachment_offset() const
+    {
+        return _attachment_offset;
+    }
+
+    inline std::size_t get_attachment_size() const
+    {
+        return _attachment_size;
+    }
+
 	void dump ();
 
 	Glib::ustring to_xml () const;
@@ -76,6 +96,9 @@ private:
     Glib::ustring _host;
     Glib::ustring _type;
     Glib::ustring _content;
+    bool _has_attachment;
+    std::size_t _attachment_offset;
+    std::size_t _attachment_size;
 };
 
 #endif /* _XML_FILE_H_ */
@@ -12,80 +12,53 @@
 #include "utils.h"
 
 #include "core_function_call.h"
-#include "function_call_sigcheck.h"
-#include "function_call_restricted.h"
+#include "function_call_checked.h"
 #include "signature_check_request.h"
 #include "restriction_check_request.h"
-#include "accessibility_checker.h"
-
-const XmlFunction::PrioMap XmlFunction::prio_map = {
-    { "log", 0 },
-    { "getFilesList", 1 },
-    { "delFile", 1 },
-    { "getFile", 1 },
-    { "setFile", 1 },
-    { "getConf", 3 },
-    { "setConf", 3 },
-    { "dataSync", 2 },
-    { "dataOut", 1 },
-    { "dataFree", 1 },
-    { "getMeasurement", 1 },
-    { "dataIn", 1 },
-    { "getMeasurementList", 1 },
-    { "getCalibration", 1 },
-    { "getDefaults", 1 },
-    { "getProfilesList", 1 },
-    { "getProfile", 1 },
-    { "getParametersList", 1 },
-    { "getParameter", 1 },
-    { "getTemplatesList", 1 },
-    { "getTemplate", 1 },
-    { "setMeasurementsList", 1 },
-    { "setMeasurement", 1 },
-    { "setCalibration", 1 },
-    { "setDefaults", 1 },
-    { "setProfilesList", 1 },
-    { "setProfile", 1 },
-    { "setParameter", 1 },
-    { "setTemplatesList", 1 },
-    { "setTemplate", 1 },
-    { "delMeasurement", 1 },
-    { "delProfile", 1 },
-    { "delTemplate", 1 },
-    { "guiIO", 3 },
-    { "procedure", 1 },
-};
 
 XmlFunction::XmlFunction (const xmlpp::Element *elem,
                           const Glib::ustring &interface,
                           const Glib::ustring &filename)
     : XmlParameter ("function", "function")
     , _elem (elem)
+    , _function (FunctionRegistry::UNKNOWN)
     , _interface (interface)
     , _filename (filename)
+    , _binary_replies (false)
 {
     assert (elem->get_name() == "function");
 
-    for (auto attr : elem->get_attributes())
+    const auto attributes = elem->get_attributes ();
+    const auto children = elem->get_children ();
+
+    /* one allocation for all parameters
+     */
+    _parameters.reserve (attributes.size () + children.size ());
+
+    for (auto attr : attributes)
     {
-	if (attr->get_name () == "fid") {
+	const Glib::ustring name = attr->get_name ();
+
+	if (name == "fid") {
 	    _fid = attr->get_value ();
-	} else if (attr->get_name () == "src") {
+	} else if (name == "src") {
 	    _src = attr->get_value ();
-            _parameters.add_str_param (attr->get_name (), _src);
-	} else if (attr->get_name () == "dest") {
+            _parameters.add_str_param (name, _src);
+	} else if (name == "dest") {
 	    _dest = attr->get_value ();
         /*
          * dest has a different meaning for dataOut. That's why
          * dest has to be added to _parameters as well.
          */
-        _parameters.add_str_param (attr->get_name (), _dest);
+        _parameters.add_str_param (name, _dest);
 	} else {
-	    _parameters.add_str_param (attr->get_name (), attr->get_value ());
+	    _parameters.add_str_param (name, attr->get_value ());
 	}
     }
 
-    for (auto c : elem->get_children ())
+    _function = FunctionRegistry::lookup (_fid);
+
+    for (auto c : children)
     {
 	const xmlpp::Element *en = dynamic_cast <xmlpp::Element *> (c);
 	const xmlpp::TextNode *tn = dynamic_cast <xmlpp::TextNode *> (c);
@@ -181,21 +154,27 @@ XmlFunction::create_call (bool sig_check)
 
     /* do access check first
      */
-    if (!AccessibilityChecker().can_be_accessed(_interface, _fid)) {
+    if (!FunctionRegistry::can_be_accessed (_function, _interface)) {
 	throw XmlExceptionNoAccess (_fid, _interface);
     }
 
     /* Create the function call
      */
     auto call = CoreFunctionCall::create (_fid,
+					  _function,
 					  _parameters,
 					  _description,
 					  _textbody,
 					  wrappo,
 					  _interface,
-                                          _filename);
+                                          _filename,
+					  _attachment,
+					  _binary_replies);
 
-    /* maybe wrap in signature check
+    Glib::RefPtr <SignatureCheckRequest> scr;
+    Glib::RefPtr <RestrictionCheckRequest> rcr;
+
+    /* maybe check signature
      */
     if (sig_check) {
 	Glib::ustring sig;
@@ -204,19 +183,23 @@ XmlFunction::create_call (bool sig_check)
 	    sig = _signature->signature ();
 	}
 
-	auto scr = SignatureCheckRequest::create (sig,
-						  _interface,
-						  _fid,
-						  _elem);
-
-	call = FunctionCallSigCheck::create (call, scr, _interface);
+	scr = SignatureCheckRequest::create (sig,
+					     _interface,
+					     _function,
+					     _elem);
     }
 
-    /* maybe wrap in restriction check
+    /* maybe check restrictions
      */
     if (_restrictions.size () > 0) {
-	auto rcr = RestrictionCheckRequest::create (_restrictions, _fid);
-	call = FunctionCallRestricted::create (call, rcr, _interface);
+	rcr = RestrictionCheckRequest::create (_restrictions, _fid, _function);
+    }
+
+    /* both checks run concurrently, the call is
+     * started when they passed
+     */
+    if (scr || rcr) {
+	call = FunctionCallChecked::create (call, scr, rcr, _interface);
     }
 
     return call;
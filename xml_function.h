@@ -8,6 +8,7 @@
 
 #include <glibmm/ustring.h>
 #include <glibmm/refptr.h>
+#include <glibmm/bytes.h>
 
 #include <libxml++/nodes/element.h>
 
@@ -18,6 +19,7 @@
 #include "xml_signature.h"
 
 #include "function_call.h"
+#include "function_registry.h"
 
 /**
  * \bruief represents a function in xml
@@ -33,7 +35,6 @@ class XmlFunction : public XmlParameter
 {
 public:
     using XmlRestrictionList = std::vector<Glib::RefPtr<XmlRestriction> >;
-    using PrioMap            = std::map<Glib::ustring, int>;
 
     XmlFunction (const xmlpp::Element *en, const Glib::ustring & interface,
                  const Glib::ustring & filename);
@@ -56,6 +57,16 @@ public:
      */
     Glib::RefPtr <FunctionCall> create_call(bool sig_check);
 
+    /**
+     * Binary attachment passed on to the CoreFunctionCall, see
+     * CoreFunctionCall::set_attachment.
+     */
+    void set_attachment(const Glib::RefPtr<Glib::Bytes>& attachment, bool binary_replies)
+    {
+        _attachment = attachment;
+        _binary_replies = binary_replies;
+    }
+
     const Glib::ustring & get_fid () const { return _fid; }
     const Glib::ustring & get_dest () const { return _dest; }
     const Glib::ustring & get_body () const { return _textbody; }
@@ -64,7 +75,7 @@ public:
         return _description;
     }
 
-    const XmlParameterList get_params () const { return _parameters; }
+    const XmlParameterList & get_params () const { return _parameters; }
 
     const XmlRestrictionList& restrictions() const
     {
@@ -85,18 +96,14 @@ public:
 
     int prio() const noexcept
     {
-        auto it = prio_map.find(_fid);
-        if (it == prio_map.end())
-            return 0;
-        return it->second;
+        return FunctionRegistry::prio(_function);
     }
 
 private:
-    static const PrioMap prio_map;
-
     xmlpp::DomParser _file_parser;
     const xmlpp::Element * _elem;
     Glib::ustring _fid;
+    FunctionRegistry::Id _function;
     XmlParameterList _parameters;
     Glib::RefPtr<XmlDescription> _description;
     XmlRestrictionList _restrictions;
@@ -110,6 +117,9 @@ private:
 
     Glib::ustring _filename;
 
+    Glib::RefPtr<Glib::Bytes> _attachment;
+    bool _binary_replies;
+
     void parse_description (xmlpp::Element *en);
     void parse_arg (xmlpp::Element *en);
 
@@ -2,6 +2,7 @@
 #include "xml_helpers.h"
 
 #include "utils.h"
+#include "ustring_utils.h"
 
 #include <libxml++/nodes/element.h>
 #include <libxml++/nodes/contentnode.h>
@@ -25,13 +26,17 @@ xml_element_pure_text (const xmlpp::Element *en)
     return cn->get_content ();
 }
 
-Glib::ustring
-doc_to_string (xmlpp::Document *doc, int format)
+/* serialized doc, to be released with xmlFree ()
+ */
+static xmlChar *
+save_doc (xmlpp::Document *doc, int format, int *size)
 {
     int save_flag = XML_SAVE_NO_DECL;
-    Glib::ustring ret;
+    xmlChar *ret;
     int err;
 
+    *size = 0;
+
     xmlBufferPtr buffer = xmlBufferCreate();
 
     if (format)
@@ -41,6 +46,7 @@ doc_to_string (xmlpp::Document *doc, int format)
     if (save_ctx == 0) {
 	PRINT_ERROR ("doc_to_string: xmlSaveToBuffer returns error");
 	xmlBufferFree (buffer);
+	return nullptr;
     }
 
     err = xmlSaveDoc (save_ctx, doc->cobj ());
@@ -48,25 +54,57 @@ doc_to_string (xmlpp::Document *doc, int format)
 	PRINT_ERROR ("doc_to_string: xmlSaveDoc returns error");
 	xmlSaveClose (save_ctx);
 	xmlBufferFree (buffer);
-	return ret;
+	return nullptr;
     }
 
     err = xmlSaveClose (save_ctx);
     if (err == -1) {
 	PRINT_ERROR ("doc_to_string: xmlSaveClose returns error");
 	xmlBufferFree (buffer);
-	return ret;
+	return nullptr;
     }
 
-    if (buffer->use) {
-	ret=Glib::ustring (reinterpret_cast <const char *> (buffer->content),
-		           reinterpret_cast <const char *> (buffer->content + buffer->use));
-    }
+    *size = buffer->use;
+    ret = xmlBufferDetach (buffer);
 
     xmlBufferFree (buffer);
     return ret;
 }
 
+Glib::ustring
+doc_to_string (xmlpp::Document *doc, int format)
+{
+    Glib::ustring ret;
+    int size;
+
+    xmlChar *content = save_doc (doc, format, &size);
+
+    if (size) {
+	ret=Glib::ustring (reinterpret_cast <const char *> (content),
+		           reinterpret_cast <const char *> (content + size));
+    }
+
+    xmlFree (content);
+    return ret;
+}
+
+static SharedBuffer
+doc_to_buffer (xmlpp::Document *doc, int format)
+{
+    int size;
+
+    /* the buffer of libxml is handed over, not copied
+     */
+    xmlChar *content = save_doc (doc, format, &size);
+
+    if (!size) {
+	xmlFree (content);
+	return SharedBuffer ();
+    }
+
+    return SharedBuffer (Glib::wrap (g_bytes_new_with_free_func (content, size, xmlFree, content)));
+}
+
 Glib::ustring
 element_to_string_no_recurse (const xmlpp::Element *element)
 {
@@ -122,6 +160,16 @@ element_to_string (const xmlpp::Element *element, int indent, int format)
     return doc_to_string (&doc, format);
 }
 
+SharedBuffer
+element_to_buffer (const xmlpp::Element *element, int format)
+{
+    xmlpp::Document doc;
+
+    doc.create_root_node_by_import (element);
+
+    return doc_to_buffer (&doc, format);
+}
+
 Glib::ustring
 node_to_string (const xmlpp::Node *node, int indent, int format)
 {
@@ -137,17 +185,31 @@ node_to_string (const xmlpp::Node *node, int indent, int format)
 Glib::ustring
 xml_escape (const Glib::ustring & raw)
 {
-    Glib::ustring ret;
-
-    for (auto ch : raw) {
-	switch (ch) {
+    const std::string & in = raw.raw ();
+    const char *p = in.data (), *end = p + in.size ();
+    std::string ret;
+
+    /* the escaped characters are ASCII, copy everything else bytewise
+     */
+    std::size_t hit = UstringUtils::find_first_of (p, end - p, "&'\"<>");
+    if (hit == in.size ())
+	return raw;
+
+    ret.reserve (in.size () + in.size () / 8);
+    while (p < end) {
+	hit = UstringUtils::find_first_of (p, end - p, "&'\"<>");
+	ret.append (p, hit);
+	p += hit;
+	if (p == end)
+	    break;
+
+	switch (*p++) {
 	    case '&':  ret.append ("&amp;"); break;
 	    case '\'': ret.append ("&apos;"); break;
 	    case '"':  ret.append ("&quot;"); break;
 	    case '<':  ret.append ("&lt;"); break;
 	    case '>':  ret.append ("&gt;"); break;
-	    default:   ret.push_back (ch); break;
 	}
     }
-    return ret;
+    return Glib::ustring (ret);
 }
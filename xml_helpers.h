@@ -6,6 +6,8 @@
 
 #include <libxml++/nodes/element.h>
 
+#include "shared_buffer.h"
+
 /**
  * \brief check whether xmlpp::Element only contains Text
  *
@@ -24,6 +26,12 @@ element_to_string_recurse_one (const xmlpp::Element *element);
 Glib::ustring
 element_to_string (const xmlpp::Element *element, int indent, int format);
 
+/**
+ * \brief like element_to_string, but the serialized element is not copied
+ */
+SharedBuffer
+element_to_buffer (const xmlpp::Element *element, int format);
+
 Glib::ustring
 node_to_string (const xmlpp::Node *element, int indent, int format);
 
@@ -14,7 +14,7 @@ XmlMeasurement::XmlMeasurement (const xmlpp::Element *en)
     _iid     = en->get_attribute_value("iid");
     _format  = en->get_attribute_value("format");
     _type    = en->get_attribute_value("type");
-    _content = element_to_string(en, 0, 0);
+    _content = element_to_buffer(en, 0);
 }
 
 XmlMeasurement::XmlMeasurement(const Glib::ustring& iid, const Glib::ustring& format) :
@@ -58,10 +58,15 @@ void XmlMeasurement::dump()
     std::cout << "_iid: "     << _iid     << std::endl;
     std::cout << "_format: "  << _format  << std::endl;
     std::cout << "_type: "    << _type    << std::endl;
-    std::cout << "_content: " << _content << std::endl;
+    std::cout << "_content: " << _content.to_string() << std::endl;
 }
 
 Glib::ustring XmlMeasurement::to_xml() const
+{
+    return _content.to_ustring();
+}
+
+SharedBuffer XmlMeasurement::to_buffer() const
 {
     return _content;
 }
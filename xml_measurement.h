@@ -63,17 +63,16 @@ public:
         return _type;
     }
 
-    inline const Glib::ustring& get_content() const
-    {
-        return _content;
-    }
-
-    inline Glib::ustring& get_content()
+    /**
+     * The serialized <measurement> element, shared and not copied.
+     */
+    inline const SharedBuffer& get_content() const
     {
         return _content;
     }
 
     Glib::ustring to_xml () const;
+    SharedBuffer to_buffer () const;
 
     void dump ();
 
@@ -82,7 +81,7 @@ private:
     Glib::ustring _iid;
     Glib::ustring _format;
     Glib::ustring _type;
-    Glib::ustring _content;
+    SharedBuffer _content;
 };
 
 #endif /* _XML_MEASUREMENT_H_ */
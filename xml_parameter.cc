@@ -19,6 +19,12 @@ XmlParameter::XmlParameter (const Glib::ustring & type, const Glib::ustring & na
     , _name (name)
 { }
 
+SharedBuffer
+XmlParameter::to_buffer () const
+{
+    return SharedBuffer (to_xml ());
+}
+
 Glib::RefPtr <XmlParameter>
 XmlParameter::create (const xmlpp::Element *en)
 {
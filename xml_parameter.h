@@ -9,6 +9,8 @@
 #include <libxml++/nodes/element.h>
 #include <map>
 
+#include "shared_buffer.h"
+
 /**
  * \brief Baseclass for Parameters in xml
  *
@@ -28,6 +30,12 @@ class XmlParameter : public Glib::Object
 	virtual void dump () = 0;
 	virtual Glib::ustring to_xml () const = 0;
 
+	/**
+	 * to_xml () as buffer, parameters with large content override
+	 * this to hand it out without copying.
+	 */
+	virtual SharedBuffer to_buffer () const;
+
 	static void register_factory (const Glib::ustring & name, Factory factory);
 	static void init ();
 
@@ -4,24 +4,62 @@
 #include "xml_string_parameter.h"
 #include "xml_exception.h"
 
+#include <algorithm>
+#include <functional>
+#include <string>
+
 XmlParameterList::XmlParameterList ()
 { }
 
-Glib::RefPtr <XmlParameter>
-XmlParameterList::get_param (const Glib::ustring & name) const
+static std::size_t
+name_hash (const Glib::ustring & name)
 {
-    Glib::RefPtr <XmlParameter> retval;
+    return std::hash <std::string> () (name.raw ());
+}
 
-    for (auto e : *this) {
-	if (e->get_name () == name) {
-	    if (retval)
-		return Glib::RefPtr <XmlParameter> ();
+std::vector <XmlParameterList::Slot>::const_iterator
+XmlParameterList::find_slot (const Glib::ustring & name, std::size_t hash) const
+{
+    auto it = std::lower_bound (_index.begin (), _index.end (), hash,
+				[] (const Slot & slot, std::size_t h) { return slot.hash < h; });
 
-	    retval = e;
-	}
+    for (; it != _index.end () && it->hash == hash; ++it) {
+	if ((*this)[it->pos]->get_name () == name)
+	    return it;
     }
 
-    return retval;
+    return _index.end ();
+}
+
+void
+XmlParameterList::push_back (const Glib::RefPtr <XmlParameter> & param)
+{
+    std::size_t hash = name_hash (param->get_name ());
+    auto it = find_slot (param->get_name (), hash);
+
+    if (it != _index.end ()) {
+	_index[it - _index.begin ()].duplicate = true;
+    } else {
+	/* after the slots of the same hash
+	 */
+	Slot slot = { hash, size (), false };
+	auto pos = std::upper_bound (_index.begin (), _index.end (), hash,
+				     [] (std::size_t h, const Slot & s) { return h < s.hash; });
+	_index.insert (pos, slot);
+    }
+
+    Base::push_back (param);
+}
+
+Glib::RefPtr <XmlParameter>
+XmlParameterList::get_param (const Glib::ustring & name) const
+{
+    auto it = find_slot (name, name_hash (name));
+
+    if (it == _index.end () || it->duplicate)
+	return Glib::RefPtr <XmlParameter> ();
+
+    return (*this)[it->pos];
 }
 
 Glib::RefPtr <XmlParameter>
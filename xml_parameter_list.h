@@ -3,6 +3,7 @@
 #define ZIX_XML_PARAMETER_LIST_H
 
 #include <list>
+#include <vector>
 
 #include <glibmm/refptr.h>
 #include <glibmm/ustring.h>
@@ -14,12 +15,35 @@
  *
  * XmlParameterList is also passed to the CoreFunctionCall, when
  * its created.
+ *
+ * The parameters are kept in order in one vector, so copying the
+ * list is a single allocation. Lookups by name go through a small
+ * index sorted by the hash of the name, names which occur more than
+ * once are marked when they are added.
  */
-class XmlParameterList : public std::list <Glib::RefPtr <XmlParameter> >
+class XmlParameterList : private std::vector <Glib::RefPtr <XmlParameter> >
 {
+    typedef std::vector <Glib::RefPtr <XmlParameter> > Base;
+
     public:
+	using Base::value_type;
+	using Base::const_iterator;
+	using Base::size;
+	using Base::empty;
+	using Base::reserve;
+
 	XmlParameterList ();
 
+	const_iterator begin () const { return Base::begin (); }
+	const_iterator end () const { return Base::end (); }
+	const value_type & front () const { return Base::front (); }
+
+	void push_back (const Glib::RefPtr <XmlParameter> & param);
+
+	/**
+	 * @return the parameter called name, an empty RefPtr, if there is
+	 *         none or more than one.
+	 */
 	Glib::RefPtr <XmlParameter> get_param (const Glib::ustring & name) const;
     Glib::RefPtr <XmlParameter> get_first_param () const;
 
@@ -55,6 +79,20 @@ class XmlParameterList : public std::list <Glib::RefPtr <XmlParameter> >
 	void add_str_param (const Glib::ustring & name, const Glib::ustring & val);
 
 	void dump () const;
+
+    private:
+	struct Slot
+	{
+	    std::size_t hash;
+	    std::size_t pos;
+	    bool duplicate;
+	};
+
+	/* sorted by hash, positions stay valid when the list is copied
+	 */
+	std::vector <Slot> _index;
+
+	std::vector <Slot>::const_iterator find_slot (const Glib::ustring & name, std::size_t hash) const;
 };
 
 #endif
@@ -6,7 +6,6 @@
 #include "file_handler.h"
 #include "procedure_step_handler.h"
 #include "file_interface_connection.h"
-#include "accessibility_checker.h"
 #include "zix_interface.h"
 #include "xml_helpers.h"
 
@@ -52,6 +51,29 @@ XmlProcessor::parse_stream (std::istream & is, int tid, int prio, std::weak_ptr
 	return;
     }
 
+    enqueue_request (xml_req, interface);
+}
+
+void
+XmlProcessor::parse_document (std::shared_ptr <xmlpp::DomParser> parser, int tid, int prio, std::weak_ptr <InterfaceConnection> ic, const Glib::ustring& interface)
+{
+    Glib::RefPtr <XmlRequest> xml_req;
+    auto conn = ic.lock();
+
+    try {
+	xml_req = XmlRequest::create (parser, prio, ic, interface, tid);
+    } catch (const std::exception& e) {
+	auto result = XmlResultBadRequest::create (e.what());
+	conn->emit_result (result->to_xml (), tid);
+	return;
+    }
+
+    enqueue_request (xml_req, interface);
+}
+
+void
+XmlProcessor::enqueue_request (const ReqPtr& xml_req, const Glib::ustring& interface)
+{
     /*
      * Execution of tasks:
      *  - FIFO based on function and interface priority
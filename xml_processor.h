@@ -36,6 +36,13 @@ public:
     void parse_stream(std::istream& is, int tid, int prio, std::weak_ptr<InterfaceConnection> ic,
                       const Glib::ustring& interface = "", bool restart_proc = false);
 
+    /**
+     * Same as parse_stream, but for a document already parsed elsewhere
+     * (e.g. by IngestBatchRequest). Requests are queued in call order.
+     */
+    void parse_document(std::shared_ptr<xmlpp::DomParser> parser, int tid, int prio,
+                        std::weak_ptr<InterfaceConnection> ic, const Glib::ustring& interface = "");
+
     void init();
 
 protected:
@@ -45,6 +52,7 @@ protected:
     void request_finished();
     void high_prio_request_finished();
     void gui_request_finished();
+    void enqueue_request(const ReqPtr& xml_req, const Glib::ustring& interface);
 
 private:
     std::priority_queue<ReqPtr,
@@ -5,7 +5,6 @@
 #include "xml_result_bad_request.h"
 #include "xml_exception.h"
 #include "zix_interface.h"
-#include "accessibility_checker.h"
 #include "file_handler.h"
 
 #include "xml_request.h"
@@ -15,19 +14,38 @@ int XmlRequest::req_counter = 0;
 
 XmlRequest::XmlRequest (std::istream & is, int prio, std::weak_ptr <InterfaceConnection> ic, const Glib::ustring& interface, int tid, bool restart_proc)
     : Glib::ObjectBase (typeid (XmlRequest))
-    , _parser ()
+    , _parser (std::make_shared <xmlpp::DomParser> ())
     , _prio (prio)
     , _interface_connection (ic)
     , _interface (interface)
     , _tid (tid)
     , _ts (req_counter++)
 {
-    _parser.parse_stream (is);
+    _parser->parse_stream (is);
 
-    auto conn = ic.lock();
-    _function = XmlFunction::create (_parser.get_document()->get_root_node(),
+    setup (restart_proc);
+}
+
+XmlRequest::XmlRequest (std::shared_ptr <xmlpp::DomParser> parser, int prio, std::weak_ptr <InterfaceConnection> ic, const Glib::ustring& interface, int tid)
+    : Glib::ObjectBase (typeid (XmlRequest))
+    , _parser (parser)
+    , _prio (prio)
+    , _interface_connection (ic)
+    , _interface (interface)
+    , _tid (tid)
+    , _ts (req_counter++)
+{
+    setup (false);
+}
+
+void
+XmlRequest::setup (bool restart_proc)
+{
+    auto conn = _interface_connection.lock();
+    _function = XmlFunction::create (_parser->get_document()->get_root_node(),
                                      _interface,
                                      conn->get_filename());
+    _function->set_attachment (conn->get_attachment (), conn->supports_attachments ());
 
     if ((_function->get_fid () == "procedure") && !restart_proc) {
 	/* procedure xmls need to be saved,
@@ -35,13 +53,13 @@ XmlRequest::XmlRequest (std::istream & is, int prio, std::weak_ptr <InterfaceCon
 	 * restarts
 	 */
 
-	_parser.get_document ()->write_to_file (ZIX_PROC_SAVE_FILE_TMP);
+	_parser->get_document ()->write_to_file (ZIX_PROC_SAVE_FILE_TMP);
 	rename (ZIX_PROC_SAVE_FILE_TMP, ZIX_PROC_SAVE_FILE);
 
 	/* after saving procedure, note current step (0)
 	 * in current state file
 	 */
-	note_current_proc_step (0, interface, conn->get_resume_reply_file ());
+	note_current_proc_step (0, _interface, conn->get_resume_reply_file ());
     } else if (_function->get_fid () == "update") {
         const XmlParameterList fparams = _function->get_params ();
         Glib::ustring target;
@@ -74,6 +92,12 @@ XmlRequest::create (std::istream & is, int prio, std::weak_ptr <InterfaceConnect
     return Glib::RefPtr <XmlRequest> (new XmlRequest (is, prio, ic, interface, tid, restart_proc));
 }
 
+Glib::RefPtr <XmlRequest>
+XmlRequest::create (std::shared_ptr <xmlpp::DomParser> parser, int prio, std::weak_ptr <InterfaceConnection> ic, const Glib::ustring& interface, int tid)
+{
+    return Glib::RefPtr <XmlRequest> (new XmlRequest (parser, prio, ic, interface, tid));
+}
+
 void
 XmlRequest::execute ()
 {
@@ -104,13 +128,16 @@ void
 XmlRequest::function_finished (Glib::RefPtr <XmlResult> result)
 {
     auto ic = _interface_connection.lock();
-    auto xml_result = result->to_xml();
 
     /* the result is sent back over the interface_connection
      * it came from.
      */
 
-    ic->emit_result (xml_result, _tid);
+    auto stream_result = Glib::RefPtr <XmlResultStream>::cast_dynamic (result);
+    if (stream_result)
+	ic->emit_result_stream (stream_result, _tid);
+    else
+	ic->emit_result_buffer (result->to_buffer(), _tid);
 
     _current_call.reset();
     finished.emit();
@@ -129,7 +156,7 @@ XmlRequest::print_node (const xmlpp::Node *node)
 void
 XmlRequest::print_dom ()
 {
-    const xmlpp::Node* node = _parser.get_document()->get_root_node();
+    const xmlpp::Node* node = _parser->get_document()->get_root_node();
 
     print_node (node);
 }
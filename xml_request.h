@@ -32,8 +32,15 @@ class XmlRequest : public Glib::Object
 {
 public:
     XmlRequest (std::istream & is, int prio, std::weak_ptr <InterfaceConnection> ic, const Glib::ustring& interface, int tid, bool restart_proc);
+    XmlRequest (std::shared_ptr <xmlpp::DomParser> parser, int prio, std::weak_ptr <InterfaceConnection> ic, const Glib::ustring& interface, int tid);
     static Glib::RefPtr <XmlRequest> create (std::istream & is, int prio, std::weak_ptr <InterfaceConnection> ih, const Glib::ustring& interface, int tid, bool restart_proc = false);
 
+    /**
+     * Create request from an already parsed document, e.g. parsed on a
+     * worker thread. The request takes over the parser.
+     */
+    static Glib::RefPtr <XmlRequest> create (std::shared_ptr <xmlpp::DomParser> parser, int prio, std::weak_ptr <InterfaceConnection> ic, const Glib::ustring& interface, int tid);
+
     sigc::signal <void> finished;
     void execute ();
 
@@ -43,7 +50,7 @@ public:
     Glib::ustring fid() const noexcept;
 
 protected:
-    xmlpp::DomParser _parser;
+    std::shared_ptr <xmlpp::DomParser> _parser;
 
     Glib::RefPtr <XmlFunction> _function;
     Glib::RefPtr <FunctionCall> _current_call;
@@ -64,6 +71,7 @@ private:
     int _ts;
 
     int calculate_priority() const noexcept;
+    void setup (bool restart_proc);
 };
 
 #endif
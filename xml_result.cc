@@ -2,9 +2,6 @@
 #include "xml_result.h"
 
 #include "log.h"
-#include "xml_helpers.h"
-
-#include <libxml++/parsers/domparser.h>
 
 XmlResult::XmlResult ()
     : _redirected (false)
@@ -25,6 +22,16 @@ XmlResult::XmlResult (int status, const Glib::ustring & message,
                       const std::vector<Glib::ustring>& return_values)
     : _status (status)
     , _message (message)
+    , _redirected (false)
+{
+    for (auto&& ret : return_values)
+	_return_values.emplace_back (ret);
+}
+
+XmlResult::XmlResult (int status, const Glib::ustring & message,
+                      const std::vector<SharedBuffer>& return_values)
+    : _status (status)
+    , _message (message)
     , _return_values (return_values)
     , _redirected (false)
 {}
@@ -48,110 +55,77 @@ XmlResult::create (int status, const Glib::ustring & message,
     return Glib::RefPtr <XmlResult> (new XmlResult (status, message, return_values));
 }
 
+Glib::RefPtr <XmlResult>
+XmlResult::create (int status, const Glib::ustring & message,
+                   const std::vector<SharedBuffer>& return_values)
+{
+    return Glib::RefPtr <XmlResult> (new XmlResult (status, message, return_values));
+}
+
+/* return values and parameters, each followed by a newline
+ */
+void
+XmlResult::append_values (SharedBuffer & buffer) const
+{
+    static const SharedBuffer newline (Glib::Bytes::create ("\n", 1));
+
+    for (auto&& ret : _return_values) {
+	buffer.append (ret);
+	buffer.append (newline);
+    }
+    for (auto&& ret : _params) {
+	buffer.append (ret->to_buffer ());
+	buffer.append (newline);
+    }
+}
+
 Glib::ustring
 XmlResult::to_dest ()
 {
-    Glib::ustring res;
-
-    if( ! _raw_result.empty() ) {
-	/* This is a raw result,
-	 * we need to remove the message field, and dump all other nodes into the string
-	 */
-	xmlpp::DomParser parser;
-	parser.parse_memory (_raw_result);
-
-	const xmlpp::Element *root = parser.get_document()->get_root_node();
-
-	if (root == nullptr) {
-	    return Glib::ustring ("failed to parse XmlResult\n");
-	}
-
-	for (auto c : root->get_children ()) {
-
-	    /* we dont want to include <message> node in the file result
-	     */
-	    xmlpp::Element *en = dynamic_cast <xmlpp::Element *> (c);
-	    if (en != nullptr)
-		if (en->get_name() == "message")
-		    continue;
-
-	    res += node_to_string (c, 0, 0);
-	}
-    } else {
-	for (auto&& ret : _return_values)
-	    res += Glib::ustring::compose ("%1\n", ret);
-	for (auto&& ret : _params)
-	    res += Glib::ustring::compose ("%1\n", ret->to_xml() );
-    }
+    SharedBuffer buffer;
 
-    return res;
+    append_values (buffer);
+
+    return buffer.to_ustring ();
 }
 
 Glib::ustring
 XmlResult::to_body ()
 {
-    Glib::ustring res;
+    SharedBuffer res;
 
     if (_message.empty () && _return_values.empty() && _params.empty() )
         return Glib::ustring();
 
     if (!_message.empty())
-        res += Glib::ustring::compose ("<message>%1</message>\n", _message);
-    for (auto&& ret : _return_values)
-        res += Glib::ustring::compose ("%1\n", ret);
-    for (auto&& ret : _params)
-        res += Glib::ustring::compose ("%1\n", ret->to_xml() );
+        res.append (std::string (Glib::ustring::compose ("<message>%1</message>\n", _message).raw ()));
+    append_values (res);
 
-    return res;
+    return res.to_ustring ();
 }
 
 Glib::ustring
 XmlResult::to_xml ()
 {
-    Glib::ustring res;
-
-    if( ! _raw_result.empty() ) {
-	if (_redirected) {
-	    xmlpp::DomParser parser;
-	    parser.parse_memory (_raw_result);
-
-	    xmlpp::Element *root = parser.get_document()->get_root_node();
-
-	    if (root == nullptr) {
-		return Glib::ustring ("failed to parse XmlResult\n");
-	    }
-
-	    /* search for <message> nodes, and eliminate anything but these.
-	    */
-	    for (auto n : root->get_children ()) {
-		xmlpp::Element *en = dynamic_cast <xmlpp::Element *> (n);
-		if (en != nullptr)
-		    if (en->get_name() == "message")
-			continue;
-
-		/* this is not a message node... remove it
-		*/
-		root->remove_child (n);
-	    }
-
-	    res = node_to_string (root, 0, 0);
-
-	    return res;
-	} else {
-	    return _raw_result;
-	}
-    }
+    return to_buffer ().to_ustring ();
+}
 
+SharedBuffer
+XmlResult::to_buffer ()
+{
     if (_message.empty () && _return_values.empty() && _params.empty())
-        return Glib::ustring::compose ("<reply status=\"%1\"/>\n", _status);
+        return SharedBuffer (std::string (Glib::ustring::compose ("<reply status=\"%1\"/>\n", _status).raw ()));
+
+    std::string head = Glib::ustring::compose ("<reply status=\"%1\">\n", _status).raw ();
+
+    // include message in redirected requests, but nothing else
+    if (!_message.empty())
+        head += Glib::ustring::compose ("<message>%1</message>\n", _message).raw ();
 
-    res += Glib::ustring::compose ("<reply status=\"%1\">\n", _status);
+    SharedBuffer res (std::move (head));
     if (!_redirected)
-	res += to_body ();
-    else // include message in redirected requests
-        if (!_message.empty())
-            res += Glib::ustring::compose ("<message>%1</message>\n", _message);
-    res += "</reply>\n";
+	append_values (res);
+    res.append (std::string ("</reply>\n"));
 
     return res;
 }
@@ -177,17 +151,10 @@ void XmlResult::dump()
     printf("###    Parameters: %d\n", (int)_params.size() );
 
     for (auto&& ret : _return_values)
-        printf("###   Return value: %s\n", ret.c_str() );
+        printf("###   Return value: %s\n", ret.to_string().c_str() );
 
     printf("\n");
 }
 
 
-void XmlResult::setRawResult(const Glib::ustring &raw_result)
-{
-    _raw_result=raw_result;
-    return;
-}
-
-
 //---fin----------------------------------------------------------------------
@@ -7,13 +7,15 @@
 #include "glibmm/object.h"
 
 #include "xml_parameter_list.h"
+#include "shared_buffer.h"
 
 /**
  * \brief Baseclass for Result of CoreFunctionCall
  *
  * The XmlResult can be converted to a Glib::ustring of
  * xml, which is then emitted via the InterfaceHandler
- * emit_result function
+ * emit_result function. to_buffer() produces the same
+ * xml without copying return values and parameter content.
  */
 class XmlResult : public Glib::Object
 {
@@ -23,21 +25,24 @@ public:
     XmlResult(int status, const Glib::ustring & message);
     XmlResult(int status, const Glib::ustring & message,
               const std::vector<Glib::ustring>& return_values);
+    XmlResult(int status, const Glib::ustring & message,
+              const std::vector<SharedBuffer>& return_values);
 
     static Glib::RefPtr <XmlResult> create (int status);
     static Glib::RefPtr <XmlResult> create (int status, const Glib::ustring & message);
     static Glib::RefPtr <XmlResult> create (int status, const Glib::ustring & message,
                                             const std::vector<Glib::ustring>& return_values);
+    static Glib::RefPtr <XmlResult> create (int status, const Glib::ustring & message,
+                                            const std::vector<SharedBuffer>& return_values);
 
-    Glib::ustring to_dest ();
-    Glib::ustring to_body ();
-    Glib::ustring to_xml ();
+    virtual Glib::ustring to_dest ();
+    virtual Glib::ustring to_body ();
+    virtual Glib::ustring to_xml ();
+    virtual SharedBuffer to_buffer ();
     int get_status();
     void dump_params();
     void dump();
 
-    void setRawResult(const Glib::ustring &raw_result);
-
     const XmlParameterList& getParameterList() const
     {
         return _params;
@@ -57,9 +62,11 @@ protected:
     XmlParameterList _params;
     Glib::ustring _message;
     Glib::ustring _textbody;
-    Glib::ustring _raw_result;
-    std::vector<Glib::ustring> _return_values;
+    std::vector<SharedBuffer> _return_values;
     bool _redirected;
+
+private:
+    void append_values (SharedBuffer & buffer) const;
 };
 
 #endif
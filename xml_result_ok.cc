@@ -14,6 +14,11 @@ XmlResultOk::XmlResultOk (const Glib::ustring & message,
     : XmlResult (200, message, return_values)
 { }
 
+XmlResultOk::XmlResultOk (const Glib::ustring & message,
+                          const std::vector<SharedBuffer>& return_values)
+    : XmlResult (200, message, return_values)
+{ }
+
 Glib::RefPtr <XmlResult>
 XmlResultOk::create ()
 {
@@ -38,3 +43,12 @@ XmlResultOk::create (const Glib::ustring & message,
 
     return Glib::RefPtr <XmlResult>::cast_dynamic (res);
 }
+
+Glib::RefPtr <XmlResult>
+XmlResultOk::create (const Glib::ustring & message,
+                     const std::vector<SharedBuffer>& return_values)
+{
+    auto res = Glib::RefPtr <XmlResultOk> (new XmlResultOk (message, return_values));
+
+    return Glib::RefPtr <XmlResult>::cast_dynamic (res);
+}
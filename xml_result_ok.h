@@ -14,10 +14,14 @@ class XmlResultOk : public XmlResult
 	XmlResultOk (const Glib::ustring & message);
     XmlResultOk (const Glib::ustring & message,
                  const std::vector<Glib::ustring>& return_values);
+    XmlResultOk (const Glib::ustring & message,
+                 const std::vector<SharedBuffer>& return_values);
 
 	static Glib::RefPtr <XmlResult> create ();
 	static Glib::RefPtr <XmlResult> create (const Glib::ustring & message);
     static Glib::RefPtr <XmlResult> create (const Glib::ustring & message,
                                             const std::vector<Glib::ustring>& return_values);
+    static Glib::RefPtr <XmlResult> create (const Glib::ustring & message,
+                                            const std::vector<SharedBuffer>& return_values);
 };
 #endif
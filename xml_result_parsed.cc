@@ -5,30 +5,40 @@
 #include "log.h"
 
 #include <libxml++/nodes/element.h>
+#include <libxml++/document.h>
 
 #include <string>
 #include <cassert>
 
 
 XmlResultParsed::XmlResultParsed (const Glib::ustring & xml)
-	: XmlResult ()
+	: XmlResultParsed (SharedBuffer (xml))
 {
-    _parser.parse_memory (xml);
-    const xmlpp::Element *root = _parser.get_document()->get_root_node();
+}
+
+
+XmlResultParsed::XmlResultParsed (const SharedBuffer & raw)
+    : XmlResult ()
+    , _parser (std::make_shared <xmlpp::DomParser> ())
+    , _raw (raw)
+{
+    gsize size = 0;
+    Glib::RefPtr <Glib::Bytes> bytes = _raw.bytes ();
+    const unsigned char *data = static_cast <const unsigned char *> (bytes->get_data (size));
 
-    setRawResult(xml);
+    _parser->parse_memory_raw (data, size);
 
-    parse(root);
+    parse (root ());
 }
 
 
 XmlResultParsed::XmlResultParsed (const unsigned char* contents, int bytes_count)
     : XmlResult ()
+    , _parser (std::make_shared <xmlpp::DomParser> ())
 {
-    _parser.parse_memory_raw (contents, bytes_count);
-    const xmlpp::Element *root = _parser.get_document()->get_root_node();
+    _parser->parse_memory_raw (contents, bytes_count);
 
-    parse (root);
+    parse (root ());
 }
 
 XmlResultParsed::XmlResultParsed (const xmlpp::Element *root)
@@ -83,6 +93,13 @@ XmlResultParsed::create (const Glib::ustring & xml)
 }
 
 
+Glib::RefPtr <XmlResult>
+XmlResultParsed::create (const SharedBuffer & raw)
+{
+    return Glib::RefPtr <XmlResult> (new XmlResultParsed (raw));
+}
+
+
 Glib::RefPtr <XmlResult>
 XmlResultParsed::create (const unsigned char* contents, int bytes_count)
 {
@@ -94,3 +111,74 @@ XmlResultParsed::create (const xmlpp::Element *root)
 {
     return Glib::RefPtr <XmlResult> (new XmlResultParsed (root));
 }
+
+const xmlpp::Element *
+XmlResultParsed::root () const
+{
+    return _parser->get_document ()->get_root_node ();
+}
+
+/* the reply without anything but its <message> nodes, built from the kept
+ * document
+ */
+Glib::ustring
+XmlResultParsed::redirected_reply () const
+{
+    xmlpp::Document doc;
+    xmlpp::Element *reply = doc.create_root_node (root ()->get_name ());
+
+    for (auto attr : root ()->get_attributes ())
+	reply->set_attribute (attr->get_name (), attr->get_value ());
+
+    for (auto c : root ()->get_children ("message"))
+	reply->import_node (c);
+
+    return element_to_string (reply, 0, 0);
+}
+
+Glib::ustring
+XmlResultParsed::to_dest ()
+{
+    Glib::ustring res;
+
+    if (_raw.empty ())
+	return XmlResult::to_dest ();
+
+    for (auto c : root ()->get_children ()) {
+
+	/* we dont want to include <message> node in the file result
+	 */
+	const xmlpp::Element *en = dynamic_cast <const xmlpp::Element *> (c);
+	if (en != nullptr)
+	    if (en->get_name() == "message")
+		continue;
+
+	res += node_to_string (c, 0, 0);
+    }
+
+    return res;
+}
+
+Glib::ustring
+XmlResultParsed::to_xml ()
+{
+    if (_raw.empty ())
+	return XmlResult::to_xml ();
+
+    if (_redirected)
+	return redirected_reply ();
+
+    return _raw.to_ustring ();
+}
+
+SharedBuffer
+XmlResultParsed::to_buffer ()
+{
+    if (_raw.empty ())
+	return XmlResult::to_buffer ();
+
+    if (_redirected)
+	return SharedBuffer (std::string (redirected_reply ().raw ()));
+
+    return _raw;
+}
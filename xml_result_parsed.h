@@ -2,7 +2,10 @@
 #ifndef ZIX_XML_RESULT_PARSED
 #define ZIX_XML_RESULT_PARSED
 
+#include <memory>
+
 #include "xml_result.h"
+#include "shared_buffer.h"
 #include "libxml++/parsers/domparser.h"
 
 namespace xmlpp
@@ -10,21 +13,38 @@ namespace xmlpp
     class DomParser;
 }
 
+/**
+ * \brief XmlResult of a <reply> received from a device or a socket
+ *
+ * When created from the raw reply, the parsed document is kept and the raw
+ * bytes are forwarded verbatim by to_xml() and to_buffer(), so a reply is
+ * parsed exactly once on its way through the daemon.
+ */
 class XmlResultParsed : public XmlResult
 {
     public:
 	XmlResultParsed (const Glib::ustring & xml);
+	XmlResultParsed (const SharedBuffer & raw);
 	XmlResultParsed (const unsigned char* contents, int bytes_count);
 	XmlResultParsed (const xmlpp::Element *root);
 
 	static Glib::RefPtr <XmlResult> create (const Glib::ustring & xml);
+	static Glib::RefPtr <XmlResult> create (const SharedBuffer & raw);
 	static Glib::RefPtr <XmlResult> create (const unsigned char* contents, int bytes_count);
 	static Glib::RefPtr <XmlResult> create (const xmlpp::Element *root);
 
 	void parse (const xmlpp::Element *root);
 
+	virtual Glib::ustring to_dest ();
+	virtual Glib::ustring to_xml ();
+	virtual SharedBuffer to_buffer ();
+
     private:
-	xmlpp::DomParser _parser;
+	std::shared_ptr <xmlpp::DomParser> _parser;
+	SharedBuffer _raw;
+
+	const xmlpp::Element *root () const;
+	Glib::ustring redirected_reply () const;
 };
 
 #endif
@@ -0,0 +1,349 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "xml_result_stream.h"
+
+const std::size_t XmlResultStream::CHUNK_SIZE;
+
+XmlResultStream::XmlResultStream ()
+    : XmlResult (200)
+    , _attachment_size (0)
+{}
+
+Glib::RefPtr <XmlResultStream>
+XmlResultStream::create ()
+{
+    return Glib::RefPtr <XmlResultStream> (new XmlResultStream ());
+}
+
+void
+XmlResultStream::add_text (const Glib::ustring & text)
+{
+    Part part;
+
+    part.text = text;
+    _parts.push_back (part);
+}
+
+std::size_t
+XmlResultStream::file_size (const std::string & path)
+{
+    struct stat sb;
+
+    if (stat (path.c_str (), &sb) || !S_ISREG (sb.st_mode) || access (path.c_str (), R_OK))
+        throw std::runtime_error ("Failed to open file " + path);
+
+    return sb.st_size;
+}
+
+std::string
+XmlResultStream::attachment_ref (const Part & part)
+{
+    return Glib::ustring::compose ("<attachment offset=\"%1\" size=\"%2\"/>",
+                                   part.offset, part.size).raw ();
+}
+
+void
+XmlResultStream::add_file_base64 (const std::string & path, const Glib::ustring & head,
+                                  const Glib::ustring & tail, const Glib::ustring & empty)
+{
+    Part part;
+
+    part.size  = file_size (path);
+    part.text  = head;
+    part.path  = path;
+    part.tail  = tail;
+    part.empty = empty;
+    _parts.push_back (part);
+}
+
+void
+XmlResultStream::add_file_attachment (const std::string & path, const Glib::ustring & head,
+                                      const Glib::ustring & tail)
+{
+    Part part;
+
+    part.size       = file_size (path);
+    part.text       = head;
+    part.path       = path;
+    part.tail       = tail;
+    part.attachment = true;
+    part.offset     = _attachment_size;
+    _parts.push_back (part);
+
+    _attachment_size += part.size;
+}
+
+std::size_t
+XmlResultStream::xml_size () const
+{
+    if (_redirected || _parts.empty ())
+        return const_cast<XmlResultStream *> (this)->XmlResult::to_xml ().bytes ();
+
+    std::size_t size = Glib::ustring::compose ("<reply status=\"%1\">\n", _status).bytes ();
+
+    for (auto && part : _parts) {
+        if (part.path.empty ())
+            size += part.text.bytes ();
+        else if (part.attachment)
+            size += part.text.bytes () + attachment_ref (part).size () + part.tail.bytes ();
+        else if (part.size == 0)
+            size += part.empty.bytes ();
+        else
+            size += part.text.bytes () + (part.size + 2) / 3 * 4 + part.tail.bytes ();
+        size += 1;
+    }
+
+    return size + strlen ("</reply>\n");
+}
+
+XmlResultStream::Cursor::Cursor (const XmlResultStream & result, bool envelope)
+    : _result (result)
+    , _envelope (envelope)
+    , _phase (envelope ? HEAD : PART)
+    , _part (0)
+    , _attachment_part (0)
+    , _map (nullptr)
+    , _size (0)
+    , _pos (0)
+{}
+
+XmlResultStream::Cursor::~Cursor ()
+{
+    unmap ();
+}
+
+void
+XmlResultStream::Cursor::unmap ()
+{
+    if (_map)
+        munmap (_map, _size);
+    _map = nullptr;
+}
+
+/**
+ * Map the first size bytes of the file, size is the file size seen when
+ * the file was added.
+ */
+void
+XmlResultStream::Cursor::map_file (const std::string & path, std::size_t size)
+{
+    struct stat sb;
+
+    int fd = open (path.c_str (), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error ("Failed to open file " + path + ": " + strerror (errno));
+
+    if (fstat (fd, &sb)) {
+        int err = errno;
+        close (fd);
+        throw std::runtime_error ("Failed to stat file " + path + ": " + strerror (err));
+    }
+
+    if (static_cast<std::size_t> (sb.st_size) < size) {
+        close (fd);
+        throw std::runtime_error ("File " + path + " was truncated");
+    }
+
+    _map = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (_map == MAP_FAILED) {
+        _map = nullptr;
+        throw std::runtime_error ("Failed to map file " + path + ": " + strerror (errno));
+    }
+
+    madvise (_map, size, MADV_SEQUENTIAL);
+
+    _size = size;
+    _pos = 0;
+}
+
+void
+XmlResultStream::Cursor::open_file (std::string & out)
+{
+    const auto & part = _result._parts[_part];
+
+    if (part.size == 0) {
+        out.append (part.empty.raw ());
+        out.push_back ('\n');
+        ++_part;
+        return;
+    }
+
+    map_file (part.path, part.size);
+    _phase = FILE;
+
+    out.append (part.text.raw ());
+}
+
+bool
+XmlResultStream::Cursor::next (std::string & out)
+{
+    out.clear ();
+
+    switch (_phase) {
+    case HEAD:
+        /* same layout as XmlResultOk with return values
+         */
+        if (_result._redirected || _result._parts.empty ()) {
+            out = const_cast<XmlResultStream &> (_result).XmlResult::to_xml ().raw ();
+            _phase = DONE;
+        } else {
+            out = Glib::ustring::compose ("<reply status=\"%1\">\n", _result._status).raw ();
+            _phase = PART;
+        }
+        return true;
+
+    case PART:
+        if (_part == _result._parts.size ()) {
+            _phase = DONE;
+            if (!_envelope)
+                return false;
+            out = "</reply>\n";
+            return true;
+        }
+
+        if (_result._parts[_part].path.empty ()) {
+            out.append (_result._parts[_part].text.raw ());
+            out.push_back ('\n');
+            ++_part;
+        } else if (_result._parts[_part].attachment) {
+            const auto & part = _result._parts[_part];
+
+            out.append (part.text.raw ());
+            out.append (attachment_ref (part));
+            out.append (part.tail.raw ());
+            out.push_back ('\n');
+            ++_part;
+        } else {
+            open_file (out);
+        }
+        return true;
+
+    case FILE:
+        encode_chunk (out);
+        return true;
+
+    case DONE:
+        break;
+    }
+
+    return false;
+}
+
+void
+XmlResultStream::Cursor::encode_chunk (std::string & out)
+{
+    std::size_t len = std::min (CHUNK_SIZE, _size - _pos);
+    std::size_t used = out.size ();
+
+    out.resize (used + Base64Codec::Encoder::max_step_size (len) + Base64Codec::Encoder::MAX_CLOSE_SIZE);
+    used += _encoder.step (static_cast<const char *> (_map) + _pos, len, &out[used]);
+    _pos += len;
+
+    if (_pos < _size) {
+        out.resize (used);
+        return;
+    }
+
+    used += _encoder.close (&out[used]);
+    out.resize (used);
+    out.append (_result._parts[_part].tail.raw ());
+    out.push_back ('\n');
+
+    unmap ();
+    ++_part;
+    _phase = PART;
+}
+
+bool
+XmlResultStream::Cursor::next_attachment (std::string & out)
+{
+    const auto & parts = _result._parts;
+
+    out.clear ();
+
+    while (!_map) {
+        if (_attachment_part == parts.size ())
+            return false;
+
+        const auto & part = parts[_attachment_part];
+
+        if (part.attachment && part.size)
+            map_file (part.path, part.size);
+        else
+            ++_attachment_part;
+    }
+
+    std::size_t len = std::min (CHUNK_SIZE, _size - _pos);
+
+    out.assign (static_cast<const char *> (_map) + _pos, len);
+    _pos += len;
+
+    if (_pos == _size) {
+        unmap ();
+        ++_attachment_part;
+    }
+
+    return true;
+}
+
+void
+XmlResultStream::write_to (const Sink & sink) const
+{
+    Cursor cursor (*this);
+    std::string chunk;
+
+    while (cursor.next (chunk))
+        sink (chunk.data (), chunk.size ());
+}
+
+Glib::ustring
+XmlResultStream::to_dest ()
+{
+    Cursor cursor (*this, false);
+    std::string res, chunk;
+
+    while (cursor.next (chunk))
+        res += chunk;
+
+    return res;
+}
+
+Glib::ustring
+XmlResultStream::to_body ()
+{
+    return to_dest ();
+}
+
+Glib::ustring
+XmlResultStream::to_xml ()
+{
+    std::string res;
+
+    write_to ([&res] (const char *data, std::size_t len) { res.append (data, len); });
+
+    return res;
+}
+
+SharedBuffer
+XmlResultStream::to_buffer ()
+{
+    Cursor cursor (*this);
+    SharedBuffer res;
+    std::string chunk;
+
+    // the encoded chunks are handed over as segments
+    while (cursor.next (chunk))
+        res.append (std::move (chunk));
+
+    return res;
+}
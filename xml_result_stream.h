@@ -0,0 +1,165 @@
+#ifndef ZIX_XML_RESULT_STREAM_H
+#define ZIX_XML_RESULT_STREAM_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <glibmm/refptr.h>
+#include <glibmm/ustring.h>
+
+#include "xml_result.h"
+#include "base64_codec.h"
+
+/**
+ * \brief Good Result of CoreFunctionCall with (large) file contents
+ *
+ * Works like XmlResultOk with return values, but files are not read into
+ * memory. When the reply is sent, the files are mapped and base64 encoded
+ * chunk by chunk directly to the interface connection, see
+ * InterfaceConnection::emit_result_stream. to_xml() still builds the whole
+ * reply as string for interfaces which can not stream.
+ *
+ * On connections supporting attachments, files can be sent unencoded in
+ * the attachment section after the xml instead, the xml then refers to
+ * them with <attachment offset="..." size="..."/>.
+ *
+ * File sizes are taken when a file is added, so xml_size() and
+ * attachment_size() are known before the reply is sent.
+ */
+class XmlResultStream : public XmlResult
+{
+public:
+    using Sink = std::function<void (const char *data, std::size_t len)>;
+
+    /**
+     * Input bytes encoded per chunk, a multiple of 3.
+     */
+    static const std::size_t CHUNK_SIZE = 48 * 1024;
+
+    /**
+     * \brief Produces the reply piece by piece
+     *
+     * Only the file currently encoded is mapped, the result has to outlive
+     * the cursor.
+     */
+    class Cursor
+    {
+    public:
+        /**
+         * @param envelope include <reply> element, otherwise only the
+         *                 return values are produced (see to_dest())
+         */
+        Cursor (const XmlResultStream & result, bool envelope = true);
+        ~Cursor ();
+
+        Cursor (const Cursor &) = delete;
+        Cursor & operator= (const Cursor &) = delete;
+
+        /**
+         * Replace out with the next piece of the reply, at most about
+         * 4/3 * CHUNK_SIZE bytes plus surrounding text.
+         *
+         * Throws, if a file can not be read.
+         *
+         * @return false, if the reply is complete
+         */
+        bool next (std::string & out);
+
+        /**
+         * After next() returned false, replace out with the next piece of
+         * the attachment section, at most CHUNK_SIZE bytes.
+         *
+         * @return false, if the attachments are complete
+         */
+        bool next_attachment (std::string & out);
+
+    private:
+        enum Phase { HEAD, PART, FILE, DONE };
+
+        const XmlResultStream & _result;
+        bool _envelope;
+        Phase _phase;
+        std::size_t _part;
+        std::size_t _attachment_part;
+        void *_map;
+        std::size_t _size;
+        std::size_t _pos;
+        Base64Codec::Encoder _encoder;
+
+        void map_file (const std::string & path, std::size_t size);
+        void open_file (std::string & out);
+        void encode_chunk (std::string & out);
+        void unmap ();
+    };
+
+    XmlResultStream ();
+
+    static Glib::RefPtr <XmlResultStream> create ();
+
+    /**
+     * Append a return value.
+     */
+    void add_text (const Glib::ustring & text);
+
+    /**
+     * Append a return value containing the base64 encoded content of a file:
+     * head, content, tail. For an empty file empty is used instead.
+     *
+     * Throws, if the file is not a readable regular file.
+     */
+    void add_file_base64 (const std::string & path, const Glib::ustring & head,
+                          const Glib::ustring & tail, const Glib::ustring & empty);
+
+    /**
+     * Append a return value referring to the unencoded content of a file in
+     * the attachment section: head, <attachment .../>, tail. Must only be
+     * used if the reply goes to a connection supporting attachments.
+     *
+     * Throws, if the file is not a readable regular file.
+     */
+    void add_file_attachment (const std::string & path, const Glib::ustring & head,
+                              const Glib::ustring & tail);
+
+    /**
+     * Size of the xml reply produced by Cursor::next().
+     */
+    std::size_t xml_size () const;
+
+    /**
+     * Size of the attachment section produced by Cursor::next_attachment().
+     */
+    std::size_t attachment_size () const { return _attachment_size; }
+
+    /**
+     * Write the reply in chunks to sink.
+     */
+    void write_to (const Sink & sink) const;
+
+    Glib::ustring to_dest () override;
+    Glib::ustring to_body () override;
+    Glib::ustring to_xml () override;
+    SharedBuffer to_buffer () override;
+
+private:
+    struct Part
+    {
+        Part () : size (0), attachment (false), offset (0) {}
+
+        Glib::ustring text;
+        std::string path;
+        Glib::ustring tail;
+        Glib::ustring empty;
+        std::size_t size;
+        bool attachment;
+        std::size_t offset;
+    };
+
+    std::vector<Part> _parts;
+    std::size_t _attachment_size;
+
+    static std::size_t file_size (const std::string & path);
+    static std::string attachment_ref (const Part & part);
+};
+
+#endif
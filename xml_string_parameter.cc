@@ -1,6 +1,10 @@
 
 #include "xml_string_parameter.h"
 
+#include "block_pool.h"
+
+typedef BlockPool <sizeof (XmlStringParameter)> StringParameterPool;
+
 XmlStringParameter::XmlStringParameter (const Glib::ustring & name, const Glib::ustring & val)
     : XmlParameter ("string", name)
     , _val (val)
@@ -12,6 +16,18 @@ XmlStringParameter::create (const Glib::ustring & name, const Glib::ustring & va
     return Glib::RefPtr <XmlStringParameter> (new XmlStringParameter (name, val));
 }
 
+void *
+XmlStringParameter::operator new (std::size_t size)
+{
+    return StringParameterPool::allocate (size);
+}
+
+void
+XmlStringParameter::operator delete (void *p, std::size_t size)
+{
+    StringParameterPool::release (p, size);
+}
+
 const Glib::ustring &
 XmlStringParameter::get_str ()
 {
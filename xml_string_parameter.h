@@ -26,6 +26,11 @@ class XmlStringParameter : public XmlParameter
 
 	const Glib::ustring & get_str();
 
+	/* every request creates some of them, they are pooled
+	 */
+	static void *operator new (std::size_t size);
+	static void operator delete (void *p, std::size_t size);
+
 	void dump ();
 	Glib::ustring to_xml () const;
 
@@ -66,6 +66,11 @@ public:
         ZixInterface(std::string(inf))
     {}
 
+    Inf id() const noexcept
+    {
+        return _inf;
+    }
+
     std::string to_string() const noexcept;
 
     std::string get_config_par() const noexcept;